@@ -0,0 +1,816 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCBenchmark.h"
+#include "Runtime/Engine/Classes/Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/EngineVersion.h"
+#include "Interfaces/IPluginManager.h"
+#include "SCBenchmarkModule.h"
+#include "SCClient.h"
+#include "SCJsonConvert.h"
+#include "SCJsonArena.h"
+#include "SCMessageAccounting.h"
+#include "SC_Formatter.h"
+
+/** The per message costs the budget limits */
+static const TCHAR* SCBudgetMetrics[] = { TEXT("allocationsPerMessage"), TEXT("allocatedBytesPerMessage"), TEXT("transcodesPerMessage") };
+
+static FString SCDefaultBudgetPath()
+{
+	TSharedPtr<IPlugin> plugin = IPluginManager::Get().FindPlugin(TEXT("SocketCluster"));
+	return (plugin.IsValid() ? plugin->GetBaseDir() / TEXT("Config") : FPaths::ProjectConfigDir()) / TEXT("SCMessageBudget.json");
+}
+
+USCBenchmark::USCBenchmark()
+{
+	World = nullptr;
+	client = nullptr;
+	running = false;
+	step = 0;
+	scenarioStart = 0.0;
+	stepStart = 0.0;
+	scenarioFrames = 0;
+	sent = 0;
+	received = 0;
+	payloadIndex = 0;
+	accounting = false;
+}
+
+USCBenchmark* USCBenchmark::run(const UObject* WorldContextObject, const FSCBenchmarkOptions& options, TFunction<void(TSharedPtr<FJsonObject> results)> oncomplete)
+{
+	USCBenchmark* benchmark = NewObject<USCBenchmark>();
+	benchmark->AddToRoot();
+	benchmark->World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	benchmark->options = options;
+	benchmark->oncomplete = oncomplete;
+
+	benchmark->results = MakeShareable(new FJsonObject);
+	benchmark->results->SetStringField("plugin", USCClient::Version());
+	benchmark->results->SetStringField("engine", FEngineVersion::Current().ToString());
+	benchmark->results->SetStringField("platform", ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+	benchmark->results->SetStringField("timestamp", FDateTime::UtcNow().ToIso8601());
+	benchmark->results->SetObjectField("scenarios", MakeShareable(new FJsonObject));
+
+	for (const FString& name : getScenarioNames())
+	{
+		if (options.scenarios.Num() == 0 || options.scenarios.Contains(name))
+		{
+			benchmark->pending.Add(name);
+		}
+	}
+
+	// Accounting started from the console is left running once the run completes
+	if (options.accountMessages && !FSCMessageAccounting::isRunning())
+	{
+		benchmark->accounting = FSCMessageAccounting::start();
+	}
+
+	benchmark->server = MakeUnique<FSCServer>();
+	benchmark->server->servicePasses = 256;
+	if (benchmark->World == nullptr || !benchmark->server->listen(options.port))
+	{
+		benchmark->results->SetStringField("error", benchmark->World == nullptr ? "Unable to access current game world." : FString::Printf(TEXT("Could not listen on port %d"), options.port));
+		benchmark->_complete();
+		return benchmark;
+	}
+
+	benchmark->running = true;
+	return benchmark;
+}
+
+const TArray<FString>& USCBenchmark::getScenarioNames()
+{
+	static const TArray<FString> names = { "rpc", "publish", "fanin", "resubscribe", "decode" };
+	return names;
+}
+
+bool USCBenchmark::writeResults(TSharedPtr<FJsonObject> results, FString path)
+{
+	if (path.IsEmpty())
+	{
+		path = FPaths::ProjectSavedDir() / TEXT("SCBenchmarks") / FString::Printf(TEXT("SCBenchmark-%s.json"), *FDateTime::Now().ToString());
+	}
+	if (!FFileHelper::SaveStringToFile(USCJsonConvert::ToJsonString(results), *path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogSCBenchmark, Error, TEXT("Could not write the benchmark results to %s"), *path);
+		return false;
+	}
+	UE_LOG(LogSCBenchmark, Log, TEXT("Benchmark results written to %s"), *path);
+	return true;
+}
+
+bool USCBenchmark::passed(TSharedPtr<FJsonObject> results)
+{
+	if (!results.IsValid() || results->HasField("error"))
+	{
+		return false;
+	}
+	for (auto& scenario : results->GetObjectField("scenarios")->Values)
+	{
+		if (scenario.Value->AsObject()->HasField("error"))
+		{
+			return false;
+		}
+	}
+	const TSharedPtr<FJsonObject>* budget;
+	return !results->TryGetObjectField("budget", budget) || (*budget)->GetBoolField("passed");
+}
+
+UWorld* USCBenchmark::GetWorld() const
+{
+	return World;
+}
+
+bool USCBenchmark::IsTickable() const
+{
+	return running;
+}
+
+TStatId USCBenchmark::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USCBenchmark, STATGROUP_Tickables);
+}
+
+void USCBenchmark::Tick(float DeltaTime)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	if (scenario.IsEmpty())
+	{
+		_startScenario();
+		return;
+	}
+
+	scenarioFrames++;
+
+	if (!failure.IsEmpty())
+	{
+		_finishScenario(failure);
+		return;
+	}
+
+	if (FPlatformTime::Seconds() - scenarioStart > options.scenarioTimeout)
+	{
+		_finishScenario("Timed out");
+		return;
+	}
+
+	// Every scenario starts once its client socket is connected
+	if (step < 0)
+	{
+		if (client->getState() != ESocketClusterState::OPEN)
+		{
+			return;
+		}
+		step = 0;
+		stepStart = FPlatformTime::Seconds();
+	}
+
+	if (scenario.Equals("rpc"))
+	{
+		_tickRpc();
+	}
+	else if (scenario.Equals("publish"))
+	{
+		_tickPublish();
+	}
+	else if (scenario.Equals("fanin"))
+	{
+		_tickFanIn();
+	}
+	else if (scenario.Equals("resubscribe"))
+	{
+		_tickResubscribe();
+	}
+}
+
+void USCBenchmark::_startScenario()
+{
+	if (pending.Num() == 0)
+	{
+		_complete();
+		return;
+	}
+
+	scenario = pending[0];
+	pending.RemoveAt(0);
+	scenarioResult = MakeShareable(new FJsonObject);
+	scenarioStart = FPlatformTime::Seconds();
+	scenarioFrames = 0;
+	failure.Empty();
+	sent = 0;
+	received = 0;
+	payloadIndex = 0;
+	latency.reset();
+	if (options.accountMessages)
+	{
+		FSCMessageAccounting::reset();
+	}
+
+	UE_LOG(LogSCBenchmark, Log, TEXT("Running scenario %s"), *scenario);
+
+	if (scenario.Equals("decode"))
+	{
+		_runDecode();
+		_finishScenario();
+		return;
+	}
+
+	step = -1;
+	_createClient();
+}
+
+void USCBenchmark::_finishScenario(const FString& error)
+{
+	_destroyClient();
+
+	const double seconds = FPlatformTime::Seconds() - scenarioStart;
+	if (!error.IsEmpty())
+	{
+		scenarioResult->SetStringField("error", error);
+		UE_LOG(LogSCBenchmark, Warning, TEXT("Scenario %s failed: %s"), *scenario, *error);
+	}
+	scenarioResult->SetNumberField("seconds", seconds);
+	scenarioResult->SetNumberField("frames", scenarioFrames);
+	scenarioResult->SetNumberField("fps", seconds > 0.0 ? scenarioFrames / seconds : 0.0);
+	if (options.accountMessages && FSCMessageAccounting::isRunning() && !scenario.Equals("decode"))
+	{
+		scenarioResult->SetObjectField("messages", FSCMessageAccounting::toJson());
+	}
+	results->GetObjectField("scenarios")->SetObjectField(scenario, scenarioResult);
+
+	scenario.Empty();
+	failure.Empty();
+}
+
+void USCBenchmark::_complete()
+{
+	running = false;
+	_destroyClient();
+	if (server.IsValid())
+	{
+		server->close();
+		server.Reset();
+	}
+	if (accounting)
+	{
+		FSCMessageAccounting::stop();
+		accounting = false;
+	}
+	if (options.accountMessages)
+	{
+		_checkBudget();
+	}
+	RemoveFromRoot();
+
+	if (oncomplete)
+	{
+		oncomplete(results);
+	}
+}
+
+void USCBenchmark::_checkBudget()
+{
+	const FString path = options.budgetFile.IsEmpty() ? SCDefaultBudgetPath() : options.budgetFile;
+	TSharedPtr<FJsonObject> budgetResult = MakeShareable(new FJsonObject);
+	budgetResult->SetStringField("file", path);
+	results->SetObjectField("budget", budgetResult);
+
+	TSharedPtr<FJsonObject> scenarios = results->GetObjectField("scenarios");
+	if (options.writeBudget)
+	{
+		TSharedPtr<FJsonObject> budgetScenarios = MakeShareable(new FJsonObject);
+		for (auto& scenario : scenarios->Values)
+		{
+			const TSharedPtr<FJsonObject>* messages;
+			if (!scenario.Value->AsObject()->TryGetObjectField("messages", messages))
+			{
+				continue;
+			}
+			TSharedPtr<FJsonObject> budgetDirections = MakeShareable(new FJsonObject);
+			for (auto& direction : (*messages)->Values)
+			{
+				TSharedPtr<FJsonObject> budgetTypes = MakeShareable(new FJsonObject);
+				for (auto& type : direction.Value->AsObject()->Values)
+				{
+					TSharedPtr<FJsonObject> limits = MakeShareable(new FJsonObject);
+					for (const TCHAR* metric : SCBudgetMetrics)
+					{
+						// Rounded up to a tenth so the file diffs cleanly when it is recorded again
+						limits->SetNumberField(metric, FMath::CeilToDouble(type.Value->AsObject()->GetNumberField(metric) * (1.0 + options.budgetHeadroom) * 10.0) / 10.0);
+					}
+					budgetTypes->SetObjectField(type.Key, limits);
+				}
+				budgetDirections->SetObjectField(direction.Key, budgetTypes);
+			}
+			budgetScenarios->SetObjectField(scenario.Key, budgetDirections);
+		}
+
+		TSharedPtr<FJsonObject> budget = MakeShareable(new FJsonObject);
+		budget->SetStringField("plugin", USCClient::Version());
+		budget->SetStringField("platform", ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+		budget->SetNumberField("headroom", options.budgetHeadroom);
+		budget->SetObjectField("scenarios", budgetScenarios);
+
+		const bool written = FFileHelper::SaveStringToFile(USCJsonConvert::ToJsonString(budget), *path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+		if (written)
+		{
+			UE_LOG(LogSCBenchmark, Log, TEXT("Message budget written to %s"), *path);
+		}
+		else
+		{
+			UE_LOG(LogSCBenchmark, Error, TEXT("Could not write the message budget to %s"), *path);
+		}
+		budgetResult->SetBoolField("written", written);
+		budgetResult->SetBoolField("passed", written);
+		return;
+	}
+
+	FString text;
+	TSharedPtr<FJsonValue> budgetValue;
+	if (FFileHelper::LoadFileToString(text, *path))
+	{
+		budgetValue = USCJsonConvert::JsonStringToJsonValue(text);
+	}
+	if (!budgetValue.IsValid() || budgetValue->Type != EJson::Object)
+	{
+		if (options.requireBudget)
+		{
+			UE_LOG(LogSCBenchmark, Error, TEXT("There is no message budget at %s, run with -writebudget to record one"), *path);
+		}
+		else
+		{
+			UE_LOG(LogSCBenchmark, Warning, TEXT("There is no message budget at %s, run with -writebudget to record one"), *path);
+		}
+		budgetResult->SetBoolField("missing", true);
+		budgetResult->SetBoolField("passed", !options.requireBudget);
+		return;
+	}
+
+	// Only what ran and has a budget is checked, new message types are reported without failing the run
+	TArray<TSharedPtr<FJsonValue>> failures;
+	TArray<TSharedPtr<FJsonValue>> unbudgeted;
+	const TSharedPtr<FJsonObject>* budgetScenarios;
+	if (!budgetValue->AsObject()->TryGetObjectField("scenarios", budgetScenarios))
+	{
+		budgetScenarios = nullptr;
+	}
+	for (auto& scenario : scenarios->Values)
+	{
+		const TSharedPtr<FJsonObject>* messages;
+		if (!scenario.Value->AsObject()->TryGetObjectField("messages", messages))
+		{
+			continue;
+		}
+		const TSharedPtr<FJsonObject>* budgetDirections = nullptr;
+		const bool budgeted = budgetScenarios != nullptr && (*budgetScenarios)->TryGetObjectField(scenario.Key, budgetDirections);
+		for (auto& direction : (*messages)->Values)
+		{
+			const TSharedPtr<FJsonObject>* budgetTypes = nullptr;
+			const bool directionBudgeted = budgeted && (*budgetDirections)->TryGetObjectField(direction.Key, budgetTypes);
+			for (auto& type : direction.Value->AsObject()->Values)
+			{
+				const TSharedPtr<FJsonObject>* limits = nullptr;
+				if (!directionBudgeted || !(*budgetTypes)->TryGetObjectField(type.Key, limits))
+				{
+					unbudgeted.Add(USCJsonConvert::ToJsonValue(scenario.Key + " " + direction.Key + " " + type.Key));
+					continue;
+				}
+				for (const TCHAR* metric : SCBudgetMetrics)
+				{
+					double limit;
+					const double value = type.Value->AsObject()->GetNumberField(metric);
+					if ((*limits)->TryGetNumberField(metric, limit) && value > limit)
+					{
+						const FString failure = FString::Printf(TEXT("%s %s %s: %s is %.2f, the budget is %.2f"), *scenario.Key, *direction.Key, *type.Key, metric, value, limit);
+						UE_LOG(LogSCBenchmark, Error, TEXT("Over the message budget, %s"), *failure);
+						failures.Add(USCJsonConvert::ToJsonValue(failure));
+					}
+				}
+			}
+		}
+	}
+
+	budgetResult->SetArrayField("failures", failures);
+	budgetResult->SetArrayField("unbudgeted", unbudgeted);
+	budgetResult->SetBoolField("passed", failures.Num() == 0);
+	UE_LOG(LogSCBenchmark, Log, TEXT("Message budget %s, %d failures and %d message types without a budget"), failures.Num() == 0 ? TEXT("passed") : TEXT("failed"), failures.Num(), unbudgeted.Num());
+}
+
+void USCBenchmark::_createClient()
+{
+	client = USCClient::Create(World, nullptr, nullptr, nullptr, "127.0.0.1", false, options.port, "/socketcluster/", 2,
+		30.0f, true, false, 10.0f, 10.0f, 1.5f, 60.0f, 0.0f, 0.0f, false, false, "t", "socketCluster.benchmark", false);
+}
+
+void USCBenchmark::_destroyClient()
+{
+	if (client != nullptr)
+	{
+		USCClient::Destroy(client);
+		client = nullptr;
+	}
+}
+
+void USCBenchmark::_tickRpc()
+{
+	if (step == 0)
+	{
+		payload = _makePayload(64);
+		step = 1;
+		_sendRpc();
+	}
+	else if (received >= options.rpcCount)
+	{
+		const double seconds = FPlatformTime::Seconds() - stepStart;
+		scenarioResult->SetNumberField("count", received);
+		scenarioResult->SetNumberField("roundTripsPerSecond", seconds > 0.0 ? received / seconds : 0.0);
+		scenarioResult->SetObjectField("latencyMicroseconds", latency.toJson(false));
+		_finishScenario();
+	}
+}
+
+void USCBenchmark::_sendRpc()
+{
+	const double emittedAt = FPlatformTime::Seconds();
+	sent++;
+	client->emit("bench.echo", USCJsonConvert::ToJsonValue(payload), [&, emittedAt](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+	{
+		if (error.IsValid())
+		{
+			failure = "rpc emit failed: " + USCJsonConvert::ToJsonString(error);
+			return;
+		}
+		latency.record((uint64)((FPlatformTime::Seconds() - emittedAt) * 1000000.0));
+		received++;
+		if (received < options.rpcCount)
+		{
+			_sendRpc();
+		}
+	});
+}
+
+void USCBenchmark::_tickPublish()
+{
+	static const FString channelName = "bench.publish";
+
+	if (step == 0)
+	{
+		client->subscribe(channelName);
+		client->watch(channelName, [&](TSharedPtr<FJsonValue> data)
+		{
+			received++;
+		});
+		scenarioResult->SetArrayField("sizes", TArray<TSharedPtr<FJsonValue>>());
+		step = 1;
+	}
+	else if (step == 1)
+	{
+		if (!client->isSubscribed(channelName))
+		{
+			return;
+		}
+
+		// Everything is published at once, the socket writes it as fast as it is serviced
+		payload = _makePayload(options.payloadSizes[payloadIndex]);
+		TSharedPtr<FJsonValue> data = USCJsonConvert::ToJsonValue(payload);
+		sent = 0;
+		received = 0;
+		stepStart = FPlatformTime::Seconds();
+		for (; sent < options.publishCount; sent++)
+		{
+			client->publish(channelName, data);
+		}
+		step = 2;
+	}
+	else if (received >= options.publishCount)
+	{
+		const double seconds = FPlatformTime::Seconds() - stepStart;
+		TSharedPtr<FJsonObject> size = MakeShareable(new FJsonObject);
+		size->SetNumberField("payloadBytes", options.payloadSizes[payloadIndex]);
+		size->SetNumberField("messages", received);
+		size->SetNumberField("seconds", seconds);
+		size->SetNumberField("messagesPerSecond", seconds > 0.0 ? received / seconds : 0.0);
+		size->SetNumberField("bytesPerSecond", seconds > 0.0 ? (double)received * options.payloadSizes[payloadIndex] / seconds : 0.0);
+
+		TArray<TSharedPtr<FJsonValue>> sizes = scenarioResult->GetArrayField("sizes");
+		sizes.Add(USCJsonConvert::ToJsonValue(size));
+		scenarioResult->SetArrayField("sizes", sizes);
+
+		payloadIndex++;
+		if (payloadIndex < options.payloadSizes.Num())
+		{
+			step = 1;
+		}
+		else
+		{
+			_finishScenario();
+		}
+	}
+}
+
+void USCBenchmark::_tickFanIn()
+{
+	if (step == 0)
+	{
+		for (int32 i = 0; i < options.fanInChannels; i++)
+		{
+			const FString channelName = FString::Printf(TEXT("bench.fanin.%d"), i);
+			client->subscribe(channelName);
+			client->watch(channelName, [&](TSharedPtr<FJsonValue> data)
+			{
+				received++;
+			});
+		}
+		step = 1;
+	}
+	else if (step == 1)
+	{
+		if (client->subscriptions(false).Num() < options.fanInChannels)
+		{
+			return;
+		}
+		scenarioResult->SetNumberField("subscribeSeconds", FPlatformTime::Seconds() - stepStart);
+
+		TSharedPtr<FJsonValue> data = USCJsonConvert::ToJsonValue(_makePayload(256));
+		stepStart = FPlatformTime::Seconds();
+		for (int32 message = 0; message < options.fanInMessages; message++)
+		{
+			for (int32 i = 0; i < options.fanInChannels; i++)
+			{
+				server->publish(FString::Printf(TEXT("bench.fanin.%d"), i), data);
+			}
+		}
+		step = 2;
+	}
+	else if (received >= options.fanInChannels * options.fanInMessages)
+	{
+		const double seconds = FPlatformTime::Seconds() - stepStart;
+		scenarioResult->SetNumberField("channels", options.fanInChannels);
+		scenarioResult->SetNumberField("messages", received);
+		scenarioResult->SetNumberField("messagesPerSecond", seconds > 0.0 ? received / seconds : 0.0);
+		_finishScenario();
+	}
+}
+
+void USCBenchmark::_tickResubscribe()
+{
+	if (step == 0)
+	{
+		client->on("subscribe", [&](TSharedPtr<FJsonValue> data, USCResponse* response)
+		{
+			received++;
+		});
+
+		TSharedPtr<FJsonObject> opts = MakeShareable(new FJsonObject);
+		opts->SetBoolField("batch", true);
+		for (int32 i = 0; i < options.resubscribeChannels; i++)
+		{
+			client->subscribe(FString::Printf(TEXT("bench.resubscribe.%d"), i), opts);
+		}
+		step = 1;
+	}
+	else if (step == 1)
+	{
+		if (received < options.resubscribeChannels)
+		{
+			return;
+		}
+		scenarioResult->SetNumberField("subscribeSeconds", FPlatformTime::Seconds() - stepStart);
+		client->disconnect();
+		step = 2;
+	}
+	else if (step == 2)
+	{
+		if (client->getState() != ESocketClusterState::CLOSED)
+		{
+			return;
+		}
+		received = 0;
+		stepStart = FPlatformTime::Seconds();
+		client->connect();
+		step = 3;
+	}
+	else if (received >= options.resubscribeChannels)
+	{
+		const double seconds = FPlatformTime::Seconds() - stepStart;
+		scenarioResult->SetNumberField("channels", options.resubscribeChannels);
+		scenarioResult->SetNumberField("resubscribeSeconds", seconds);
+		scenarioResult->SetNumberField("channelsPerSecond", seconds > 0.0 ? options.resubscribeChannels / seconds : 0.0);
+		_finishScenario();
+	}
+}
+
+void USCBenchmark::_runDecode()
+{
+	FString directory = options.snapshotDirectory.IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("SCBenchmarks") / TEXT("Snapshots") : options.snapshotDirectory;
+
+	TArray<FString> files;
+	IFileManager::Get().FindFiles(files, *(directory / TEXT("*.json")), true, false);
+	files.Sort();
+
+	TArray<TPair<FString, TArray<uint8>>> snapshots;
+	for (const FString& file : files)
+	{
+		TArray<uint8> bytes;
+		if (FFileHelper::LoadFileToArray(bytes, *(directory / file)))
+		{
+			snapshots.Emplace(file, MoveTemp(bytes));
+		}
+	}
+
+	if (snapshots.Num() == 0)
+	{
+		// A world snapshot shaped payload, so the scenario still runs without recordings
+		TArray<TSharedPtr<FJsonValue>> entities;
+		for (int32 i = 0; i < 500; i++)
+		{
+			TSharedPtr<FJsonObject> entity = MakeShareable(new FJsonObject);
+			entity->SetNumberField("id", i);
+			entity->SetStringField("name", FString::Printf(TEXT("entity_%d"), i));
+			entity->SetArrayField("position", { USCJsonConvert::ToJsonValue(i * 1.25), USCJsonConvert::ToJsonValue(i * -0.5), USCJsonConvert::ToJsonValue(100.0 + i) });
+			entity->SetNumberField("health", 100 - i % 100);
+			entity->SetBoolField("active", i % 3 != 0);
+			entities.Add(USCJsonConvert::ToJsonValue(entity));
+		}
+		TSharedPtr<FJsonObject> snapshot = MakeShareable(new FJsonObject);
+		snapshot->SetNumberField("tick", 1024);
+		snapshot->SetArrayField("entities", entities);
+
+		FTCHARToUTF8 converted(*USCJsonConvert::ToJsonString(snapshot));
+		TArray<uint8> bytes((const uint8*)converted.Get(), converted.Length());
+		snapshots.Emplace("synthetic", MoveTemp(bytes));
+		scenarioResult->SetBoolField("synthetic", true);
+	}
+
+	USC_Formatter* formatter = NewObject<USC_Formatter>();
+	FSCJsonDocument document;
+	TArray<TSharedPtr<FJsonValue>> entries;
+	for (const TPair<FString, TArray<uint8>>& snapshot : snapshots)
+	{
+		const TArrayView<const uint8> bytes(snapshot.Value);
+		FSCHistogram valueTime;
+		FSCHistogram documentTime;
+		for (int32 i = 0; i < options.decodeIterations; i++)
+		{
+			uint64 start = FPlatformTime::Cycles64();
+			formatter->decode(bytes, ESCCodecFrame::TEXT);
+			valueTime.record((uint64)(FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - start) * 1000000000.0));
+
+			start = FPlatformTime::Cycles64();
+			formatter->decode(bytes, ESCCodecFrame::TEXT, document);
+			documentTime.record((uint64)(FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - start) * 1000000000.0));
+		}
+
+		TSharedPtr<FJsonObject> entry = MakeShareable(new FJsonObject);
+		entry->SetStringField("name", snapshot.Key);
+		entry->SetNumberField("bytes", bytes.Num());
+		entry->SetObjectField("valueNanoseconds", valueTime.toJson(false));
+		entry->SetObjectField("documentNanoseconds", documentTime.toJson(false));
+		entry->SetNumberField("valueBytesPerSecond", valueTime.getMean() > 0.0 ? bytes.Num() / (valueTime.getMean() / 1000000000.0) : 0.0);
+		entry->SetNumberField("documentBytesPerSecond", documentTime.getMean() > 0.0 ? bytes.Num() / (documentTime.getMean() / 1000000000.0) : 0.0);
+		entries.Add(USCJsonConvert::ToJsonValue(entry));
+	}
+	scenarioResult->SetArrayField("snapshots", entries);
+}
+
+FString USCBenchmark::_makePayload(int32 size)
+{
+	// A JSON text of about size bytes, published as a string the client parses on arrival
+	static const int32 overhead = 10;
+	return "{\"pad\":\"" + FString::ChrN(FMath::Max(0, size - overhead), 'x') + "\"}";
+}
+
+static void RunBenchmarkCommand(const TArray<FString>& Args, UWorld* World)
+{
+	FSCBenchmarkOptions options;
+	FString out;
+	for (const FString& arg : Args)
+	{
+		if (arg.StartsWith("-port="))
+		{
+			options.port = FCString::Atoi(*arg.Mid(6));
+		}
+		else if (arg.StartsWith("-out="))
+		{
+			out = arg.Mid(5);
+		}
+		else if (arg.StartsWith("-snapshots="))
+		{
+			options.snapshotDirectory = arg.Mid(11);
+		}
+		else if (arg.StartsWith("-budget="))
+		{
+			options.budgetFile = arg.Mid(8);
+		}
+		else if (arg.StartsWith("-headroom="))
+		{
+			options.budgetHeadroom = FCString::Atof(*arg.Mid(10));
+		}
+		else if (arg.Equals("-writebudget"))
+		{
+			options.writeBudget = true;
+		}
+		else if (arg.Equals("-noaccounting"))
+		{
+			options.accountMessages = false;
+		}
+		else if (USCBenchmark::getScenarioNames().Contains(arg))
+		{
+			options.scenarios.Add(arg);
+		}
+		else
+		{
+			UE_LOG(LogSCBenchmark, Warning, TEXT("Unknown benchmark argument %s"), *arg);
+		}
+	}
+
+	USCBenchmark::run(World, options, [out](TSharedPtr<FJsonObject> results)
+	{
+		USCBenchmark::writeResults(results, out);
+		if (!USCBenchmark::passed(results))
+		{
+			UE_LOG(LogSCBenchmark, Error, TEXT("The benchmark failed, see the results for the scenario errors and message budget failures"));
+		}
+	});
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SCBenchmarkCommand(
+	TEXT("SocketCluster.Benchmark"),
+	TEXT("Runs the SocketCluster loopback benchmarks and writes the results to Saved/SCBenchmarks. Arguments: [rpc|publish|fanin|resubscribe|decode ...] [-port=8181] [-snapshots=dir] [-budget=file] [-writebudget] [-headroom=0.1] [-noaccounting] [-out=file]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunBenchmarkCommand)
+);
+
+USCBenchmarkCommandlet::USCBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	HelpDescription = TEXT("Runs the SocketCluster loopback benchmarks, fails when a scenario fails or a message type is over its allocation budget or there is no budget file");
+	HelpUsage = TEXT("-run=SCBenchmark [-scenarios=rpc,publish,fanin,resubscribe,decode] [-port=8181] [-snapshots=dir] [-budget=file] [-writebudget] [-headroom=0.1] [-noaccounting] [-out=file]");
+}
+
+int32 USCBenchmarkCommandlet::Main(const FString& Params)
+{
+	FSCBenchmarkOptions options;
+	FParse::Value(*Params, TEXT("port="), options.port);
+	FParse::Value(*Params, TEXT("snapshots="), options.snapshotDirectory);
+	FParse::Value(*Params, TEXT("budget="), options.budgetFile);
+	FParse::Value(*Params, TEXT("headroom="), options.budgetHeadroom);
+	options.writeBudget = FParse::Param(*Params, TEXT("writebudget"));
+	options.accountMessages = !FParse::Param(*Params, TEXT("noaccounting"));
+	options.requireBudget = true;
+
+	FString scenarios;
+	if (FParse::Value(*Params, TEXT("scenarios="), scenarios, false))
+	{
+		scenarios.ParseIntoArray(options.scenarios, TEXT(","));
+	}
+
+	FString out;
+	FParse::Value(*Params, TEXT("out="), out);
+
+	// Commandlets do not tick a world, the client socket and the server are ticked here as fast as possible
+	UWorld* world = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SCBenchmark"));
+	FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	worldContext.SetCurrentWorld(world);
+
+	TSharedPtr<FJsonObject> results;
+	USCBenchmark* benchmark = USCBenchmark::run(world, options, [&results](TSharedPtr<FJsonObject> InResults)
+	{
+		results = InResults;
+	});
+
+	double last = FPlatformTime::Seconds();
+	while (benchmark->isRunning() && !IsEngineExitRequested())
+	{
+		const double now = FPlatformTime::Seconds();
+		const float deltaTime = (float)(now - last);
+		last = now;
+
+		GFrameCounter++;
+		world->GetTimerManager().Tick(deltaTime);
+		FTickableGameObject::TickObjects(nullptr, LEVELTICK_All, false, deltaTime);
+	}
+
+	GEngine->DestroyWorldContext(world);
+	world->DestroyWorld(false);
+
+	if (!results.IsValid() || !USCBenchmark::writeResults(results, out))
+	{
+		return 1;
+	}
+	if (!USCBenchmark::passed(results))
+	{
+		UE_LOG(LogSCBenchmark, Error, TEXT("The benchmark failed, see the results for the scenario errors and message budget failures"));
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,22 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCBenchmarkModule.h"
+
+#define LOCTEXT_NAMESPACE "FSCBenchmarkModule"
+
+DEFINE_LOG_CATEGORY(LogSCBenchmark);
+
+void FSCBenchmarkModule::StartupModule()
+{
+	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+}
+
+void FSCBenchmarkModule::ShutdownModule()
+{
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FSCBenchmarkModule, SCBenchmark)
\ No newline at end of file
@@ -0,0 +1,549 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCLoadGenerator.h"
+#include "Runtime/Engine/Classes/Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Misc/EngineVersion.h"
+#include "SCBenchmark.h"
+#include "SCBenchmarkModule.h"
+#include "SCClient.h"
+#include "SCJsonConvert.h"
+#include "SCSocketContext.h"
+
+#if PLATFORM_LINUX
+#include <sys/resource.h>
+#endif
+
+/** Every client holds a socket, raise the open file limit of the process to fit them. Only Linux has a soft limit far below what a load test needs */
+static void SCRaiseFileLimit(int32 clients)
+{
+#if PLATFORM_LINUX
+	// The server connection of every client plus room for the files the engine keeps open
+	const rlim_t needed = (rlim_t)clients + 256;
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur >= needed)
+	{
+		return;
+	}
+
+	limit.rlim_cur = limit.rlim_max == RLIM_INFINITY ? needed : FMath::Min(needed, limit.rlim_max);
+	if (setrlimit(RLIMIT_NOFILE, &limit) != 0)
+	{
+		getrlimit(RLIMIT_NOFILE, &limit);
+	}
+	if (limit.rlim_cur < needed)
+	{
+		UE_LOG(LogSCBenchmark, Warning, TEXT("The open file limit is %llu, %d clients need %llu, raise it with ulimit -n"), (uint64)limit.rlim_cur, clients, (uint64)needed);
+	}
+#endif
+}
+
+USCLoadGenerator::USCLoadGenerator()
+{
+	World = nullptr;
+	running = false;
+	stopping = false;
+	startTime = 0.0;
+	rampedAt = 0.0;
+	stopTime = 0.0;
+	lastReport = 0.0;
+	lastReportDeliveries = 0;
+	connected = 0;
+	connectFailures = 0;
+	disconnects = 0;
+	authFailures = 0;
+	publishSent = 0;
+	publishAcked = 0;
+	publishErrors = 0;
+	deliveries = 0;
+	rpcSent = 0;
+	rpcAcked = 0;
+	rpcErrors = 0;
+}
+
+USCLoadGenerator* USCLoadGenerator::run(const UObject* WorldContextObject, const FSCLoadGeneratorOptions& options, TFunction<void(TSharedPtr<FJsonObject> results)> oncomplete)
+{
+	USCLoadGenerator* generator = NewObject<USCLoadGenerator>();
+	generator->AddToRoot();
+	generator->World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	generator->options = options;
+	generator->options.channelsPerClient = FMath::Clamp(options.channelsPerClient, 0, FMath::Max(1, options.channelCount));
+	generator->oncomplete = oncomplete;
+
+	// Room for the publish time in front of the padding
+	generator->payload = "|" + FString::ChrN(FMath::Max(0, options.payloadSize - 18), 'x');
+
+	generator->startTime = FPlatformTime::Seconds();
+	generator->lastReport = generator->startTime;
+	generator->running = true;
+
+	if (generator->World == nullptr)
+	{
+		UE_LOG(LogSCBenchmark, Error, TEXT("Unable to access current game world."));
+		generator->_complete();
+		return generator;
+	}
+
+	SCRaiseFileLimit(options.clients);
+	UE_LOG(LogSCBenchmark, Log, TEXT("Starting %d clients against %s:%d"), options.clients, *options.hostname, options.port);
+	return generator;
+}
+
+void USCLoadGenerator::stop()
+{
+	if (running && !stopping)
+	{
+		stopping = true;
+		stopTime = FPlatformTime::Seconds();
+		for (USCClientSocket* client : clients)
+		{
+			client->disconnect();
+		}
+	}
+}
+
+UWorld* USCLoadGenerator::GetWorld() const
+{
+	return World;
+}
+
+bool USCLoadGenerator::IsTickable() const
+{
+	return running;
+}
+
+TStatId USCLoadGenerator::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USCLoadGenerator, STATGROUP_Tickables);
+}
+
+void USCLoadGenerator::Tick(float DeltaTime)
+{
+	if (!running)
+	{
+		return;
+	}
+
+	const double now = FPlatformTime::Seconds();
+
+	if (stopping)
+	{
+		// The disconnect frames are written on the following ticks
+		bool open = false;
+		for (USCClientSocket* client : clients)
+		{
+			if (client->getState() != ESocketClusterState::CLOSED)
+			{
+				open = true;
+				break;
+			}
+		}
+		if (!open || now - stopTime > 5.0)
+		{
+			_complete();
+		}
+		return;
+	}
+
+	const int32 due = options.connectRate > 0.0f ? FMath::Min(options.clients, (int32)((now - startTime) * options.connectRate) + 1) : options.clients;
+	while (clients.Num() < due)
+	{
+		_startClient();
+	}
+	if (rampedAt == 0.0 && clients.Num() >= options.clients)
+	{
+		rampedAt = now;
+	}
+
+	for (int32 index = 0; index < clients.Num(); index++)
+	{
+		if (clients[index]->getState() != ESocketClusterState::OPEN || !scripts[index].subscribed)
+		{
+			continue;
+		}
+		_publish(index, now);
+		_emit(index, now);
+	}
+
+	if (options.reportInterval > 0.0f && now - lastReport >= options.reportInterval)
+	{
+		_report(now);
+	}
+
+	if (rampedAt > 0.0 && now - rampedAt >= options.duration)
+	{
+		stop();
+	}
+}
+
+void USCLoadGenerator::_startClient()
+{
+	const int32 index = clients.Num();
+	FSCLoadClient& script = scripts.AddDefaulted_GetRef();
+	script.connectingAt = FPlatformTime::Seconds();
+
+	// Every client keeps its own token, the auth engine stores tokens by name
+	USCClientSocket* client = USCClient::Create(World, nullptr, nullptr, nullptr, options.hostname, options.secure, options.port, options.path, options.protocolVersion,
+		10.0f, false, true, 10.0f, 10.0f, 1.5f, 60.0f, 0.0f, 0.0f, false, false, "t", FString::Printf(TEXT("socketCluster.load.%d"), index), false, true, true, "",
+		ESocketClusterReconnectStrategy::FULL_JITTER, 0, 10.0f, 0.0f, false, "", 5.0f, options.sharedContext);
+	clients.Add(client);
+
+	client->on("connect", [this, index](TSharedPtr<FJsonValue> status, USCResponse* res)
+	{
+		_onConnect(index);
+	});
+	client->on("connectAbort", [this, index](TSharedPtr<FJsonValue> data, USCResponse* res)
+	{
+		connectFailures++;
+		scripts[index].connectingAt = FPlatformTime::Seconds();
+	});
+	client->on("disconnect", [this, index](TSharedPtr<FJsonValue> data, USCResponse* res)
+	{
+		connected--;
+		if (!stopping)
+		{
+			disconnects++;
+		}
+		scripts[index].connectingAt = FPlatformTime::Seconds();
+	});
+
+	client->connect();
+}
+
+void USCLoadGenerator::_onConnect(int32 index)
+{
+	connected++;
+	connectLatency.record((uint64)((FPlatformTime::Seconds() - scripts[index].connectingAt) * 1000000.0));
+
+	if (options.authToken.IsEmpty())
+	{
+		_subscribe(index);
+		return;
+	}
+
+	clients[index]->authenticate(options.authToken, [this, index](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> status)
+	{
+		if (error.IsValid() && error->Type != EJson::Null)
+		{
+			authFailures++;
+			return;
+		}
+		_subscribe(index);
+	});
+}
+
+void USCLoadGenerator::_subscribe(int32 index)
+{
+	FSCLoadClient& script = scripts[index];
+	if (!script.subscribed)
+	{
+		USCClientSocket* client = clients[index];
+		for (int32 j = 0; j < options.channelsPerClient; j++)
+		{
+			const FString channelName = options.channelPrefix + FString::FromInt((index * options.channelsPerClient + j) % FMath::Max(1, options.channelCount));
+			client->subscribe(channelName);
+			client->watch(channelName, [this](TSharedPtr<FJsonValue> data)
+			{
+				deliveries++;
+				if (data.IsValid() && data->Type == EJson::String)
+				{
+					const double publishedAt = FCString::Atod(*data->AsString());
+					if (publishedAt > 0.0)
+					{
+						deliveryLatency.record((uint64)(FMath::Max(0.0, FPlatformTime::Seconds() - publishedAt) * 1000000.0));
+					}
+				}
+			});
+		}
+		script.subscribed = true;
+	}
+
+	// The clients start their schedules at random phases, so they do not publish in lock-step
+	const double now = FPlatformTime::Seconds();
+	script.nextPublish = options.publishRate > 0.0f ? now + FMath::FRand() / options.publishRate : 0.0;
+	script.nextRpc = options.rpcRate > 0.0f ? now + FMath::FRand() / options.rpcRate : 0.0;
+}
+
+void USCLoadGenerator::_publish(int32 index, double now)
+{
+	FSCLoadClient& script = scripts[index];
+	if (options.publishRate <= 0.0f || options.channelsPerClient <= 0 || now < script.nextPublish)
+	{
+		return;
+	}
+
+	// A client which fell behind skips the publishes it missed instead of sending them in a burst
+	script.nextPublish = FMath::Max(script.nextPublish + 1.0 / options.publishRate, now);
+
+	const int32 j = FMath::RandHelper(options.channelsPerClient);
+	const FString channelName = options.channelPrefix + FString::FromInt((index * options.channelsPerClient + j) % FMath::Max(1, options.channelCount));
+	TSharedPtr<FJsonValue> data = USCJsonConvert::ToJsonValue(FString::Printf(TEXT("%.6f"), now) + payload);
+
+	publishSent++;
+	clients[index]->publish(channelName, data, [this, now](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> response)
+	{
+		if (error.IsValid() && error->Type != EJson::Null)
+		{
+			publishErrors++;
+			return;
+		}
+		publishAcked++;
+		publishLatency.record((uint64)((FPlatformTime::Seconds() - now) * 1000000.0));
+	});
+}
+
+void USCLoadGenerator::_emit(int32 index, double now)
+{
+	FSCLoadClient& script = scripts[index];
+	if (options.rpcRate <= 0.0f || now < script.nextRpc)
+	{
+		return;
+	}
+
+	script.nextRpc = FMath::Max(script.nextRpc + 1.0 / options.rpcRate, now);
+
+	rpcSent++;
+	clients[index]->emit(options.rpcEvent, USCJsonConvert::ToJsonValue((double)index), [this, now](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> response)
+	{
+		if (error.IsValid() && error->Type != EJson::Null)
+		{
+			rpcErrors++;
+			return;
+		}
+		rpcAcked++;
+		rpcLatency.record((uint64)((FPlatformTime::Seconds() - now) * 1000000.0));
+	});
+}
+
+void USCLoadGenerator::_report(double now)
+{
+	const double seconds = now - lastReport;
+	UE_LOG(LogSCBenchmark, Log, TEXT("%d/%d clients connected, %d sockets on the shared context, %.0f deliveries/s, publish ack p99 %llu us, rpc p99 %llu us, %llu errors"),
+		connected, options.clients, FSCSocketContext::getSocketCount(), seconds > 0.0 ? (deliveries - lastReportDeliveries) / seconds : 0.0,
+		publishLatency.getPercentile(99.0), rpcLatency.getPercentile(99.0), publishErrors + rpcErrors + (uint64)authFailures);
+	lastReport = now;
+	lastReportDeliveries = deliveries;
+}
+
+void USCLoadGenerator::_complete()
+{
+	running = false;
+	TSharedPtr<FJsonObject> results = _results();
+
+	for (USCClientSocket* client : clients)
+	{
+		USCClient::Destroy(client);
+	}
+	clients.Empty();
+	RemoveFromRoot();
+
+	if (oncomplete)
+	{
+		oncomplete(results);
+	}
+}
+
+TSharedPtr<FJsonObject> USCLoadGenerator::_results() const
+{
+	const double end = stopTime > 0.0 ? stopTime : FPlatformTime::Seconds();
+	const double seconds = end - startTime;
+	auto perSecond = [seconds](uint64 count)
+	{
+		return seconds > 0.0 ? count / seconds : 0.0;
+	};
+
+	TSharedPtr<FJsonObject> results = MakeShareable(new FJsonObject);
+	results->SetStringField("plugin", USCClient::Version());
+	results->SetStringField("engine", FEngineVersion::Current().ToString());
+	results->SetStringField("platform", ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+	results->SetStringField("timestamp", FDateTime::UtcNow().ToIso8601());
+	results->SetNumberField("seconds", seconds);
+	if (World == nullptr)
+	{
+		results->SetStringField("error", "Unable to access current game world.");
+	}
+
+	TSharedPtr<FJsonObject> settings = MakeShareable(new FJsonObject);
+	settings->SetStringField("host", FString::Printf(TEXT("%s:%d%s"), *options.hostname, options.port, *options.path));
+	settings->SetNumberField("clients", options.clients);
+	settings->SetNumberField("connectRate", options.connectRate);
+	settings->SetBoolField("authenticate", !options.authToken.IsEmpty());
+	settings->SetNumberField("channelsPerClient", options.channelsPerClient);
+	settings->SetNumberField("channelCount", options.channelCount);
+	settings->SetNumberField("publishRate", options.publishRate);
+	settings->SetNumberField("payloadSize", options.payloadSize);
+	settings->SetNumberField("rpcRate", options.rpcRate);
+	settings->SetStringField("rpcEvent", options.rpcEvent);
+	settings->SetNumberField("duration", options.duration);
+	settings->SetBoolField("sharedContext", options.sharedContext);
+	results->SetObjectField("options", settings);
+
+	TSharedPtr<FJsonObject> connections = MakeShareable(new FJsonObject);
+	connections->SetNumberField("started", clients.Num());
+	connections->SetNumberField("connected", connected);
+	connections->SetNumberField("connectFailures", connectFailures);
+	connections->SetNumberField("disconnects", disconnects);
+	connections->SetNumberField("authFailures", authFailures);
+	connections->SetObjectField("connectMicroseconds", connectLatency.toJson(false));
+	results->SetObjectField("connections", connections);
+
+	TSharedPtr<FJsonObject> publish = MakeShareable(new FJsonObject);
+	publish->SetNumberField("sent", publishSent);
+	publish->SetNumberField("acknowledged", publishAcked);
+	publish->SetNumberField("errors", publishErrors);
+	publish->SetNumberField("perSecond", perSecond(publishAcked));
+	publish->SetObjectField("ackMicroseconds", publishLatency.toJson(false));
+	results->SetObjectField("publish", publish);
+
+	TSharedPtr<FJsonObject> delivery = MakeShareable(new FJsonObject);
+	delivery->SetNumberField("messages", deliveries);
+	delivery->SetNumberField("perSecond", perSecond(deliveries));
+	delivery->SetObjectField("latencyMicroseconds", deliveryLatency.toJson(false));
+	results->SetObjectField("deliveries", delivery);
+
+	TSharedPtr<FJsonObject> rpc = MakeShareable(new FJsonObject);
+	rpc->SetNumberField("sent", rpcSent);
+	rpc->SetNumberField("acknowledged", rpcAcked);
+	rpc->SetNumberField("errors", rpcErrors);
+	rpc->SetNumberField("perSecond", perSecond(rpcAcked));
+	rpc->SetObjectField("latencyMicroseconds", rpcLatency.toJson(false));
+	results->SetObjectField("rpc", rpc);
+
+	FSCSocketStats total;
+	for (USCClientSocket* client : clients)
+	{
+		const FSCSocketStats& traffic = client->getMetrics()->traffic.Get();
+		total.bytesSent += traffic.bytesSent;
+		total.bytesReceived += traffic.bytesReceived;
+		total.framesSent += traffic.framesSent;
+		total.framesReceived += traffic.framesReceived;
+	}
+	TSharedPtr<FJsonObject> traffic = MakeShareable(new FJsonObject);
+	traffic->SetNumberField("bytesSent", total.bytesSent);
+	traffic->SetNumberField("bytesReceived", total.bytesReceived);
+	traffic->SetNumberField("framesSent", total.framesSent);
+	traffic->SetNumberField("framesReceived", total.framesReceived);
+	traffic->SetNumberField("bytesSentPerSecond", perSecond(total.bytesSent));
+	traffic->SetNumberField("bytesReceivedPerSecond", perSecond(total.bytesReceived));
+	results->SetObjectField("traffic", traffic);
+
+	return results;
+}
+
+static FString SCDefaultLoadResultsPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SCBenchmarks") / FString::Printf(TEXT("SCLoadTest-%s.json"), *FDateTime::Now().ToString());
+}
+
+/** Read the load test settings from command line style arguments, shared by the commandlet and the console command */
+static void SCParseLoadOptions(const TCHAR* Params, FSCLoadGeneratorOptions& options)
+{
+	FParse::Value(Params, TEXT("host="), options.hostname);
+	FParse::Value(Params, TEXT("port="), options.port);
+	FParse::Value(Params, TEXT("path="), options.path);
+	FParse::Bool(Params, TEXT("secure="), options.secure);
+	FParse::Value(Params, TEXT("protocol="), options.protocolVersion);
+	FParse::Value(Params, TEXT("clients="), options.clients);
+	FParse::Value(Params, TEXT("connectrate="), options.connectRate);
+	FParse::Value(Params, TEXT("token="), options.authToken);
+	FParse::Value(Params, TEXT("channels="), options.channelsPerClient);
+	FParse::Value(Params, TEXT("channelcount="), options.channelCount);
+	FParse::Value(Params, TEXT("prefix="), options.channelPrefix);
+	FParse::Value(Params, TEXT("publishrate="), options.publishRate);
+	FParse::Value(Params, TEXT("payload="), options.payloadSize);
+	FParse::Value(Params, TEXT("rpcrate="), options.rpcRate);
+	FParse::Value(Params, TEXT("rpcevent="), options.rpcEvent);
+	FParse::Value(Params, TEXT("duration="), options.duration);
+	FParse::Value(Params, TEXT("progress="), options.reportInterval);
+	options.sharedContext = !FParse::Param(Params, TEXT("nosharedcontext"));
+}
+
+USCLoadTestCommandlet::USCLoadTestCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	HelpDescription = TEXT("Runs many SocketCluster client sockets against a server and reports throughput and latency percentiles");
+	HelpUsage = TEXT("-run=SCLoadTest -host=127.0.0.1 -port=8000 [-clients=1000] [-connectrate=200] [-channels=5] [-channelcount=100] [-publishrate=1] [-payload=128] [-rpcrate=1] [-rpcevent=load.rpc] [-token=jwt] [-duration=60] [-progress=5] [-tickrate=120] [-nosharedcontext] [-out=file]");
+}
+
+int32 USCLoadTestCommandlet::Main(const FString& Params)
+{
+	FSCLoadGeneratorOptions options;
+	SCParseLoadOptions(*Params, options);
+
+	FString out;
+	if (!FParse::Value(*Params, TEXT("out="), out))
+	{
+		out = SCDefaultLoadResultsPath();
+	}
+
+	float tickRate = 120.0f;
+	FParse::Value(*Params, TEXT("tickrate="), tickRate);
+
+	// Commandlets do not tick a world, the client sockets need one for their timers
+	UWorld* world = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SCLoadTest"));
+	FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	worldContext.SetCurrentWorld(world);
+
+	TSharedPtr<FJsonObject> results;
+	USCLoadGenerator* generator = USCLoadGenerator::run(world, options, [&results](TSharedPtr<FJsonObject> InResults)
+	{
+		results = InResults;
+	});
+
+	double last = FPlatformTime::Seconds();
+	while (generator->isRunning() && !IsEngineExitRequested())
+	{
+		const double now = FPlatformTime::Seconds();
+		const float deltaTime = (float)(now - last);
+		last = now;
+
+		GFrameCounter++;
+		world->GetTimerManager().Tick(deltaTime);
+		FTickableGameObject::TickObjects(nullptr, LEVELTICK_All, false, deltaTime);
+
+		const double idle = (tickRate > 0.0f ? 1.0 / tickRate : 0.0) - (FPlatformTime::Seconds() - now);
+		if (idle > 0.0)
+		{
+			FPlatformProcess::Sleep((float)idle);
+		}
+	}
+	if (generator->isRunning())
+	{
+		generator->stop();
+	}
+
+	GEngine->DestroyWorldContext(world);
+	world->DestroyWorld(false);
+
+	return results.IsValid() && USCBenchmark::writeResults(results, out) ? 0 : 1;
+}
+
+static void RunLoadTestCommand(const TArray<FString>& Args, UWorld* World)
+{
+	FSCLoadGeneratorOptions options;
+	SCParseLoadOptions(*FString::Join(Args, TEXT(" ")), options);
+
+	FString out = SCDefaultLoadResultsPath();
+	for (const FString& arg : Args)
+	{
+		if (arg.StartsWith("-out="))
+		{
+			out = arg.Mid(5);
+		}
+	}
+
+	USCLoadGenerator::run(World, options, [out](TSharedPtr<FJsonObject> results)
+	{
+		USCBenchmark::writeResults(results, out);
+	});
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SCLoadTestCommand(
+	TEXT("SocketCluster.LoadTest"),
+	TEXT("Runs many SocketCluster client sockets against a server and writes the results to Saved/SCBenchmarks. Arguments: -host=127.0.0.1 -port=8000 [-clients=1000] [-connectrate=200] [-channels=5] [-publishrate=1] [-rpcrate=1] [-token=jwt] [-duration=60] [-out=file]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunLoadTestCommand)
+);
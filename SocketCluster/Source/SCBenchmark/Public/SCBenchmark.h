@@ -0,0 +1,212 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Dom/JsonObject.h"
+#include "Commandlets/Commandlet.h"
+#include "SCHistogram.h"
+#include "SCServer.h"
+#include "SCClientSocket.h"
+#include "SCBenchmark.generated.h"
+
+/** The settings of a benchmark run */
+struct FSCBenchmarkOptions
+{
+	/** The loopback port the stand-in server listens on */
+	int32 port = 8181;
+
+	/** The scenarios to run, every scenario when empty */
+	TArray<FString> scenarios;
+
+	/** The number of sequential emits the rpc scenario waits for */
+	int32 rpcCount = 2000;
+
+	/** The payload sizes in bytes the publish scenario runs with */
+	TArray<int32> payloadSizes = { 64, 1024, 16384 };
+
+	/** The number of messages published per payload size */
+	int32 publishCount = 1000;
+
+	/** The number of channels the fanin scenario subscribes to */
+	int32 fanInChannels = 100;
+
+	/** The number of messages the server publishes to every fanin channel */
+	int32 fanInMessages = 50;
+
+	/** The number of channels the resubscribe scenario restores after reconnecting */
+	int32 resubscribeChannels = 10000;
+
+	/** The number of times every snapshot is decoded */
+	int32 decodeIterations = 200;
+
+	/** The directory the .json snapshot payloads of the decode scenario are read from, a synthetic payload is used when none is found */
+	FString snapshotDirectory;
+
+	/** The time in seconds a scenario may take before it is reported as timed out */
+	double scenarioTimeout = 120.0;
+
+	/** Whether the allocations and string transcodes of every message are accounted by type (FSCMessageAccounting) and checked against the budget */
+	bool accountMessages = true;
+
+	/** The message budget file, Config/SCMessageBudget.json of the plugin when empty */
+	FString budgetFile;
+
+	/** Whether a missing or unreadable budget file fails the run, the commandlet sets it so CI cannot pass without a budget */
+	bool requireBudget = false;
+
+	/** Whether the budget file is written from this run instead of checked, every cost gets budgetHeadroom on top */
+	bool writeBudget = false;
+
+	float budgetHeadroom = 0.1f;
+};
+
+/**
+* The SocketCluster Benchmark
+*
+* Runs throughput and latency scenarios end to end over loopback, through USCClientSocket, USCTransport, USCSocket and the codec, against FSCServer.
+* - rpc			Sequential emits echoed by the server, latency percentiles
+* - publish		Publishes to a channel the client watches, throughput per payload size
+* - fanin		The server publishes to many channels the client watches
+* - resubscribe	Restoring many subscriptions after a reconnect
+* - decode		Decoding recorded snapshot payloads with the codec
+*
+* The client socket is serviced once per engine tick, so run it with an uncapped frame rate (-nullrhi, t.MaxFPS 0) to compare results.
+* The results are a JSON object which is meant to be diffed between plugin versions.
+* Every scenario also reports the allocations and string transcodes per message type, the run fails when one of them is over the stored budget.
+*/
+UCLASS()
+class SCBENCHMARK_API USCBenchmark : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USCBenchmark();
+
+	/**
+	* Start a benchmark run, the benchmark keeps itself alive until it completes.
+	*
+	* @param WorldContextObject		The world the client sockets are created in.
+	* @param options				The settings of the run.
+	* @param oncomplete				Receives the results.
+	*/
+	static USCBenchmark* run(const UObject* WorldContextObject, const FSCBenchmarkOptions& options, TFunction<void(TSharedPtr<FJsonObject> results)> oncomplete = nullptr);
+
+	/** The names of every scenario, in the order they run */
+	static const TArray<FString>& getScenarioNames();
+
+	/** Write results to a file, the default file is Saved/SCBenchmarks/SCBenchmark-<time>.json */
+	static bool writeResults(TSharedPtr<FJsonObject> results, FString path = FString());
+
+	/** Returns whether every scenario of results ran and stayed within the message budget */
+	static bool passed(TSharedPtr<FJsonObject> results);
+
+	virtual class UWorld* GetWorld() const override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual bool IsTickableWhenPaused() const override { return true; }
+
+	virtual bool IsTickableInEditor() const override { return true; }
+
+	virtual TStatId GetStatId() const override;
+
+	bool isRunning() const { return running; }
+
+private:
+
+	UPROPERTY()
+	UWorld* World;
+
+	UPROPERTY()
+	USCClientSocket* client;
+
+	TUniquePtr<FSCServer> server;
+
+	FSCBenchmarkOptions options;
+
+	TFunction<void(TSharedPtr<FJsonObject> results)> oncomplete;
+
+	bool running;
+
+	/** The scenarios which did not run yet */
+	TArray<FString> pending;
+
+	FString scenario;
+
+	/** The step the running scenario is at, every scenario starts at 0 once its client is connected */
+	int32 step;
+
+	double scenarioStart;
+
+	/** Set by a callback when the running scenario failed, it is finished on the next tick */
+	FString failure;
+
+	double stepStart;
+
+	uint64 scenarioFrames;
+
+	TSharedPtr<FJsonObject> results;
+
+	TSharedPtr<FJsonObject> scenarioResult;
+
+	/** Set when the run started message accounting, it is stopped once the run completes */
+	bool accounting;
+
+	int32 sent;
+
+	int32 received;
+
+	int32 payloadIndex;
+
+	FString payload;
+
+	FSCHistogram latency;
+
+	void _startScenario();
+
+	void _finishScenario(const FString& error = FString());
+
+	void _complete();
+
+	/** Check the message costs of every scenario against the budget file, or write it, and report the outcome in results */
+	void _checkBudget();
+
+	void _createClient();
+
+	void _destroyClient();
+
+	void _tickRpc();
+
+	void _sendRpc();
+
+	void _tickPublish();
+
+	void _tickFanIn();
+
+	void _tickResubscribe();
+
+	void _runDecode();
+
+	static FString _makePayload(int32 size);
+};
+
+/**
+* Runs USCBenchmark headless, writes the results to Saved/SCBenchmarks and fails when a scenario failed, a message type is over its budget or there is no budget file.
+* UE4Editor-Cmd <Project> -run=SCBenchmark [-scenarios=rpc,publish,fanin,resubscribe,decode] [-port=8181] [-snapshots=dir] [-budget=file] [-writebudget] [-headroom=0.1] [-noaccounting] [-out=file]
+*/
+UCLASS()
+class SCBENCHMARK_API USCBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USCBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,17 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Core/Public/Modules/ModuleManager.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSCBenchmark, Log, All);
+
+class FSCBenchmarkModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
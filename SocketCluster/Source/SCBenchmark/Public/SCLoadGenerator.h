@@ -0,0 +1,219 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Dom/JsonObject.h"
+#include "Commandlets/Commandlet.h"
+#include "SCHistogram.h"
+#include "SCClientSocket.h"
+#include "SCLoadGenerator.generated.h"
+
+/** The settings of a load test, every virtual client follows the same script */
+struct FSCLoadGeneratorOptions
+{
+	FString hostname = "127.0.0.1";
+
+	int32 port = 8000;
+
+	FString path = "/socketcluster/";
+
+	bool secure = false;
+
+	int32 protocolVersion = 2;
+
+	/** The number of virtual clients */
+	int32 clients = 1000;
+
+	/** The number of clients started per second, 0 starts every client at once */
+	float connectRate = 200.0f;
+
+	/** The signed auth token every client authenticates with once connected, clients do not authenticate when empty */
+	FString authToken;
+
+	/** The number of channels every client subscribes to */
+	int32 channelsPerClient = 5;
+
+	/** The number of distinct channels, client i subscribes to channels (i * channelsPerClient + j) % channelCount */
+	int32 channelCount = 100;
+
+	FString channelPrefix = "load.";
+
+	/** The messages every client publishes per second to one of its channels */
+	float publishRate = 1.0f;
+
+	/** The size of a published message in bytes */
+	int32 payloadSize = 128;
+
+	/** The emits every client sends per second, the server has to respond to rpcEvent */
+	float rpcRate = 1.0f;
+
+	FString rpcEvent = "load.rpc";
+
+	/** The time in seconds the script runs once every client was started */
+	float duration = 60.0f;
+
+	/** The time in seconds between progress logs, 0 disables them */
+	float reportInterval = 5.0f;
+
+	/** Whether the clients connect through the shared socket context, a context per client does not scale past a few hundred clients */
+	bool sharedContext = true;
+};
+
+/** The script state of a virtual client */
+struct FSCLoadClient
+{
+	/** The platform time the client was started or last began connecting */
+	double connectingAt = 0.0;
+
+	/** The platform time the next publish and emit are due */
+	double nextPublish = 0.0;
+
+	double nextRpc = 0.0;
+
+	/** Whether the channels were subscribed, they are restored by the client socket after a reconnect */
+	bool subscribed = false;
+};
+
+/**
+* The SocketCluster Load Generator
+*
+* Drives many virtual clients (USCClientSocket) in one process against a SocketCluster server.
+* Every client connects, optionally authenticates, subscribes to its channels, then publishes and emits at a fixed rate.
+* The results aggregate connect, publish acknowledgement, delivery and rpc latency percentiles, throughput and errors.
+* The clients use the shared socket context, so thousands of them are serviced by a single lws_service call per tick.
+* Runs from the SCLoadTest commandlet, which ticks a world of its own as fast as it can, or the SocketCluster.LoadTest console command.
+*/
+UCLASS()
+class SCBENCHMARK_API USCLoadGenerator : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USCLoadGenerator();
+
+	/**
+	* Start a load test, the generator keeps itself alive until it completes.
+	*
+	* @param WorldContextObject		The world the client sockets are created in.
+	* @param options				The settings of the test.
+	* @param oncomplete				Receives the results.
+	*/
+	static USCLoadGenerator* run(const UObject* WorldContextObject, const FSCLoadGeneratorOptions& options, TFunction<void(TSharedPtr<FJsonObject> results)> oncomplete = nullptr);
+
+	/** Disconnect every client and complete with the results gathered so far */
+	void stop();
+
+	virtual class UWorld* GetWorld() const override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual bool IsTickableWhenPaused() const override { return true; }
+
+	virtual bool IsTickableInEditor() const override { return true; }
+
+	virtual TStatId GetStatId() const override;
+
+	bool isRunning() const { return running; }
+
+private:
+
+	UPROPERTY()
+	UWorld* World;
+
+	UPROPERTY()
+	TArray<USCClientSocket*> clients;
+
+	TArray<FSCLoadClient> scripts;
+
+	FSCLoadGeneratorOptions options;
+
+	TFunction<void(TSharedPtr<FJsonObject> results)> oncomplete;
+
+	bool running;
+
+	/** Set once the script ended, the clients are disconnecting */
+	bool stopping;
+
+	double startTime;
+
+	/** The time every client was started at */
+	double rampedAt;
+
+	double stopTime;
+
+	double lastReport;
+
+	uint64 lastReportDeliveries;
+
+	/** The payload of the published messages, prefixed with the publish time when it is sent */
+	FString payload;
+
+	int32 connected;
+
+	int32 connectFailures;
+
+	int32 disconnects;
+
+	int32 authFailures;
+
+	uint64 publishSent;
+
+	uint64 publishAcked;
+
+	uint64 publishErrors;
+
+	uint64 deliveries;
+
+	uint64 rpcSent;
+
+	uint64 rpcAcked;
+
+	uint64 rpcErrors;
+
+	/** The latencies in microseconds */
+	FSCHistogram connectLatency;
+
+	FSCHistogram publishLatency;
+
+	FSCHistogram deliveryLatency;
+
+	FSCHistogram rpcLatency;
+
+	void _startClient();
+
+	void _onConnect(int32 index);
+
+	void _subscribe(int32 index);
+
+	void _publish(int32 index, double now);
+
+	void _emit(int32 index, double now);
+
+	void _report(double now);
+
+	void _complete();
+
+	TSharedPtr<FJsonObject> _results() const;
+};
+
+/**
+* Runs USCLoadGenerator headless and writes the results to Saved/SCBenchmarks.
+* UE4Editor-Cmd <Project> -run=SCLoadTest -host=127.0.0.1 -port=8000 [-clients=1000] [-connectrate=200] [-channels=5] [-channelcount=100] [-publishrate=1] [-payload=128]
+*	[-rpcrate=1] [-rpcevent=load.rpc] [-token=jwt] [-duration=60] [-progress=5] [-tickrate=120] [-nosharedcontext] [-out=file]
+*/
+UCLASS()
+class SCBENCHMARK_API USCLoadTestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USCLoadTestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,34 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class SCBenchmark : ModuleRules
+{
+	public SCBenchmark(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"Json",
+				"SCJson",
+				"SCClient",
+				"SCServer",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"SCSocket",
+				"SCCodecEngine",
+				"SCAuthEngine",
+				"Projects",
+			}
+			);
+	}
+}
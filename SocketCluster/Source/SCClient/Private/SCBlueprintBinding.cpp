@@ -0,0 +1,174 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCBlueprintBinding.h"
+#include "SCErrors.h"
+#include "SCJsonConvert.h"
+#include "SCJsonValue.h"
+#include "SCResponse.h"
+#include "SCClientModule.h"
+
+static bool SCIsObjectParam(UProperty* Property, UClass* Class)
+{
+	UObjectProperty* ObjectProperty = Cast<UObjectProperty>(Property);
+	return ObjectProperty != nullptr && ObjectProperty->PropertyClass != nullptr && ObjectProperty->PropertyClass->IsChildOf(Class);
+}
+
+FSCBlueprintBinding::FSCBlueprintBinding()
+{
+	shape = ESCBlueprintArgShape::NONE;
+	bHadTarget = false;
+}
+
+FSCBlueprintBinding::FSCBlueprintBinding(UObject* Target, const FString& FunctionName)
+{
+	name = FunctionName;
+	shape = ESCBlueprintArgShape::NONE;
+	bHadTarget = Target != nullptr && Target->IsValidLowLevel();
+	if (!bHadTarget)
+	{
+		return;
+	}
+
+	target = Target;
+	UFunction* Function = Target->FindFunction(FName(*FunctionName));
+	if (Function == nullptr)
+	{
+		return;
+	}
+	function = Function;
+
+	TArray<UProperty*, TInlineAllocator<2>> Properties;
+	for (TFieldIterator<UProperty> Iterator(Function); Iterator && (Iterator->PropertyFlags & CPF_Parm) && Properties.Num() < 2; ++Iterator)
+	{
+		if (!Iterator->HasAnyPropertyFlags(CPF_ReturnParm))
+		{
+			Properties.Add(*Iterator);
+		}
+	}
+
+	if (Properties.Num() == 0)
+	{
+		return;
+	}
+
+	if (SCIsObjectParam(Properties[0], USCJsonValue::StaticClass()))
+	{
+		if (Properties.Num() == 1)
+		{
+			shape = ESCBlueprintArgShape::VALUE;
+		}
+		else if (SCIsObjectParam(Properties[1], USCJsonValue::StaticClass()))
+		{
+			shape = ESCBlueprintArgShape::VALUE_VALUE;
+		}
+		else if (SCIsObjectParam(Properties[1], USCResponse::StaticClass()))
+		{
+			shape = ESCBlueprintArgShape::VALUE_RESPONSE;
+		}
+	}
+	else if (Properties.Num() == 1 && Properties[0]->IsA<UStrProperty>())
+	{
+		shape = ESCBlueprintArgShape::STRING;
+	}
+}
+
+TSharedPtr<FJsonValue> FSCBlueprintBinding::check(const FString& action, const FString& role, ESCBlueprintArgShape expected, ESCBlueprintArgShape alternative) const
+{
+	if (!bHadTarget)
+	{
+		return USCErrors::InvalidActionError(action + " target not found for " + role + " function '" + name + "'");
+	}
+
+	if (!hasFunction())
+	{
+		return USCErrors::InvalidActionError(action + " " + role + " function '" + name + "' not found");
+	}
+
+	if (shape == ESCBlueprintArgShape::NONE || (shape != expected && shape != alternative))
+	{
+		return USCErrors::InvalidArgumentsError(action + " " + role + " function '" + name + "' parameters incorrect");
+	}
+	return nullptr;
+}
+
+bool FSCBlueprintBinding::call(TSharedPtr<FJsonValue> data) const
+{
+	UObject* Target = target.Get();
+	UFunction* Function = function.Get();
+	if (Target == nullptr || Function == nullptr)
+	{
+		return false;
+	}
+
+	if (shape == ESCBlueprintArgShape::VALUE)
+	{
+		struct FDynamicArgs
+		{
+			USCJsonValue* Arg01 = nullptr;
+		};
+
+		FDynamicArgs Args = FDynamicArgs();
+		Args.Arg01 = NewObject<USCJsonValue>();
+		Args.Arg01->SetRootValue(data);
+		SCOPE_CYCLE_COUNTER(STAT_SCBlueprintCallback);
+		Target->ProcessEvent(Function, &Args);
+		return true;
+	}
+	else if (shape == ESCBlueprintArgShape::STRING)
+	{
+		FString StringValue = USCJsonConvert::ToJsonString(data);
+		SCOPE_CYCLE_COUNTER(STAT_SCBlueprintCallback);
+		Target->ProcessEvent(Function, &StringValue);
+		return true;
+	}
+	return false;
+}
+
+bool FSCBlueprintBinding::call(TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data) const
+{
+	UObject* Target = target.Get();
+	UFunction* Function = function.Get();
+	if (Target == nullptr || Function == nullptr || shape != ESCBlueprintArgShape::VALUE_VALUE)
+	{
+		return false;
+	}
+
+	struct FDynamicArgs
+	{
+		USCJsonValue* Arg01 = nullptr;
+		USCJsonValue* Arg02 = nullptr;
+	};
+
+	FDynamicArgs Args = FDynamicArgs();
+	Args.Arg01 = NewObject<USCJsonValue>();
+	Args.Arg01->SetRootValue(error);
+	Args.Arg02 = NewObject<USCJsonValue>();
+	Args.Arg02->SetRootValue(data);
+	SCOPE_CYCLE_COUNTER(STAT_SCBlueprintCallback);
+	Target->ProcessEvent(Function, &Args);
+	return true;
+}
+
+bool FSCBlueprintBinding::call(TSharedPtr<FJsonValue> data, USCResponse* res) const
+{
+	UObject* Target = target.Get();
+	UFunction* Function = function.Get();
+	if (Target == nullptr || Function == nullptr || shape != ESCBlueprintArgShape::VALUE_RESPONSE)
+	{
+		return false;
+	}
+
+	struct FDynamicArgs
+	{
+		USCJsonValue* Arg01 = nullptr;
+		USCResponse* Arg02 = nullptr;
+	};
+
+	FDynamicArgs Args = FDynamicArgs();
+	Args.Arg01 = NewObject<USCJsonValue>();
+	Args.Arg01->SetRootValue(data);
+	Args.Arg02 = res;
+	SCOPE_CYCLE_COUNTER(STAT_SCBlueprintCallback);
+	Target->ProcessEvent(Function, &Args);
+	return true;
+}
@@ -11,6 +11,11 @@ USCChannel* USCChannel::create(FString channelName, USCClientSocket* clientSocke
 	channel->channel_name = channelName;
 	channel->channel_state = ESocketClusterChannelState::UNSUBSCRIBED;
 	channel->channel_client = clientSocket;
+	channel->channel_conflate = false;
+	channel->channel_lastCollapsed = 0;
+	channel->channel_totalCollapsed = 0;
+	channel->_hasConflatedRaw = false;
+	channel->_pendingCollapsed = 0;
 
 	channel->channel_options = options;
 	channel->setOptions(options);
@@ -30,6 +35,73 @@ void USCChannel::setOptions(TSharedPtr<FJsonObject> options)
 	{
 		channel_data = USCJsonConvert::ToJsonValue(options->GetObjectField("data"));
 	}
+	if (options->HasField("conflate"))
+	{
+		channel_conflate = options->GetBoolField("conflate");
+		channel_conflateKey = options->HasField("conflateKey") ? options->GetStringField("conflateKey") : FString("");
+	}
+}
+
+void USCChannel::setConflate(const bool conflate, const FString& conflateKey)
+{
+	channel_conflate = conflate;
+	channel_conflateKey = conflateKey;
+}
+
+int32 USCChannel::getLastCollapsedCount()
+{
+	return channel_lastCollapsed;
+}
+
+int64 USCChannel::getTotalCollapsedCount()
+{
+	return channel_totalCollapsed;
+}
+
+void USCChannel::_conflate(const FString& data)
+{
+	if (channel_conflateKey.IsEmpty())
+	{
+		if (_hasConflatedRaw)
+		{
+			_pendingCollapsed++;
+		}
+		_conflatedRaw = data;
+		_hasConflatedRaw = true;
+		return;
+	}
+
+	TSharedPtr<FJsonValue> value = USCJsonConvert::JsonStringToJsonValue(data);
+	FString key;
+	if (value.IsValid() && value->Type == EJson::Object)
+	{
+		value->AsObject()->TryGetStringField(channel_conflateKey, key);
+	}
+
+	if (_conflatedByKey.Contains(key))
+	{
+		_pendingCollapsed++;
+	}
+	_conflatedByKey.Add(key, value);
+}
+
+void USCChannel::_takeConflated(TArray<TSharedPtr<FJsonValue>>& messages)
+{
+	if (_hasConflatedRaw)
+	{
+		messages.Add(USCJsonConvert::JsonStringToJsonValue(_conflatedRaw));
+		_conflatedRaw.Empty();
+		_hasConflatedRaw = false;
+	}
+	for (auto& message : _conflatedByKey)
+	{
+		messages.Add(message.Value);
+	}
+	_conflatedByKey.Reset();
+
+	channel_lastCollapsed = _pendingCollapsed;
+	channel_totalCollapsed += _pendingCollapsed;
+	_pendingCollapsed = 0;
 }
 
 ESocketClusterChannelState USCChannel::getState()
@@ -71,67 +143,21 @@ void USCChannel::onBlueprint(const FString& event, const FString& handler, UObje
 {
 	if (!handler.IsEmpty())
 	{
-		on(event, [&, event, handler, handlerTarget](TSharedPtr<FJsonValue> data){
-			onBlueprintHandler(event, handler, handlerTarget, data);
-		});
+		FSCBlueprintBinding binding(handlerTarget, handler);
+		if (!binding.check("On", "handler", ESCBlueprintArgShape::VALUE).IsValid())
+		{
+			on(event, [&, binding](TSharedPtr<FJsonValue> data){
+				onBlueprintHandler(binding, data);
+			});
+		}
 	}
 }
 
-void USCChannel::onBlueprintHandler(const FString& event, const FString& handler, UObject* handlerTarget, TSharedPtr<FJsonValue> data)
+void USCChannel::onBlueprintHandler(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> data)
 {
-	if (!handlerTarget->IsValidLowLevel())
+	if (!binding.call(data))
 	{
-		USCErrors::InvalidActionError("On target not found for handler function '" + handler + "'");
-		return;
-	}
-
-	UFunction* Function = handlerTarget->FindFunction(FName(*handler));
-	if (nullptr == Function)
-	{
-		USCErrors::InvalidActionError("On handler function '" + handler + "' not found");
-		return;
-	}
-
-	TFieldIterator<UProperty> Iterator(Function);
-
-	TArray<UProperty*> Properties;
-	while (Iterator && (Iterator->PropertyFlags & CPF_Parm))
-	{
-		UProperty* Prop = *Iterator;
-		Properties.Add(Prop);
-		++Iterator;
-	}
-
-	int32 FunctionParams = Properties.Num();
-
-	if (FunctionParams >= 1)
-	{
-
-		struct FDynamicArgs
-		{
-			USCJsonValue* Arg01 = nullptr;
-		};
-
-		FDynamicArgs Args = FDynamicArgs();
-
-		const FString& FirstParam = Properties[0]->GetCPPType();
-
-		if (FirstParam.Equals("USCJsonValue*"))
-		{
-			USCJsonValue* Value = NewObject<USCJsonValue>();
-			Value->SetRootValue(data);
-			Args.Arg01 = Value;
-			handlerTarget->ProcessEvent(Function, &Args);
-		}
-		else
-		{
-			USCErrors::InvalidArgumentsError("On handler function '" + handler + "' parameters incorrect");
-			return;
-		}
-	}
-	else
-	{
-		USCErrors::InvalidArgumentsError("On handler function '" + handler + "' parameters incorrect");
+		USCErrors::InvalidActionError("On target not found for handler function '" + binding.name + "'");
 	}
 }
 
@@ -155,6 +181,11 @@ void USCChannel::watch(TFunction<void(TSharedPtr<FJsonValue>)> handler)
 	channel_client->watch(channel_name, handler);
 }
 
+void USCChannel::watchText(TFunction<void(TArrayView<const uint8>)> handler)
+{
+	channel_client->watchText(channel_name, handler);
+}
+
 void USCChannel::unwatch()
 {
 	channel_client->unwatch(channel_name);
@@ -171,3 +202,11 @@ void USCChannel::destroy()
 }
 
 
+
+void USCChannel::_onStructReadError(const FString& what, UScriptStruct* structType)
+{
+	if (channel_client != nullptr)
+	{
+		channel_client->_onStructReadError(FString::Printf(TEXT("%s of channel %s"), *what, *channel_name), structType);
+	}
+}
@@ -97,7 +97,15 @@ USCClientSocket* USCClient::Create(
 	const bool Multiplex,
 	const bool RejectUnauthorized,
 	const bool AutoSubscribeOnConnect,
-	const FString& ChannelPrefix
+	const FString& ChannelPrefix,
+	const ESocketClusterReconnectStrategy ReconnectStrategy,
+	const int32 ReconnectBurstLimit,
+	const float ReconnectRefillInterval,
+	const float DispatchBudget,
+	const bool AdaptiveAckTimeout,
+	const FString& RttProbeEvent,
+	const float RttProbeInterval,
+	const bool SharedContext
 )
 {
 
@@ -124,6 +132,9 @@ USCClientSocket* USCClient::Create(
 	AutoReconnectOptions->SetNumberField("randomness", ReconnectRandomness);
 	AutoReconnectOptions->SetNumberField("multiplier", ReconnectMultiplier);
 	AutoReconnectOptions->SetNumberField("maxDelay", ReconnectMaxDelay);
+	AutoReconnectOptions->SetStringField("strategy", USCJsonConvert::EnumToString<ESocketClusterReconnectStrategy>("ESocketClusterReconnectStrategy", ReconnectStrategy));
+	AutoReconnectOptions->SetNumberField("burstLimit", ReconnectBurstLimit);
+	AutoReconnectOptions->SetNumberField("refillInterval", ReconnectRefillInterval);
 	options->SetObjectField("autoReconnectOptions", AutoReconnectOptions);
 
 	/* Currently not used*/
@@ -139,6 +150,11 @@ USCClientSocket* USCClient::Create(
 	options->SetBoolField("rejectUnauthorized", RejectUnauthorized);
 	options->SetBoolField("autoSubscribeOnConnect", AutoSubscribeOnConnect);
 	options->SetStringField("channelPrefix", ChannelPrefix);
+	options->SetNumberField("dispatchBudget", DispatchBudget);
+	options->SetBoolField("adaptiveAckTimeout", AdaptiveAckTimeout);
+	options->SetStringField("rttProbeEvent", RttProbeEvent);
+	options->SetNumberField("rttProbeInterval", RttProbeInterval);
+	options->SetBoolField("sharedContext", SharedContext);
 
 	if (Multiplex == false)
 	{
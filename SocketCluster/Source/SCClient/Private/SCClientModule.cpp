@@ -6,6 +6,13 @@
 
 DEFINE_LOG_CATEGORY(LogSCClient);
 
+DEFINE_STAT(STAT_SCCodecEncode);
+DEFINE_STAT(STAT_SCCodecDecode);
+DEFINE_STAT(STAT_SCHandleEvent);
+DEFINE_STAT(STAT_SCBlueprintCallback);
+DEFINE_STAT(STAT_SCDispatchQueueLength);
+DEFINE_STAT(STAT_SCDispatchQueueLatency);
+
 void FSCClientModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
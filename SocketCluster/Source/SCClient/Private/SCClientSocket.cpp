@@ -2,22 +2,31 @@
 
 #include "SCClientSocket.h"
 #include "Runtime/Engine/Classes/Engine/Engine.h"
-#include "Runtime/Core/Public/Misc/Base64.h"
 #include "Runtime/Engine/Classes/Kismet/KismetSystemLibrary.h"
 #include "SCJsonValue.h"
 #include "SCJsonObject.h"
 #include "SCJsonConvert.h"
+#include "SCBase64.h"
 #include "SC_Formatter.h"
 #include "SCTransport.h"
+#include "SCReplay.h"
 #include "SCErrors.h"
 #include "SCAuthEngine.h"
 #include "SCDefaultAuthEngine.h"
 #include "SCClient.h"
 #include "SCChannel.h"
 #include "SCClientModule.h"
+#include "SCMessageAccounting.h"
 
 USCClientSocket::USCClientSocket()
 {
+	dispatchBudget = 0.0;
+	_dispatchFrame = 0;
+	_dispatchSpent = 0.0;
+	_dispatchQueueHead[0] = 0;
+	_dispatchQueueHead[1] = 0;
+	_dispatchQueueHead[2] = 0;
+
 	_localEvents.Add("connect", 1);
 	_localEvents.Add("connectAbort", 1);
 	_localEvents.Add("close", 1);
@@ -42,9 +51,32 @@ USCClientSocket::USCClientSocket()
 		bool IsSubscribed = isSubscribed(undecoratedChannelName, true);
 		if (IsSubscribed)
 		{
-			if (_channelEmitter.Contains(undecoratedChannelName) && _channelEmitter.FindRef(undecoratedChannelName))
+			USCChannel* channel = channels.FindRef(undecoratedChannelName);
+			if (channel && channel->channel_conflate)
+			{
+				channel->_conflate(dataObj->GetStringField("data"));
+				if (!_conflatedChannels.Contains(channel))
+				{
+					_conflatedChannels.Add(channel);
+				}
+				if (!_conflatedFlushHandle.IsValid())
+				{
+					_conflatedFlushHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &USCClientSocket::_flushConflatedChannels));
+				}
+			}
+			else
 			{
-				_channelEmitter.FindRef(undecoratedChannelName)(USCJsonConvert::JsonStringToJsonValue(dataObj->GetStringField("data")));
+				const FString channelData = dataObj->GetStringField("data");
+				if (_channelTextEmitter.Contains(undecoratedChannelName))
+				{
+					FTCHARToUTF8 converted(*channelData, channelData.Len());
+					SC_ACCOUNT_TRANSCODE(converted.Length());
+					_watchChannelText(undecoratedChannelName, TArrayView<const uint8>((const uint8*)converted.Get(), converted.Length()));
+				}
+				if (_channelEmitter.Contains(undecoratedChannelName) && _channelEmitter.FindRef(undecoratedChannelName))
+				{
+					_channelEmitter.FindRef(undecoratedChannelName)(USCJsonConvert::JsonStringToJsonValue(channelData));
+				}
 			}
 		}
 	});
@@ -130,6 +162,12 @@ USCClientSocket::USCClientSocket()
 void USCClientSocket::BeginDestroy()
 {
 	destroy();
+	stopCapture();
+	if (metrics != nullptr)
+	{
+		// The metrics may outlive the socket, their gauges are no longer read from it
+		metrics->onsample = nullptr;
+	}
 	Super::BeginDestroy();
 }
 
@@ -169,9 +207,17 @@ void USCClientSocket::create(const UObject* WorldContextObject, TSubclassOf<USCA
 
 	connectAttempts = 0;
 
-	_emitBuffer.Empty();
+	_emitBufferHead = nullptr;
+	_emitBufferTail = nullptr;
+	_emitBufferLength = 0;
+	_latestEmitBuffer.Empty();
 	channels.Empty();
 
+	dispatchBudget = opts->HasField("dispatchBudget") ? FMath::Max(0.0, opts->GetNumberField("dispatchBudget")) / 1000.0 : 0.0;
+	_dispatchFrame = 0;
+	_dispatchSpent = 0.0;
+	_clearDispatchQueue();
+
 	options = opts;
 
 	_cid = 1;
@@ -199,6 +245,33 @@ void USCClientSocket::create(const UObject* WorldContextObject, TSubclassOf<USCA
 		}
 	}
 
+	reconnectPolicy = NewObject<USCReconnectPolicy>(this);
+	if (options->HasField("autoReconnectOptions"))
+	{
+		reconnectPolicy->setOptions(options->GetObjectField("autoReconnectOptions"));
+	}
+
+	_rtt = MakeShared<FSCRttEstimator>();
+	adaptiveAckTimeout = options->HasField("adaptiveAckTimeout") && options->GetBoolField("adaptiveAckTimeout");
+	double ackTimeoutBound;
+	if (options->TryGetNumberField("ackTimeoutMin", ackTimeoutBound))
+	{
+		_rtt->minTimeout = ackTimeoutBound;
+	}
+	if (options->TryGetNumberField("ackTimeoutMax", ackTimeoutBound))
+	{
+		_rtt->maxTimeout = ackTimeoutBound;
+	}
+	rttProbeEvent = options->HasField("rttProbeEvent") ? options->GetStringField("rttProbeEvent") : FString();
+	rttProbeInterval = options->HasField("rttProbeInterval") ? options->GetNumberField("rttProbeInterval") : 0.0f;
+	_rttProbeSamples = 0;
+
+	metrics = NewObject<USCMetrics>(this);
+	metrics->onsample = [&]()
+	{
+		metrics->setGauges(transport != nullptr ? transport->getSendQueueLength() : 0, transport != nullptr ? transport->getPendingAckCount() : 0, _emitBufferLength);
+	};
+
 	if (!options->HasField("subscriptionRetryOptions"))
 	{
 		options->SetObjectField("subscriptionRetryOptions", nullptr);
@@ -225,6 +298,7 @@ void USCClientSocket::create(const UObject* WorldContextObject, TSubclassOf<USCA
 	options->SetStringField("query", queryParse(opts->GetObjectField("query")));
 
 	_channelEmitter.Empty();
+	_channelTextEmitter.Empty();
 
 	if (options->GetBoolField("autoConnect"))
 	{
@@ -241,72 +315,24 @@ void USCClientSocket::deauthenticateBlueprint(const FString& callback, UObject*
 {
 	if (!callback.IsEmpty())
 	{
-		deauthenticate([&, callback, callbackTarget, this](TSharedPtr<FJsonValue> error)
+		FSCBlueprintBinding binding(callbackTarget, callback);
+		if (!binding.check("Deauthenticate", "callback", ESCBlueprintArgShape::VALUE).IsValid())
 		{
-			deauthenticateBlueprintCallback(callback, callbackTarget, error);
-		});
-	}
-	else
-	{
-		deauthenticate();
+			deauthenticate([&, binding, this](TSharedPtr<FJsonValue> error)
+			{
+				deauthenticateBlueprintCallback(binding, error);
+			});
+			return;
+		}
 	}
+	deauthenticate();
 }
 
-void USCClientSocket::deauthenticateBlueprintCallback(const FString& callback, UObject* target, TSharedPtr<FJsonValue> error)
+void USCClientSocket::deauthenticateBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> error)
 {
-	if (!target->IsValidLowLevel())
-	{
-		USCErrors::InvalidActionError("Deauthenticate target not found for callback function '" + callback + "'");
-		return;
-	}
-
-	UFunction* Function = target->FindFunction(FName(*callback));
-	if (nullptr == Function)
-	{
-		USCErrors::InvalidActionError("Deauthenticate callback function '" + callback + "' not found");
-		return;
-	}
-
-	TFieldIterator<UProperty> Iterator(Function);
-
-	TArray<UProperty*> Properties;
-	while (Iterator && (Iterator->PropertyFlags & CPF_Parm))
-	{
-		UProperty* Prop = *Iterator;
-		Properties.Add(Prop);
-		++Iterator;
-	}
-
-	int32 FunctionParams = Properties.Num();
-
-	if (FunctionParams >= 1)
-	{
-		const FString& FirstParam = Properties[0]->GetCPPType();
-		if (FirstParam.Equals("USCJsonValue*"))
-		{
-			struct FDynamicArgs
-			{
-				USCJsonValue* Arg01 = nullptr;
-			};
-
-			FDynamicArgs Args = FDynamicArgs();
-			
-			USCJsonValue* Value = NewObject<USCJsonValue>();
-			Value->SetRootValue(error);
-
-			Args.Arg01 = Value;
-
-			target->ProcessEvent(Function, &Args);
-		}
-		else
-		{
-			USCErrors::InvalidArgumentsError("Deauthenticate callback function '" + callback + "' parameters incorrect");
-		}
-
-	}
-	else
+	if (!binding.call(error))
 	{
-		USCErrors::InvalidArgumentsError("Deauthenticate callback function '" + callback + "' parameters incorrect");
+		USCErrors::InvalidActionError("Deauthenticate target not found for callback function '" + binding.name + "'");
 	}
 }
 
@@ -360,42 +386,68 @@ void USCClientSocket::connect()
 			Emitter.FindRef("connecting")(nullptr, nullptr);
 		}
 
-		if (transport->IsValidLowLevel())
-		{
-			transport->off();
-		}
+		_createTransport(false);
+	}
+}
 
-		transport = NewObject<USCTransport>(this);
-		transport->create(auth, codec, options);
+void USCClientSocket::_createTransport(bool offline)
+{
+	if (transport->IsValidLowLevel())
+	{
+		transport->off();
+	}
 
-		transport->onopen = [&](TSharedPtr<FJsonValue> status)
-		{
-			state = ESocketClusterState::OPEN;
-			_onSCOpen(status);
-		};
+	transport = NewObject<USCTransport>(this);
+	transport->metrics = metrics;
+	transport->rtt = _rtt;
+	transport->adaptiveAckTimeout = adaptiveAckTimeout;
+	transport->capture = _capture;
+	transport->networkConditions = _networkConditions;
+	transport->create(auth, codec, options, offline);
 
-		transport->onerror = [&](TSharedPtr<FJsonValue> err)
-		{
-			_onSCError(err);
-		};
+	transport->onopen = [&](TSharedPtr<FJsonValue> status)
+	{
+		state = ESocketClusterState::OPEN;
+		_onSCOpen(status);
+	};
 
-		transport->onclose = [&](int32 code, FString data)
-		{
-			state = ESocketClusterState::CLOSED;
-			_onSCClose(code, data);
-		};
+	transport->onerror = [&](TSharedPtr<FJsonValue> err)
+	{
+		_onSCError(err);
+	};
 
-		transport->onopenAbort = [&](int32 code, FString data)
-		{
-			state = ESocketClusterState::CLOSED;
-			_onSCClose(code, data, true);
-		};
+	transport->onclose = [&](int32 code, FString data)
+	{
+		state = ESocketClusterState::CLOSED;
+		_onSCClose(code, data);
+	};
 
-		transport->onevent = [&](FString event, TSharedPtr<FJsonValue> data, USCResponse* res)
-		{
-			_onSCEvent(event, data, res);
-		};
-	}
+	transport->onopenAbort = [&](int32 code, FString data)
+	{
+		state = ESocketClusterState::CLOSED;
+		_onSCClose(code, data, true);
+	};
+
+	transport->onevent = [&](FString event, TSharedPtr<FJsonValue> data, USCResponse* res)
+	{
+		_onSCEvent(event, data, res);
+	};
+
+	transport->haslistener = [&](const FString& event)
+	{
+		return Emitter.Contains(event) && Emitter.FindRef(event);
+	};
+
+	transport->oneventview = [&](const FString& event, const FSCJsonNode& data, int32 cid)
+	{
+		return _onSCEventView(event, data, cid);
+	};
+
+	transport->haseventview = [&](const FString& event)
+	{
+		return _viewEmitter.Contains(event) && !_privateEventHandlerMap.Contains(event);
+	};
+	transport->useDocument = _viewEmitter.Num() > 0;
 }
 
 void USCClientSocket::reconnect(int32 code, TSharedPtr<FJsonValue> data)
@@ -509,29 +561,47 @@ void USCClientSocket::_changeToAuthenticatedState(FString token)
 
 FString USCClientSocket::decodeBase64(FString encodedString)
 {
-	FString decodedString;
-	FBase64::Decode(encodedString, decodedString);
-	return decodedString;
+	TArray<uint8> decodedBytes;
+	if (!FSCBase64::Decode(encodedString, decodedBytes))
+	{
+		return FString();
+	}
+	FUTF8ToTCHAR converted((const ANSICHAR*)decodedBytes.GetData(), decodedBytes.Num());
+	return FString(converted.Length(), converted.Get());
 }
 
 FString USCClientSocket::encodeBase64(FString decodedString)
 {
-	FString encodedString = FBase64::Encode(decodedString);
-	return encodedString;
+	FTCHARToUTF8 converted(*decodedString, decodedString.Len());
+	return FSCBase64::Encode(TArrayView<const uint8>((const uint8*)converted.Get(), converted.Length()));
 }
 
 TSharedPtr<FJsonValue> USCClientSocket::_extractAuthTokenData(FString token)
 {
 	TArray<FString> tokenParts;
 	token.ParseIntoArray(tokenParts, TEXT("."), true);
+	if (tokenParts.Num() < 2)
+	{
+		return nullptr;
+	}
 
-	FString encodedTokenData = tokenParts[1];
-	if (!encodedTokenData.IsEmpty())
+	// The payload of a JWT is base64url, tokens signed with the standard alphabet are accepted as well
+	TArray<uint8> tokenBytes;
+	if (!FSCBase64::Decode(tokenParts[1], tokenBytes, ESCBase64::Url) && !FSCBase64::Decode(tokenParts[1], tokenBytes, ESCBase64::Standard))
 	{
-		TSharedPtr<FJsonValue> tokenData = USCJsonConvert::ToJsonValue(decodeBase64(encodedTokenData));
-		return tokenData;
+		return nullptr;
 	}
-	return nullptr;
+	return USCJsonConvert::JsonBytesToJsonValue(tokenBytes);
+}
+
+USCReconnectPolicy* USCClientSocket::getReconnectPolicy()
+{
+	return reconnectPolicy;
+}
+
+USCMetrics* USCClientSocket::getMetrics()
+{
+	return metrics;
 }
 
 USCJsonValue* USCClientSocket::getAuthTokenBlueprint()
@@ -555,79 +625,24 @@ void USCClientSocket::authenticateBlueprint(const FString& token, const FString&
 {
 	if (!callback.IsEmpty())
 	{
-		authenticate(token, [&, callback, callbackTarget](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+		FSCBlueprintBinding binding(callbackTarget, callback);
+		if (!binding.check("Authenticate", "callback", ESCBlueprintArgShape::VALUE_VALUE).IsValid())
 		{
-			authenticateBlueprintCallback(callback, callbackTarget, error, data);
-		});
-	}
-	else
-	{
-		authenticate(token);
+			authenticate(token, [&, binding](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+			{
+				authenticateBlueprintCallback(binding, error, data);
+			});
+			return;
+		}
 	}
+	authenticate(token);
 }
 
-void USCClientSocket::authenticateBlueprintCallback(const FString& callback, UObject* target, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+void USCClientSocket::authenticateBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
 {
-	if (!target->IsValidLowLevel())
-	{
-		USCErrors::InvalidActionError("Authenticate target not found for callback function '" + callback + "'");
-		return;
-	}
-
-	UFunction* Function = target->FindFunction(FName(*callback));
-	if (nullptr == Function)
-	{
-		USCErrors::InvalidActionError("Authenticate callback function '" + callback + "' not found");
-		return;
-	}
-
-	TFieldIterator<UProperty> Iterator(Function);
-
-	TArray<UProperty*> Properties;
-	while (Iterator && (Iterator->PropertyFlags & CPF_Parm))
-	{
-		UProperty* Prop = *Iterator;
-		Properties.Add(Prop);
-		++Iterator;
-	}
-
-	int32 FunctionParams = Properties.Num();
-
-	if(FunctionParams >= 2)
-	{
-
-		struct FDynamicArgs
-		{
-			USCJsonValue* Arg01 = nullptr;
-			USCJsonValue* Arg02 = nullptr;
-		};
-
-		FDynamicArgs Args = FDynamicArgs();
-
-		const FString& FirstParam = Properties[0]->GetCPPType();
-		const FString& SecondParam = Properties[1]->GetCPPType();
-
-		if (FirstParam.Equals("USCJsonValue*") && SecondParam.Equals("USCJsonValue*"))
-		{
-			USCJsonValue* err = NewObject<USCJsonValue>();
-			err->SetRootValue(error);
-
-			USCJsonValue* authStatus = NewObject<USCJsonValue>();
-			authStatus->SetRootValue(data);
-
-			Args.Arg01 = err;
-			Args.Arg02 = authStatus;
-
-			target->ProcessEvent(Function, &Args);
-		}
-		else
-		{
-			USCErrors::InvalidArgumentsError("Authenticate callback function '" + callback + "' parameters incorrect");
-		}
-	}
-	else
+	if (!binding.call(error, data))
 	{
-		USCErrors::InvalidArgumentsError("Authenticate callback function '" + callback + "' parameters incorrect");
+		USCErrors::InvalidActionError("Authenticate target not found for callback function '" + binding.name + "'");
 	}
 }
 
@@ -696,23 +711,8 @@ void USCClientSocket::authenticate(FString token, TFunction<void(TSharedPtr<FJso
 void USCClientSocket::_tryReconnect(float initialDelay)
 {
 	int32 exponent = connectAttempts++;
-	TSharedPtr<FJsonObject> reconnectOptions = options->GetObjectField("autoReconnectOptions");
-	float timeout;
-
-	if (initialDelay == NULL || exponent > 0)
-	{
-		float initialTimeout = FMath::RoundToFloat(reconnectOptions->GetNumberField("initialDelay") + (reconnectOptions->GetNumberField("randomness") || 0) * FMath::RandRange(0, 1));
-		timeout = FMath::RoundToFloat(initialTimeout * FMath::Pow(reconnectOptions->GetNumberField("multiplier"), exponent));
-	}
-	else
-	{
-		timeout = initialDelay;
-	}
-
-	if (timeout > reconnectOptions->GetNumberField("maxDelay"))
-	{
-		timeout = reconnectOptions->GetNumberField("maxDelay");
-	}
+	float timeout = reconnectPolicy->nextDelay(exponent, initialDelay);
+	metrics->recordReconnect();
 
 	clearTimeout(_reconnectTimeoutHandle);
 
@@ -749,8 +749,16 @@ void USCClientSocket::_onSCOpen(TSharedPtr<FJsonValue> status)
 		_changeToUnauthenticatedStateAndClearTokens();
 	}
 
+	reconnectPolicy->recordConnected(connectAttempts);
 	connectAttempts = 0;
 
+	if (!rttProbeEvent.IsEmpty() && rttProbeInterval > 0.0f)
+	{
+		_rttProbeSamples = _rtt->getSampleCount();
+		_rttProbeRef.BindUObject(this, &USCClientSocket::_sendRttProbe);
+		GetWorld()->GetTimerManager().SetTimer(_rttProbeHandle, _rttProbeRef, rttProbeInterval, true);
+	}
+
 	if (options->GetBoolField("autoSubscribeOnConnect"))
 	{
 		processPendingSubscriptions();
@@ -775,6 +783,19 @@ void USCClientSocket::_onSCError(TSharedPtr<FJsonValue> err)
 	}
 }
 
+void USCClientSocket::_onStructReadError(const FString& source, UScriptStruct* structType, USCResponse* res)
+{
+	const FString message = FString::Printf(TEXT("The data of %s could not be read into %s"), *source, structType != nullptr ? *structType->GetName() : TEXT("a struct"));
+	UE_LOG(LogSCClient, Warning, TEXT("%s"), *message);
+
+	TSharedPtr<FJsonValue> error = USCErrors::InvalidMessageError(message);
+	if (res != nullptr)
+	{
+		res->error(error);
+	}
+	_onSCError(error);
+}
+
 void USCClientSocket::_suspendSubscriptions()
 {
 	USCChannel* channel;
@@ -798,13 +819,20 @@ void USCClientSocket::_suspendSubscriptions()
 
 void USCClientSocket::_abortAllPendingEventsDueToBadConnection(FString failureType)
 {
-	TArray<USCEventObject*> currentNode = _emitBuffer;
-	for (auto& eventObject : currentNode)
+	USCEventObject* currentNode = _emitBufferHead;
+	USCEventObject* nextNode;
+	while (currentNode)
 	{
+		nextNode = currentNode->next;
+		USCEventObject* eventObject = currentNode;
 		clearTimeout(eventObject->timeoutHandle);
+		_detachFromEmitBuffer(eventObject);
+		currentNode = nextNode;
+
 		TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = eventObject->callback;
 		if (callback)
 		{
+			eventObject->callback = nullptr;
 			FString errorMessage = "Event '" + eventObject->event + "' was aborted due to a bad connection";
 			TSharedPtr<FJsonValue> error = USCErrors::BadConnectionError(errorMessage, failureType);
 			callback(error, nullptr);
@@ -828,12 +856,17 @@ void USCClientSocket::_onSCClose(int32 code, FString data, bool openAbort)
 	pendingReconnect = false;
 	pendingReconnectTimeout = 0.0f;
 	clearTimeout(_reconnectTimeoutHandle);
+	clearTimeout(_rttProbeHandle);
 
 	_suspendSubscriptions();
 	_abortAllPendingEventsDueToBadConnection(openAbort ? "connectAbort" : "disconnect");
 
+	// Events and responses queued for the closed connection are dropped, they must not be dispatched after the reconnect
+	_clearDispatchQueue();
+
 	if (options->GetBoolField("autoReconnect"))
 	{
+		reconnectPolicy->setRetryAfterFromReason(data);
 		if (code == 4000 || code == 4001 || code == 1005)
 		{
 			_tryReconnect(0);
@@ -890,6 +923,38 @@ void USCClientSocket::_onSCClose(int32 code, FString data, bool openAbort)
 }
 
 void USCClientSocket::_onSCEvent(FString event, TSharedPtr<FJsonValue> data, USCResponse* res)
+{
+	// Protocol events are handled immediately, only #publish and user events go through the dispatch queue
+	if (dispatchBudget <= 0.0 || (_privateEventHandlerMap.Contains(event) && !event.Equals("#publish")))
+	{
+		_dispatchSCEvent(event, data, res);
+		return;
+	}
+
+	if (_getDispatchQueueLength() == 0 && _hasDispatchBudget())
+	{
+		double start = FPlatformTime::Seconds();
+		_dispatchSCEvent(event, data, res);
+		_dispatchSpent += FPlatformTime::Seconds() - start;
+		_dispatchLatency.record(0);
+		return;
+	}
+
+	FSCDispatchItem item;
+	item.event = event;
+	item.data = data;
+	item.res = res;
+	item.queuedAt = FPlatformTime::Seconds();
+	_getDispatchQueue(_getDispatchPriority(event, data)).Add(item);
+	INC_DWORD_STAT(STAT_SCDispatchQueueLength);
+
+	if (!_dispatchDrainHandle.IsValid())
+	{
+		_dispatchDrainHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &USCClientSocket::_drainDispatchQueue));
+	}
+}
+
+void USCClientSocket::_dispatchSCEvent(FString event, TSharedPtr<FJsonValue> data, USCResponse* res)
 {
 	if (_privateEventHandlerMap.Contains(event))
 	{
@@ -899,6 +964,13 @@ void USCClientSocket::_onSCEvent(FString event, TSharedPtr<FJsonValue> data, USC
 			handler(data, res);
 		}
 	}
+	else if (_viewEmitter.Contains(event))
+	{
+		// The codec did not produce a document, so the data is copied into one for the view handler
+		FSCJsonDocument document;
+		document.Assign(data);
+		_viewEmitter[event](document.GetRoot(), res);
+	}
 	else
 	{
 		if (Emitter.Contains(event) && Emitter.FindRef(event))
@@ -908,295 +980,532 @@ void USCClientSocket::_onSCEvent(FString event, TSharedPtr<FJsonValue> data, USC
 	}
 }
 
-TSharedPtr<FJsonValue> USCClientSocket::decode(FString message)
-{
-	return transport->decode(message);
-}
-
-FString USCClientSocket::encode(TSharedPtr<FJsonValue> object)
+bool USCClientSocket::_onSCEventView(const FString& event, const FSCJsonNode& data, int32 cid)
 {
-	return transport->encode(object);
-}
+	TFunction<void(const FSCJsonNode&, USCResponse*)>* handler = _viewEmitter.Find(event);
+	if (handler == nullptr || _privateEventHandlerMap.Contains(event))
+	{
+		return false;
+	}
 
-void USCClientSocket::_flushEmitBuffer()
-{
-	TArray<USCEventObject*> currentNodes = _emitBuffer;
-	for (auto& eventObject : currentNodes)
+	USCResponse* res = nullptr;
+	if (cid != 0)
 	{
-		transport->emitObject(eventObject);
-		GetWorld()->GetTimerManager().ClearTimer(eventObject->timeoutHandle);
-		_emitBuffer.Remove(eventObject);
+		res = NewObject<USCResponse>();
+		res->create(transport, cid);
 	}
+	(*handler)(data, res);
+	return true;
 }
 
-void USCClientSocket::_handleEventAckTimeout(USCEventObject* eventObject)
+ESocketClusterDispatchPriority USCClientSocket::_getDispatchPriority(const FString& event, TSharedPtr<FJsonValue> data)
 {
-	if (IsValid(eventObject))
+	if (event.Equals("#publish"))
 	{
-		clearTimeout(eventObject->timeoutHandle);
-
-		TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = eventObject->callback;
-		if (callback)
-		{
-			eventObject->callback = nullptr;
-			TSharedPtr<FJsonValue> error = USCErrors::TimeoutError("Event response for '" + eventObject->event + "' timed out");
-			callback(error, nullptr);
-		}
-
-		if (eventObject->cid != 0)
+		if (_channelPriorities.Num() > 0 && data.IsValid() && data->Type == EJson::Object)
 		{
-			transport->cancelPendingResponse(eventObject->cid);
+			const ESocketClusterDispatchPriority* priority = _channelPriorities.Find(_undecorateChannelName(data->AsObject()->GetStringField("channel")));
+			if (priority)
+			{
+				return *priority;
+			}
 		}
+		return ESocketClusterDispatchPriority::NORMAL;
 	}
+
+	const ESocketClusterDispatchPriority* priority = _eventPriorities.Find(event);
+	return priority ? *priority : ESocketClusterDispatchPriority::NORMAL;
 }
 
-void USCClientSocket::_emit(FString event, TSharedPtr<FJsonValue> data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback)
+TArray<FSCDispatchItem>& USCClientSocket::_getDispatchQueue(ESocketClusterDispatchPriority priority)
 {
-
-	if (state == ESocketClusterState::CLOSED)
+	switch (priority)
 	{
-		connect();
+	case ESocketClusterDispatchPriority::HIGH:
+		return _dispatchQueueHigh;
+	case ESocketClusterDispatchPriority::LOW:
+		return _dispatchQueueLow;
+	case ESocketClusterDispatchPriority::NORMAL:
+	default:
+		return _dispatchQueueNormal;
 	}
+}
 
-	USCEventObject* eventObject = NewObject<USCEventObject>();
-	eventObject->event = event;
-	eventObject->callback = callback;
-	eventObject->data = data;
-	eventObject->timeout = FTimerDelegate::CreateUObject(this, &USCClientSocket::_handleEventAckTimeout, eventObject);
-	GetWorld()->GetTimerManager().SetTimer(eventObject->timeoutHandle, eventObject->timeout, options->GetNumberField("ackTimeout"), false);
-
-	_emitBuffer.Add(eventObject);
-	if (state == ESocketClusterState::OPEN)
-	{
-		_flushEmitBuffer();
-	}
+int32 USCClientSocket::_getDispatchQueueLength()
+{
+	return (_dispatchQueueHigh.Num() - _dispatchQueueHead[0]) + (_dispatchQueueNormal.Num() - _dispatchQueueHead[1]) + (_dispatchQueueLow.Num() - _dispatchQueueHead[2]);
 }
 
-void USCClientSocket::send(const FString& data)
+bool USCClientSocket::_hasDispatchBudget()
 {
-	if (transport->IsValidLowLevel())
+	if (_dispatchFrame != GFrameCounter)
 	{
-		transport->send(data);
+		_dispatchFrame = GFrameCounter;
+		_dispatchSpent = 0.0;
 	}
+	return _dispatchSpent < dispatchBudget;
 }
 
-void USCClientSocket::emitBlueprint(const FString& event, USCJsonValue* data, const FString& callback, UObject* callbackTarget)
+void USCClientSocket::_drainDispatchQueue()
 {
-	TSharedPtr<FJsonValue> DataValue = nullptr;
-	if (data != nullptr)
-	{
-		DataValue = data->GetRootValue();
-	}
-	else
-	{
-		DataValue = MakeShareable(new FJsonValueNull);
-	}
+	_dispatchDrainHandle.Invalidate();
 
-	if (!callback.IsEmpty())
+	// Always dispatch at least one event per frame so a single slow handler can not stall the queue
+	bool dispatched = false;
+	for (int32 priority = 0; priority < 3; priority++)
 	{
-		
-		emit(event, DataValue, [&, callback, callbackTarget](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+		TArray<FSCDispatchItem>& queue = _getDispatchQueue((ESocketClusterDispatchPriority)priority);
+		int32& head = _dispatchQueueHead[priority];
+		while (head < queue.Num() && (!dispatched || _hasDispatchBudget()))
 		{
-			emitBlueprintCallback(callback, callbackTarget, error, data);
-		});
+			FSCDispatchItem item = MoveTemp(queue[head]);
+			queue[head].res = nullptr;
+			head++;
+
+			// The frame of a deferred event was accounted when it arrived, its dispatch is accounted on its own
+			SC_ACCOUNT_MESSAGE(ESCMessageDirection::INBOUND);
+			SC_NAME_MESSAGE([&item]() { return item.event + TEXT(" (deferred)"); });
+
+			double start = FPlatformTime::Seconds();
+			_dispatchLatency.record((uint64)((start - item.queuedAt) * 1000000.0));
+			DEC_DWORD_STAT(STAT_SCDispatchQueueLength);
+			SET_FLOAT_STAT(STAT_SCDispatchQueueLatency, (start - item.queuedAt) * 1000.0);
+			_dispatchSCEvent(item.event, item.data, item.res);
+			_dispatchSpent += FPlatformTime::Seconds() - start;
+			dispatched = true;
+		}
+
+		if (head >= queue.Num())
+		{
+			queue.Reset();
+			head = 0;
+		}
 	}
-	else
+
+	if (_getDispatchQueueLength() > 0 && !_dispatchDrainHandle.IsValid())
 	{
-		emit(event, DataValue);
+		_dispatchDrainHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &USCClientSocket::_drainDispatchQueue));
 	}
 }
 
-void USCClientSocket::emitBlueprintCallback(const FString& callback, UObject* target, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+void USCClientSocket::_clearDispatchQueue()
 {
-	if (!target->IsValidLowLevel())
+	DEC_DWORD_STAT_BY(STAT_SCDispatchQueueLength, _getDispatchQueueLength());
+	if (_dispatchDrainHandle.IsValid())
 	{
-		USCErrors::InvalidActionError("Emit target not found for callback function '" + callback + "'");
-		return;
+		if (GetWorld() != nullptr)
+		{
+			GetWorld()->GetTimerManager().ClearTimer(_dispatchDrainHandle);
+		}
+		_dispatchDrainHandle.Invalidate();
 	}
+	_dispatchQueueHigh.Empty();
+	_dispatchQueueNormal.Empty();
+	_dispatchQueueLow.Empty();
+	_dispatchQueueHead[0] = 0;
+	_dispatchQueueHead[1] = 0;
+	_dispatchQueueHead[2] = 0;
+}
 
-	UFunction* Function = target->FindFunction(FName(*callback));
-	if (nullptr == Function)
-	{
-		USCErrors::InvalidActionError("Emit callback function '" + callback + "' not found");
-		return;
-	}
+void USCClientSocket::setEventPriority(const FString& event, ESocketClusterDispatchPriority priority)
+{
+	_eventPriorities.Add(event, priority);
+}
 
-	TFieldIterator<UProperty> Iterator(Function);
+void USCClientSocket::setChannelPriority(const FString& channelName, ESocketClusterDispatchPriority priority)
+{
+	_channelPriorities.Add(channelName, priority);
+}
 
-	TArray<UProperty*> Properties;
-	while (Iterator && (Iterator->PropertyFlags & CPF_Parm))
-	{
-		UProperty* Prop = *Iterator;
-		Properties.Add(Prop);
-		++Iterator;
-	}
+void USCClientSocket::setDispatchBudget(float budget)
+{
+	dispatchBudget = FMath::Max(0.0f, budget) / 1000.0;
+}
 
-	int32 FunctionParams = Properties.Num();
+int32 USCClientSocket::getDispatchQueueLength()
+{
+	return _getDispatchQueueLength();
+}
 
-	if(FunctionParams >= 2)
+USCJsonValue* USCClientSocket::getDispatchLatencyHistogramBlueprint()
+{
+	USCJsonValue* Value = NewObject<USCJsonValue>();
+	Value->SetRootValue(USCJsonConvert::ToJsonValue(_dispatchLatency.toJson()));
+	return Value;
+}
+
+TSharedPtr<FJsonValue> USCClientSocket::decode(FString message)
+{
+	return transport->decode(message);
+}
+
+FString USCClientSocket::encode(TSharedPtr<FJsonValue> object)
+{
+	return transport->encode(object);
+}
+
+void USCClientSocket::_flushEmitBuffer()
+{
+	double now = FPlatformTime::Seconds();
+	USCEventObject* currentNode = _emitBufferHead;
+	USCEventObject* nextNode;
+	while (currentNode)
 	{
+		nextNode = currentNode->next;
+		USCEventObject* eventObject = currentNode;
+		currentNode = nextNode;
 
-		struct FDynamicArgs
+		if (eventObject->expiry > 0.0 && now >= eventObject->expiry)
 		{
-			USCJsonValue* Arg01 = nullptr;
-			USCJsonValue* Arg02 = nullptr;
-		};
+			_dropBufferedEmit(eventObject, "expired");
+			continue;
+		}
 
-		FDynamicArgs Args = FDynamicArgs();
+		_detachFromEmitBuffer(eventObject);
+		transport->emitObject(eventObject);
+		GetWorld()->GetTimerManager().ClearTimer(eventObject->timeoutHandle);
 
-		const FString& FirstParam = Properties[0]->GetCPPType();
-		const FString& SecondParam = Properties[1]->GetCPPType();
+		// The adaptive timeout only starts once the emit is on the wire, waiting in the buffer is covered by ackTimeout
+		if (adaptiveAckTimeout && eventObject->callback)
+		{
+			GetWorld()->GetTimerManager().SetTimer(eventObject->timeoutHandle, eventObject->timeout, _getAckTimeout(), false);
+		}
+	}
+}
+
+void USCClientSocket::_flushConflatedChannels()
+{
+	_conflatedFlushHandle.Invalidate();
 
-		if (FirstParam.Equals("USCJsonValue*") && SecondParam.Equals("USCJsonValue*"))
+	TArray<USCChannel*> conflatedChannels = MoveTemp(_conflatedChannels);
+	_conflatedChannels.Reset();
+
+	TArray<TSharedPtr<FJsonValue>> messages;
+	TArray<uint8> text;
+	for (auto& channel : conflatedChannels)
+	{
+		messages.Reset();
+		channel->_takeConflated(messages);
+
+		if (!isSubscribed(channel->channel_name, true))
 		{
-			USCJsonValue* ErrorValue = NewObject<USCJsonValue>();
-			ErrorValue->SetRootValue(error);
+			continue;
+		}
 
-			USCJsonValue* DataValue = NewObject<USCJsonValue>();
-			DataValue->SetRootValue(data);
+		for (auto& message : messages)
+		{
+			if (_channelTextEmitter.Contains(channel->channel_name))
+			{
+				text.Reset();
+				FSCByteWriter writer(text);
+				FSCStructPlan::WriteJsonValue(message, writer);
+				_watchChannelText(channel->channel_name, text);
+			}
+			if (_channelEmitter.Contains(channel->channel_name) && _channelEmitter.FindRef(channel->channel_name))
+			{
+				_channelEmitter.FindRef(channel->channel_name)(message);
+			}
+		}
+	}
+}
 
-			Args.Arg01 = ErrorValue;
-			Args.Arg02 = DataValue;
-			target->ProcessEvent(Function, &Args);
+void USCClientSocket::_watchChannelText(const FString& channelName, TArrayView<const uint8> text)
+{
+	for (auto It = _channelTextEmitter.CreateConstKeyIterator(channelName); It; ++It)
+	{
+		if (It.Value())
+		{
+			It.Value()(text);
 		}
-		else
+	}
+}
+
+void USCClientSocket::_appendToEmitBuffer(USCEventObject* eventObject)
+{
+	if (_latestOnlyEvents.Contains(eventObject->event))
+	{
+		USCEventObject* previousEmit = _latestEmitBuffer.FindRef(eventObject->event);
+		if (previousEmit)
 		{
-			USCErrors::InvalidArgumentsError("Emit callback function '" + callback + "' parameters incorrect");
+			_dropBufferedEmit(previousEmit, "superseded");
 		}
+		_latestEmitBuffer.Add(eventObject->event, eventObject);
+	}
+
+	eventObject->prev = _emitBufferTail;
+	eventObject->next = nullptr;
+	if (_emitBufferTail)
+	{
+		_emitBufferTail->next = eventObject;
 	}
 	else
 	{
-		USCErrors::InvalidArgumentsError("Emit callback function '" + callback + "' parameters incorrect");
+		_emitBufferHead = eventObject;
 	}
+	_emitBufferTail = eventObject;
+	eventObject->buffered = true;
+	_emitBufferLength++;
 }
 
-void USCClientSocket::emit(FString event, TSharedPtr<FJsonValue> data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback)
+void USCClientSocket::_detachFromEmitBuffer(USCEventObject* eventObject)
 {
-	if (!_localEvents.Contains(event))
+	if (!eventObject->buffered)
 	{
-		_emit(event, data, callback);
+		return;
 	}
-	else if (event.Equals("error"))
+
+	if (eventObject->prev)
 	{
-		if (Emitter.Contains(event) && Emitter.FindRef(event))
-		{
-			Emitter.FindRef(event)(data, nullptr);
-		}
+		eventObject->prev->next = eventObject->next;
 	}
 	else
 	{
-		TSharedPtr<FJsonValue> error = USCErrors::InvalidActionError("The '" + event + "' event is reserved and cannot be emitted on a client socket");
-		_onSCError(error);
+		_emitBufferHead = eventObject->next;
+	}
+
+	if (eventObject->next)
+	{
+		eventObject->next->prev = eventObject->prev;
 	}
+	else
+	{
+		_emitBufferTail = eventObject->prev;
+	}
+
+	if (_latestEmitBuffer.FindRef(eventObject->event) == eventObject)
+	{
+		_latestEmitBuffer.Remove(eventObject->event);
+	}
+
+	eventObject->next = nullptr;
+	eventObject->prev = nullptr;
+	eventObject->buffered = false;
+	_emitBufferLength--;
 }
 
-void USCClientSocket::onBlueprint(const FString& event, const FString& handler, UObject* handlerTarget)
+void USCClientSocket::_dropBufferedEmit(USCEventObject* eventObject, FString failureType)
 {
-	if (!handler.IsEmpty())
+	clearTimeout(eventObject->timeoutHandle);
+	_detachFromEmitBuffer(eventObject);
+
+	TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = eventObject->callback;
+	if (callback)
 	{
-		on(event, [&, event, handler, handlerTarget](TSharedPtr<FJsonValue> data, USCResponse* res) {
-			onBlueprintHandler(event, handler, handlerTarget, data, res);
-		});
+		eventObject->callback = nullptr;
+		FString errorMessage = "Event '" + eventObject->event + "' was dropped from the emit buffer because it was " + failureType;
+		TSharedPtr<FJsonValue> error = USCErrors::BadConnectionError(errorMessage, failureType);
+		callback(error, nullptr);
 	}
 }
 
-void USCClientSocket::onBlueprintHandler(const FString& event, const FString& handler, UObject* handlerTarget, TSharedPtr<FJsonValue> data, USCResponse* res)
+void USCClientSocket::_handleEventAckTimeout(USCEventObject* eventObject)
 {
-	if (!handlerTarget->IsValidLowLevel())
+	if (IsValid(eventObject))
 	{
-		USCErrors::InvalidActionError("On target not found for handler function '" + handler + "'");
-		return;
+		clearTimeout(eventObject->timeoutHandle);
+		_detachFromEmitBuffer(eventObject);
+
+		TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = eventObject->callback;
+		if (callback)
+		{
+			eventObject->callback = nullptr;
+			TSharedPtr<FJsonValue> error = USCErrors::TimeoutError("Event response for '" + eventObject->event + "' timed out");
+			callback(error, nullptr);
+		}
+
+		if (eventObject->cid != 0)
+		{
+			// It was sent and not acknowledged in time, the next timeouts back off until a response arrives
+			_rtt->backoff();
+			transport->cancelPendingResponse(eventObject->cid);
+		}
 	}
+}
 
-	UFunction* Function = handlerTarget->FindFunction(FName(*handler));
-	if (nullptr == Function)
+float USCClientSocket::_getAckTimeout()
+{
+	return adaptiveAckTimeout ? (float)_rtt->getTimeout(ackTimeout) : ackTimeout;
+}
+
+void USCClientSocket::_sendRttProbe()
+{
+	// Acknowledged emits already measure the round trip, the probe only fills the gaps
+	if (state != ESocketClusterState::OPEN || _rtt->getSampleCount() != _rttProbeSamples)
 	{
-		USCErrors::InvalidActionError("On handler function '" + handler + "' not found");
+		_rttProbeSamples = _rtt->getSampleCount();
 		return;
 	}
 
-	TFieldIterator<UProperty> Iterator(Function);
+	const FDateTime now = FDateTime::UtcNow();
+	TSharedPtr<FJsonObject> probe = MakeShareable(new FJsonObject);
+	probe->SetNumberField("t", (double)now.ToUnixTimestamp() * 1000.0 + now.GetMillisecond());
+	transport->emit(rttProbeEvent, USCJsonConvert::ToJsonValue(probe), MakeShareable(new FJsonObject), [&](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+	{
+		// The probe's own sample does not count as traffic
+		_rttProbeSamples = _rtt->getSampleCount();
+	});
+}
+
+float USCClientSocket::getRoundTripTime()
+{
+	return (float)_rtt->getSmoothedRtt();
+}
+
+float USCClientSocket::getRoundTripTimeVariance()
+{
+	return (float)_rtt->getRttVariance();
+}
 
-	TArray<UProperty*> Properties;
-	while (Iterator && (Iterator->PropertyFlags & CPF_Parm))
+float USCClientSocket::getAckTimeout()
+{
+	return _getAckTimeout();
+}
+
+bool USCClientSocket::startCapture(const FString& path)
+{
+	stopCapture();
+
+	_capture = MakeShared<FSCSocketCapture>(path);
+	if (!_capture->isOpen())
+	{
+		_capture.Reset();
+		return false;
+	}
+	if (transport != nullptr)
 	{
-		UProperty* Prop = *Iterator;
-		Properties.Add(Prop);
-		++Iterator;
+		transport->setCapture(_capture);
 	}
+	return true;
+}
 
-	int32 FunctionParams = Properties.Num();
-	
-	if (FunctionParams == 1)
+void USCClientSocket::stopCapture()
+{
+	if (!_capture.IsValid())
+	{
+		return;
+	}
+	if (transport != nullptr)
 	{
+		transport->setCapture(nullptr);
+	}
+	_capture->close();
+	_capture.Reset();
+}
 
-		struct FDynamicArgs
-		{
-			USCJsonValue* Arg01 = nullptr;
-		};
+void USCClientSocket::setNetworkConditions(const FSCNetworkConditions& conditions)
+{
+	_networkConditions = MakeShared<FSCNetworkConditions>(conditions);
+	if (transport != nullptr)
+	{
+		transport->setNetworkConditions(_networkConditions);
+	}
+}
 
-		FDynamicArgs Args = FDynamicArgs();
+void USCClientSocket::clearNetworkConditions()
+{
+	_networkConditions.Reset();
+	if (transport != nullptr)
+	{
+		transport->setNetworkConditions(nullptr);
+	}
+}
 
-		const FString& FirstParam = Properties[0]->GetCPPType();
+void USCClientSocket::simulateDisconnect(int32 code)
+{
+	if (transport != nullptr && state != ESocketClusterState::CLOSED)
+	{
+		transport->simulateDisconnect(code);
+	}
+}
 
-		if (FirstParam.Equals("USCJsonValue*"))
-		{
-			USCJsonValue* Value = NewObject<USCJsonValue>();
-			Value->SetRootValue(data);
-			Args.Arg01 = Value;
-			handlerTarget->ProcessEvent(Function, &Args);
-		}
-		else
-		{
-			USCErrors::InvalidArgumentsError("On handler function '" + handler + "' parameters incorrect");
-			return;
-		}
+USCReplay* USCClientSocket::replay(const FString& path, float speed)
+{
+	if (!active)
+	{
+		TSharedPtr<FJsonValue> error = USCErrors::InvalidActionError("Cannot replay on a destroyed client");
+		_onSCError(error);
+		return nullptr;
 	}
-	else if (FunctionParams >= 2)
+
+	if (state != ESocketClusterState::CLOSED)
 	{
-		struct FDynamicArgs
-		{
-			USCJsonValue* Arg01 = nullptr;
-			USCResponse* Arg02 = nullptr;
-		};
+		TSharedPtr<FJsonValue> error = USCErrors::InvalidActionError("Cannot replay a capture while the client is connected");
+		_onSCError(error);
+		return nullptr;
+	}
 
-		FDynamicArgs Args = FDynamicArgs();
-		const FString& FirstParam = Properties[0]->GetCPPType();
-		const FString& SecondParam = Properties[1]->GetCPPType();
+	TArray<FSCCaptureRecord> records;
+	if (!FSCSocketCaptureReader::load(path, records))
+	{
+		TSharedPtr<FJsonValue> error = USCErrors::InvalidArgumentsError("Cannot read the capture " + path);
+		_onSCError(error);
+		return nullptr;
+	}
 
-		if (FirstParam.Equals("USCJsonValue*") && SecondParam.Equals("USCResponse*"))
-		{
-			if (res != nullptr)
-			{
-				USCJsonValue* Value = NewObject<USCJsonValue>();
-				Value->SetRootValue(data);
-				Args.Arg01 = Value;
-				Args.Arg02 = res;
-				handlerTarget->ProcessEvent(Function, &Args);
-			}
-			else
-			{
-				USCErrors::InvalidArgumentsError("Event '" + event + "' does not support a Response object");
-			}
-		}
-		else
-		{
-			USCErrors::InvalidArgumentsError("On handler function '" + handler + "' parameters incorrect");
-		}	
+	pendingReconnect = false;
+	pendingReconnectTimeout = 0.0f;
+	clearTimeout(_reconnectTimeoutHandle);
+
+	state = ESocketClusterState::CONNECTING;
+	if (Emitter.Contains("connecting") && Emitter.FindRef("connecting"))
+	{
+		Emitter.FindRef("connecting")(nullptr, nullptr);
+	}
+
+	_createTransport(true);
+
+	if (_replay != nullptr)
+	{
+		_replay->onfinished = nullptr;
+		_replay->stop();
 	}
+	_replay = NewObject<USCReplay>(this);
+	_replay->onfinished = [&]()
+	{
+		disconnect();
+	};
+	_replay->start(transport, MoveTemp(records), speed);
+	return _replay;
 }
 
-void USCClientSocket::on(FString event, TFunction<void(TSharedPtr<FJsonValue>, USCResponse*)> handler)
+void USCClientSocket::_emit(FString event, TSharedPtr<FJsonValue> data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback, TSharedPtr<FJsonObject> opts)
 {
-	Emitter.Add(event, handler);
+	SC_ACCOUNT_MESSAGE_TYPE(ESCMessageDirection::OUTBOUND, *event);
+
+	if (state == ESocketClusterState::CLOSED)
+	{
+		connect();
+	}
+
+	USCEventObject* eventObject = NewObject<USCEventObject>();
+	eventObject->event = event;
+	eventObject->callback = callback;
+	eventObject->data = data;
+	eventObject->timeout = FTimerDelegate::CreateUObject(this, &USCClientSocket::_handleEventAckTimeout, eventObject);
+	GetWorld()->GetTimerManager().SetTimer(eventObject->timeoutHandle, eventObject->timeout, options->GetNumberField("ackTimeout"), false);
+
+	double ttl;
+	if (opts.IsValid() && opts->TryGetNumberField("ttl", ttl) && ttl > 0.0)
+	{
+		eventObject->expiry = FPlatformTime::Seconds() + ttl;
+	}
+
+	_appendToEmitBuffer(eventObject);
+	if (state == ESocketClusterState::OPEN)
+	{
+		_flushEmitBuffer();
+	}
 }
 
-void USCClientSocket::off(FString event)
+void USCClientSocket::send(const FString& data)
 {
-	Emitter.Remove(event);
+	if (transport->IsValidLowLevel())
+	{
+		transport->send(data);
+	}
 }
 
-void USCClientSocket::publishBlueprint(const FString& channelName, USCJsonValue* data, const FString& callback, UObject* callbackTarget)
+void USCClientSocket::emitBlueprint(const FString& event, USCJsonValue* data, const FString& callback, UObject* callbackTarget, float ttl)
 {
 	TSharedPtr<FJsonValue> DataValue = nullptr;
 	if (data != nullptr)
@@ -1208,80 +1517,167 @@ void USCClientSocket::publishBlueprint(const FString& channelName, USCJsonValue*
 		DataValue = MakeShareable(new FJsonValueNull);
 	}
 
+	TSharedPtr<FJsonObject> opts = nullptr;
+	if (ttl > 0.0f)
+	{
+		opts = MakeShareable(new FJsonObject);
+		opts->SetNumberField("ttl", ttl);
+	}
+
 	if (!callback.IsEmpty())
 	{
-		publish(channelName, DataValue, [&, callback, callbackTarget, this](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+		FSCBlueprintBinding binding(callbackTarget, callback);
+		if (!binding.check("Emit", "callback", ESCBlueprintArgShape::VALUE_VALUE).IsValid())
 		{
-			publishBlueprintCallback(callback, callbackTarget, error, data);
-		});
+			emit(event, DataValue, [&, binding](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+			{
+				emitBlueprintCallback(binding, error, data);
+			}, opts);
+			return;
+		}
 	}
-	else
+	emit(event, DataValue, nullptr, opts);
+}
+
+void USCClientSocket::emitBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+{
+	if (!binding.call(error, data))
 	{
-		publish(channelName, DataValue);
+		USCErrors::InvalidActionError("Emit target not found for callback function '" + binding.name + "'");
 	}
 }
 
-void USCClientSocket::publishBlueprintCallback(const FString& callback, UObject* target, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+void USCClientSocket::emit(FString event, TSharedPtr<FJsonValue> data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback, TSharedPtr<FJsonObject> opts)
 {
-	if (!target->IsValidLowLevel())
+	if (!_localEvents.Contains(event))
 	{
-		USCErrors::InvalidActionError("Publish target not found for callback function '" + callback + "'");
-		return;
+		_emit(event, data, callback, opts);
 	}
-
-	UFunction* Function = target->FindFunction(FName(*callback));
-	if (nullptr == Function)
+	else if (event.Equals("error"))
 	{
-		USCErrors::InvalidActionError("Publish callback function '" + callback + "' not found");
-		return;
+		if (Emitter.Contains(event) && Emitter.FindRef(event))
+		{
+			Emitter.FindRef(event)(data, nullptr);
+		}
 	}
+	else
+	{
+		TSharedPtr<FJsonValue> error = USCErrors::InvalidActionError("The '" + event + "' event is reserved and cannot be emitted on a client socket");
+		_onSCError(error);
+	}
+}
 
-	TFieldIterator<UProperty> Iterator(Function);
-
-	TArray<UProperty*> Properties;
-	while (Iterator && (Iterator->PropertyFlags & CPF_Parm))
+void USCClientSocket::setLatestOnly(const FString& event, bool latestOnly)
+{
+	if (latestOnly)
+	{
+		_latestOnlyEvents.Add(event);
+	}
+	else
 	{
-		UProperty* Prop = *Iterator;
-		Properties.Add(Prop);
-		++Iterator;
+		_latestOnlyEvents.Remove(event);
+		_latestEmitBuffer.Remove(event);
 	}
+}
 
-	int32 FunctionParams = Properties.Num();
+int32 USCClientSocket::getEmitBufferLength()
+{
+	return _emitBufferLength;
+}
 
-	if(FunctionParams >= 2)
+void USCClientSocket::onBlueprint(const FString& event, const FString& handler, UObject* handlerTarget)
+{
+	if (!handler.IsEmpty())
 	{
+		FSCBlueprintBinding binding(handlerTarget, handler);
+		if (!binding.check("On", "handler", ESCBlueprintArgShape::VALUE, ESCBlueprintArgShape::VALUE_RESPONSE).IsValid())
+		{
+			on(event, [&, event, binding](TSharedPtr<FJsonValue> data, USCResponse* res) {
+				onBlueprintHandler(event, binding, data, res);
+			});
+		}
+	}
+}
 
-		struct FDynamicArgs
+void USCClientSocket::onBlueprintHandler(const FString& event, const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> data, USCResponse* res)
+{
+	if (binding.shape == ESCBlueprintArgShape::VALUE_RESPONSE)
+	{
+		if (res == nullptr)
+		{
+			USCErrors::InvalidArgumentsError("Event '" + event + "' does not support a Response object");
+		}
+		else if (!binding.call(data, res))
 		{
-			USCJsonValue* Arg01 = nullptr;
-			USCJsonValue* Arg02 = nullptr;
-		};
+			USCErrors::InvalidActionError("On target not found for handler function '" + binding.name + "'");
+		}
+	}
+	else if (!binding.call(data))
+	{
+		USCErrors::InvalidActionError("On target not found for handler function '" + binding.name + "'");
+	}
+}
 
-		FDynamicArgs Args = FDynamicArgs();
+void USCClientSocket::on(FString event, TFunction<void(TSharedPtr<FJsonValue>, USCResponse*)> handler)
+{
+	Emitter.Add(event, handler);
+}
 
-		const FString& FirstParam = Properties[0]->GetCPPType();
-		const FString& SecondParam = Properties[1]->GetCPPType();
+void USCClientSocket::onView(FString event, TFunction<void(const FSCJsonNode&, USCResponse*)> handler)
+{
+	if (!handler)
+	{
+		return;
+	}
+	_viewEmitter.Add(event, handler);
+	if (transport->IsValidLowLevel())
+	{
+		transport->useDocument = true;
+	}
+}
 
-		if (FirstParam.Equals("USCJsonValue*") && SecondParam.Equals("USCJsonValue*"))
-		{
-			USCJsonValue* ErrorValue = NewObject<USCJsonValue>();
-			ErrorValue->SetRootValue(error);
-			Args.Arg01 = ErrorValue;
+void USCClientSocket::off(FString event)
+{
+	Emitter.Remove(event);
+	_viewEmitter.Remove(event);
+	if (transport->IsValidLowLevel())
+	{
+		transport->useDocument = _viewEmitter.Num() > 0;
+	}
+}
 
-			USCJsonValue* DataValue = NewObject<USCJsonValue>();
-			DataValue->SetRootValue(data);
-			Args.Arg02 = DataValue;
+void USCClientSocket::publishBlueprint(const FString& channelName, USCJsonValue* data, const FString& callback, UObject* callbackTarget)
+{
+	TSharedPtr<FJsonValue> DataValue = nullptr;
+	if (data != nullptr)
+	{
+		DataValue = data->GetRootValue();
+	}
+	else
+	{
+		DataValue = MakeShareable(new FJsonValueNull);
+	}
 
-			target->ProcessEvent(Function, &Args);
-		}
-		else
+	if (!callback.IsEmpty())
+	{
+		FSCBlueprintBinding binding(callbackTarget, callback);
+		if (!binding.check("Publish", "callback", ESCBlueprintArgShape::VALUE_VALUE).IsValid())
 		{
-			USCErrors::InvalidArgumentsError("Publish callback function '" + callback + "' parameters incorrect");
+			publish(channelName, DataValue, [&, binding, this](TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+			{
+				publishBlueprintCallback(binding, error, data);
+			});
+			return;
 		}
 	}
-	else
+	publish(channelName, DataValue);
+}
+
+void USCClientSocket::publishBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+{
+	if (!binding.call(error, data))
 	{
-		USCErrors::InvalidArgumentsError("Publish callback function '" + callback + "' parameters incorrect");
+		USCErrors::InvalidActionError("Publish target not found for callback function '" + binding.name + "'");
 	}
 }
 
@@ -1649,10 +2045,14 @@ void USCClientSocket::watchBlueprint(const FString& channelName, const FString&
 {
 	if (!handler.IsEmpty())
 	{
-		watch(channelName, [&, handler, handlerTarget](TSharedPtr<FJsonValue> data)
+		FSCBlueprintBinding binding(handlerTarget, handler);
+		if (!binding.check("Watch", "handler", ESCBlueprintArgShape::VALUE, ESCBlueprintArgShape::STRING).IsValid())
 		{
-			watchBlueprintCallback(handler, handlerTarget, data);
-		});
+			watch(channelName, [&, binding](TSharedPtr<FJsonValue> data)
+			{
+				watchBlueprintCallback(binding, data);
+			});
+		}
 	}
 	else
 	{
@@ -1660,82 +2060,38 @@ void USCClientSocket::watchBlueprint(const FString& channelName, const FString&
 	}
 }
 
-void USCClientSocket::watchBlueprintCallback(const FString& handler, UObject* target, TSharedPtr<FJsonValue> data)
+void USCClientSocket::watchBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> data)
 {
-	if (!target->IsValidLowLevel())
+	if (!binding.call(data))
 	{
-		USCErrors::InvalidActionError("Watch target not found for handler function '" + handler + "'");
-		return;
+		USCErrors::InvalidActionError("Watch target not found for handler function '" + binding.name + "'");
 	}
+}
 
-	UFunction* Function = target->FindFunction(FName(*handler));
-	if (nullptr == Function)
+void USCClientSocket::watch(FString channelName, TFunction<void(TSharedPtr<FJsonValue>)> handler)
+{
+	if (!handler)
 	{
-		USCErrors::InvalidActionError("Watch handler function '" + handler + "' not found");
+		USCErrors::InvalidArgumentsError("No handler function was provided");
 		return;
 	}
-
-	TFieldIterator<UProperty> Iterator(Function);
-
-	TArray<UProperty*> Properties;
-	while (Iterator && (Iterator->PropertyFlags & CPF_Parm))
-	{
-		UProperty* Prop = *Iterator;
-		Properties.Add(Prop);
-		++Iterator;
-	}
-
-	int32 FunctionParams = Properties.Num();
-
-	if (FunctionParams >= 1)
-	{
-
-		struct FDynamicArgs
-		{
-			void* Arg01 = nullptr;
-		};
-
-		FDynamicArgs Args = FDynamicArgs();
-
-		const FString& FirstParam = Properties[0]->GetCPPType();
-
-		if (FirstParam.Equals("USCJsonValue*"))
-		{
-			USCJsonValue* DataValue = NewObject<USCJsonValue>();
-			DataValue->SetRootValue(data);
-			Args.Arg01 = DataValue;
-			target->ProcessEvent(Function, &Args);
-			
-		}
-		else if (FirstParam.Equals("FString"))
-		{
-			FString	StringValue = USCJsonConvert::ToJsonString(data);
-			target->ProcessEvent(Function, &StringValue);
-		}
-		else
-		{
-			USCErrors::InvalidArgumentsError("Watch handler function '" + handler + "' parameters incorrect");
-		}
-	}
-	else
-	{
-		USCErrors::InvalidArgumentsError("Watch handler function '" + handler + "' parameters incorrect");
-	}
+	_channelEmitter.Add(channelName, handler);
 }
 
-void USCClientSocket::watch(FString channelName, TFunction<void(TSharedPtr<FJsonValue>)> handler)
+void USCClientSocket::watchText(FString channelName, TFunction<void(TArrayView<const uint8>)> handler)
 {
 	if (!handler)
 	{
 		USCErrors::InvalidArgumentsError("No handler function was provided");
 		return;
 	}
-	_channelEmitter.Add(channelName, handler);
+	_channelTextEmitter.Add(channelName, handler);
 }
 
 void USCClientSocket::unwatch(const FString& channelName)
 {
 	_channelEmitter.Remove(channelName);
+	_channelTextEmitter.Remove(channelName);
 }
 
 TArray<TFunction<void(TSharedPtr<FJsonValue>)>> USCClientSocket::watchers(FString channelName)
@@ -0,0 +1,50 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCClientTrace.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Trace/Trace.h"
+
+#if UE_TRACE_ENABLED
+
+#if ENGINE_MINOR_VERSION >= 25
+UE_TRACE_CHANNEL(SocketClusterChannel)
+#define SC_TRACE_LOG(EventName, ...) UE_TRACE_LOG(SocketCluster, EventName, SocketClusterChannel, ##__VA_ARGS__)
+#else
+// Trace channels arrived in 4.25, before that every event is toggled on its own
+#define SC_TRACE_LOG(EventName, ...) UE_TRACE_LOG(SocketCluster, EventName, ##__VA_ARGS__)
+#endif
+
+UE_TRACE_EVENT_BEGIN(SocketCluster, EmitBegin)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int32, Cid)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(SocketCluster, EmitEnd)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int32, Cid)
+	UE_TRACE_EVENT_FIELD(uint8, Outcome)
+UE_TRACE_EVENT_END()
+
+#endif
+
+void FSCClientTrace::emitBegin(int32 cid, const FString& event)
+{
+#if UE_TRACE_ENABLED
+	// The event name is attached as TCHARs, with the terminator
+	const uint32 nameSize = (event.Len() + 1) * sizeof(TCHAR);
+	SC_TRACE_LOG(EmitBegin, nameSize)
+		<< EmitBegin.Cycle(FPlatformTime::Cycles64())
+		<< EmitBegin.Cid(cid)
+		<< EmitBegin.Attachment(*event, nameSize);
+#endif
+}
+
+void FSCClientTrace::emitEnd(int32 cid, ESCTraceEmitOutcome outcome)
+{
+#if UE_TRACE_ENABLED
+	SC_TRACE_LOG(EmitEnd)
+		<< EmitEnd.Cycle(FPlatformTime::Cycles64())
+		<< EmitEnd.Cid(cid)
+		<< EmitEnd.Outcome((uint8)outcome);
+#endif
+}
@@ -0,0 +1,26 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** How an emit which expected a response ended */
+enum class ESCTraceEmitOutcome : uint8
+{
+	ACK,
+	TIMEOUT,
+	ABORT,
+	CANCEL
+};
+
+/**
+* The SocketCluster trace events for Unreal Insights.
+* Every emit with a callback is traced from the moment it is sent until its cid is acknowledged, times out, is aborted or cancelled.
+* The events are only written while the SocketCluster trace channel (4.24: the SocketCluster events) is enabled.
+*/
+struct FSCClientTrace
+{
+	static void emitBegin(int32 cid, const FString& event);
+
+	static void emitEnd(int32 cid, ESCTraceEmitOutcome outcome);
+};
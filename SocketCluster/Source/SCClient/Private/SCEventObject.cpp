@@ -5,4 +5,9 @@
 USCEventObject::USCEventObject()
 {
 	cid = 0;
+	next = nullptr;
+	prev = nullptr;
+	buffered = false;
+	expiry = 0.0;
+	sentAt = 0.0;
 }
\ No newline at end of file
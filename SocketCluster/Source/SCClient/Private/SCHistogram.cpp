@@ -0,0 +1,118 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCHistogram.h"
+#include "SCJsonConvert.h"
+
+/** Number of bits used for the linear sub buckets of each power of two */
+static const int32 SCHistogramSubBucketBits = 5;
+static const uint64 SCHistogramSubBucketCount = 1ull << SCHistogramSubBucketBits;
+static const int32 SCHistogramExactLimit = (int32)SCHistogramSubBucketCount * 2;
+
+FSCHistogram::FSCHistogram()
+{
+	reset();
+}
+
+void FSCHistogram::record(uint64 value)
+{
+	int32 index = bucketIndex(value);
+	if (index >= buckets.Num())
+	{
+		buckets.AddZeroed(index + 1 - buckets.Num());
+	}
+	buckets[index]++;
+
+	if (count == 0 || value < minValue)
+	{
+		minValue = value;
+	}
+	if (value > maxValue)
+	{
+		maxValue = value;
+	}
+	count++;
+	total += value;
+}
+
+void FSCHistogram::reset()
+{
+	buckets.Empty();
+	count = 0;
+	total = 0;
+	minValue = 0;
+	maxValue = 0;
+}
+
+uint64 FSCHistogram::getPercentile(double percentile) const
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	uint64 target = (uint64)FMath::CeilToDouble(FMath::Clamp(percentile, 0.0, 100.0) / 100.0 * (double)count);
+	target = FMath::Max<uint64>(target, 1);
+
+	uint64 seen = 0;
+	for (int32 i = 0; i < buckets.Num(); i++)
+	{
+		seen += buckets[i];
+		if (seen >= target)
+		{
+			return FMath::Min(bucketUpperBound(i), maxValue);
+		}
+	}
+	return maxValue;
+}
+
+TSharedPtr<FJsonObject> FSCHistogram::toJson(bool includeBuckets) const
+{
+	TSharedPtr<FJsonObject> summary = MakeShareable(new FJsonObject);
+	summary->SetNumberField("count", count);
+	summary->SetNumberField("min", getMin());
+	summary->SetNumberField("max", getMax());
+	summary->SetNumberField("mean", getMean());
+	summary->SetNumberField("p50", getPercentile(50.0));
+	summary->SetNumberField("p90", getPercentile(90.0));
+	summary->SetNumberField("p99", getPercentile(99.0));
+	summary->SetNumberField("p999", getPercentile(99.9));
+
+	if (includeBuckets)
+	{
+		TArray<TSharedPtr<FJsonValue>> bucketList;
+		for (int32 i = 0; i < buckets.Num(); i++)
+		{
+			if (buckets[i] > 0)
+			{
+				TSharedPtr<FJsonObject> bucket = MakeShareable(new FJsonObject);
+				bucket->SetNumberField("le", bucketUpperBound(i));
+				bucket->SetNumberField("count", buckets[i]);
+				bucketList.Add(USCJsonConvert::ToJsonValue(bucket));
+			}
+		}
+		summary->SetArrayField("buckets", bucketList);
+	}
+	return summary;
+}
+
+int32 FSCHistogram::bucketIndex(uint64 value)
+{
+	if (value < (uint64)SCHistogramExactLimit)
+	{
+		return (int32)value;
+	}
+	int32 exponent = (int32)FMath::FloorLog2_64(value) - SCHistogramSubBucketBits;
+	uint64 mantissa = value >> exponent;
+	return SCHistogramExactLimit + (exponent - 1) * (int32)SCHistogramSubBucketCount + (int32)(mantissa - SCHistogramSubBucketCount);
+}
+
+uint64 FSCHistogram::bucketUpperBound(int32 index)
+{
+	if (index < SCHistogramExactLimit)
+	{
+		return (uint64)index;
+	}
+	int32 exponent = (index - SCHistogramExactLimit) / (int32)SCHistogramSubBucketCount + 1;
+	uint64 mantissa = (uint64)((index - SCHistogramExactLimit) % (int32)SCHistogramSubBucketCount) + SCHistogramSubBucketCount;
+	return (mantissa << exponent) + ((1ull << exponent) - 1);
+}
@@ -0,0 +1,171 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCMetrics.h"
+#include "SCJsonConvert.h"
+
+USCMetrics::USCMetrics()
+	: traffic(MakeShared<FSCSocketStats>())
+{
+	reconnects = 0;
+	ackTimeouts = 0;
+	sendQueueLength = 0;
+	pendingAckCount = 0;
+	emitBufferLength = 0;
+}
+
+void USCMetrics::recordEncode(uint64 cycles)
+{
+	encodeTime.record((uint64)(FPlatformTime::ToSeconds64(cycles) * 1000000000.0));
+}
+
+void USCMetrics::recordDecode(uint64 cycles)
+{
+	decodeTime.record((uint64)(FPlatformTime::ToSeconds64(cycles) * 1000000000.0));
+}
+
+void USCMetrics::recordAck(const FString& event, double seconds)
+{
+	ackLatency.FindOrAdd(event).record((uint64)FMath::Max(0.0, seconds * 1000000.0));
+}
+
+void USCMetrics::recordAckTimeout()
+{
+	ackTimeouts++;
+}
+
+void USCMetrics::recordReconnect()
+{
+	reconnects++;
+}
+
+void USCMetrics::setGauges(int32 sendQueue, int32 pendingAcks, int32 emitBuffer)
+{
+	sendQueueLength = sendQueue;
+	pendingAckCount = pendingAcks;
+	emitBufferLength = emitBuffer;
+}
+
+void USCMetrics::reset()
+{
+	*traffic = FSCSocketStats();
+	reconnects = 0;
+	ackTimeouts = 0;
+	encodeTime.reset();
+	decodeTime.reset();
+	ackLatency.Empty();
+}
+
+TSharedPtr<FJsonObject> USCMetrics::toJson(bool includeBuckets)
+{
+	_sample();
+
+	TSharedPtr<FJsonObject> snapshot = MakeShareable(new FJsonObject);
+	snapshot->SetNumberField("bytesSent", traffic->bytesSent);
+	snapshot->SetNumberField("bytesReceived", traffic->bytesReceived);
+	snapshot->SetNumberField("framesSent", traffic->framesSent);
+	snapshot->SetNumberField("framesReceived", traffic->framesReceived);
+	snapshot->SetNumberField("reconnects", reconnects);
+	snapshot->SetNumberField("ackTimeouts", ackTimeouts);
+	snapshot->SetNumberField("sendQueueLength", sendQueueLength);
+	snapshot->SetNumberField("pendingAckCount", pendingAckCount);
+	snapshot->SetNumberField("emitBufferLength", emitBufferLength);
+	snapshot->SetObjectField("encodeTime", encodeTime.toJson(includeBuckets));
+	snapshot->SetObjectField("decodeTime", decodeTime.toJson(includeBuckets));
+
+	TSharedPtr<FJsonObject> ackLatencies = MakeShareable(new FJsonObject);
+	for (auto& entry : ackLatency)
+	{
+		ackLatencies->SetObjectField(entry.Key, entry.Value.toJson(includeBuckets));
+	}
+	snapshot->SetObjectField("ackLatency", ackLatencies);
+	return snapshot;
+}
+
+USCJsonValue* USCMetrics::getSnapshotBlueprint(bool includeBuckets)
+{
+	USCJsonValue* Value = NewObject<USCJsonValue>();
+	Value->SetRootValue(USCJsonConvert::ToJsonValue(toJson(includeBuckets)));
+	return Value;
+}
+
+int64 USCMetrics::getBytesSent() const
+{
+	return (int64)traffic->bytesSent;
+}
+
+int64 USCMetrics::getBytesReceived() const
+{
+	return (int64)traffic->bytesReceived;
+}
+
+int64 USCMetrics::getFramesSent() const
+{
+	return (int64)traffic->framesSent;
+}
+
+int64 USCMetrics::getFramesReceived() const
+{
+	return (int64)traffic->framesReceived;
+}
+
+int32 USCMetrics::getReconnects() const
+{
+	return reconnects;
+}
+
+int32 USCMetrics::getAckTimeouts() const
+{
+	return ackTimeouts;
+}
+
+int32 USCMetrics::getSendQueueLength()
+{
+	_sample();
+	return sendQueueLength;
+}
+
+int32 USCMetrics::getPendingAckCount()
+{
+	_sample();
+	return pendingAckCount;
+}
+
+int32 USCMetrics::getEmitBufferLength()
+{
+	_sample();
+	return emitBufferLength;
+}
+
+USCJsonValue* USCMetrics::getEncodeTimeHistogramBlueprint()
+{
+	USCJsonValue* Value = NewObject<USCJsonValue>();
+	Value->SetRootValue(USCJsonConvert::ToJsonValue(encodeTime.toJson()));
+	return Value;
+}
+
+USCJsonValue* USCMetrics::getDecodeTimeHistogramBlueprint()
+{
+	USCJsonValue* Value = NewObject<USCJsonValue>();
+	Value->SetRootValue(USCJsonConvert::ToJsonValue(decodeTime.toJson()));
+	return Value;
+}
+
+USCJsonValue* USCMetrics::getAckLatencyHistogramBlueprint(const FString& event)
+{
+	const FSCHistogram* histogram = ackLatency.Find(event);
+	if (histogram == nullptr)
+	{
+		return nullptr;
+	}
+	USCJsonValue* Value = NewObject<USCJsonValue>();
+	Value->SetRootValue(USCJsonConvert::ToJsonValue(histogram->toJson()));
+	return Value;
+}
+
+void USCMetrics::_sample()
+{
+	if (onsample)
+	{
+		onsample();
+	}
+}
@@ -0,0 +1,192 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCReconnectPolicy.h"
+#include "SCJsonConvert.h"
+
+USCReconnectPolicy::USCReconnectPolicy()
+{
+	strategy = ESocketClusterReconnectStrategy::EXPONENTIAL;
+	initialDelay = 1.0f;
+	randomness = 1.0f;
+	multiplier = 1.0f;
+	maxDelay = 1.0f;
+	burstLimit = 0;
+	refillInterval = 10.0f;
+	throttledAttempts = 0;
+	tokens = 0.0;
+	lastRefill = FPlatformTime::Seconds();
+
+	// Jitter must differ between clients which restarted at the same time, so every policy gets its own seed
+	random.Initialize((int32)(FPlatformTime::Cycles() ^ (uint32)FPlatformProcess::GetCurrentProcessId() ^ (uint32)(UPTRINT)this));
+	reset();
+}
+
+void USCReconnectPolicy::setOptions(TSharedPtr<FJsonObject> reconnectOptions)
+{
+	if (!reconnectOptions.IsValid())
+	{
+		return;
+	}
+
+	initialDelay = reconnectOptions->GetNumberField("initialDelay");
+	randomness = reconnectOptions->GetNumberField("randomness");
+	multiplier = reconnectOptions->GetNumberField("multiplier");
+	maxDelay = reconnectOptions->GetNumberField("maxDelay");
+
+	if (reconnectOptions->HasField("strategy"))
+	{
+		strategy = USCJsonConvert::StringToEnum<ESocketClusterReconnectStrategy>("ESocketClusterReconnectStrategy", reconnectOptions->GetStringField("strategy"));
+	}
+	if (reconnectOptions->HasField("burstLimit"))
+	{
+		burstLimit = FMath::Max(0, (int32)reconnectOptions->GetNumberField("burstLimit"));
+	}
+	if (reconnectOptions->HasField("refillInterval"))
+	{
+		refillInterval = FMath::Max(0.0f, (float)reconnectOptions->GetNumberField("refillInterval"));
+	}
+
+	tokens = burstLimit;
+	lastRefill = FPlatformTime::Seconds();
+}
+
+float USCReconnectPolicy::nextDelay(int32 attempt, float initialDelayHint)
+{
+	float delay;
+	if (initialDelayHint >= 0.0f && attempt == 0)
+	{
+		delay = initialDelayHint;
+	}
+	else
+	{
+		delay = computeDelay(attempt, previousDelay);
+	}
+
+	delay = FMath::Clamp(delay, 0.0f, FMath::Max(maxDelay, 0.0f));
+
+	if (retryAfter > delay)
+	{
+		// Spread the clients over the window the server asked for instead of reconnecting all at its end
+		delay = retryAfter + random.FRandRange(0.0f, FMath::Max(retryAfter, initialDelay));
+	}
+	retryAfter = 0.0f;
+
+	delay = _takeToken(delay);
+
+	previousDelay = delay;
+	delayHistogram.record((uint64)FMath::RoundToDouble(delay * 1000.0f));
+	return delay;
+}
+
+float USCReconnectPolicy::computeDelay(int32 attempt, float lastDelay)
+{
+	switch (strategy)
+	{
+	case ESocketClusterReconnectStrategy::FULL_JITTER:
+	{
+		float ceiling = FMath::Min(maxDelay, initialDelay * FMath::Pow(multiplier, attempt));
+		return random.FRandRange(0.0f, ceiling);
+	}
+	case ESocketClusterReconnectStrategy::DECORRELATED_JITTER:
+	{
+		float upper = FMath::Max(initialDelay, lastDelay * 3.0f);
+		return FMath::Min(maxDelay, random.FRandRange(initialDelay, upper));
+	}
+	case ESocketClusterReconnectStrategy::EXPONENTIAL:
+	default:
+	{
+		float initialTimeout = initialDelay + randomness * random.FRand();
+		return initialTimeout * FMath::Pow(multiplier, attempt);
+	}
+	}
+}
+
+void USCReconnectPolicy::setRetryAfter(float seconds)
+{
+	retryAfter = FMath::Max(0.0f, seconds);
+}
+
+void USCReconnectPolicy::setRetryAfterFromReason(const FString& reason)
+{
+	if (reason.IsEmpty())
+	{
+		return;
+	}
+
+	TSharedPtr<FJsonValue> value = USCJsonConvert::JsonStringToJsonValue(reason);
+	if (value.IsValid() && value->Type == EJson::Object)
+	{
+		double seconds;
+		if (value->AsObject()->TryGetNumberField("retryAfter", seconds))
+		{
+			setRetryAfter(seconds);
+		}
+	}
+	else if (value.IsValid() && value->Type == EJson::Number)
+	{
+		setRetryAfter(value->AsNumber());
+	}
+}
+
+void USCReconnectPolicy::recordConnected(int32 attempts)
+{
+	attemptHistogram.record(FMath::Max(0, attempts));
+	reset();
+}
+
+void USCReconnectPolicy::reset()
+{
+	previousDelay = initialDelay;
+	retryAfter = 0.0f;
+}
+
+float USCReconnectPolicy::_takeToken(float delay)
+{
+	if (burstLimit <= 0)
+	{
+		return delay;
+	}
+
+	double now = FPlatformTime::Seconds();
+	double attemptTime = now + delay;
+	double available = tokens;
+	if (refillInterval > 0.0f && attemptTime > lastRefill)
+	{
+		available = FMath::Min<double>(burstLimit, tokens + (attemptTime - lastRefill) / refillInterval);
+	}
+
+	if (available >= 1.0)
+	{
+		tokens = available - 1.0;
+		lastRefill = FMath::Max(lastRefill, attemptTime);
+		return delay;
+	}
+
+	// Not enough tokens at the planned attempt time, push the attempt back until one has been refilled
+	float wait = refillInterval > 0.0f ? (float)((1.0 - available) * refillInterval) : maxDelay;
+	throttledAttempts++;
+	tokens = 0.0;
+	lastRefill = attemptTime + wait;
+	return delay + wait;
+}
+
+USCJsonValue* USCReconnectPolicy::getAttemptHistogramBlueprint()
+{
+	USCJsonValue* Value = NewObject<USCJsonValue>();
+	TSharedPtr<FJsonValue> histogram = USCJsonConvert::ToJsonValue(attemptHistogram.toJson());
+	Value->SetRootValue(histogram);
+	return Value;
+}
+
+USCJsonValue* USCReconnectPolicy::getDelayHistogramBlueprint()
+{
+	USCJsonValue* Value = NewObject<USCJsonValue>();
+	TSharedPtr<FJsonValue> histogram = USCJsonConvert::ToJsonValue(delayHistogram.toJson());
+	Value->SetRootValue(histogram);
+	return Value;
+}
+
+int32 USCReconnectPolicy::getThrottledAttempts()
+{
+	return throttledAttempts;
+}
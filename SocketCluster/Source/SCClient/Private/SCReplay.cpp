@@ -0,0 +1,114 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCReplay.h"
+#include "SCTransport.h"
+#include "SCClientModule.h"
+
+USCReplay::USCReplay()
+	: transport(nullptr)
+	, index(0)
+	, speed(1.0f)
+	, running(false)
+	, startTime(0.0)
+	, framesReplayed(0)
+	, bytesReplayed(0)
+	, handlingTime(0.0)
+{
+}
+
+void USCReplay::start(USCTransport* replayTransport, TArray<FSCCaptureRecord>&& replayRecords, float replaySpeed)
+{
+	transport = replayTransport;
+	records.Reset();
+	for (FSCCaptureRecord& record : replayRecords)
+	{
+		if (record.direction == ESCCaptureDirection::INBOUND)
+		{
+			records.Add(MoveTemp(record));
+		}
+	}
+
+	// The replay clock starts at the first inbound frame, the time before it was spent connecting
+	const double origin = records.Num() > 0 ? records[0].time : 0.0;
+	for (FSCCaptureRecord& record : records)
+	{
+		record.time -= origin;
+	}
+
+	index = 0;
+	speed = replaySpeed;
+	running = true;
+	startTime = 0.0;
+	framesReplayed = 0;
+	bytesReplayed = 0;
+	handlingTime = 0.0;
+}
+
+void USCReplay::stop()
+{
+	if (running)
+	{
+		index = records.Num();
+		_finish();
+	}
+}
+
+float USCReplay::getProgress() const
+{
+	return records.Num() > 0 ? (float)index / records.Num() : 1.0f;
+}
+
+void USCReplay::Tick(float DeltaTime)
+{
+	if (transport == nullptr || transport->getState() == ESocketClusterState::CLOSED)
+	{
+		_finish();
+		return;
+	}
+
+	// The offline transport sends its handshake on the tick after it was created, the replay clock starts after it
+	if (startTime == 0.0)
+	{
+		startTime = FPlatformTime::Seconds();
+		return;
+	}
+
+	const double elapsed = speed > 0.0f ? (FPlatformTime::Seconds() - startTime) * speed : TNumericLimits<double>::Max();
+	const double tickStart = FPlatformTime::Seconds();
+	while (running && index < records.Num() && records[index].time <= elapsed)
+	{
+		const FSCCaptureRecord& record = records[index++];
+		framesReplayed++;
+		bytesReplayed += record.payload.Num();
+		transport->receiveOffline(record.payload, record.binary);
+		if (transport->getState() == ESocketClusterState::CLOSED)
+		{
+			break;
+		}
+	}
+	handlingTime += FPlatformTime::Seconds() - tickStart;
+
+	if (index >= records.Num() || transport->getState() == ESocketClusterState::CLOSED)
+	{
+		_finish();
+	}
+}
+
+TStatId USCReplay::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USCReplay, STATGROUP_SocketCluster);
+}
+
+void USCReplay::_finish()
+{
+	if (!running)
+	{
+		return;
+	}
+	running = false;
+	UE_LOG(LogSCClient, Log, TEXT("Replayed %d frames (%llu bytes) in %.3f seconds, %.3f seconds handling them"), framesReplayed, bytesReplayed, FPlatformTime::Seconds() - startTime, handlingTime);
+	if (onfinished)
+	{
+		onfinished();
+	}
+}
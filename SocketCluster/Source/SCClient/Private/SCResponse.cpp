@@ -21,7 +21,7 @@ void USCResponse::_respond(TSharedPtr<FJsonValue> responseData)
 	else
 	{
 		sent = true;
-		socket->send(socket->encode(responseData));
+		socket->sendObject(responseData);
 	}
 }
 
@@ -0,0 +1,66 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCRttEstimator.h"
+
+/** The gains of RFC 6298, alpha = 1/8 and beta = 1/4 */
+static const double SCRttAlpha = 0.125;
+static const double SCRttBeta = 0.25;
+
+/** The timeout covers the smoothed RTT plus four mean deviations */
+static const double SCRttDeviations = 4.0;
+
+/** The timer granularity, the deviation term never goes below it */
+static const double SCRttGranularity = 0.01;
+
+/** The timeout is doubled at most six times, 64 times the estimate */
+static const int32 SCRttMaxBackoffShift = 6;
+
+FSCRttEstimator::FSCRttEstimator()
+{
+	minTimeout = 0.2;
+	maxTimeout = 60.0;
+	reset();
+}
+
+void FSCRttEstimator::sample(double rtt)
+{
+	rtt = FMath::Max(0.0, rtt);
+	if (sampleCount == 0)
+	{
+		smoothedRtt = rtt;
+		rttVariance = rtt / 2.0;
+	}
+	else
+	{
+		rttVariance = (1.0 - SCRttBeta) * rttVariance + SCRttBeta * FMath::Abs(smoothedRtt - rtt);
+		smoothedRtt = (1.0 - SCRttAlpha) * smoothedRtt + SCRttAlpha * rtt;
+	}
+	latestRtt = rtt;
+	sampleCount++;
+	backoffShift = 0;
+}
+
+void FSCRttEstimator::backoff()
+{
+	backoffShift = FMath::Min(backoffShift + 1, SCRttMaxBackoffShift);
+}
+
+void FSCRttEstimator::reset()
+{
+	smoothedRtt = 0.0;
+	rttVariance = 0.0;
+	latestRtt = 0.0;
+	sampleCount = 0;
+	backoffShift = 0;
+}
+
+double FSCRttEstimator::getTimeout(double fallback) const
+{
+	if (sampleCount == 0)
+	{
+		return fallback;
+	}
+	double timeout = smoothedRtt + FMath::Max(SCRttGranularity, SCRttDeviations * rttVariance);
+	timeout *= (double)(1 << backoffShift);
+	return FMath::Clamp(timeout, minTimeout, FMath::Max(minTimeout, maxTimeout));
+}
@@ -6,6 +6,8 @@
 #include "SCSocket.h"
 #include "Runtime/Engine/Classes/Kismet/KismetSystemLibrary.h"
 #include "SCClientModule.h"
+#include "SCClientTrace.h"
+#include "SCMessageAccounting.h"
 
 void USCTransport::BeginDestroy()
 {
@@ -18,7 +20,7 @@ UWorld* USCTransport::GetWorld() const
 	return GetOuter()->GetWorld();
 }
 
-void USCTransport::create(USCAuthEngine* authEngine, USCCodecEngine* codecEngine, TSharedPtr<FJsonObject> opts)
+void USCTransport::create(USCAuthEngine* authEngine, USCCodecEngine* codecEngine, TSharedPtr<FJsonObject> opts, bool offline)
 {
 	state = ESocketClusterState::CLOSED;
 	auth = authEngine;
@@ -39,7 +41,23 @@ void USCTransport::create(USCAuthEngine* authEngine, USCCodecEngine* codecEngine
 	FString url = uri();
 
 	socket = NewObject<USCSocket>(this);
-	socket->createWebSocket(url, options);
+	if (metrics != nullptr)
+	{
+		socket->stats = metrics->traffic;
+	}
+	socket->capture = capture;
+	if (networkConditions.IsValid())
+	{
+		socket->simulate(*networkConditions);
+	}
+	if (offline)
+	{
+		socket->openOffline();
+	}
+	else
+	{
+		socket->createWebSocket(url, options);
+	}
 	
 	socket->onopen = [&]()
 	{
@@ -60,9 +78,9 @@ void USCTransport::create(USCAuthEngine* authEngine, USCCodecEngine* codecEngine
 		_onClose(code, Event->GetStringField("reason"));
 	};
 
-	socket->onmessage = [&](const FString& Message)
+	socket->ondata = [&](const TArray<uint8>& Data, bool bBinary)
 	{
-		_onMessage(Message);
+		_onData(Data, bBinary);
 	};
 
 	socket->onerror = [&](const TSharedPtr<FJsonValue> Error)
@@ -79,6 +97,62 @@ void USCTransport::create(USCAuthEngine* authEngine, USCCodecEngine* codecEngine
 		socket->close(4007);
 	});
 	GetWorld()->GetTimerManager().SetTimer(_connectTimeoutHandle,_connectTimeoutRef, connectTimeout, false);
+
+	if (offline)
+	{
+		// Opened on the next tick, like a connection, so the owner can bind its handlers first
+		GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &USCTransport::_onOfflineOpen));
+	}
+}
+
+void USCTransport::_onOfflineOpen()
+{
+	if (state == ESocketClusterState::CONNECTING)
+	{
+		_onOpen();
+	}
+}
+
+void USCTransport::receiveOffline(const TArray<uint8>& message, bool binary)
+{
+	if (socket != nullptr)
+	{
+		socket->receiveOffline(message, binary);
+	}
+}
+
+void USCTransport::setCapture(TSharedPtr<FSCSocketCapture> newCapture)
+{
+	capture = newCapture;
+	if (socket != nullptr)
+	{
+		socket->capture = capture;
+	}
+}
+
+void USCTransport::setNetworkConditions(TSharedPtr<FSCNetworkConditions> conditions)
+{
+	networkConditions = conditions;
+	if (socket == nullptr)
+	{
+		return;
+	}
+	if (networkConditions.IsValid())
+	{
+		socket->simulate(*networkConditions);
+	}
+	else
+	{
+		socket->stopSimulating();
+	}
+}
+
+void USCTransport::simulateDisconnect(int32 code)
+{
+	if (socket != nullptr && state != ESocketClusterState::CLOSED)
+	{
+		socket->simulateDisconnect(code);
+	}
 }
 
 FString USCTransport::uri()
@@ -185,6 +259,7 @@ void USCTransport::_abortAllPendingEventsDueToBadConnection(FString failureType)
 	for (auto& i : _callbackMaplocal)
 	{
 		USCEventObject* eventObject = _callbackMap.FindAndRemoveChecked(i.Key);
+		FSCClientTrace::emitEnd(i.Key, ESCTraceEmitOutcome::ABORT);
 
 		clearTimeout(eventObject->timeoutHandle);
 
@@ -200,7 +275,7 @@ void USCTransport::_onClose(int32 code, FString data)
 {
 	socket->onopen = nullptr;
 	socket->onclose = nullptr;
-	socket->onmessage = nullptr;
+	socket->ondata = nullptr;
 	socket->onerror = nullptr;
 
 	clearTimeout(_connectTimeoutHandle);
@@ -221,10 +296,12 @@ void USCTransport::_onClose(int32 code, FString data)
 	}
 }
 
-void USCTransport::_handleEventObject(TSharedPtr<FJsonObject> obj, FString message)
+void USCTransport::_handleEventObject(TSharedPtr<FJsonObject> obj, const TArray<uint8>& message, bool binary)
 {
+	SCOPE_CYCLE_COUNTER(STAT_SCHandleEvent);
 	if (obj.IsValid() && obj->HasField("event"))
 	{
+		SC_NAME_MESSAGE([&]() { return obj->GetStringField("event"); });
 		USCResponse* response = nullptr;
 		if (obj->HasField("cid"))
 		{
@@ -235,12 +312,23 @@ void USCTransport::_handleEventObject(TSharedPtr<FJsonObject> obj, FString messa
 	}
 	else if (obj.IsValid() && obj->HasField("rid"))
 	{
+		SC_NAME_MESSAGE(TEXT("#response"));
 		USCEventObject* eventObject = _callbackMap.FindRef(obj->GetNumberField("rid"));
 		if (eventObject != nullptr)
 		{
 			clearTimeout(eventObject->timeoutHandle);
 			int32 rid = obj->GetNumberField("rid");
 			_callbackMap.Remove(rid);
+			FSCClientTrace::emitEnd(rid, ESCTraceEmitOutcome::ACK);
+			const double roundTrip = FPlatformTime::Seconds() - eventObject->sentAt;
+			if (metrics != nullptr)
+			{
+				metrics->recordAck(eventObject->event, roundTrip);
+			}
+			if (rtt.IsValid())
+			{
+				rtt->sample(roundTrip);
+			}
 			if (eventObject->callback)
 			{
 				TSharedPtr<FJsonValue> rehydratedError = nullptr;
@@ -262,18 +350,54 @@ void USCTransport::_handleEventObject(TSharedPtr<FJsonObject> obj, FString messa
 	}
 	else
 	{
-		onevent("raw", USCJsonConvert::ToJsonValue(message), nullptr);
+		SC_NAME_MESSAGE(TEXT("raw"));
+		onevent("raw", _rawMessage(message, binary), nullptr);
+	}
+}
+
+TSharedPtr<FJsonValue> USCTransport::_rawMessage(const TArray<uint8>& message, bool binary)
+{
+	if (binary)
+	{
+		return USCJsonConvert::ToJsonValue(message);
 	}
+	FUTF8ToTCHAR converted((const ANSICHAR*)message.GetData(), message.Num());
+	SC_ACCOUNT_TRANSCODE(message.Num());
+	return USCJsonConvert::ToJsonValue(FString(converted.Length(), converted.Get()));
 }
 
-void USCTransport::_onMessage(FString message)
+void USCTransport::_onData(const TArray<uint8>& message, bool binary)
 {
-	onevent("message", USCJsonConvert::ToJsonValue(message), nullptr);
+	// The raw message is only converted when somebody listens for it
+	if (!haslistener || haslistener("message"))
+	{
+		onevent("message", _rawMessage(message, binary), nullptr);
+	}
 
-	TSharedPtr<FJsonValue> obj = decode(message);
+	if (useDocument && oneventview && !_documentInUse && _wantsDocument(message, binary) && _onDocument(message, binary))
+	{
+		return;
+	}
+
+	TSharedPtr<FJsonValue> obj;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SCCodecDecode);
+		const uint64 decodeStart = FPlatformTime::Cycles64();
+		obj = codec->decode(TArrayView<const uint8>(message), binary ? ESCCodecFrame::BINARY : ESCCodecFrame::TEXT);
+		if (metrics != nullptr)
+		{
+			metrics->recordDecode(FPlatformTime::Cycles64() - decodeStart);
+		}
+	}
+	if (!obj.IsValid())
+	{
+		_handleEventObject(nullptr, message, binary);
+		return;
+	}
 
 	if (options->GetNumberField("protocolVersion") == 1 && obj->Type == EJson::String && obj->AsString().Equals("#1"))
 	{
+		SC_NAME_MESSAGE(TEXT("#ping"));
 		_resetPingTimeout();
 		if (socket->readyState == ESocketState::OPEN)
 		{
@@ -282,6 +406,7 @@ void USCTransport::_onMessage(FString message)
 	}
 	else if(options->GetNumberField("protocolVersion") == 2 && obj->Type == EJson::Null && obj->IsNull())
 	{
+		SC_NAME_MESSAGE(TEXT("#ping"));
 		_resetPingTimeout();
 		if (socket->readyState == ESocketState::OPEN)
 		{
@@ -295,18 +420,90 @@ void USCTransport::_onMessage(FString message)
 			TArray<TSharedPtr<FJsonValue>> array = obj->AsArray();
 			for (int32 i = 0; i != array.Num(); ++i)
 			{
-				TSharedPtr<FJsonObject> objItem = array[i]->AsObject();
-				_handleEventObject(objItem, message);
+				TSharedPtr<FJsonObject> objItem = array[i]->Type == EJson::Object ? array[i]->AsObject() : nullptr;
+				_handleEventObject(objItem, message, binary);
 			}
 		}
 		else
 		{
-			TSharedPtr<FJsonObject> Item = obj->AsObject();
-			_handleEventObject(Item, message);
+			TSharedPtr<FJsonObject> Item = obj->Type == EJson::Object ? obj->AsObject() : nullptr;
+			_handleEventObject(Item, message, binary);
 		}	
 	}
 }
 
+bool USCTransport::_wantsDocument(const TArray<uint8>& message, bool binary)
+{
+	// Events without a view handler would be parsed into the arena only to be copied out again
+	FString event;
+	if (!haseventview || !codec->peekEvent(TArrayView<const uint8>(message), binary ? ESCCodecFrame::BINARY : ESCCodecFrame::TEXT, event))
+	{
+		return true;
+	}
+	return haseventview(event);
+}
+
+bool USCTransport::_onDocument(const TArray<uint8>& message, bool binary)
+{
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SCCodecDecode);
+		const uint64 decodeStart = FPlatformTime::Cycles64();
+		if (!codec->decode(TArrayView<const uint8>(message), binary ? ESCCodecFrame::BINARY : ESCCodecFrame::TEXT, _document))
+		{
+			return false;
+		}
+		if (metrics != nullptr)
+		{
+			metrics->recordDecode(FPlatformTime::Cycles64() - decodeStart);
+		}
+	}
+
+	// Pings and other non packet frames are left to the FJsonValue path
+	const FSCJsonNode& root = _document.GetRoot();
+	if (!root.IsObject() && !root.IsArray())
+	{
+		_document.Reset();
+		return false;
+	}
+
+	_documentInUse = true;
+	if (root.IsArray())
+	{
+		for (int32 i = 0; i < root.Num(); ++i)
+		{
+			_handleEventNode(root[i], message, binary);
+		}
+	}
+	else
+	{
+		_handleEventNode(root, message, binary);
+	}
+	_documentInUse = false;
+
+	// Every node of the frame is released at once
+	_document.Reset();
+	return true;
+}
+
+void USCTransport::_handleEventNode(const FSCJsonNode& packet, const TArray<uint8>& message, bool binary)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SCHandleEvent);
+	const FSCJsonNode* event = packet.FindField(TEXT("event"));
+	if (event != nullptr && event->IsString())
+	{
+		SC_NAME_MESSAGE([event]() { return event->AsString(); });
+		const FSCJsonNode* cid = packet.FindField(TEXT("cid"));
+		if (oneventview(event->AsString(), packet.GetField(TEXT("data")), cid != nullptr ? (int32)cid->AsNumber() : 0))
+		{
+			return;
+		}
+	}
+
+	// Everything else is promoted and handled like a frame decoded without a document
+	TSharedPtr<FJsonValue> value = packet.ToJsonValue();
+	_handleEventObject(value->Type == EJson::Object ? value->AsObject() : nullptr, message, binary);
+}
+
 void USCTransport::_onError(TSharedPtr<FJsonValue> err)
 {
 	onerror(err);
@@ -341,9 +538,14 @@ void USCTransport::close(int32 code, TSharedPtr<FJsonValue> data)
 		TSharedPtr<FJsonObject> dataobj = MakeShareable(new FJsonObject);
 		dataobj->SetStringField("event", "#disconnect");
 		dataobj->SetObjectField("data", packet);
-		FString str = serializeObject(USCJsonConvert::ToJsonValue(dataobj));
-		
-		socket->send(str);
+		FSCSocketFrame frame;
+		USCSocket::beginFrame(frame);
+		{
+			SCOPE_CYCLE_COUNTER(STAT_SCCodecEncode);
+			FSCByteWriter writer(frame.payload);
+			frame.binary = codec->encodeTo(USCJsonConvert::ToJsonValue(dataobj), writer) == ESCCodecFrame::BINARY;
+		}
+		socket->sendFrame(frame);
 
 		_onClose(code, data.IsValid() ? USCJsonConvert::ToJsonString(data) : "");
 		socket->close(code);
@@ -357,6 +559,7 @@ void USCTransport::close(int32 code, TSharedPtr<FJsonValue> data)
 
 int32 USCTransport::emitObject(USCEventObject* eventObject, TSharedPtr<FJsonObject> opts)
 {
+	SC_ACCOUNT_MESSAGE_TYPE(ESCMessageDirection::OUTBOUND, *eventObject->event);
 	TSharedPtr<FJsonObject> simpleEventObject = MakeShareable(new FJsonObject);
 	simpleEventObject->SetStringField("event", eventObject->event);
 	if (eventObject->data.IsValid())
@@ -368,8 +571,10 @@ int32 USCTransport::emitObject(USCEventObject* eventObject, TSharedPtr<FJsonObje
 	if (eventObject->callback)
 	{
 		eventObject->cid = callIdGenerator();
+		eventObject->sentAt = FPlatformTime::Seconds();
 		simpleEventObject->SetNumberField("cid", eventObject->cid);
 		_callbackMap.Add(eventObject->cid, eventObject);
+		FSCClientTrace::emitBegin(eventObject->cid, eventObject->event);
 	}
 
 	sendObject(USCJsonConvert::ToJsonValue(simpleEventObject), opts);
@@ -382,10 +587,21 @@ void USCTransport::_handleEventAckTimeout(USCEventObject* eventObject)
 	if (eventObject->cid != 0)
 	{
 		_callbackMap.Remove(eventObject->cid);
+		FSCClientTrace::emitEnd(eventObject->cid, ESCTraceEmitOutcome::TIMEOUT);
 	}
 
 	clearTimeout(eventObject->timeoutHandle);
 
+	if (metrics != nullptr)
+	{
+		metrics->recordAckTimeout();
+	}
+
+	if (rtt.IsValid())
+	{
+		rtt->backoff();
+	}
+
 	TFunction<void(TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)> callback = eventObject->callback;
 	if (callback)
 	{
@@ -408,7 +624,8 @@ int32 USCTransport::emit(FString event, TSharedPtr<FJsonValue> data, TSharedPtr<
 	if (callback && !opts->HasField("noTimeout"))
 	{
 		eventObject->timeout = FTimerDelegate::CreateUObject(this, &USCTransport::_handleEventAckTimeout, eventObject);
-		GetWorld()->GetTimerManager().SetTimer(eventObject->timeoutHandle, eventObject->timeout, options->GetNumberField("ackTimeout"), false);
+		const double ackTimeout = options->GetNumberField("ackTimeout");
+		GetWorld()->GetTimerManager().SetTimer(eventObject->timeoutHandle, eventObject->timeout, adaptiveAckTimeout && rtt.IsValid() ? rtt->getTimeout(ackTimeout) : ackTimeout, false);
 	}
 
 	int32 cid = 0;
@@ -421,7 +638,10 @@ int32 USCTransport::emit(FString event, TSharedPtr<FJsonValue> data, TSharedPtr<
 
 void USCTransport::cancelPendingResponse(int32 cid)
 {
-	_callbackMap.Remove(cid);
+	if (_callbackMap.Remove(cid) > 0)
+	{
+		FSCClientTrace::emitEnd(cid, ESCTraceEmitOutcome::CANCEL);
+	}
 }
 
 TSharedPtr<FJsonValue> USCTransport::decode(FString message)
@@ -436,6 +656,7 @@ FString USCTransport::encode(TSharedPtr<FJsonValue> object)
 
 void USCTransport::send(FString data)
 {
+	SC_ACCOUNT_MESSAGE_TYPE(ESCMessageDirection::OUTBOUND, TEXT("raw"));
 	if (socket->readyState != ESocketState::OPEN)
 	{
 		_onClose(1005);
@@ -446,10 +667,34 @@ void USCTransport::send(FString data)
 	}
 }
 
-FString USCTransport::serializeObject(TSharedPtr<FJsonValue> object)
+void USCTransport::sendEncoded(TSharedPtr<FJsonValue> object)
 {
-	FString str = encode(object);
-	return str;
+	if (socket->readyState != ESocketState::OPEN)
+	{
+		_onClose(1005);
+		return;
+	}
+
+	// The codec writes straight into the queued socket frame
+	SCOPE_CYCLE_COUNTER(STAT_SCCodecEncode);
+	const uint64 encodeStart = FPlatformTime::Cycles64();
+	FSCSocketFrame& frame = socket->bufferFrame();
+	FSCByteWriter writer(frame.payload);
+	frame.binary = codec->encodeTo(object, writer) == ESCCodecFrame::BINARY;
+	if (metrics != nullptr)
+	{
+		metrics->recordEncode(FPlatformTime::Cycles64() - encodeStart);
+	}
+}
+
+int32 USCTransport::getSendQueueLength() const
+{
+	return socket != nullptr ? socket->getQueuedFrameCount() : 0;
+}
+
+int32 USCTransport::getPendingAckCount() const
+{
+	return _callbackMap.Num();
 }
 
 void USCTransport::sendObjectBatch(TSharedPtr<FJsonValue> object)
@@ -465,25 +710,41 @@ void USCTransport::sendObjectBatch(TSharedPtr<FJsonValue> object)
 		clearTimeout(_batchTimeoutHandle);
 		if (_batchSendList.Num() > 0)
 		{
-			FString str = serializeObject(USCJsonConvert::ToJsonValue(_batchSendList));
-			if (!str.IsEmpty())
-			{
-				send(str);
-			}
+			SC_ACCOUNT_MESSAGE_TYPE(ESCMessageDirection::OUTBOUND, TEXT("#batch"));
+			sendEncoded(USCJsonConvert::ToJsonValue(_batchSendList));
 			_batchSendList.Empty();
 		}
 	});
-	GetWorld()->GetTimerManager().SetTimer(_batchTimeoutHandle, _batchTimeout, options->GetNumberField("pubSubBatchDuration") || 0, false);
+	// A zero duration batches everything sent until the next tick, SetTimer would clear the timer instead
+	const float batchDuration = options->GetNumberField("pubSubBatchDuration");
+	if (batchDuration > 0.0f)
+	{
+		GetWorld()->GetTimerManager().SetTimer(_batchTimeoutHandle, _batchTimeout, batchDuration, false);
+	}
+	else
+	{
+		_batchTimeoutHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(_batchTimeout);
+	}
 }
 
 void USCTransport::sendObjectSingle(TSharedPtr<FJsonValue> object)
 {
-	FString str = serializeObject(object);
-	send(str);
+	sendEncoded(object);
 }
 
 void USCTransport::sendObject(TSharedPtr<FJsonValue> object, TSharedPtr<FJsonObject> opts)
 {
+	// Emits are already named, this names responses and pongs
+	SC_ACCOUNT_MESSAGE(ESCMessageDirection::OUTBOUND);
+	SC_NAME_MESSAGE([&]()
+	{
+		if (object->Type != EJson::Object)
+		{
+			return FString("#pong");
+		}
+		FString event;
+		return object->AsObject()->TryGetStringField("event", event) ? event : FString(object->AsObject()->HasField("rid") ? "#response" : "unknown");
+	});
 	if (opts.IsValid() && opts->HasField("batch"))
 	{
 		sendObjectBatch(object);
@@ -0,0 +1,82 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "SCJsonObject.h"
+
+class USCResponse;
+
+/** The parameter layouts supported by Blueprint callbacks and handlers */
+enum class ESCBlueprintArgShape : uint8
+{
+	/** The function was not found or its parameters are not supported */
+	NONE,
+	/** (USCJsonValue* data) */
+	VALUE,
+	/** (USCJsonValue* error, USCJsonValue* data) */
+	VALUE_VALUE,
+	/** (USCJsonValue* data, USCResponse* res) */
+	VALUE_RESPONSE,
+	/** (FString data) */
+	STRING
+};
+
+/**
+* A Blueprint function resolved when the callback or handler is registered.
+* The function lookup and the parameter validation happen once, invoking the binding only checks that the target is still alive.
+*/
+struct SCCLIENT_API FSCBlueprintBinding
+{
+	FSCBlueprintBinding();
+
+	/**
+	* Looks up the function on the target and classifies its parameters.
+	*
+	* @param target			The object which owns the function.
+	* @param functionName	The name of the function.
+	*/
+	FSCBlueprintBinding(UObject* target, const FString& functionName);
+
+	/** The name of the bound function */
+	FString name;
+
+	/** The object which owns the function */
+	TWeakObjectPtr<UObject> target;
+
+	/** The resolved function */
+	TWeakObjectPtr<UFunction> function;
+
+	/** The parameter layout of the function */
+	ESCBlueprintArgShape shape;
+
+	/** Whether or not the target was valid when the binding was created */
+	bool hasTarget() const { return bHadTarget; }
+
+	/** Whether or not the function was found on the target */
+	bool hasFunction() const { return function.IsValid(); }
+
+	/**
+	* Returns an InvalidActionError or InvalidArgumentsError describing why the binding can not be invoked, nullptr if it can.
+	*
+	* @param action			The action used in the error message, e.g. Emit.
+	* @param role			The role of the function used in the error message, callback or handler.
+	* @param expected		The parameter layout the caller invokes the function with.
+	* @param alternative	Optional, A second parameter layout the caller supports.
+	*/
+	TSharedPtr<FJsonValue> check(const FString& action, const FString& role, ESCBlueprintArgShape expected, ESCBlueprintArgShape alternative = ESCBlueprintArgShape::NONE) const;
+
+	/** Invoke a VALUE or STRING function, returns false if the target is gone or the shape does not match */
+	bool call(TSharedPtr<FJsonValue> data) const;
+
+	/** Invoke a VALUE_VALUE function, returns false if the target is gone or the shape does not match */
+	bool call(TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data) const;
+
+	/** Invoke a VALUE_RESPONSE function, returns false if the target is gone or the shape does not match */
+	bool call(TSharedPtr<FJsonValue> data, USCResponse* res) const;
+
+private:
+
+	bool bHadTarget;
+};
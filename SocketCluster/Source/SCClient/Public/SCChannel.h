@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "SCJsonValue.h"
 #include "SCJsonObject.h"
+#include "SCBlueprintBinding.h"
+#include "SCStructPlan.h"
 #include "SCChannel.generated.h"
 
 class USCClientSocket;
@@ -61,10 +63,45 @@ public:
 	/** The data associated with this channel */
 	TSharedPtr<FJsonValue> channel_data;
 
+	/** A boolean which indicates whether or not only the newest message published to this channel is delivered, once per tick. Useful for channels which carry absolute state such as positions or scores. This option is false by default. */
+	bool channel_conflate;
+
+	/** The field of the published data used to keep the newest message per key while conflating (e.g. an entity id), if empty only a single message is kept */
+	FString channel_conflateKey;
+
+	/** The number of messages which were collapsed during the last conflated delivery */
+	int32 channel_lastCollapsed;
+
+	/** The number of messages which were collapsed since the channel was created */
+	int64 channel_totalCollapsed;
+
 	static USCChannel* create(FString channelName, USCClientSocket* clientSocket, TSharedPtr<FJsonObject> options);
 
 	void setOptions(TSharedPtr<FJsonObject> options);
 
+	/**
+	* Only deliver the newest message published to this channel, once per tick.
+	*
+	* @param conflate			Whether or not messages are conflated.
+	* @param conflateKey		Optional, The field of the published data used to keep the newest message per key.
+	*/
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Set Conflate"), Category = "SocketCluster|Channel")
+		void setConflate(const bool conflate, const FString& conflateKey = FString(""));
+
+	/** Returns the number of messages which were collapsed during the last conflated delivery */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Last Collapsed Count"), Category = "SocketCluster|Channel")
+		int32 getLastCollapsedCount();
+
+	/** Returns the number of messages which were collapsed since the channel was created */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Total Collapsed Count"), Category = "SocketCluster|Channel")
+		int64 getTotalCollapsedCount();
+
+	/** Store a published message until the next conflated delivery, replacing the previous message with the same key */
+	void _conflate(const FString& data);
+
+	/** Move the messages waiting for the conflated delivery into messages */
+	void _takeConflated(TArray<TSharedPtr<FJsonValue>>& messages);
+
 	/** Returns the state of the channel as a enum
 	* - SUBSCRIBED
 	* - PENDING
@@ -95,7 +132,7 @@ public:
 	* - Read about the server-side socket.setAuthToken(tokenData) function for more details.
 	* The data property of the options object can be used to pass data along with the subscription.
 	*
-	* @param options		Optional, Options for this subscribe request {waitForAuth: true, data: someCustomData, batch: true}.
+	* @param options		Optional, Options for this subscribe request {waitForAuth: true, data: someCustomData, batch: true, conflate: true, conflateKey: "id"}.
 	*/
 	void subscribe(TSharedPtr<FJsonObject> options);
 
@@ -133,6 +170,15 @@ public:
 	*/
 	void publish(TSharedPtr<FJsonValue> data = nullptr, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = nullptr);
 
+	/**
+	* Publish a USTRUCT to this channel, the struct is written through its cached plan straight into the frame.
+	*/
+	template<typename T, typename TEnableIf<TSCIsUStruct<T>::Value, int32>::Type = 0>
+	void publish(const T& data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = nullptr)
+	{
+		publish(TSCStructPlan<T>::MakeJsonValue(data), callback);
+	}
+
 	/**
 	* Add a handler for a particular event on this channel.
 	* The handler is a function in the form:
@@ -147,7 +193,7 @@ public:
 
 private:
 
-	void onBlueprintHandler(const FString& event, const FString& handler, UObject* handlerTarget, TSharedPtr<FJsonValue> data);
+	void onBlueprintHandler(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> data);
 
 public:
 
@@ -160,6 +206,29 @@ public:
 	*/
 	void on(FString event, TFunction<void(TSharedPtr<FJsonValue>)> handler = nullptr);
 
+	/**
+	* Add a handler for a particular event on this channel which receives the data decoded into a USTRUCT.
+	* Channel events carry data the client made itself, like kickOut, so there are no frame bytes to read and the data is decoded from its FJsonObject.
+	* Data which is not an object or does not fit the struct is reported to the client socket instead of calling the handler.
+	*
+	* @param event					The name of the event.
+	* @param handler				handler(data)
+	*/
+	template<typename T, typename TEnableIf<TSCIsUStruct<T>::Value, int32>::Type = 0>
+	void on(FString event, TFunction<void(const T&)> handler)
+	{
+		on(event, [this, event, handler](TSharedPtr<FJsonValue> data)
+		{
+			T value;
+			if (!TSCStructPlan<T>::Decode(data, value))
+			{
+				_onStructReadError("event " + event, T::StaticStruct());
+				return;
+			}
+			handler(value);
+		});
+	}
+
 	/**
 	* Unbind a previously attached event handler from this channel.
 	*
@@ -189,6 +258,34 @@ public:
 	*/
 	void watch(TFunction<void(TSharedPtr<FJsonValue>)> handler);
 
+	/**
+	* Capture any data which is published to this channel as UTF-8 JSON text, without decoding it into FJsonValues.
+	*
+	* @param handler		handler(text)
+	*/
+	void watchText(TFunction<void(TArrayView<const uint8>)> handler);
+
+	/**
+	* Capture any data which is published to this channel, decoded into a USTRUCT straight from its JSON text.
+	* Fields missing from the data keep their default value. Data which is not an object or does not fit the struct is reported to the client socket instead of calling the handler.
+	*
+	* @param handler		handler(data)
+	*/
+	template<typename T, typename TEnableIf<TSCIsUStruct<T>::Value, int32>::Type = 0>
+	void watch(TFunction<void(const T&)> handler)
+	{
+		watchText([this, handler](TArrayView<const uint8> text)
+		{
+			T value;
+			if (!TSCStructPlan<T>::Read(text, value))
+			{
+				_onStructReadError("published data", T::StaticStruct());
+				return;
+			}
+			handler(value);
+		});
+	}
+
 	/** Unbind all handlers from this channel.*/
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "UnWatch"), Category = "SocketCluster|Channel")
 		void unwatch();
@@ -199,4 +296,19 @@ public:
 	/** Destroy the current SCChannel object - This makes it unusable and it will allow it to be garbage collected. */
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Destroy"), Category = "SocketCluster|Channel")
 		void destroy();
+
+private:
+
+	/** Pass data a typed handler could not read to USCClientSocket::_onStructReadError, with the channel name in the source */
+	void _onStructReadError(const FString& what, UScriptStruct* structType);
+
+	/** The newest raw message, it is only decoded when it is delivered */
+	FString _conflatedRaw;
+
+	bool _hasConflatedRaw;
+
+	/** The newest message per value of channel_conflateKey */
+	TMap<FString, TSharedPtr<FJsonValue>> _conflatedByKey;
+
+	int32 _pendingCollapsed;
 };
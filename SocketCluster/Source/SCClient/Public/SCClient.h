@@ -55,7 +55,7 @@ public:
 	 *
 	 * @param Query					A map of key-value pairs which will be used as query parameters for the initial HTTP handshake which will initiate the WebSocket connection.
 	 * @param AuthEngine				A custom engine to use for storing and loading JWT auth tokens on the client side
-	 * @param CodecEngine				Lets you set a custom codec engine. This allows you to specify how data gets encoded before being sent over the wire and how it gets decoded once it reaches the other side.
+	 * @param CodecEngine				Lets you set a custom codec engine. This allows you to specify how data gets encoded before being sent over the wire and how it gets decoded once it reaches the other side. Use SC_CodecMinBin to talk to a server running sc-codec-min-bin.
 	 * @param Hostname					Defaults to the current host.
 	 * @param Secure					Defaults to false.
 	 * @param Port						Defaults to 80 if secure is false other wise defaults to 443.
@@ -76,9 +76,17 @@ public:
 	 * @param RejectUnauthorized		Set this to false during debugging - Otherwise client connection will fail when using self-signed certificates.
 	 * @param AutoSubscribeOnConnect	This is true by default. If you set this to false, then the socket will not automatically try to subscribe to pending subscriptions on connect - Instead, you will have to manually invoke the processSubscriptions callback from inside the 'connect' event handler on the client side. See SCSocket Client API. This gives you more fine-grained control with regards to when pending subscriptions are processed after the socket connection is established (or re-established).
 	 * @param ChannelPrefix			The prefix of the channel names
+	 * @param ReconnectStrategy		The backoff strategy used between reconnect attempts, jittered strategies keep a fleet of clients from reconnecting in lock-step.
+	 * @param ReconnectBurstLimit		The number of reconnect attempts allowed back to back before attempts are throttled, 0 disables throttling.
+	 * @param ReconnectRefillInterval	The time in seconds it takes to regain one throttled reconnect attempt.
+	 * @param DispatchBudget			The time in milliseconds inbound event handlers may take per frame, events which do not fit are carried over to the next frame, 0 dispatches every event immediately.
+	 * @param AdaptiveAckTimeout		Whether sent emits time out after a multiple of the measured round trip time instead of AckTimeOut, AckTimeOut is still used until the first response arrives.
+	 * @param RttProbeEvent			An event the server answers right away, emitted with a timestamp to measure the round trip time while no other emits are acknowledged. Empty disables probing.
+	 * @param RttProbeInterval			The time in seconds between round trip time probes.
+	 * @param SharedContext			Whether the socket connects through the context shared by every socket created with this option, which is serviced once per frame for all of them. Use it to run many sockets in one process.
 	 */
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Create", WorldContext = "WorldContextObject", AutoCreateRefTerm = "Query", 
-		AdvancedDisplay = "Query, AuthEngine, CodecEngine, ProtocolVersion, AckTimeOut, AutoConnect, AutoReconnect, ReconnectInitialDelay, ReconnectRandomness, ReconnectMultiplier, ReconnectMaxDelay, PubSubBatchDuration, ConnectTimeout, PingTimeoutDisabled, TimestampRequests, TimestampParam, AuthTokenName, Multiplex, RejectUnauthorized, CloneData, AutoSubscribeOnConnect, ChannelPrefix"), Category = "SocketCluster|Client")
+		AdvancedDisplay = "Query, AuthEngine, CodecEngine, ProtocolVersion, AckTimeOut, AutoConnect, AutoReconnect, ReconnectInitialDelay, ReconnectRandomness, ReconnectMultiplier, ReconnectMaxDelay, PubSubBatchDuration, ConnectTimeout, PingTimeoutDisabled, TimestampRequests, TimestampParam, AuthTokenName, Multiplex, RejectUnauthorized, CloneData, AutoSubscribeOnConnect, ChannelPrefix, ReconnectStrategy, ReconnectBurstLimit, ReconnectRefillInterval, DispatchBudget, AdaptiveAckTimeout, RttProbeEvent, RttProbeInterval, SharedContext"), Category = "SocketCluster|Client")
 		static USCClientSocket* Create(
 			const UObject* WorldContextObject,
 			USCJsonObject* Query,
@@ -105,7 +113,15 @@ public:
 			const bool Multiplex = true,
 			const bool RejectUnauthorized = true,
 			const bool AutoSubscribeOnConnect = true,
-			const FString& ChannelPrefix = FString(TEXT(""))
+			const FString& ChannelPrefix = FString(TEXT("")),
+			const ESocketClusterReconnectStrategy ReconnectStrategy = ESocketClusterReconnectStrategy::EXPONENTIAL,
+			const int32 ReconnectBurstLimit = 0,
+			const float ReconnectRefillInterval = 10.0f,
+			const float DispatchBudget = 0.0f,
+			const bool AdaptiveAckTimeout = false,
+			const FString& RttProbeEvent = FString(TEXT("")),
+			const float RttProbeInterval = 5.0f,
+			const bool SharedContext = false
 		);
 };
 
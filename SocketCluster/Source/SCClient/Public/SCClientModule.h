@@ -3,9 +3,17 @@
 #pragma once
 
 #include "Runtime/Core/Public/Modules/ModuleManager.h"
+#include "SCSocketModule.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSCClient, Log, All);
 
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Codec Encode"), STAT_SCCodecEncode, STATGROUP_SocketCluster, SCCLIENT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Codec Decode"), STAT_SCCodecDecode, STATGROUP_SocketCluster, SCCLIENT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handle Event Object"), STAT_SCHandleEvent, STATGROUP_SocketCluster, SCCLIENT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Blueprint Callback"), STAT_SCBlueprintCallback, STATGROUP_SocketCluster, SCCLIENT_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Dispatch Queue Length"), STAT_SCDispatchQueueLength, STATGROUP_SocketCluster, SCCLIENT_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Dispatch Queue Latency (ms)"), STAT_SCDispatchQueueLatency, STATGROUP_SocketCluster, SCCLIENT_API);
+
 #define SCC_FUNC (FString(__FUNCTION__))
 #define SCC_LINE (FString::FromInt(__LINE__))
 #define SCC_FUNC_LINE (SCC_FUNC + "(" + SCC_LINE + ")")
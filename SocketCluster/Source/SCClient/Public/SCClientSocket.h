@@ -12,9 +12,17 @@
 #include "SCResponse.h"
 #include "SCErrors.h"
 #include "SCJsonValue.h"
+#include "SCReconnectPolicy.h"
+#include "SCMetrics.h"
+#include "SCRttEstimator.h"
+#include "SCBlueprintBinding.h"
+#include "SCStructPlan.h"
+#include "SCSocketCapture.h"
+#include "SCNetworkSimulator.h"
 #include "SCClientSocket.generated.h"
 
 class USCTransport;
+class USCReplay;
 
 /** The states of the socket */
 UENUM(BlueprintType, DisplayName = "SocketClusterState")
@@ -33,6 +41,34 @@ enum class ESocketClusterAuthState : uint8
 	UNAUTHENTICATED
 };
 
+/** The priority classes of the inbound dispatch queue, higher classes are dispatched first when the frame budget is exceeded */
+UENUM(BlueprintType, DisplayName = "SocketClusterDispatchPriority")
+enum class ESocketClusterDispatchPriority : uint8
+{
+	HIGH,
+	NORMAL,
+	LOW
+};
+
+/** An inbound event waiting in the dispatch queue */
+USTRUCT()
+struct FSCDispatchItem
+{
+	GENERATED_BODY()
+
+	FString event;
+
+	TSharedPtr<FJsonValue> data;
+
+	UPROPERTY()
+	USCResponse* res;
+
+	/** The time (in platform seconds) the event was queued */
+	double queuedAt;
+
+	FSCDispatchItem() : res(nullptr), queuedAt(0.0) {}
+};
+
 /** */
 UENUM()
 enum class ESocketClusterLocalEvents : uint8
@@ -80,6 +116,14 @@ class SCCLIENT_API USCClientSocket : public UObject
 	UPROPERTY()
 	USCTransport* transport;
 
+	/** The policy deciding the delay between reconnect attempts */
+	UPROPERTY()
+	USCReconnectPolicy* reconnectPolicy;
+
+	/** The traffic, latency and queue metrics of this socket */
+	UPROPERTY()
+	USCMetrics* metrics;
+
 	/** The current client id */
 	FString clientId;
 
@@ -149,18 +193,78 @@ class SCCLIENT_API USCClientSocket : public UObject
 	/** List of channels current associated with this socket */
 	TMap<FString, USCChannel*> channels;
 
-	/** The buffer for the emit events */
-	TArray<USCEventObject*> _emitBuffer;
+	/** The first event of the emit buffer, events are linked through USCEventObject::next */
+	UPROPERTY()
+	USCEventObject* _emitBufferHead;
+
+	/** The last event of the emit buffer */
+	USCEventObject* _emitBufferTail;
+
+	/** The number of events in the emit buffer */
+	int32 _emitBufferLength;
+
+	/** The events of which only the latest emit is kept in the emit buffer */
+	TSet<FString> _latestOnlyEvents;
+
+	/** The buffered emit of each latest only event */
+	TMap<FString, USCEventObject*> _latestEmitBuffer;
 
 	/** List of private events handled internally */
 	TMap<FString, TFunction<void(TSharedPtr<FJsonValue>, USCResponse*)>> _privateEventHandlerMap;
 
 	/** Event emitter to handle events */
 	TMultiMap<FString, TFunction<void(TSharedPtr<FJsonValue>, USCResponse*)>> Emitter;
+
+	/** Event handlers which read the data in place from the arena document of the received frame */
+	TMap<FString, TFunction<void(const FSCJsonNode&, USCResponse*)>> _viewEmitter;
 	
 	/** Event emitter to handle channel events */
 	TMultiMap<FString, TFunction<void(TSharedPtr<FJsonValue>)>> _channelEmitter;
 
+	/** Channel watchers which read the published data from its JSON text */
+	TMultiMap<FString, TFunction<void(TArrayView<const uint8>)>> _channelTextEmitter;
+
+	/** The conflating channels which received messages since the last conflated delivery */
+	UPROPERTY()
+	TArray<USCChannel*> _conflatedChannels;
+
+	/** The next tick timer which delivers the conflated messages */
+	FTimerHandle _conflatedFlushHandle;
+
+	/** The time in seconds inbound event handlers may take per frame, 0 dispatches every event immediately */
+	double dispatchBudget;
+
+	/** The queued inbound events per priority class */
+	UPROPERTY()
+	TArray<FSCDispatchItem> _dispatchQueueHigh;
+
+	UPROPERTY()
+	TArray<FSCDispatchItem> _dispatchQueueNormal;
+
+	UPROPERTY()
+	TArray<FSCDispatchItem> _dispatchQueueLow;
+
+	/** The index of the next event to dispatch in each queue */
+	int32 _dispatchQueueHead[3];
+
+	/** The priority class of events, events which are not listed are NORMAL */
+	TMap<FString, ESocketClusterDispatchPriority> _eventPriorities;
+
+	/** The priority class of channel messages, channels which are not listed are NORMAL */
+	TMap<FString, ESocketClusterDispatchPriority> _channelPriorities;
+
+	/** The frame the dispatch time was last accounted for */
+	uint64 _dispatchFrame;
+
+	/** The time in seconds spent in event handlers during _dispatchFrame */
+	double _dispatchSpent;
+
+	/** The next tick timer which drains the dispatch queue */
+	FTimerHandle _dispatchDrainHandle;
+
+	/** The time in microseconds events waited in the dispatch queue */
+	FSCHistogram _dispatchLatency;
+
 	/** List of private events which are prohibited and for internal use only */
 	TMap<FString, int32> _localEvents;
 
@@ -176,6 +280,37 @@ class SCCLIENT_API USCClientSocket : public UObject
 	/** The reconnect timeout handler */
 	FTimerHandle _reconnectTimeoutHandle;
 
+	/** The round trip time estimate, shared with the transport which samples it from acknowledgements */
+	TSharedPtr<FSCRttEstimator> _rtt;
+
+	/** Whether the ack timeout of sent emits follows the round trip time estimate instead of ackTimeout */
+	bool adaptiveAckTimeout;
+
+	/** The event sent to measure the round trip time while no emit is acknowledged, the server has to respond to it. Empty disables the probe */
+	FString rttProbeEvent;
+
+	/** The time in seconds between round trip time probes */
+	float rttProbeInterval;
+
+	/** The number of round trip samples at the last probe */
+	uint64 _rttProbeSamples;
+
+	/** The round trip time probe reference */
+	FTimerDelegate _rttProbeRef;
+
+	/** The round trip time probe handler */
+	FTimerHandle _rttProbeHandle;
+
+	/** The capture the frames of every connection are appended to while capturing */
+	TSharedPtr<FSCSocketCapture> _capture;
+
+	/** The replay feeding the transport, while a capture is replayed */
+	UPROPERTY()
+	USCReplay* _replay;
+
+	/** The network conditions the socket of every connection simulates, while set */
+	TSharedPtr<FSCNetworkConditions> _networkConditions;
+
 public:
 
 	UPROPERTY(Transient)
@@ -209,7 +344,7 @@ public:
 
 private:
 
-	void deauthenticateBlueprintCallback(const FString& callback, UObject* target, TSharedPtr<FJsonValue> error);
+	void deauthenticateBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> error);
 
 public:
 
@@ -230,6 +365,9 @@ public:
 
 private:
 
+	/** Create a transport and bind its handlers, an offline transport receives the frames of a replay */
+	void _createTransport(bool offline);
+
 	void reconnect(int32 code, TSharedPtr<FJsonValue> data);
 
 public:
@@ -272,6 +410,75 @@ private:
 
 public:
 
+	/** Returns the reconnect policy of this socket, which holds the reconnect attempt and delay histograms. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Reconnect Policy"), Category = "SocketCluster|Client")
+		USCReconnectPolicy* getReconnectPolicy();
+
+	/** Returns the metrics of this socket: traffic, encode and decode time, queue lengths, reconnects and ack latencies per event. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Metrics"), Category = "SocketCluster|Client")
+		USCMetrics* getMetrics();
+
+	/** Returns the smoothed round trip time in seconds, measured from acknowledged emits and probes. 0 before the first measurement. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Round Trip Time"), Category = "SocketCluster|Client")
+		float getRoundTripTime();
+
+	/** Returns the mean deviation of the round trip time in seconds. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Round Trip Time Variance"), Category = "SocketCluster|Client")
+		float getRoundTripTimeVariance();
+
+	/** Returns the ack timeout in seconds an emit sent now gets, the adaptive timeout when it is enabled. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Ack Timeout"), Category = "SocketCluster|Client")
+		float getAckTimeout();
+
+	/** Returns the round trip time estimate */
+	const FSCRttEstimator& getRttEstimator() const { return *_rtt; }
+
+	/**
+	* Start appending every frame sent and received to a capture file, across reconnects, until stopCapture is called.
+	* Start it before connecting to capture a session which can be replayed.
+	*
+	* @param path		The file the frames are written to, it is replaced if it exists.
+	*/
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Start Capture"), Category = "SocketCluster|Client")
+		bool startCapture(const FString& path);
+
+	/** Stop capturing and close the capture file. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Stop Capture"), Category = "SocketCluster|Client")
+		void stopCapture();
+
+	/**
+	* Replay the frames a capture received, without a connection. The socket handles them like frames received from the server
+	* and goes through the connect, event, channel and close handlers, which makes sessions reproducible and the dispatch and decode paths measurable on real traffic.
+	* The socket is disconnected once every frame was replayed.
+	*
+	* @param path		The capture file written by startCapture.
+	* @param speed		Optional, the speed relative to the recorded timing, 0 replays every frame at once.
+	*/
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Replay"), Category = "SocketCluster|Client")
+		USCReplay* replay(const FString& path, float speed = 1.0f);
+
+	/**
+	* Simulate network conditions on this socket, across reconnects, until clearNetworkConditions is called.
+	* Adds latency, jitter, bandwidth caps and stalls to the frames in both directions and drops the connection with the chosen close codes,
+	* to see how batching, backpressure and reconnects behave on a poor network against a local server.
+	*
+	* @param conditions		The conditions to simulate, the random events repeat for the same seed.
+	*/
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Set Network Conditions"), Category = "SocketCluster|Client")
+		void setNetworkConditions(const FSCNetworkConditions& conditions);
+
+	/** Stop simulating network conditions, the frames which are held are sent and handled right away. */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Clear Network Conditions"), Category = "SocketCluster|Client")
+		void clearNetworkConditions();
+
+	/**
+	* Drop the connection as if the network failed, the socket closes with code and reconnects like it would after a real failure.
+	*
+	* @param code		The close code, for example 1006 (abnormal closure), 4000 (ping timeout) or 4001 (client error).
+	*/
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Simulate Disconnect"), Category = "SocketCluster|Client")
+		void simulateDisconnect(int32 code = 1006);
+
 	/** Returns the auth token as a plain JavaScript object. */
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Auth Token"), Category = "SocketCluster|Client")
 		USCJsonValue* getAuthTokenBlueprint();
@@ -301,7 +508,7 @@ public:
 
 private:
 
-	void authenticateBlueprintCallback(const FString& callback, UObject* target, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data);
+	void authenticateBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data);
 
 public:
 
@@ -317,7 +524,7 @@ public:
 
 private:
 
-	void _tryReconnect(float initialDelay = NULL);
+	void _tryReconnect(float initialDelay = -1.0f);
 
 	void _onSCOpen(TSharedPtr<FJsonValue> status);
 
@@ -331,15 +538,49 @@ private:
 
 	void _onSCEvent(FString event, TSharedPtr<FJsonValue> data, USCResponse* res = nullptr);
 
+	void _dispatchSCEvent(FString event, TSharedPtr<FJsonValue> data, USCResponse* res = nullptr);
+
+	bool _onSCEventView(const FString& event, const FSCJsonNode& data, int32 cid);
+
+	ESocketClusterDispatchPriority _getDispatchPriority(const FString& event, TSharedPtr<FJsonValue> data);
+
+	TArray<FSCDispatchItem>& _getDispatchQueue(ESocketClusterDispatchPriority priority);
+
+	int32 _getDispatchQueueLength();
+
+	bool _hasDispatchBudget();
+
+	void _drainDispatchQueue();
+
+	/** Drop every queued event and response and cancel the pending drain */
+	void _clearDispatchQueue();
+
 	TSharedPtr<FJsonValue> decode(FString message);
 
 	FString encode(TSharedPtr<FJsonValue> object);
 
 	void _flushEmitBuffer();
 
+	void _flushConflatedChannels();
+
+	/** Pass the JSON text of a published message to the text watchers of the channel */
+	void _watchChannelText(const FString& channelName, TArrayView<const uint8> text);
+
+	void _appendToEmitBuffer(USCEventObject* eventObject);
+
+	void _detachFromEmitBuffer(USCEventObject* eventObject);
+
+	void _dropBufferedEmit(USCEventObject* eventObject, FString failureType);
+
 	void _handleEventAckTimeout(USCEventObject* eventObject);
 
-	void _emit(FString event, TSharedPtr<FJsonValue> data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback);
+	/** The ack timeout in seconds for an emit which is sent now */
+	float _getAckTimeout();
+
+	/** Send a timestamped probe if no emit was acknowledged since the last one */
+	void _sendRttProbe();
+
+	void _emit(FString event, TSharedPtr<FJsonValue> data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback, TSharedPtr<FJsonObject> opts = nullptr);
 
 public:
 
@@ -358,17 +599,18 @@ public:
 	* @param data				Optional, The data to send to the server.
 	* @param callback			Optional, The name of the function to be called when the callback is received.
 	* @param callbackTarget		Optional, defaults to self, The class location of the callback function.
+	* @param ttl				Optional, The time in seconds the event may wait in the emit buffer while the socket is not connected, 0 to never expire.
 	*
 	* Note : The Callback function needs to have at least the following parameters.
 	* First Parameter	: USCJsonValue* (error)
 	* Second Parameter	: USCJsonValue* (data)
 	*/
-	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Emit", DefaultToSelf = "callbackTarget"), Category = "SocketCluster|Client")
-		void emitBlueprint(const FString& event, USCJsonValue* data = nullptr, const FString& callback = FString(""), UObject* callbackTarget = nullptr);
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Emit", DefaultToSelf = "callbackTarget", AdvancedDisplay = "ttl"), Category = "SocketCluster|Client")
+		void emitBlueprint(const FString& event, USCJsonValue* data = nullptr, const FString& callback = FString(""), UObject* callbackTarget = nullptr, float ttl = 0.0f);
 
 private:
 
-	void emitBlueprintCallback(const FString& callback, UObject* target, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data);
+	void emitBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data);
 
 public:
 
@@ -378,8 +620,71 @@ public:
 	* @param event				The name of the event.
 	* @param data				Optional, The data to send to the server.
 	* @param callback			Optional, callback(err, data)
+	* @param opts				Optional, {ttl: seconds} the time the event may wait in the emit buffer while the socket is not connected.
+	*/
+	void emit(FString event, TSharedPtr<FJsonValue> data = nullptr, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = nullptr, TSharedPtr<FJsonObject> opts = nullptr);
+
+	/**
+	* Emit a USTRUCT, the struct is encoded through its cached plan.
+	*
+	* @param event				The name of the event.
+	* @param data				The struct to send to the server.
+	* @param callback			Optional, callback(err, data)
+	* @param opts				Optional, {ttl: seconds}
+	*/
+	template<typename T, typename TEnableIf<TSCIsUStruct<T>::Value, int32>::Type = 0>
+	void emit(FString event, const T& data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = nullptr, TSharedPtr<FJsonObject> opts = nullptr)
+	{
+		emit(event, TSCStructPlan<T>::MakeJsonValue(data), callback, opts);
+	}
+
+	/**
+	* Only keep the latest emit of the specified event in the emit buffer while the socket is not connected.
+	* Older buffered emits of the event are dropped and their callback receives a BadConnectionError of type 'superseded'.
+	*
+	* @param event				The name of the event.
+	* @param latestOnly			Whether or not only the latest emit is kept.
 	*/
-	void emit(FString event, TSharedPtr<FJsonValue> data = nullptr, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = nullptr);
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Set Latest Only"), Category = "SocketCluster|Client")
+		void setLatestOnly(const FString& event, bool latestOnly = true);
+
+	/**
+	* Set the priority class of an inbound event. When the dispatch budget of a frame is used up, queued events are dispatched HIGH first.
+	*
+	* @param event				The name of the event.
+	* @param priority			The priority class.
+	*/
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Set Event Priority"), Category = "SocketCluster|Client")
+		void setEventPriority(const FString& event, ESocketClusterDispatchPriority priority);
+
+	/**
+	* Set the priority class of the messages published to a channel.
+	*
+	* @param channelName		The name of the channel.
+	* @param priority			The priority class.
+	*/
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Set Channel Priority"), Category = "SocketCluster|Client")
+		void setChannelPriority(const FString& channelName, ESocketClusterDispatchPriority priority);
+
+	/**
+	* Set the time in milliseconds inbound event handlers may take per frame. Events which do not fit are carried over to the next frame.
+	*
+	* @param budget				The budget in milliseconds, 0 dispatches every event immediately.
+	*/
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Set Dispatch Budget"), Category = "SocketCluster|Client")
+		void setDispatchBudget(float budget);
+
+	/** Returns the number of inbound events waiting in the dispatch queue */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Dispatch Queue Length"), Category = "SocketCluster|Client")
+		int32 getDispatchQueueLength();
+
+	/** Returns the histogram of the time in microseconds inbound events waited in the dispatch queue */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Dispatch Latency Histogram"), Category = "SocketCluster|Client")
+		USCJsonValue* getDispatchLatencyHistogramBlueprint();
+
+	/** Returns the number of events waiting in the emit buffer */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Emit Buffer Length"), Category = "SocketCluster|Client")
+		int32 getEmitBufferLength();
 
 	/**
 	* Client Side Event :
@@ -405,7 +710,7 @@ public:
 
 private:
 
-	void onBlueprintHandler(const FString& event, const FString& handler, UObject* handlerTarget, TSharedPtr<FJsonValue> data, USCResponse* res);
+	void onBlueprintHandler(const FString& event, const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> data, USCResponse* res);
 
 public:
 
@@ -428,6 +733,41 @@ public:
 	*/
 	void on(FString event, TFunction<void(TSharedPtr<FJsonValue>, USCResponse*)> handler = nullptr);
 
+	/**
+	* Add a handler which receives the event data decoded into a USTRUCT, e.g. on<FPlayerMove>("move", ...).
+	* Fields missing from the data keep their default value. Data which is not an object or does not fit the struct is reported with _onStructReadError instead of calling the handler.
+	* The struct is read through its plan from the arena document of the frame, it is a view handler and is called like the ones added with onView.
+	*
+	* @param event					The name of the event.
+	* @param handler				handler(data, res)
+	*/
+	template<typename T, typename TEnableIf<TSCIsUStruct<T>::Value, int32>::Type = 0>
+	void on(FString event, TFunction<void(const T&, USCResponse*)> handler)
+	{
+		onView(event, [this, event, handler](const FSCJsonNode& data, USCResponse* res)
+		{
+			T value;
+			if (!TSCStructPlan<T>::Read(data, value))
+			{
+				_onStructReadError("event " + event, T::StaticStruct(), res);
+				return;
+			}
+			handler(value, res);
+		});
+	}
+
+	/**
+	* Add a handler which reads the event data in place, without building FJsonValues for it.
+	* With a codec that decodes into arena documents (the default formatter) the data points into the arena of the received frame,
+	* which is released as soon as the handler returns, so call ToJsonValue on anything that has to be kept.
+	* The handler is called while the frame is being received, the dispatch budget does not delay it.
+	* An event with a view handler is not passed to the handlers added with on.
+	*
+	* @param event					The name of the event.
+	* @param handler				handler(data, res)
+	*/
+	void onView(FString event, TFunction<void(const FSCJsonNode&, USCResponse*)> handler);
+
 	/** 
 	* Unbind a previously attached event handler. 
 	*
@@ -458,7 +798,7 @@ public:
 
 private:
 
-	void publishBlueprintCallback(const FString& callback, UObject* target, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data);
+	void publishBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data);
 
 public:
 
@@ -478,6 +818,19 @@ public:
 	*/
 	void publish(FString channelName, TSharedPtr<FJsonValue> data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = nullptr);
 
+	/**
+	* Publish a USTRUCT to the specified channelName, the struct is encoded through its cached plan.
+	*
+	* @param channelName		The name of the channel to publish data to.
+	* @param data				The struct to send to the channel.
+	* @param callback			Optional, callback(err, ackData)
+	*/
+	template<typename T, typename TEnableIf<TSCIsUStruct<T>::Value, int32>::Type = 0>
+	void publish(FString channelName, const T& data, TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback = nullptr)
+	{
+		publish(channelName, TSCStructPlan<T>::MakeJsonValue(data), callback);
+	}
+
 private:
 
 	void _triggerChannelSubscribe(USCChannel* channel, TSharedPtr<FJsonObject> subscriptionOptions);
@@ -525,7 +878,7 @@ public:
 	* Batching can result in a significant performance boost if the client needs to subscribe to a large number of channels (will also speed up socket reconnect if there are a lot of pending channels).
 	*
 	* @param channelName		The name of the channel to subscribe to.
-	* @param opts				Optional, Options for this subscribe request {waitForAuth: true, data: someCustomData, batch: true}.
+	* @param opts				Optional, Options for this subscribe request {waitForAuth: true, data: someCustomData, batch: true, conflate: true, conflateKey: "id"}.
 	*/
 	USCChannel* subscribe(const FString& channelName, TSharedPtr<FJsonObject> opts = nullptr);
 
@@ -565,7 +918,7 @@ public:
 	* The returned channel will be inactive initially. You can call channel->subscribe() later to activate that channel when required.
 	*
 	* @param channelName		The name of the channel.
-	* @param opts				Optional, Options for this channel {waitForAuth: true, data: someCustomData, batch: true}.
+	* @param opts				Optional, Options for this channel {waitForAuth: true, data: someCustomData, batch: true, conflate: true, conflateKey: "id"}.
 	*/
 	USCChannel* channel(const FString& channelName, TSharedPtr<FJsonObject> opts);
 
@@ -617,7 +970,7 @@ public:
 
 private:
 
-	void watchBlueprintCallback(const FString& handler, UObject* target, TSharedPtr<FJsonValue> data);
+	void watchBlueprintCallback(const FSCBlueprintBinding& binding, TSharedPtr<FJsonValue> data);
 
 public:
 
@@ -629,6 +982,48 @@ public:
 	*/
 	void watch(FString channelName, TFunction<void(TSharedPtr<FJsonValue>)> handler);
 
+	/**
+	* Watch a channel with a handler which receives the published data as UTF-8 JSON text, without decoding it into FJsonValues.
+	* The text is only valid while the handler runs.
+	*
+	* @param channelName		The name of the channel to watch.
+	* @param handler			handler(text)
+	*/
+	void watchText(FString channelName, TFunction<void(TArrayView<const uint8>)> handler);
+
+	/**
+	* Watch a channel with a handler which receives the published data decoded into a USTRUCT, e.g. watch<FPlayerMove>("moves", ...).
+	* The struct is read through its plan straight from the JSON text of the data, fields missing from the data keep their default value.
+	* Data which is not an object or does not fit the struct is reported with _onStructReadError instead of calling the handler.
+	*
+	* @param channelName		The name of the channel to watch.
+	* @param handler			handler(data)
+	*/
+	template<typename T, typename TEnableIf<TSCIsUStruct<T>::Value, int32>::Type = 0>
+	void watch(FString channelName, TFunction<void(const T&)> handler)
+	{
+		watchText(channelName, [this, channelName, handler](TArrayView<const uint8> text)
+		{
+			T value;
+			if (!TSCStructPlan<T>::Read(text, value))
+			{
+				_onStructReadError("channel " + channelName, T::StaticStruct());
+				return;
+			}
+			handler(value);
+		});
+	}
+
+	/**
+	* Report data which could not be read into the USTRUCT of a typed handler, the handler is not called for it.
+	* The error is logged and passed to the error handler, with res the server also gets it as the response.
+	*
+	* @param source			The event or channel the data was received on.
+	* @param structType		The struct the data was read into.
+	* @param res			Optional, the response to the event.
+	*/
+	void _onStructReadError(const FString& source, UScriptStruct* structType, USCResponse* res = nullptr);
+
 	/**
 	* Stop handling data which is published on the specified channel. This is different from unsubscribe in that the socket will still receive channel data but the specified handler will no longer capture it
 	*
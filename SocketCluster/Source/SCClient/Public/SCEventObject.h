@@ -31,4 +31,20 @@ public:
 
 	FTimerHandle timeoutHandle;
 
+	/** The next event in the emit buffer */
+	UPROPERTY()
+	USCEventObject* next;
+
+	/** The previous event in the emit buffer */
+	USCEventObject* prev;
+
+	/** Whether or not the event is currently waiting in the emit buffer */
+	bool buffered;
+
+	/** The time (in platform seconds) after which the event is dropped instead of sent, 0 if it never expires */
+	double expiry;
+
+	/** The time (in platform seconds) the event was sent, used for the ack latency */
+	double sentAt;
+
 };
@@ -0,0 +1,53 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SCJsonObject.h"
+
+/**
+* A log-linear (HDR style) histogram of unsigned integer samples.
+* Values below 64 are counted exactly, larger values land in one of 32 linear sub buckets per power of two,
+* which keeps the relative error of any reported percentile below ~3% at a fixed memory cost.
+*/
+struct SCCLIENT_API FSCHistogram
+{
+	FSCHistogram();
+
+	/** Record a single sample */
+	void record(uint64 value);
+
+	/** Remove all recorded samples */
+	void reset();
+
+	/** The number of recorded samples */
+	uint64 getCount() const { return count; }
+
+	uint64 getMin() const { return count > 0 ? minValue : 0; }
+
+	uint64 getMax() const { return maxValue; }
+
+	double getMean() const { return count > 0 ? (double)total / (double)count : 0.0; }
+
+	/** Returns the (upper bound of the bucket holding the) value at the given percentile, 0 - 100 */
+	uint64 getPercentile(double percentile) const;
+
+	/** Returns a summary of the histogram {count, min, max, mean, p50, p90, p99, p999, buckets: [{le, count}]} */
+	TSharedPtr<FJsonObject> toJson(bool includeBuckets = true) const;
+
+private:
+
+	static int32 bucketIndex(uint64 value);
+
+	static uint64 bucketUpperBound(int32 index);
+
+	TArray<uint64> buckets;
+
+	uint64 count;
+
+	uint64 total;
+
+	uint64 minValue;
+
+	uint64 maxValue;
+};
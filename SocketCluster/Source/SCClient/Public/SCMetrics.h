@@ -0,0 +1,134 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SCJsonObject.h"
+#include "SCJsonValue.h"
+#include "SCHistogram.h"
+#include "SCSocket.h"
+#include "SCMetrics.generated.h"
+
+/**
+* The SocketCluster Metrics
+*
+* The counters, gauges and histograms of a single client socket, kept across reconnects.
+* Recording is a counter increment or a histogram bucket increment, so the metrics are always on.
+* The gauges (send queue, pending acks, emit buffer) are read from the client socket whenever they are asked for.
+*/
+UCLASS(BlueprintType, DisplayName = "SCMetrics")
+class SCCLIENT_API USCMetrics : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USCMetrics();
+
+	/** The traffic counters, handed to the socket of every connection */
+	TSharedRef<FSCSocketStats> traffic;
+
+	/** Called before the gauges are read, so the owner can update them */
+	TFunction<void()> onsample;
+
+	/** Record the time a frame took to encode */
+	void recordEncode(uint64 cycles);
+
+	/** Record the time a frame took to decode */
+	void recordDecode(uint64 cycles);
+
+	/** Record the time between an emit and its acknowledgement */
+	void recordAck(const FString& event, double seconds);
+
+	void recordAckTimeout();
+
+	void recordReconnect();
+
+	void setGauges(int32 sendQueue, int32 pendingAcks, int32 emitBuffer);
+
+	/** Clears every counter and histogram */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Reset"), Category = "SocketCluster|Metrics")
+		void reset();
+
+	/**
+	* Returns every metric as a JSON object
+	* {bytesSent, bytesReceived, framesSent, framesReceived, reconnects, ackTimeouts, sendQueueLength, pendingAckCount, emitBufferLength,
+	*  encodeTime, decodeTime, ackLatency: {event: histogram}}
+	*/
+	TSharedPtr<FJsonObject> toJson(bool includeBuckets = false);
+
+	/** Returns every metric, see toJson */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Snapshot"), Category = "SocketCluster|Metrics")
+		USCJsonValue* getSnapshotBlueprint(bool includeBuckets = false);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Bytes Sent"), Category = "SocketCluster|Metrics")
+		int64 getBytesSent() const;
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Bytes Received"), Category = "SocketCluster|Metrics")
+		int64 getBytesReceived() const;
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Frames Sent"), Category = "SocketCluster|Metrics")
+		int64 getFramesSent() const;
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Frames Received"), Category = "SocketCluster|Metrics")
+		int64 getFramesReceived() const;
+
+	/** Returns the number of reconnect attempts */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Reconnects"), Category = "SocketCluster|Metrics")
+		int32 getReconnects() const;
+
+	/** Returns the number of emits which did not get their acknowledgement in time */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Ack Timeouts"), Category = "SocketCluster|Metrics")
+		int32 getAckTimeouts() const;
+
+	/** Returns the number of frames queued on the socket which were not written yet */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Send Queue Length"), Category = "SocketCluster|Metrics")
+		int32 getSendQueueLength();
+
+	/** Returns the number of emits waiting for their acknowledgement */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Pending Ack Count"), Category = "SocketCluster|Metrics")
+		int32 getPendingAckCount();
+
+	/** Returns the number of events waiting in the emit buffer for the socket to connect */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Emit Buffer Length"), Category = "SocketCluster|Metrics")
+		int32 getEmitBufferLength();
+
+	/** Returns the histogram of the time in nanoseconds frames took to encode */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Encode Time Histogram"), Category = "SocketCluster|Metrics")
+		USCJsonValue* getEncodeTimeHistogramBlueprint();
+
+	/** Returns the histogram of the time in nanoseconds frames took to decode */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Decode Time Histogram"), Category = "SocketCluster|Metrics")
+		USCJsonValue* getDecodeTimeHistogramBlueprint();
+
+	/** Returns the histogram of the time in microseconds the emits of an event waited for their acknowledgement, null if none was acknowledged */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Ack Latency Histogram"), Category = "SocketCluster|Metrics")
+		USCJsonValue* getAckLatencyHistogramBlueprint(const FString& event);
+
+	const FSCHistogram& getEncodeTime() const { return encodeTime; }
+
+	const FSCHistogram& getDecodeTime() const { return decodeTime; }
+
+	/** The ack latency histogram of every event which was acknowledged */
+	const TMap<FString, FSCHistogram>& getAckLatencies() const { return ackLatency; }
+
+private:
+
+	void _sample();
+
+	int32 reconnects;
+
+	int32 ackTimeouts;
+
+	int32 sendQueueLength;
+
+	int32 pendingAckCount;
+
+	int32 emitBufferLength;
+
+	FSCHistogram encodeTime;
+
+	FSCHistogram decodeTime;
+
+	TMap<FString, FSCHistogram> ackLatency;
+};
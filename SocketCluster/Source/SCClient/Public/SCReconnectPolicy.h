@@ -0,0 +1,132 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "SCJsonObject.h"
+#include "SCJsonValue.h"
+#include "SCHistogram.h"
+#include "SCReconnectPolicy.generated.h"
+
+/** The backoff strategies used to space out reconnect attempts */
+UENUM(BlueprintType, DisplayName = "SocketClusterReconnectStrategy")
+enum class ESocketClusterReconnectStrategy : uint8
+{
+	/** (initialDelay + randomness * random) * multiplier ^ attempt, capped at maxDelay */
+	EXPONENTIAL,
+	/** random(0, min(maxDelay, initialDelay * multiplier ^ attempt)) */
+	FULL_JITTER,
+	/** min(maxDelay, random(initialDelay, previousDelay * 3)) */
+	DECORRELATED_JITTER
+};
+
+/**
+* The SocketCluster Reconnect Policy
+*
+* Decides how long the client socket waits before each reconnect attempt.
+* On top of the backoff strategy a token bucket caps the number of attempts (burstLimit attempts, refilled at one per refillInterval seconds)
+* and a retryAfter value suggested by the server in the close reason is always honoured, so a fleet of clients spreads out after a server restart.
+* Subclass and override computeDelay to plug in a custom strategy.
+*/
+UCLASS(Blueprintable, BlueprintType, DisplayName = "SCReconnectPolicy")
+class SCCLIENT_API USCReconnectPolicy : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USCReconnectPolicy();
+
+	/** The strategy used to compute the backoff delay */
+	ESocketClusterReconnectStrategy strategy;
+
+	/** The base delay in seconds */
+	float initialDelay;
+
+	/** The extra random delay in seconds (EXPONENTIAL strategy only) */
+	float randomness;
+
+	/** The growth factor of the delay per attempt */
+	float multiplier;
+
+	/** The maximum delay in seconds */
+	float maxDelay;
+
+	/** The number of attempts which can be made back to back before the token bucket starts throttling, 0 disables the bucket */
+	int32 burstLimit;
+
+	/** The time in seconds it takes to regain a single attempt token */
+	float refillInterval;
+
+	/** Reads the policy settings from the autoReconnectOptions object of the client socket */
+	void setOptions(TSharedPtr<FJsonObject> reconnectOptions);
+
+	/**
+	* Returns the delay in seconds to wait before the next reconnect attempt and records it.
+	*
+	* @param attempt			The zero based number of the reconnect attempt.
+	* @param initialDelayHint	The delay requested by the caller for the first attempt (negative if none).
+	*/
+	float nextDelay(int32 attempt, float initialDelayHint = -1.0f);
+
+	/** Store a server suggested retry delay (in seconds) which will be used as the lower bound of the next delay */
+	void setRetryAfter(float seconds);
+
+	/** Reads a retryAfter suggestion from a close reason, either a JSON object {"retryAfter": seconds} or a plain number of seconds */
+	void setRetryAfterFromReason(const FString& reason);
+
+	/** Called once the client socket successfully connected after the given number of attempts */
+	void recordConnected(int32 attempts);
+
+	/** Forget the decorrelated jitter state and the pending retryAfter, the token bucket keeps its level */
+	void reset();
+
+	/** Returns the histogram of attempts it took to reconnect */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Attempt Histogram"), Category = "SocketCluster|Reconnect")
+		USCJsonValue* getAttemptHistogramBlueprint();
+
+	/** Returns the histogram of reconnect delays in milliseconds */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Delay Histogram"), Category = "SocketCluster|Reconnect")
+		USCJsonValue* getDelayHistogramBlueprint();
+
+	/** Returns the number of attempts which were postponed by the token bucket */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Throttled Attempts"), Category = "SocketCluster|Reconnect")
+		int32 getThrottledAttempts();
+
+	const FSCHistogram& getAttemptHistogram() const { return attemptHistogram; }
+
+	const FSCHistogram& getDelayHistogram() const { return delayHistogram; }
+
+protected:
+
+	/**
+	* Computes the backoff delay in seconds for the given attempt, before throttling and retryAfter are applied.
+	*
+	* @param attempt			The zero based number of the reconnect attempt.
+	* @param previousDelay		The delay which was used for the previous attempt.
+	*/
+	virtual float computeDelay(int32 attempt, float previousDelay);
+
+	/** The random stream of the jitter, seeded per policy */
+	FRandomStream random;
+
+private:
+
+	/** Takes a token from the bucket and returns the seconds to wait until one is available */
+	float _takeToken(float delay);
+
+	float previousDelay;
+
+	float retryAfter;
+
+	double tokens;
+
+	double lastRefill;
+
+	int32 throttledAttempts;
+
+	FSCHistogram attemptHistogram;
+
+	FSCHistogram delayHistogram;
+};
@@ -0,0 +1,86 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "SCSocketCapture.h"
+#include "SCReplay.generated.h"
+
+class USCTransport;
+
+/**
+* The SocketCluster Replay
+*
+* Feeds the inbound frames of a capture into an offline transport, so the client socket handles them like frames received from the server.
+* The frames keep their recorded spacing divided by the speed, a speed of 0 replays every frame on the first tick.
+* Outbound frames are not replayed, the responses to the emits of the client are matched by their call id like on a live connection,
+* so the capture has to be started before the client socket connects.
+*/
+UCLASS(BlueprintType, DisplayName = "SCReplay")
+class SCCLIENT_API USCReplay : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	USCReplay();
+
+	/** Start feeding records into transport */
+	void start(USCTransport* replayTransport, TArray<FSCCaptureRecord>&& replayRecords, float replaySpeed);
+
+	/** Stop the replay, the remaining frames are dropped */
+	void stop();
+
+	/** Called once every frame was replayed or the transport closed */
+	TFunction<void()> onfinished;
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Is Running"), Category = "SocketCluster|Replay")
+		bool isRunning() const { return running; }
+
+	/** Returns the share of the inbound frames which were replayed, from 0 to 1 */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Progress"), Category = "SocketCluster|Replay")
+		float getProgress() const;
+
+	/** Returns the number of frames which were replayed */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Frames Replayed"), Category = "SocketCluster|Replay")
+		int32 getFramesReplayed() const { return framesReplayed; }
+
+	/** Returns the time in seconds the client socket spent handling the replayed frames */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Handling Time"), Category = "SocketCluster|Replay")
+		float getHandlingTime() const { return (float)handlingTime; }
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return running; }
+
+	virtual bool IsTickableWhenPaused() const override { return true; }
+
+	virtual TStatId GetStatId() const override;
+
+private:
+
+	UPROPERTY()
+	USCTransport* transport;
+
+	/** The inbound frames of the capture */
+	TArray<FSCCaptureRecord> records;
+
+	int32 index;
+
+	float speed;
+
+	bool running;
+
+	/** The platform time the replay started at */
+	double startTime;
+
+	int32 framesReplayed;
+
+	uint64 bytesReplayed;
+
+	/** The time in seconds spent in receiveOffline */
+	double handlingTime;
+
+	void _finish();
+};
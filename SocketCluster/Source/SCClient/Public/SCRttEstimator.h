@@ -0,0 +1,59 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* A smoothed round trip time estimate, kept like TCP's retransmission timer (RFC 6298).
+* Every sample moves the smoothed RTT by 1/8 and the mean deviation by 1/4 of the error, the timeout is SRTT + 4 * RTTVAR.
+* A timeout doubles the next timeout until a new sample arrives, so a slow link backs off instead of timing out every emit.
+*/
+struct SCCLIENT_API FSCRttEstimator
+{
+	FSCRttEstimator();
+
+	/** The lower bound of the timeout in seconds */
+	double minTimeout;
+
+	/** The upper bound of the timeout in seconds */
+	double maxTimeout;
+
+	/** Add a round trip time in seconds */
+	void sample(double rtt);
+
+	/** Double the timeout until the next sample, called when an emit timed out */
+	void backoff();
+
+	/** Forget every sample */
+	void reset();
+
+	/** Whether at least one round trip was measured */
+	bool hasSample() const { return sampleCount > 0; }
+
+	uint64 getSampleCount() const { return sampleCount; }
+
+	/** The smoothed round trip time in seconds, 0 before the first sample */
+	double getSmoothedRtt() const { return smoothedRtt; }
+
+	/** The mean deviation of the round trip time in seconds */
+	double getRttVariance() const { return rttVariance; }
+
+	/** The last measured round trip time in seconds */
+	double getLatestRtt() const { return latestRtt; }
+
+	/** The timeout in seconds for a response, fallback until the first sample */
+	double getTimeout(double fallback) const;
+
+private:
+
+	double smoothedRtt;
+
+	double rttVariance;
+
+	double latestRtt;
+
+	uint64 sampleCount;
+
+	int32 backoffShift;
+};
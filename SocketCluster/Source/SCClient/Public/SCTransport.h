@@ -11,10 +11,12 @@
 #include "SCJsonObject.h"
 #include "SCJsonValue.h"
 #include "SCSocket.h"
+#include "SCNetworkSimulator.h"
 #include "SCClientSocket.h"
 #include "SCEventObject.h"
 #include "SCResponse.h"
-#include "SCSocket.h"
+#include "SCMetrics.h"
+#include "SCRttEstimator.h"
 #include "SCTransport.generated.h"
 
 /**
@@ -94,6 +96,12 @@ private:
 
 	/** The ping timeout handler */
 	FTimerHandle _pingTimeoutTickerHandle;
+
+	/** The arena document frames are decoded into, reset after every frame */
+	FSCJsonDocument _document;
+
+	/** Set while _document holds a frame, handlers which make the socket receive again fall back to the FJsonValue path */
+	bool _documentInUse = false;
 	
 public:
 
@@ -107,7 +115,63 @@ public:
 
 	TFunction<void(FString event, TSharedPtr<FJsonValue> data, USCResponse* res)> onevent;
 
-	void create(USCAuthEngine* authEngine, USCCodecEngine* codecEngine, TSharedPtr<FJsonObject> opts);
+	/** Optional, tells the transport whether an event has listeners so it can skip building unused raw messages */
+	TFunction<bool(const FString& event)> haslistener;
+
+	/**
+	* Optional, receives events read in place from the arena document of the frame (cid is 0 when no response is expected).
+	* Returns whether the event was handled, the others are copied out of the arena and passed to onevent.
+	*/
+	TFunction<bool(const FString& event, const FSCJsonNode& data, int32 cid)> oneventview;
+
+	/** Optional, tells the transport whether oneventview handles an event, frames of other events are decoded without the document */
+	TFunction<bool(const FString& event)> haseventview;
+
+	/** Whether frames are decoded into the arena document first, only worth it while oneventview has handlers */
+	bool useDocument = false;
+
+	/** Optional, the metrics of the client socket, set before create */
+	UPROPERTY()
+	USCMetrics* metrics = nullptr;
+
+	/** Optional, the round trip time estimate every acknowledgement is added to */
+	TSharedPtr<FSCRttEstimator> rtt;
+
+	/** Whether the ack timeout of emits follows rtt instead of the ackTimeout option */
+	bool adaptiveAckTimeout = false;
+
+	/** Optional, the capture every frame of the socket is appended to */
+	TSharedPtr<FSCSocketCapture> capture;
+
+	/** Start or stop capturing the frames of the current socket */
+	void setCapture(TSharedPtr<FSCSocketCapture> newCapture);
+
+	/** Optional, the network conditions the socket simulates */
+	TSharedPtr<FSCNetworkConditions> networkConditions;
+
+	/** Start, update or stop simulating network conditions on the current socket */
+	void setNetworkConditions(TSharedPtr<FSCNetworkConditions> conditions);
+
+	/** Drop the connection as if the network failed */
+	void simulateDisconnect(int32 code);
+
+	/** Returns the state of the transport */
+	ESocketClusterState getState() const { return state; }
+
+	/** Returns the number of frames queued on the socket which were not written yet */
+	int32 getSendQueueLength() const;
+
+	/** Returns the number of emits waiting for their acknowledgement */
+	int32 getPendingAckCount() const;
+
+	/**
+	* Open the transport.
+	* An offline transport opens its socket without a connection and only receives the frames passed to receiveOffline, used to replay a capture.
+	*/
+	void create(USCAuthEngine* authEngine, USCCodecEngine* codecEngine, TSharedPtr<FJsonObject> opts, bool offline = false);
+
+	/** Handle a frame as if it was received on the connection, only on an offline transport */
+	void receiveOffline(const TArray<uint8>& message, bool binary);
 
 private:
 
@@ -115,15 +179,28 @@ private:
 	
 	void _onOpen();
 
+	void _onOfflineOpen();
+
 	void _handshake(TFunction<void(TSharedPtr<FJsonValue>, TSharedPtr<FJsonValue>)> callback);
 
 	void _abortAllPendingEventsDueToBadConnection(FString failureType);
 
 	void _onClose(int32 code, FString data = "");
 
-	void _handleEventObject(TSharedPtr<FJsonObject> obj, FString message);
+	void _handleEventObject(TSharedPtr<FJsonObject> obj, const TArray<uint8>& message, bool binary);
+
+	/** The raw frame as passed to the message and raw events, a string for text frames and binary for binary frames */
+	TSharedPtr<FJsonValue> _rawMessage(const TArray<uint8>& message, bool binary);
 
-	void _onMessage(FString message);
+	void _onData(const TArray<uint8>& message, bool binary);
+
+	/** Whether a frame is worth decoding into _document, the event name is read ahead of the decode when the codec can */
+	bool _wantsDocument(const TArray<uint8>& message, bool binary);
+
+	/** Handle the packets of a frame decoded into _document, returns false if the frame has to go through the FJsonValue path */
+	bool _onDocument(const TArray<uint8>& message, bool binary);
+
+	void _handleEventNode(const FSCJsonNode& packet, const TArray<uint8>& message, bool binary);
 
 	void _onError(TSharedPtr<FJsonValue> err);
 
@@ -151,16 +228,17 @@ public:
 
 	void send(FString data);
 
+	void sendObject(TSharedPtr<FJsonValue> object, TSharedPtr<FJsonObject> options = nullptr);
+
 private:
 
-	FString serializeObject(TSharedPtr<FJsonValue> object);
+	/** Encode object with the codec into a new socket frame */
+	void sendEncoded(TSharedPtr<FJsonValue> object);
 
 	void sendObjectBatch(TSharedPtr<FJsonValue> object);
 
 	void sendObjectSingle(TSharedPtr<FJsonValue> object);
 
-	void sendObject(TSharedPtr<FJsonValue> object, TSharedPtr<FJsonObject> options = nullptr);
-
 	int32 callIdGenerator();
 
 public:
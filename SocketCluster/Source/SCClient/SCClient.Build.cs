@@ -21,6 +21,7 @@ public class SCClient : ModuleRules
                 "SCAuthEngine",
                 "SCErrors",
                 "SCJson",
+                "TraceLog",
 			}
            );
 
@@ -0,0 +1,410 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCCodecBenchmark.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/EngineVersion.h"
+#include "UObject/UObjectHash.h"
+#include "Interfaces/IPluginManager.h"
+#include "SCAllocationCounter.h"
+#include "SCCodecBenchmarkModule.h"
+#include "SCJsonConvert.h"
+#include "SCJsonValue.h"
+#include "SCJsonArena.h"
+
+/** Time operation over iterations runs after as many warmup runs, then count its allocations in a separate pass */
+template <typename OperationType>
+static TSharedPtr<FJsonObject> SCMeasure(int32 iterations, bool countAllocations, OperationType&& operation)
+{
+	for (int32 i = 0; i < iterations; i++)
+	{
+		operation();
+	}
+
+	const uint64 start = FPlatformTime::Cycles64();
+	for (int32 i = 0; i < iterations; i++)
+	{
+		operation();
+	}
+	const double nanoseconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - start) * 1000000000.0;
+
+	TSharedPtr<FJsonObject> result = MakeShareable(new FJsonObject);
+	result->SetNumberField("nsPerOp", nanoseconds / iterations);
+	result->SetNumberField("opsPerSecond", nanoseconds > 0.0 ? iterations / (nanoseconds / 1000000000.0) : 0.0);
+
+	if (countAllocations)
+	{
+		// The counting proxy slows every allocation down, so it stays out of the timed pass
+		int64 allocations;
+		int64 allocatedBytes;
+		{
+			FSCAllocationCounterScope scope;
+			for (int32 i = 0; i < iterations; i++)
+			{
+				operation();
+			}
+			allocations = scope.get().getAllocations();
+			allocatedBytes = scope.get().getBytes();
+		}
+		result->SetNumberField("allocationsPerOp", (double)allocations / iterations);
+		result->SetNumberField("allocatedBytesPerOp", (double)allocatedBytes / iterations);
+	}
+	return result;
+}
+
+static TSharedPtr<FJsonValue> SCMakeEntity(int32 id)
+{
+	TSharedPtr<FJsonObject> entity = MakeShareable(new FJsonObject);
+	entity->SetNumberField("id", id);
+	entity->SetStringField("type", id % 4 == 0 ? "vehicle" : "character");
+	entity->SetArrayField("position", { USCJsonConvert::ToJsonValue(id * 1.25), USCJsonConvert::ToJsonValue(id * -0.5), USCJsonConvert::ToJsonValue(100.0 + id) });
+	entity->SetNumberField("yaw", (id * 37) % 360);
+	entity->SetNumberField("health", 100 - id % 100);
+	entity->SetBoolField("alive", id % 7 != 0);
+	return USCJsonConvert::ToJsonValue(entity);
+}
+
+TArray<FSCCodecCorpusFrame> FSCCodecBenchmark::buildCorpus(const FString& corpusDirectory)
+{
+	TArray<FSCCodecCorpusFrame> corpus;
+
+	{
+		TSharedPtr<FJsonObject> data = MakeShareable(new FJsonObject);
+		data->SetStringField("user", "player_42");
+		data->SetStringField("message", "gg wp");
+		TSharedPtr<FJsonObject> packet = MakeShareable(new FJsonObject);
+		packet->SetStringField("event", "chat");
+		packet->SetObjectField("data", data);
+		packet->SetNumberField("cid", 17);
+		corpus.Add({ "chat", "small", USCJsonConvert::ToJsonValue(packet) });
+	}
+
+	{
+		TArray<TSharedPtr<FJsonValue>> players;
+		for (int32 i = 0; i < 8; i++)
+		{
+			players.Add(SCMakeEntity(i));
+		}
+		TSharedPtr<FJsonObject> state = MakeShareable(new FJsonObject);
+		state->SetNumberField("seq", 9812);
+		state->SetArrayField("players", players);
+		TSharedPtr<FJsonObject> publication = MakeShareable(new FJsonObject);
+		publication->SetStringField("channel", "match.1234.state");
+		publication->SetObjectField("data", state);
+		TSharedPtr<FJsonObject> packet = MakeShareable(new FJsonObject);
+		packet->SetStringField("event", "#publish");
+		packet->SetObjectField("data", publication);
+		corpus.Add({ "matchState", "publish", USCJsonConvert::ToJsonValue(packet) });
+	}
+
+	{
+		TArray<TSharedPtr<FJsonValue>> entities;
+		for (int32 i = 0; i < 1000; i++)
+		{
+			entities.Add(SCMakeEntity(i));
+		}
+		TSharedPtr<FJsonObject> snapshot = MakeShareable(new FJsonObject);
+		snapshot->SetNumberField("tick", 48213);
+		snapshot->SetArrayField("entities", entities);
+		TSharedPtr<FJsonObject> packet = MakeShareable(new FJsonObject);
+		packet->SetNumberField("rid", 3);
+		packet->SetObjectField("data", snapshot);
+		corpus.Add({ "worldSnapshot", "snapshot", USCJsonConvert::ToJsonValue(packet) });
+	}
+
+	{
+		FRandomStream random(1234);
+		TArray<TSharedPtr<FJsonValue>> frames;
+		for (int32 i = 0; i < 4; i++)
+		{
+			TArray<uint8> bytes;
+			bytes.SetNumUninitialized(4096);
+			for (uint8& byte : bytes)
+			{
+				byte = (uint8)random.RandRange(0, 255);
+			}
+			frames.Add(MakeShareable(new FJsonValueBinary(bytes)));
+		}
+		TSharedPtr<FJsonObject> data = MakeShareable(new FJsonObject);
+		data->SetNumberField("seq", 77);
+		data->SetStringField("codec", "opus");
+		data->SetArrayField("frames", frames);
+		TSharedPtr<FJsonObject> packet = MakeShareable(new FJsonObject);
+		packet->SetStringField("event", "voice");
+		packet->SetObjectField("data", data);
+		corpus.Add({ "voiceFrames", "binary", USCJsonConvert::ToJsonValue(packet) });
+	}
+
+	if (!corpusDirectory.IsEmpty())
+	{
+		TArray<FString> files;
+		IFileManager::Get().FindFiles(files, *(corpusDirectory / TEXT("*.json")), true, false);
+		files.Sort();
+		for (const FString& file : files)
+		{
+			TArray<uint8> bytes;
+			if (!FFileHelper::LoadFileToArray(bytes, *(corpusDirectory / file)))
+			{
+				continue;
+			}
+			TSharedPtr<FJsonValue> value = USCJsonConvert::JsonBytesToJsonValue(bytes);
+			if (value.IsValid())
+			{
+				corpus.Add({ FPaths::GetBaseFilename(file), "recorded", value });
+			}
+			else
+			{
+				UE_LOG(LogSCCodecBenchmark, Warning, TEXT("Skipping corpus file %s, it is not valid JSON"), *file);
+			}
+		}
+	}
+
+	return corpus;
+}
+
+TSharedPtr<FJsonObject> FSCCodecBenchmark::run(const FSCCodecBenchmarkOptions& options)
+{
+	const int32 iterations = FMath::Max(1, options.iterations);
+	const TArray<FSCCodecCorpusFrame> corpus = buildCorpus(options.corpusDirectory);
+
+	TSharedPtr<FJsonObject> results = MakeShareable(new FJsonObject);
+	TSharedPtr<IPlugin> plugin = IPluginManager::Get().FindPlugin(TEXT("SocketCluster"));
+	results->SetStringField("plugin", plugin.IsValid() ? plugin->GetDescriptor().VersionName : FString());
+	results->SetStringField("engine", FEngineVersion::Current().ToString());
+	results->SetStringField("platform", ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+	results->SetStringField("timestamp", FDateTime::UtcNow().ToIso8601());
+	results->SetNumberField("iterations", iterations);
+
+	TArray<TSharedPtr<FJsonValue>> corpusSummary;
+	for (const FSCCodecCorpusFrame& frame : corpus)
+	{
+		TSharedPtr<FJsonObject> summary = MakeShareable(new FJsonObject);
+		summary->SetStringField("name", frame.name);
+		summary->SetStringField("category", frame.category);
+		corpusSummary.Add(USCJsonConvert::ToJsonValue(summary));
+	}
+	results->SetArrayField("corpus", corpusSummary);
+
+	TArray<UClass*> codecClasses;
+	GetDerivedClasses(USCCodecEngine::StaticClass(), codecClasses);
+
+	TSharedPtr<FJsonObject> codecs = MakeShareable(new FJsonObject);
+	for (UClass* codecClass : codecClasses)
+	{
+		if (codecClass->HasAnyClassFlags(CLASS_Abstract) || (options.codecs.Num() > 0 && !options.codecs.Contains(codecClass->GetName())))
+		{
+			continue;
+		}
+
+		USCCodecEngine* codec = codecClass->GetDefaultObject<USCCodecEngine>();
+		TSharedPtr<FJsonObject> codecResults = MakeShareable(new FJsonObject);
+		for (const FSCCodecCorpusFrame& frame : corpus)
+		{
+			TSharedPtr<FJsonObject> frameResults = MakeShareable(new FJsonObject);
+
+			TArray<uint8> encoded;
+			ESCCodecFrame frameType = ESCCodecFrame::TEXT;
+			TSharedPtr<FJsonObject> encode = SCMeasure(iterations, options.countAllocations, [&]()
+			{
+				encoded.Reset();
+				FSCByteWriter writer(encoded);
+				frameType = codec->encodeTo(frame.value, writer);
+			});
+			encode->SetNumberField("bytesPerOp", encoded.Num());
+			encode->SetBoolField("binary", frameType == ESCCodecFrame::BINARY);
+			frameResults->SetObjectField("encode", encode);
+
+			const TArrayView<const uint8> bytes(encoded);
+			if (!codec->decode(bytes, frameType).IsValid())
+			{
+				frameResults->SetStringField("error", "The encoded frame could not be decoded");
+				codecResults->SetObjectField(frame.name, frameResults);
+				continue;
+			}
+
+			TSharedPtr<FJsonObject> decode = SCMeasure(iterations, options.countAllocations, [&]()
+			{
+				codec->decode(bytes, frameType);
+			});
+			decode->SetNumberField("bytesPerOp", encoded.Num());
+			frameResults->SetObjectField("decode", decode);
+
+			FSCJsonDocument document;
+			if (codec->decode(bytes, frameType, document))
+			{
+				TSharedPtr<FJsonObject> decodeDocument = SCMeasure(iterations, options.countAllocations, [&]()
+				{
+					codec->decode(bytes, frameType, document);
+				});
+				decodeDocument->SetNumberField("bytesPerOp", encoded.Num());
+				frameResults->SetObjectField("decodeDocument", decodeDocument);
+			}
+
+			codecResults->SetObjectField(frame.name, frameResults);
+		}
+		codecs->SetObjectField(codecClass->GetName(), codecResults);
+	}
+	results->SetObjectField("codecs", codecs);
+
+	TSharedPtr<FJsonObject> helpers = MakeShareable(new FJsonObject);
+	for (const FSCCodecCorpusFrame& frame : corpus)
+	{
+		TSharedPtr<FJsonObject> frameResults = MakeShareable(new FJsonObject);
+
+		FString text;
+		TSharedPtr<FJsonObject> toJsonString = SCMeasure(iterations, options.countAllocations, [&]()
+		{
+			text = USCJsonConvert::ToJsonString(frame.value);
+		});
+
+		FTCHARToUTF8 converted(*text);
+		const TArray<uint8> utf8((const uint8*)converted.Get(), converted.Length());
+		toJsonString->SetNumberField("bytesPerOp", utf8.Num());
+		frameResults->SetObjectField("toJsonString", toJsonString);
+
+		TSharedPtr<FJsonObject> jsonStringToJsonValue = SCMeasure(iterations, options.countAllocations, [&]()
+		{
+			USCJsonConvert::JsonStringToJsonValue(text);
+		});
+		jsonStringToJsonValue->SetNumberField("bytesPerOp", utf8.Num());
+		frameResults->SetObjectField("jsonStringToJsonValue", jsonStringToJsonValue);
+
+		TSharedPtr<FJsonObject> jsonBytesToJsonValue = SCMeasure(iterations, options.countAllocations, [&]()
+		{
+			USCJsonConvert::JsonBytesToJsonValue(utf8);
+		});
+		jsonBytesToJsonValue->SetNumberField("bytesPerOp", utf8.Num());
+		frameResults->SetObjectField("jsonBytesToJsonValue", jsonBytesToJsonValue);
+
+		helpers->SetObjectField(frame.name, frameResults);
+	}
+	results->SetObjectField("helpers", helpers);
+
+	return results;
+}
+
+static void SCLogCodecResults(TSharedPtr<FJsonObject> results)
+{
+	auto logOperations = [](const FString& owner, const FString& frame, TSharedPtr<FJsonObject> operations)
+	{
+		for (auto& operation : operations->Values)
+		{
+			if (operation.Value->Type != EJson::Object)
+			{
+				continue;
+			}
+			TSharedPtr<FJsonObject> result = operation.Value->AsObject();
+			double allocations = 0.0;
+			result->TryGetNumberField("allocationsPerOp", allocations);
+			UE_LOG(LogSCCodecBenchmark, Display, TEXT("%-16s %-16s %-22s %12.0f ns/op %10.0f B/op %8.1f allocs/op"), *owner, *frame, *operation.Key,
+				result->GetNumberField("nsPerOp"), result->GetNumberField("bytesPerOp"), allocations);
+		}
+	};
+
+	for (auto& codec : results->GetObjectField("codecs")->Values)
+	{
+		for (auto& frame : codec.Value->AsObject()->Values)
+		{
+			logOperations(codec.Key, frame.Key, frame.Value->AsObject());
+		}
+	}
+	for (auto& frame : results->GetObjectField("helpers")->Values)
+	{
+		logOperations("USCJsonConvert", frame.Key, frame.Value->AsObject());
+	}
+}
+
+static FString SCDefaultCodecResultsPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SCBenchmarks") / FString::Printf(TEXT("SCCodecBenchmark-%s.json"), *FDateTime::Now().ToString());
+}
+
+bool FSCCodecBenchmark::writeResults(TSharedPtr<FJsonObject> results, FString path)
+{
+	if (path.IsEmpty())
+	{
+		path = SCDefaultCodecResultsPath();
+	}
+	if (!FFileHelper::SaveStringToFile(USCJsonConvert::ToJsonString(results), *path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogSCCodecBenchmark, Error, TEXT("Could not write the codec benchmark results to %s"), *path);
+		return false;
+	}
+	UE_LOG(LogSCCodecBenchmark, Log, TEXT("Codec benchmark results written to %s"), *path);
+	return true;
+}
+
+USCCodecBenchmarkCommandlet::USCCodecBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	HelpDescription = TEXT("Measures the SocketCluster codec engines and JSON helpers over a corpus of frames");
+	HelpUsage = TEXT("-run=SCCodecBenchmark [-iterations=1000] [-codecs=SC_Formatter,SC_CodecMinBin] [-corpus=dir] [-out=file] [-noallocations]");
+}
+
+int32 USCCodecBenchmarkCommandlet::Main(const FString& Params)
+{
+	FSCCodecBenchmarkOptions options;
+	FParse::Value(*Params, TEXT("iterations="), options.iterations);
+	FParse::Value(*Params, TEXT("corpus="), options.corpusDirectory);
+	options.countAllocations = !FParse::Param(*Params, TEXT("noallocations"));
+
+	FString codecs;
+	if (FParse::Value(*Params, TEXT("codecs="), codecs, false))
+	{
+		codecs.ParseIntoArray(options.codecs, TEXT(","));
+	}
+
+	FString out;
+	if (!FParse::Value(*Params, TEXT("out="), out))
+	{
+		out = SCDefaultCodecResultsPath();
+	}
+
+	TSharedPtr<FJsonObject> results = FSCCodecBenchmark::run(options);
+	SCLogCodecResults(results);
+	return FSCCodecBenchmark::writeResults(results, out) ? 0 : 1;
+}
+
+static void RunCodecBenchmarkCommand(const TArray<FString>& Args)
+{
+	FSCCodecBenchmarkOptions options;
+	FString out = SCDefaultCodecResultsPath();
+	for (const FString& arg : Args)
+	{
+		if (arg.StartsWith("-iterations="))
+		{
+			options.iterations = FCString::Atoi(*arg.Mid(12));
+		}
+		else if (arg.StartsWith("-corpus="))
+		{
+			options.corpusDirectory = arg.Mid(8);
+		}
+		else if (arg.StartsWith("-out="))
+		{
+			out = arg.Mid(5);
+		}
+		else if (arg.Equals("-noallocations"))
+		{
+			options.countAllocations = false;
+		}
+		else
+		{
+			options.codecs.Add(arg);
+		}
+	}
+
+	TSharedPtr<FJsonObject> results = FSCCodecBenchmark::run(options);
+	SCLogCodecResults(results);
+	FSCCodecBenchmark::writeResults(results, out);
+}
+
+static FAutoConsoleCommand SCCodecBenchmarkCommand(
+	TEXT("SocketCluster.CodecBenchmark"),
+	TEXT("Measures the SocketCluster codec engines and JSON helpers and writes the results to Saved/SCBenchmarks. Arguments: [codec ...] [-iterations=1000] [-corpus=dir] [-out=file] [-noallocations]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunCodecBenchmarkCommand)
+);
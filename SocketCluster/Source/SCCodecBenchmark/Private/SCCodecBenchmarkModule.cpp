@@ -0,0 +1,22 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCCodecBenchmarkModule.h"
+
+#define LOCTEXT_NAMESPACE "FSCCodecBenchmarkModule"
+
+DEFINE_LOG_CATEGORY(LogSCCodecBenchmark);
+
+void FSCCodecBenchmarkModule::StartupModule()
+{
+	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+}
+
+void FSCCodecBenchmarkModule::ShutdownModule()
+{
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FSCCodecBenchmarkModule, SCCodecBenchmark)
\ No newline at end of file
@@ -0,0 +1,70 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "Commandlets/Commandlet.h"
+#include "SCCodecEngine.h"
+#include "SCCodecBenchmark.generated.h"
+
+/** The settings of a codec benchmark run */
+struct FSCCodecBenchmarkOptions
+{
+	/** The number of times every operation runs per frame, after as many warmup runs */
+	int32 iterations = 1000;
+
+	/** The codec classes to measure by name (SC_Formatter, SC_CodecMinBin), every codec when empty */
+	TArray<FString> codecs;
+
+	/** The directory of recorded .json frames added to the corpus, only the built in frames are used when empty */
+	FString corpusDirectory;
+
+	/** Whether allocations are counted, which swaps GMalloc for a counting proxy while an operation runs */
+	bool countAllocations = true;
+};
+
+/** A frame of the codec benchmark corpus */
+struct FSCCodecCorpusFrame
+{
+	FString name;
+
+	/** small, publish, snapshot, binary or recorded */
+	FString category;
+
+	TSharedPtr<FJsonValue> value;
+};
+
+/**
+* The SocketCluster Codec Benchmark
+*
+* Measures encode, decode and the USCJsonConvert helpers (ToJsonString, JsonStringToJsonValue, JsonBytesToJsonValue) of every codec engine over a corpus of frames.
+* Every operation reports ns/op, bytes/op (the encoded size) and allocations/op with the allocated bytes/op.
+* Needs no game world, it runs from the SCCodecBenchmark commandlet or the SocketCluster.CodecBenchmark console command.
+*/
+struct SCCODECBENCHMARK_API FSCCodecBenchmark
+{
+	static TSharedPtr<FJsonObject> run(const FSCCodecBenchmarkOptions& options);
+
+	/** The built in frames (small events, channel publishes, large snapshots, binary heavy) and the recorded frames in corpusDirectory */
+	static TArray<FSCCodecCorpusFrame> buildCorpus(const FString& corpusDirectory = FString());
+
+	/** Write results to a file, the default file is Saved/SCBenchmarks/SCCodecBenchmark-<time>.json */
+	static bool writeResults(TSharedPtr<FJsonObject> results, FString path = FString());
+};
+
+/**
+* Runs FSCCodecBenchmark headless and writes the results to Saved/SCBenchmarks.
+* UE4Editor-Cmd <Project> -run=SCCodecBenchmark [-iterations=1000] [-codecs=SC_Formatter,SC_CodecMinBin] [-corpus=dir] [-out=file] [-noallocations]
+*/
+UCLASS()
+class SCCODECBENCHMARK_API USCCodecBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USCCodecBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,30 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class SCCodecBenchmark : ModuleRules
+{
+	public SCCodecBenchmark(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"Json",
+				"SCJson",
+				"SCCodecEngine",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Projects",
+			}
+			);
+	}
+}
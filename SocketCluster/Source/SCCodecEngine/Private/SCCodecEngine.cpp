@@ -2,6 +2,7 @@
 
 #include "SCCodecEngine.h"
 #include "SCCodecEngineModule.h"
+#include "SCMessageAccounting.h"
 
 FString USCCodecEngine::encode(TSharedPtr<FJsonValue> object)
 {
@@ -18,3 +19,26 @@ TSharedPtr<FJsonValue> USCCodecEngine::decode(const FString& input)
 	#endif
 	return nullptr;
 }
+
+ESCCodecFrame USCCodecEngine::encodeTo(TSharedPtr<FJsonValue> object, FSCByteWriter& writer)
+{
+	writer.writeUTF8(encode(object));
+	return ESCCodecFrame::TEXT;
+}
+
+TSharedPtr<FJsonValue> USCCodecEngine::decode(TArrayView<const uint8> input, ESCCodecFrame frame)
+{
+	FUTF8ToTCHAR converted((const ANSICHAR*)input.GetData(), input.Num());
+	SC_ACCOUNT_TRANSCODE(input.Num());
+	return decode(FString(converted.Length(), converted.Get()));
+}
+
+bool USCCodecEngine::decode(TArrayView<const uint8> Input, ESCCodecFrame Frame, FSCJsonDocument& Document)
+{
+	return false;
+}
+
+bool USCCodecEngine::peekEvent(TArrayView<const uint8> Input, ESCCodecFrame Frame, FString& OutEvent)
+{
+	return false;
+}
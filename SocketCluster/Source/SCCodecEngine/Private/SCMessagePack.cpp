@@ -0,0 +1,409 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCMessagePack.h"
+#include "Dom/JsonObject.h"
+#include "SCJsonValue.h"
+#include "SCJsonNumber.h"
+#include "SCMessageAccounting.h"
+
+/** Nesting limit of the decoder, deeper input is rejected instead of overflowing the stack */
+static const int32 SCMessagePackMaxDepth = 256;
+
+static FORCEINLINE uint64 SCReadBigEndian(const uint8* data, int32 bytes)
+{
+	uint64 value = 0;
+	for (int32 i = 0; i < bytes; i++)
+	{
+		value = (value << 8) | data[i];
+	}
+	return value;
+}
+
+void FSCMessagePack::encode(const TSharedPtr<FJsonValue>& value, FSCByteWriter& out)
+{
+	if (!value.IsValid())
+	{
+		out.write(0xc0);
+		return;
+	}
+
+	switch (value->Type)
+	{
+	case EJson::Boolean:
+		out.write(value->AsBool() ? 0xc3 : 0xc2);
+		break;
+	case EJson::Number:
+		writeNumber(value->AsNumber(), out);
+		break;
+	case EJson::String:
+		if (FJsonValueBinary::IsBinary(value))
+		{
+			writeBinary(FJsonValueBinary::AsBinary(value), out);
+		}
+		else
+		{
+			writeString(value->AsString(), out);
+		}
+		break;
+	case EJson::Array:
+	if (const TArray<double>* numbers = FJsonValueNumberArray::AsNumberArray(value))
+	{
+		writeHeader(0x90, 16, 0xdc, 0xdd, numbers->Num(), out);
+		for (double number : *numbers)
+		{
+			writeNumber(number, out);
+		}
+	}
+	else
+	{
+		const TArray<TSharedPtr<FJsonValue>>& array = value->AsArray();
+		writeHeader(0x90, 16, 0xdc, 0xdd, array.Num(), out);
+		for (const TSharedPtr<FJsonValue>& item : array)
+		{
+			encode(item, out);
+		}
+	}
+	break;
+	case EJson::Object:
+	{
+		const TSharedPtr<FJsonObject>& object = value->AsObject();
+		if (!object.IsValid())
+		{
+			out.write(0xc0);
+			break;
+		}
+		writeHeader(0x80, 16, 0xde, 0xdf, object->Values.Num(), out);
+		for (const auto& field : object->Values)
+		{
+			writeString(field.Key, out);
+			encode(field.Value, out);
+		}
+	}
+	break;
+	case EJson::None:
+	case EJson::Null:
+	default:
+		out.write(0xc0);
+		break;
+	}
+}
+
+void FSCMessagePack::writeNumber(double value, FSCByteWriter& out)
+{
+	// Same rule as msgpack-lite: a number is an integer when (value | 0) === value
+	if (FMath::IsFinite(value) && value >= (double)MIN_int32 && value <= (double)MAX_int32 && (double)(int32)value == value)
+	{
+		int32 integer = (int32)value;
+		if (integer >= -0x20 && integer <= 0x7f)
+		{
+			out.write((uint8)(int8)integer);
+		}
+		else if (integer >= 0)
+		{
+			if (integer <= 0xff)
+			{
+				out.write(0xcc);
+				out.writeBigEndian((uint32)integer, 1);
+			}
+			else if (integer <= 0xffff)
+			{
+				out.write(0xcd);
+				out.writeBigEndian((uint32)integer, 2);
+			}
+			else
+			{
+				out.write(0xce);
+				out.writeBigEndian((uint32)integer, 4);
+			}
+		}
+		else
+		{
+			if (integer >= -0x80)
+			{
+				out.write(0xd0);
+				out.writeBigEndian((uint8)(int8)integer, 1);
+			}
+			else if (integer >= -0x8000)
+			{
+				out.write(0xd1);
+				out.writeBigEndian((uint16)(int16)integer, 2);
+			}
+			else
+			{
+				out.write(0xd2);
+				out.writeBigEndian((uint32)integer, 4);
+			}
+		}
+		return;
+	}
+
+	uint64 bits;
+	FMemory::Memcpy(&bits, &value, sizeof(bits));
+	out.write(0xcb);
+	out.writeBigEndian(bits, 8);
+}
+
+void FSCMessagePack::writeString(const FString& value, FSCByteWriter& out)
+{
+	FTCHARToUTF8 utf8(*value, value.Len());
+	SC_ACCOUNT_TRANSCODE(utf8.Length());
+	uint32 length = (uint32)utf8.Length();
+	if (length < 32)
+	{
+		out.write((uint8)(0xa0 | length));
+	}
+	else if (length <= 0xff)
+	{
+		out.write(0xd9);
+		out.writeBigEndian(length, 1);
+	}
+	else if (length <= 0xffff)
+	{
+		out.write(0xda);
+		out.writeBigEndian(length, 2);
+	}
+	else
+	{
+		out.write(0xdb);
+		out.writeBigEndian(length, 4);
+	}
+	out.write(utf8.Get(), length);
+}
+
+void FSCMessagePack::writeBinary(const TArray<uint8>& value, FSCByteWriter& out)
+{
+	uint32 length = (uint32)value.Num();
+	if (length <= 0xff)
+	{
+		out.write(0xc4);
+		out.writeBigEndian(length, 1);
+	}
+	else if (length <= 0xffff)
+	{
+		out.write(0xc5);
+		out.writeBigEndian(length, 2);
+	}
+	else
+	{
+		out.write(0xc6);
+		out.writeBigEndian(length, 4);
+	}
+	out.write(value.GetData(), value.Num());
+}
+
+void FSCMessagePack::writeHeader(uint8 fixType, uint8 fixLimit, uint8 type16, uint8 type32, uint32 length, FSCByteWriter& out)
+{
+	if (length < fixLimit)
+	{
+		out.write((uint8)(fixType | length));
+	}
+	else if (length <= 0xffff)
+	{
+		out.write(type16);
+		out.writeBigEndian(length, 2);
+	}
+	else
+	{
+		out.write(type32);
+		out.writeBigEndian(length, 4);
+	}
+}
+
+TSharedPtr<FJsonValue> FSCMessagePack::decode(const uint8* data, int32 size)
+{
+	if (data == nullptr || size <= 0)
+	{
+		return nullptr;
+	}
+
+	const uint8* cursor = data;
+	return readValue(cursor, data + size, 0);
+}
+
+TSharedPtr<FJsonValue> FSCMessagePack::readValue(const uint8*& cursor, const uint8* end, int32 depth)
+{
+	if (cursor >= end || depth > SCMessagePackMaxDepth)
+	{
+		return nullptr;
+	}
+
+	uint8 type = *cursor++;
+
+	// Reads a big endian length or value of the given number of bytes, bails out on truncated input
+	#define SC_MSGPACK_READ(Bytes, Out) \
+		if (end - cursor < (Bytes)) { return nullptr; } \
+		Out = SCReadBigEndian(cursor, (Bytes)); \
+		cursor += (Bytes);
+
+	uint64 length = 0;
+	int32 kind;
+
+	// 0 = string, 1 = binary, 2 = array, 3 = map, 4 = ext
+	if (type <= 0x7f)
+	{
+		return MakeShareable(new FJsonValueNumber(type));
+	}
+	else if (type >= 0xe0)
+	{
+		return MakeShareable(new FJsonValueNumber((int8)type));
+	}
+	else if ((type & 0xe0) == 0xa0)
+	{
+		kind = 0;
+		length = type & 0x1f;
+	}
+	else if ((type & 0xf0) == 0x90)
+	{
+		kind = 2;
+		length = type & 0x0f;
+	}
+	else if ((type & 0xf0) == 0x80)
+	{
+		kind = 3;
+		length = type & 0x0f;
+	}
+	else
+	{
+		uint64 raw;
+		switch (type)
+		{
+		case 0xc0:
+			return MakeShareable(new FJsonValueNull);
+		case 0xc2:
+			return MakeShareable(new FJsonValueBoolean(false));
+		case 0xc3:
+			return MakeShareable(new FJsonValueBoolean(true));
+		case 0xc4: kind = 1; SC_MSGPACK_READ(1, length); break;
+		case 0xc5: kind = 1; SC_MSGPACK_READ(2, length); break;
+		case 0xc6: kind = 1; SC_MSGPACK_READ(4, length); break;
+		case 0xc7: kind = 4; SC_MSGPACK_READ(1, length); length += 1; break;
+		case 0xc8: kind = 4; SC_MSGPACK_READ(2, length); length += 1; break;
+		case 0xc9: kind = 4; SC_MSGPACK_READ(4, length); length += 1; break;
+		case 0xca:
+		{
+			SC_MSGPACK_READ(4, raw);
+			uint32 bits = (uint32)raw;
+			float value;
+			FMemory::Memcpy(&value, &bits, sizeof(value));
+			return MakeShareable(new FJsonValueNumber(value));
+		}
+		case 0xcb:
+		{
+			SC_MSGPACK_READ(8, raw);
+			double value;
+			FMemory::Memcpy(&value, &raw, sizeof(value));
+			return MakeShareable(new FJsonValueNumber(value));
+		}
+		case 0xcc: SC_MSGPACK_READ(1, raw); return MakeShareable(new FJsonValueNumber((double)raw));
+		case 0xcd: SC_MSGPACK_READ(2, raw); return MakeShareable(new FJsonValueNumber((double)raw));
+		case 0xce: SC_MSGPACK_READ(4, raw); return MakeShareable(new FJsonValueNumber((double)raw));
+		case 0xcf: SC_MSGPACK_READ(8, raw); return MakeShareable(new FJsonValueNumber((double)raw));
+		case 0xd0: SC_MSGPACK_READ(1, raw); return MakeShareable(new FJsonValueNumber((double)(int8)raw));
+		case 0xd1: SC_MSGPACK_READ(2, raw); return MakeShareable(new FJsonValueNumber((double)(int16)raw));
+		case 0xd2: SC_MSGPACK_READ(4, raw); return MakeShareable(new FJsonValueNumber((double)(int32)raw));
+		case 0xd3: SC_MSGPACK_READ(8, raw); return MakeShareable(new FJsonValueNumber((double)(int64)raw));
+		case 0xd4: kind = 4; length = 2; break;
+		case 0xd5: kind = 4; length = 3; break;
+		case 0xd6: kind = 4; length = 5; break;
+		case 0xd7: kind = 4; length = 9; break;
+		case 0xd8: kind = 4; length = 17; break;
+		case 0xd9: kind = 0; SC_MSGPACK_READ(1, length); break;
+		case 0xda: kind = 0; SC_MSGPACK_READ(2, length); break;
+		case 0xdb: kind = 0; SC_MSGPACK_READ(4, length); break;
+		case 0xdc: kind = 2; SC_MSGPACK_READ(2, length); break;
+		case 0xdd: kind = 2; SC_MSGPACK_READ(4, length); break;
+		case 0xde: kind = 3; SC_MSGPACK_READ(2, length); break;
+		case 0xdf: kind = 3; SC_MSGPACK_READ(4, length); break;
+		default:
+			// 0xc1 is never used
+			return nullptr;
+		}
+	}
+
+	#undef SC_MSGPACK_READ
+
+	switch (kind)
+	{
+	case 0:
+	{
+		if ((uint64)(end - cursor) < length)
+		{
+			return nullptr;
+		}
+		FUTF8ToTCHAR converted((const ANSICHAR*)cursor, (int32)length);
+		SC_ACCOUNT_TRANSCODE((int32)length);
+		cursor += length;
+		return MakeShareable(new FJsonValueString(FString(converted.Length(), converted.Get())));
+	}
+	case 1:
+	{
+		if ((uint64)(end - cursor) < length)
+		{
+			return nullptr;
+		}
+		TArray<uint8> bytes(cursor, (int32)length);
+		cursor += length;
+		return MakeShareable(new FJsonValueBinary(bytes));
+	}
+	case 2:
+	{
+		// Every element takes at least one byte, reject lengths the remaining input can not hold before reserving memory
+		if ((uint64)(end - cursor) < length)
+		{
+			return nullptr;
+		}
+		TArray<TSharedPtr<FJsonValue>> array;
+		array.Reserve((int32)length);
+		for (uint64 i = 0; i < length; i++)
+		{
+			TSharedPtr<FJsonValue> item = readValue(cursor, end, depth + 1);
+			if (!item.IsValid())
+			{
+				return nullptr;
+			}
+			array.Add(item);
+		}
+		return MakeShareable(new FJsonValueArray(array));
+	}
+	case 3:
+	{
+		if ((uint64)(end - cursor) < length * 2)
+		{
+			return nullptr;
+		}
+		TSharedPtr<FJsonObject> object = MakeShareable(new FJsonObject);
+		for (uint64 i = 0; i < length; i++)
+		{
+			TSharedPtr<FJsonValue> key = readValue(cursor, end, depth + 1);
+			TSharedPtr<FJsonValue> item = key.IsValid() ? readValue(cursor, end, depth + 1) : nullptr;
+			if (!item.IsValid())
+			{
+				return nullptr;
+			}
+
+			FString keyString;
+			if (key->Type == EJson::Number)
+			{
+				keyString = FSCJsonNumber::ToString(key->AsNumber());
+			}
+			else if (!key->TryGetString(keyString))
+			{
+				return nullptr;
+			}
+			object->SetField(keyString, item);
+		}
+		return MakeShareable(new FJsonValueObject(object));
+	}
+	case 4:
+	default:
+	{
+		// Extension types are not used by sc-codec-min-bin, skip the payload (type byte included)
+		if ((uint64)(end - cursor) < length)
+		{
+			return nullptr;
+		}
+		cursor += length;
+		return MakeShareable(new FJsonValueNull);
+	}
+	}
+}
@@ -0,0 +1,218 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SC_CodecMinBin.h"
+#include "SCMessagePack.h"
+
+static FORCEINLINE bool SCIsSet(const TSharedPtr<FJsonValue>* field)
+{
+	return field != nullptr && field->IsValid() && !(*field)->IsNull();
+}
+
+static FORCEINLINE TSharedPtr<FJsonValue> SCValueOrNull(const TSharedPtr<FJsonValue>* field)
+{
+	return field != nullptr && field->IsValid() ? *field : MakeShareable(new FJsonValueNull);
+}
+
+FString USC_CodecMinBin::encode(TSharedPtr<FJsonValue> object)
+{
+	return USCJsonConvert::ToJsonString(object);
+}
+
+TSharedPtr<FJsonValue> USC_CodecMinBin::decode(const FString& input)
+{
+	// Leave ping or pong message as is
+	if (input.Equals("#1") || input.Equals("#2"))
+	{
+		return MakeShareable(new FJsonValueString(input));
+	}
+	return USCJsonConvert::JsonStringToJsonValue(input);
+}
+
+ESCCodecFrame USC_CodecMinBin::encodeTo(TSharedPtr<FJsonValue> object, FSCByteWriter& writer)
+{
+	// Ping and pong stay plain text frames
+	if (isPingOrPong(object))
+	{
+		writer.writeUTF8(object->AsString());
+		return ESCCodecFrame::TEXT;
+	}
+
+	FSCMessagePack::encode(compressPacket(object), writer);
+	return ESCCodecFrame::BINARY;
+}
+
+TSharedPtr<FJsonValue> USC_CodecMinBin::decode(TArrayView<const uint8> input, ESCCodecFrame frame)
+{
+	if (frame == ESCCodecFrame::TEXT)
+	{
+		return USCCodecEngine::decode(input, frame);
+	}
+
+	TSharedPtr<FJsonValue> object = FSCMessagePack::decode(input.GetData(), input.Num());
+	if (object.IsValid())
+	{
+		decompressPacket(object);
+	}
+	return object;
+}
+
+bool USC_CodecMinBin::isPingOrPong(const TSharedPtr<FJsonValue>& object)
+{
+	if (!object.IsValid() || object->Type != EJson::String || FJsonValueBinary::IsBinary(object))
+	{
+		return false;
+	}
+	const FString& message = object->AsString();
+	return message.IsEmpty() || message.Equals("#1") || message.Equals("#2");
+}
+
+TSharedPtr<FJsonValue> USC_CodecMinBin::compressPacket(const TSharedPtr<FJsonValue>& object)
+{
+	if (object.IsValid() && object->Type == EJson::Array)
+	{
+		TArray<TSharedPtr<FJsonValue>> packets;
+		for (const TSharedPtr<FJsonValue>& packet : object->AsArray())
+		{
+			packets.Add(compressSinglePacket(packet));
+		}
+		return MakeShareable(new FJsonValueArray(packets));
+	}
+	return compressSinglePacket(object);
+}
+
+TSharedPtr<FJsonValue> USC_CodecMinBin::compressSinglePacket(const TSharedPtr<FJsonValue>& object)
+{
+	if (!object.IsValid() || object->Type != EJson::Object || !object->AsObject().IsValid())
+	{
+		return object;
+	}
+
+	// Work on a shallow copy, the caller keeps its packet untouched
+	TSharedPtr<FJsonObject> packet = MakeShareable(new FJsonObject(*object->AsObject()));
+
+	const TSharedPtr<FJsonValue>* event = packet->Values.Find("event");
+	const TSharedPtr<FJsonValue>* data = packet->Values.Find("data");
+	const TSharedPtr<FJsonValue>* cid = packet->Values.Find("cid");
+
+	if (SCIsSet(event) && (*event)->Type == EJson::String && (*event)->AsString().Equals("#publish") && SCIsSet(data))
+	{
+		TSharedPtr<FJsonObject> publishData = (*data)->Type == EJson::Object ? (*data)->AsObject() : nullptr;
+		TArray<TSharedPtr<FJsonValue>> publishArray;
+		publishArray.Add(publishData.IsValid() ? SCValueOrNull(publishData->Values.Find("channel")) : MakeShareable(new FJsonValueNull));
+		publishArray.Add(publishData.IsValid() ? SCValueOrNull(publishData->Values.Find("data")) : MakeShareable(new FJsonValueNull));
+		if (SCIsSet(cid))
+		{
+			publishArray.Add(*cid);
+		}
+		packet->SetArrayField("p", publishArray);
+		packet->RemoveField("event");
+		packet->RemoveField("data");
+		packet->RemoveField("cid");
+	}
+	else if (SCIsSet(event))
+	{
+		TArray<TSharedPtr<FJsonValue>> emitArray;
+		emitArray.Add(*event);
+		emitArray.Add(SCValueOrNull(data));
+		if (SCIsSet(cid))
+		{
+			emitArray.Add(*cid);
+		}
+		packet->SetArrayField("e", emitArray);
+		packet->RemoveField("event");
+		packet->RemoveField("data");
+		packet->RemoveField("cid");
+	}
+
+	const TSharedPtr<FJsonValue>* rid = packet->Values.Find("rid");
+	if (SCIsSet(rid))
+	{
+		TArray<TSharedPtr<FJsonValue>> responseArray;
+		responseArray.Add(*rid);
+		responseArray.Add(SCValueOrNull(packet->Values.Find("error")));
+		responseArray.Add(SCValueOrNull(packet->Values.Find("data")));
+		packet->SetArrayField("r", responseArray);
+		packet->RemoveField("rid");
+		packet->RemoveField("error");
+		packet->RemoveField("data");
+	}
+
+	return MakeShareable(new FJsonValueObject(packet));
+}
+
+void USC_CodecMinBin::decompressPacket(const TSharedPtr<FJsonValue>& object)
+{
+	if (object->Type == EJson::Array)
+	{
+		for (const TSharedPtr<FJsonValue>& packet : object->AsArray())
+		{
+			decompressSinglePacket(packet);
+		}
+	}
+	else
+	{
+		decompressSinglePacket(object);
+	}
+}
+
+void USC_CodecMinBin::decompressSinglePacket(const TSharedPtr<FJsonValue>& object)
+{
+	if (!object.IsValid() || object->Type != EJson::Object || !object->AsObject().IsValid())
+	{
+		return;
+	}
+
+	TSharedPtr<FJsonObject> packet = object->AsObject();
+	const TArray<TSharedPtr<FJsonValue>>* array;
+
+	if (packet->TryGetArrayField("p", array))
+	{
+		TSharedPtr<FJsonObject> publishData = MakeShareable(new FJsonObject);
+		publishData->SetField("channel", array->IsValidIndex(0) ? (*array)[0] : MakeShareable(new FJsonValueNull));
+		publishData->SetField("data", array->IsValidIndex(1) ? (*array)[1] : MakeShareable(new FJsonValueNull));
+		TSharedPtr<FJsonValue> cid = array->IsValidIndex(2) ? (*array)[2] : nullptr;
+
+		packet->SetStringField("event", "#publish");
+		packet->SetObjectField("data", publishData);
+		if (SCIsSet(&cid))
+		{
+			packet->SetField("cid", cid);
+		}
+		packet->RemoveField("p");
+	}
+	else if (packet->TryGetArrayField("e", array))
+	{
+		TSharedPtr<FJsonValue> event = array->IsValidIndex(0) ? (*array)[0] : MakeShareable(new FJsonValueNull);
+		TSharedPtr<FJsonValue> data = array->IsValidIndex(1) ? (*array)[1] : MakeShareable(new FJsonValueNull);
+		TSharedPtr<FJsonValue> cid = array->IsValidIndex(2) ? (*array)[2] : nullptr;
+
+		packet->SetField("event", event);
+		packet->SetField("data", data);
+		if (SCIsSet(&cid))
+		{
+			packet->SetField("cid", cid);
+		}
+		packet->RemoveField("e");
+	}
+	else if (packet->TryGetArrayField("r", array))
+	{
+		TSharedPtr<FJsonValue> rid = array->IsValidIndex(0) ? (*array)[0] : nullptr;
+		TSharedPtr<FJsonValue> error = array->IsValidIndex(1) ? (*array)[1] : nullptr;
+		TSharedPtr<FJsonValue> data = array->IsValidIndex(2) ? (*array)[2] : nullptr;
+
+		// The transport checks for the presence of error and data, so nil entries are left out instead of set to null
+		if (SCIsSet(&rid))
+		{
+			packet->SetField("rid", rid);
+		}
+		if (SCIsSet(&error))
+		{
+			packet->SetField("error", error);
+		}
+		if (SCIsSet(&data))
+		{
+			packet->SetField("data", data);
+		}
+		packet->RemoveField("r");
+	}
+}
@@ -1,6 +1,7 @@
 // Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
 
 #include "SC_Formatter.h"
+#include "SCStructPlan.h"
 
 
 FString USC_Formatter::encode(TSharedPtr<FJsonValue> object)
@@ -8,8 +9,41 @@ FString USC_Formatter::encode(TSharedPtr<FJsonValue> object)
 	return USCJsonConvert::ToJsonString(object);
 }
 
+ESCCodecFrame USC_Formatter::encodeTo(TSharedPtr<FJsonValue> object, FSCByteWriter& writer)
+{
+	// Objects and arrays are written as UTF-8 straight into the frame, plain strings like #2 go out unquoted through encode
+	if (object.IsValid() && (object->Type == EJson::Object || object->Type == EJson::Array))
+	{
+		FSCStructPlan::WriteJsonValue(object, writer);
+		return ESCCodecFrame::TEXT;
+	}
+	return USCCodecEngine::encodeTo(object, writer);
+}
+
 TSharedPtr<FJsonValue> USC_Formatter::decode(const FString& input)
 {
 	TSharedPtr<FJsonValue> JsonValue = USCJsonConvert::JsonStringToJsonValue(input);
 	return JsonValue;
 }
+
+TSharedPtr<FJsonValue> USC_Formatter::decode(TArrayView<const uint8> input, ESCCodecFrame frame)
+{
+	// Text frames are parsed from the UTF-8 payload, without the FString in between
+	if (frame == ESCCodecFrame::TEXT)
+	{
+		return USCJsonConvert::JsonBytesToJsonValue(input);
+	}
+	return USCCodecEngine::decode(input, frame);
+}
+
+bool USC_Formatter::decode(TArrayView<const uint8> input, ESCCodecFrame frame, FSCJsonDocument& document)
+{
+	// Anything which is not a JSON text (#1, #2, empty pings) is left to the FString decode
+	return frame == ESCCodecFrame::TEXT && USCJsonConvert::JsonBytesToDocument(input, document);
+}
+
+bool USC_Formatter::peekEvent(TArrayView<const uint8> input, ESCCodecFrame frame, FString& event)
+{
+	// Only a single packet has one event, batches of packets are left to the document
+	return frame == ESCCodecFrame::TEXT && USCJsonConvert::JsonBytesFindStringField(input, "event", event);
+}
@@ -5,8 +5,16 @@
 #include "CoreMinimal.h"
 #include "SCJsonConvert.h"
 #include "SCJsonValue.h"
+#include "SCByteWriter.h"
 #include "SCCodecEngine.generated.h"
 
+/** The WebSocket frame type of an encoded message */
+enum class ESCCodecFrame : uint8
+{
+	TEXT,
+	BINARY
+};
+
 /**
 * The SocketCluster CodecEngine
 */
@@ -21,4 +29,45 @@ public:
 
 	virtual TSharedPtr<FJsonValue> decode(const FString& Input);
 
+	/**
+	* Encode an object straight into a byte buffer, the transport writes into the queued socket frame this way.
+	* By default the object is encoded with encode and written as UTF-8 text, codecs override this to skip the FString.
+	*
+	* @param Object		The object to encode.
+	* @param Writer		Receives the encoded bytes.
+	* @return			The frame type the bytes have to be sent as.
+	*/
+	virtual ESCCodecFrame encodeTo(TSharedPtr<FJsonValue> Object, FSCByteWriter& Writer);
+
+	/**
+	* Decode a received frame without going through an FString.
+	* By default the bytes are converted from UTF-8 and passed to decode, codecs override this to read the bytes directly.
+	*
+	* @param Input		The payload of the frame.
+	* @param Frame		The frame type the payload was received as.
+	*/
+	virtual TSharedPtr<FJsonValue> decode(TArrayView<const uint8> Input, ESCCodecFrame Frame);
+
+	/**
+	* Decode a received frame into an arena document, every node and string of the message comes out of one arena which is freed at once.
+	* By default no document is produced and the transport falls back to the decode above.
+	*
+	* @param Input		The payload of the frame.
+	* @param Frame		The frame type the payload was received as.
+	* @param Document	Receives the message.
+	* @return			Whether the document holds the message.
+	*/
+	virtual bool decode(TArrayView<const uint8> Input, ESCCodecFrame Frame, FSCJsonDocument& Document);
+
+	/**
+	* Read the event name of a received frame without decoding the rest, so the transport can pick the decode path first.
+	* By default the name is not known before decoding.
+	*
+	* @param Input		The payload of the frame.
+	* @param Frame		The frame type the payload was received as.
+	* @param OutEvent	Receives the event name.
+	* @return			Whether the frame is a single packet with an event name.
+	*/
+	virtual bool peekEvent(TArrayView<const uint8> Input, ESCCodecFrame Frame, FString& OutEvent);
+
 };
\ No newline at end of file
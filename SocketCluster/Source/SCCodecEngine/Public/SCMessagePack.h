@@ -0,0 +1,42 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonValue.h"
+#include "SCByteWriter.h"
+
+/**
+* MessagePack serialization of FJsonValue trees.
+* The encoder picks the same formats as msgpack-lite (used by sc-codec-min-bin) so the output matches the JS client byte for byte:
+* integers which fit in an int32 use the smallest int format, every other number is a float64, strings use fixstr/str8/str16/str32
+* and FJsonValueBinary values are written as bin8/bin16/bin32.
+*/
+class SCCODECENGINE_API FSCMessagePack
+{
+public:
+
+	/** Write the MessagePack encoding of value to out */
+	static void encode(const TSharedPtr<FJsonValue>& value, FSCByteWriter& out);
+
+	/**
+	* Decode a single MessagePack value.
+	*
+	* @param data		The encoded bytes.
+	* @param size		The number of encoded bytes.
+	* @return			The decoded value, nullptr if the input is malformed or truncated.
+	*/
+	static TSharedPtr<FJsonValue> decode(const uint8* data, int32 size);
+
+private:
+
+	static void writeNumber(double value, FSCByteWriter& out);
+
+	static void writeString(const FString& value, FSCByteWriter& out);
+
+	static void writeBinary(const TArray<uint8>& value, FSCByteWriter& out);
+
+	static void writeHeader(uint8 fixType, uint8 fixLimit, uint8 type16, uint8 type32, uint32 length, FSCByteWriter& out);
+
+	static TSharedPtr<FJsonValue> readValue(const uint8*& cursor, const uint8* end, int32 depth);
+};
@@ -0,0 +1,46 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SCCodecEngine.h"
+#include "SC_CodecMinBin.generated.h"
+
+/**
+* The SocketCluster MessagePack codec, compatible with sc-codec-min-bin.
+* Packets are sent as binary MessagePack frames with shortened protocol keys:
+* - {event: '#publish', data: {channel, data}, cid} -> {p: [channel, data, cid]}
+* - {event, data, cid} -> {e: [event, data, cid]}
+* - {rid, error, data} -> {r: [rid, error, data]}
+* Ping and pong messages stay plain text frames.
+* The server needs to use sc-codec-min-bin as well.
+*/
+UCLASS()
+class SCCODECENGINE_API USC_CodecMinBin : public USCCodecEngine
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual FString encode(TSharedPtr<FJsonValue> object) override;
+
+	virtual TSharedPtr<FJsonValue> decode(const FString& input) override;
+
+	virtual ESCCodecFrame encodeTo(TSharedPtr<FJsonValue> object, FSCByteWriter& writer) override;
+
+	virtual TSharedPtr<FJsonValue> decode(TArrayView<const uint8> input, ESCCodecFrame frame) override;
+
+	using USCCodecEngine::decode;
+
+private:
+
+	static bool isPingOrPong(const TSharedPtr<FJsonValue>& object);
+
+	static TSharedPtr<FJsonValue> compressPacket(const TSharedPtr<FJsonValue>& object);
+
+	static TSharedPtr<FJsonValue> compressSinglePacket(const TSharedPtr<FJsonValue>& object);
+
+	static void decompressPacket(const TSharedPtr<FJsonValue>& object);
+
+	static void decompressSinglePacket(const TSharedPtr<FJsonValue>& object);
+};
@@ -22,6 +22,16 @@ public:
 
 	virtual FString encode(TSharedPtr<FJsonValue> object) override;
 
+	virtual ESCCodecFrame encodeTo(TSharedPtr<FJsonValue> object, FSCByteWriter& writer) override;
+
 	virtual TSharedPtr<FJsonValue> decode(const FString& input) override;
 
+	virtual TSharedPtr<FJsonValue> decode(TArrayView<const uint8> input, ESCCodecFrame frame) override;
+
+	virtual bool decode(TArrayView<const uint8> input, ESCCodecFrame frame, FSCJsonDocument& document) override;
+
+	virtual bool peekEvent(TArrayView<const uint8> input, ESCCodecFrame frame, FString& event) override;
+
+	using USCCodecEngine::decode;
+
 };
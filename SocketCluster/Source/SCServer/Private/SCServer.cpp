@@ -0,0 +1,645 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCServer.h"
+#include "Misc/Guid.h"
+#include "SCJsonConvert.h"
+#include "SC_Formatter.h"
+#include "SCServerModule.h"
+
+// Namespace UI Conflict.
+// Remove UI Namepspace
+#if PLATFORM_LINUX
+#pragma push_macro("UI")
+#undef UI
+#elif PLATFORM_WINDOWS || PLATFORM_MAC
+#define UI UI_ST
+#endif
+
+THIRD_PARTY_INCLUDES_START
+#include "libwebsockets.h"
+THIRD_PARTY_INCLUDES_END
+
+// Namespace UI Conflict.
+// Restore UI Namepspace
+#if PLATFORM_LINUX
+#pragma pop_macro("UI")
+#elif PLATFORM_WINDOWS || PLATFORM_MAC
+#undef UI
+#endif
+
+static struct lws_protocols protocols[] = {
+	{
+		"socketcluster",
+		FSCServer::ws_service_callback,
+		0,
+	},
+	{
+		NULL,
+		NULL,
+		0
+	}
+};
+
+static const struct lws_extension exts[] = {
+	{
+		"permessage-deflate",
+		lws_extension_callback_pm_deflate,
+		"permessage-deflate; client_no_context_takeover"
+	},
+	{
+		NULL,
+		NULL,
+		NULL
+	}
+};
+
+FSCServer::FSCServer()
+{
+	context = nullptr;
+	port = 0;
+	protocolVersion = 2;
+	codec = nullptr;
+}
+
+FSCServer::~FSCServer()
+{
+	close();
+}
+
+void FSCServer::Tick(float DeltaTime)
+{
+	service(0);
+}
+
+bool FSCServer::IsTickable() const
+{
+	return context != nullptr;
+}
+
+TStatId FSCServer::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FSCServer, STATGROUP_SocketCluster);
+}
+
+void FSCServer::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(codec);
+}
+
+bool FSCServer::listen(int32 listenPort, int32 version, USCCodecEngine* codecEngine)
+{
+	close();
+
+	port = listenPort;
+	protocolVersion = version;
+	codec = codecEngine != nullptr ? codecEngine : NewObject<USC_Formatter>();
+
+	struct lws_context_creation_info context_info;
+	memset(&context_info, 0, sizeof(context_info));
+
+	context_info.port = port;
+	context_info.protocols = protocols;
+	context_info.extensions = exts;
+	context_info.gid = -1;
+	context_info.uid = -1;
+	context_info.user = this;
+	context_info.options = LWS_SERVER_OPTION_VALIDATE_UTF8;
+
+	context = lws_create_context(&context_info);
+	if (!context)
+	{
+		UE_LOG(LogSCServer, Error, TEXT("Could not listen on port %d"), port);
+		return false;
+	}
+
+	UE_LOG(LogSCServer, Log, TEXT("Listening on port %d (protocol v%d)"), port, protocolVersion);
+	return true;
+}
+
+void FSCServer::close()
+{
+	if (context != nullptr)
+	{
+		// Destroying the context closes every connection, their LWS_CALLBACK_CLOSED arrives in between
+		struct lws_context* closing = context;
+		context = nullptr;
+		lws_context_destroy(closing);
+	}
+	connections.Empty();
+}
+
+void FSCServer::service(int32 timeoutMs)
+{
+	if (context == nullptr)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_SCServerService);
+
+	const double now = FPlatformTime::Seconds();
+	for (auto& entry : connections)
+	{
+		FSCServerConnection& connection = *entry.Value;
+		if (!connection.handshaken || connection.closeCode != 0)
+		{
+			continue;
+		}
+
+		if (now - connection.lastPong > pingTimeout)
+		{
+			disconnect(connection.id, 4001, "Server ping timed out");
+		}
+		else if (now >= connection.nextPing)
+		{
+			connection.nextPing = now + pingInterval;
+			sendRaw(connection, protocolVersion == 1 ? "#1" : "");
+		}
+	}
+
+	for (int32 pass = 0; pass < FMath::Max(1, servicePasses) && context != nullptr; pass++)
+	{
+		lws_callback_on_writable_all_protocol(context, &protocols[0]);
+		lws_service(context, pass == 0 ? timeoutMs : 0);
+		if (!hasDueFrames())
+		{
+			break;
+		}
+	}
+}
+
+bool FSCServer::hasDueFrames() const
+{
+	const double now = FPlatformTime::Seconds();
+	for (auto& entry : connections)
+	{
+		const FSCServerConnection& connection = *entry.Value;
+		if ((connection.outbox.Num() > 0 && connection.outbox[0].Key <= now) || connection.closeCode != 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+int FSCServer::ws_service_callback(lws* wsi, lws_callback_reasons reason, void* user, void* in, size_t len)
+{
+	FSCServer* server = (FSCServer*)lws_context_user(lws_get_context(wsi));
+	if (server == nullptr)
+	{
+		return 0;
+	}
+
+	switch (reason)
+	{
+	case LWS_CALLBACK_ESTABLISHED:
+	{
+		TSharedPtr<FSCServerConnection> connection = MakeShared<FSCServerConnection>();
+		connection->id = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+		connection->wsi = wsi;
+		connection->lastPong = FPlatformTime::Seconds();
+		server->connections.Add(wsi, connection);
+		if (server->onconnection)
+		{
+			server->onconnection(connection->id);
+		}
+	}
+	break;
+	case LWS_CALLBACK_CLOSED:
+	{
+		TSharedPtr<FSCServerConnection> connection;
+		if (server->connections.RemoveAndCopyValue(wsi, connection) && server->ondisconnection)
+		{
+			server->ondisconnection(connection->id, connection->closeCode != 0 ? connection->closeCode : 1006);
+		}
+	}
+	break;
+	case LWS_CALLBACK_RECEIVE:
+	{
+		TSharedPtr<FSCServerConnection> connection = server->connections.FindRef(wsi);
+		if (!connection.IsValid())
+		{
+			break;
+		}
+
+		// Large messages arrive in several fragments, only handle complete messages
+		connection->receiveBuffer.Append((const uint8*)in, len);
+		if (!lws_is_final_fragment(wsi) || lws_remaining_packet_payload(wsi) > 0)
+		{
+			break;
+		}
+
+		TArray<uint8> data = MoveTemp(connection->receiveBuffer);
+		connection->receiveBuffer.Reset();
+		server->onData(*connection, data, lws_frame_is_binary(wsi) != 0);
+	}
+	break;
+	case LWS_CALLBACK_SERVER_WRITEABLE:
+	{
+		TSharedPtr<FSCServerConnection> connection = server->connections.FindRef(wsi);
+		if (connection.IsValid())
+		{
+			return server->writeDue(*connection);
+		}
+	}
+	break;
+	}
+	return 0;
+}
+
+int FSCServer::writeDue(FSCServerConnection& connection)
+{
+	const double now = FPlatformTime::Seconds();
+	if (connection.outbox.Num() > 0 && connection.outbox[0].Key <= now)
+	{
+		if (USCSocket::ws_write_frame(connection.wsi, connection.outbox[0].Value) < 0)
+		{
+			return -1;
+		}
+		connection.outbox.RemoveAt(0, 1, false);
+		if (connection.outbox.Num() > 0 && connection.outbox[0].Key <= now)
+		{
+			lws_callback_on_writable(connection.wsi);
+			return 0;
+		}
+	}
+
+	if (connection.closeCode != 0 && (connection.outbox.Num() == 0 || connection.outbox[0].Key > now))
+	{
+		FTCHARToUTF8 reason(*connection.closeReason);
+		lws_close_reason(connection.wsi, (enum lws_close_status)connection.closeCode, (unsigned char*)reason.Get(), reason.Length());
+		return -1;
+	}
+	return 0;
+}
+
+TArray<FString> FSCServer::getClientIds() const
+{
+	TArray<FString> ids;
+	for (auto& entry : connections)
+	{
+		ids.Add(entry.Value->id);
+	}
+	return ids;
+}
+
+TArray<FString> FSCServer::getSubscriptions(const FString& clientId) const
+{
+	TSharedPtr<FSCServerConnection> connection = findConnection(clientId);
+	return connection.IsValid() ? connection->subscriptions.Array() : TArray<FString>();
+}
+
+TSharedPtr<FSCServerConnection> FSCServer::findConnection(const FString& clientId) const
+{
+	for (auto& entry : connections)
+	{
+		if (entry.Value->id.Equals(clientId))
+		{
+			return entry.Value;
+		}
+	}
+	return nullptr;
+}
+
+void FSCServer::queueFrame(FSCServerConnection& connection, FSCSocketFrame&& frame)
+{
+	double due = FPlatformTime::Seconds() + script.latency + (script.jitter > 0.0 ? FMath::FRand() * script.jitter : 0.0);
+	if (connection.outbox.Num() > 0)
+	{
+		due = FMath::Max(due, connection.outbox.Last().Key);
+	}
+	connection.outbox.Emplace(due, MoveTemp(frame));
+}
+
+void FSCServer::sendObject(FSCServerConnection& connection, TSharedPtr<FJsonValue> object)
+{
+	FSCSocketFrame frame;
+	USCSocket::beginFrame(frame);
+	FSCByteWriter writer(frame.payload);
+	frame.binary = codec->encodeTo(object, writer) == ESCCodecFrame::BINARY;
+	queueFrame(connection, MoveTemp(frame));
+}
+
+void FSCServer::sendRaw(FSCServerConnection& connection, const FString& message)
+{
+	FTCHARToUTF8 converted(*message);
+	FSCSocketFrame frame;
+	USCSocket::fillFrame(frame, (const uint8*)converted.Get(), converted.Length(), false);
+	queueFrame(connection, MoveTemp(frame));
+}
+
+void FSCServer::sendEvent(FSCServerConnection& connection, const FString& event, TSharedPtr<FJsonValue> data, bool expectResponse)
+{
+	TSharedPtr<FJsonObject> packet = MakeShareable(new FJsonObject);
+	packet->SetStringField("event", event);
+	if (data.IsValid())
+	{
+		packet->SetField("data", data);
+	}
+	if (expectResponse)
+	{
+		packet->SetNumberField("cid", ++connection.cid);
+	}
+	sendObject(connection, USCJsonConvert::ToJsonValue(packet));
+}
+
+void FSCServer::sendResponse(FSCServerConnection& connection, int32 cid, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+{
+	TSharedPtr<FJsonObject> packet = MakeShareable(new FJsonObject);
+	packet->SetNumberField("rid", cid);
+	if (error.IsValid())
+	{
+		packet->SetField("error", error);
+	}
+	else if (data.IsValid())
+	{
+		packet->SetField("data", data);
+	}
+	sendObject(connection, USCJsonConvert::ToJsonValue(packet));
+}
+
+bool FSCServer::emit(const FString& clientId, const FString& event, TSharedPtr<FJsonValue> data)
+{
+	TSharedPtr<FSCServerConnection> connection = findConnection(clientId);
+	if (!connection.IsValid())
+	{
+		return false;
+	}
+	sendEvent(*connection, event, data);
+	return true;
+}
+
+void FSCServer::publish(const FString& channel, TSharedPtr<FJsonValue> data)
+{
+	TSharedPtr<FJsonObject> publication = MakeShareable(new FJsonObject);
+	publication->SetStringField("channel", channel);
+	publication->SetField("data", data.IsValid() ? data : MakeShareable(new FJsonValueNull));
+	TSharedPtr<FJsonValue> publicationValue = USCJsonConvert::ToJsonValue(publication);
+
+	for (auto& entry : connections)
+	{
+		if (entry.Value->subscriptions.Contains(channel))
+		{
+			sendEvent(*entry.Value, "#publish", publicationValue);
+		}
+	}
+}
+
+bool FSCServer::respond(const FString& clientId, int32 cid, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data)
+{
+	TSharedPtr<FSCServerConnection> connection = findConnection(clientId);
+	if (!connection.IsValid() || cid == 0)
+	{
+		return false;
+	}
+	sendResponse(*connection, cid, error, data);
+	return true;
+}
+
+bool FSCServer::setAuthToken(const FString& clientId, const FString& token)
+{
+	TSharedPtr<FSCServerConnection> connection = findConnection(clientId);
+	if (!connection.IsValid())
+	{
+		return false;
+	}
+	connection->authToken = token;
+
+	TSharedPtr<FJsonObject> data = MakeShareable(new FJsonObject);
+	data->SetStringField("token", token);
+	sendEvent(*connection, "#setAuthToken", USCJsonConvert::ToJsonValue(data), true);
+	return true;
+}
+
+bool FSCServer::removeAuthToken(const FString& clientId)
+{
+	TSharedPtr<FSCServerConnection> connection = findConnection(clientId);
+	if (!connection.IsValid())
+	{
+		return false;
+	}
+	connection->authToken.Empty();
+	sendEvent(*connection, "#removeAuthToken", nullptr, true);
+	return true;
+}
+
+bool FSCServer::kickOut(const FString& clientId, const FString& channel, const FString& message)
+{
+	TSharedPtr<FSCServerConnection> connection = findConnection(clientId);
+	if (!connection.IsValid() || connection->subscriptions.Remove(channel) == 0)
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> data = MakeShareable(new FJsonObject);
+	data->SetStringField("message", message);
+	data->SetStringField("channel", channel);
+	sendEvent(*connection, "#kickOut", USCJsonConvert::ToJsonValue(data));
+	return true;
+}
+
+bool FSCServer::disconnect(const FString& clientId, int32 code, const FString& reason)
+{
+	TSharedPtr<FSCServerConnection> connection = findConnection(clientId);
+	if (!connection.IsValid())
+	{
+		return false;
+	}
+	connection->closeCode = code;
+	connection->closeReason = reason;
+	lws_callback_on_writable(connection->wsi);
+	return true;
+}
+
+void FSCServer::onData(FSCServerConnection& connection, const TArray<uint8>& message, bool binary)
+{
+	// Anything the client sends proves it is alive, pongs included
+	connection.lastPong = FPlatformTime::Seconds();
+
+	if (!binary && (message.Num() == 0 || (message.Num() == 2 && message[0] == '#' && message[1] == '2')))
+	{
+		return;
+	}
+
+	TSharedPtr<FJsonValue> packet = codec->decode(TArrayView<const uint8>(message), binary ? ESCCodecFrame::BINARY : ESCCodecFrame::TEXT);
+	if (!packet.IsValid())
+	{
+		UE_LOG(LogSCServer, Warning, TEXT("Client %s sent a frame which could not be decoded"), *connection.id);
+		return;
+	}
+
+	if (packet->Type == EJson::Array)
+	{
+		// A batch of packets sent together
+		for (const TSharedPtr<FJsonValue>& item : packet->AsArray())
+		{
+			if (item.IsValid() && item->Type == EJson::Object)
+			{
+				handlePacket(connection, item->AsObject());
+			}
+		}
+	}
+	else if (packet->Type == EJson::Object)
+	{
+		handlePacket(connection, packet->AsObject());
+	}
+}
+
+void FSCServer::handlePacket(FSCServerConnection& connection, TSharedPtr<FJsonObject> packet)
+{
+	FString event;
+	if (!packet->TryGetStringField("event", event))
+	{
+		// Responses to #setAuthToken and #removeAuthToken need no handling
+		return;
+	}
+
+	const TSharedPtr<FJsonValue> data = packet->TryGetField("data");
+	const int32 cid = packet->HasField("cid") ? (int32)packet->GetNumberField("cid") : 0;
+
+	if (const int32* code = script.disconnectOn.Find(event))
+	{
+		disconnect(connection.id, *code, "Scripted disconnect on " + event);
+		return;
+	}
+
+	if (cid != 0 && shouldDrop(event))
+	{
+		return;
+	}
+
+	if (const FString* error = script.rejectEvents.Find(event))
+	{
+		if (cid != 0)
+		{
+			sendResponse(connection, cid, makeError("Error", *error), nullptr);
+		}
+		return;
+	}
+
+	if (event.Equals("#handshake"))
+	{
+		FString token;
+		if (data.IsValid() && data->Type == EJson::Object)
+		{
+			data->AsObject()->TryGetStringField("authToken", token);
+		}
+
+		TSharedPtr<FJsonObject> status = MakeShareable(new FJsonObject);
+		status->SetStringField("id", connection.id);
+		status->SetNumberField("pingTimeout", pingTimeout * 1000.0);
+		TSharedPtr<FJsonValue> authError = authenticate(connection, token);
+		status->SetBoolField("isAuthenticated", !connection.authToken.IsEmpty());
+		if (authError.IsValid())
+		{
+			status->SetField("authError", authError);
+		}
+
+		connection.handshaken = true;
+		connection.nextPing = FPlatformTime::Seconds() + pingInterval;
+		sendResponse(connection, cid, nullptr, USCJsonConvert::ToJsonValue(status));
+	}
+	else if (event.Equals("#authenticate"))
+	{
+		TSharedPtr<FJsonValue> authError = authenticate(connection, data.IsValid() && data->Type == EJson::String ? data->AsString() : FString());
+
+		TSharedPtr<FJsonObject> status = MakeShareable(new FJsonObject);
+		status->SetBoolField("isAuthenticated", !connection.authToken.IsEmpty());
+		if (authError.IsValid())
+		{
+			status->SetField("authError", authError);
+		}
+		if (cid != 0)
+		{
+			sendResponse(connection, cid, nullptr, USCJsonConvert::ToJsonValue(status));
+		}
+	}
+	else if (event.Equals("#removeAuthToken"))
+	{
+		connection.authToken.Empty();
+	}
+	else if (event.Equals("#subscribe"))
+	{
+		FString channel;
+		if (!data.IsValid() || data->Type != EJson::Object || !data->AsObject()->TryGetStringField("channel", channel))
+		{
+			if (cid != 0)
+			{
+				sendResponse(connection, cid, makeError("InvalidActionError", "Socket tried to subscribe without a channel name"), nullptr);
+			}
+			return;
+		}
+		connection.subscriptions.Add(channel);
+		if (cid != 0)
+		{
+			sendResponse(connection, cid, nullptr, nullptr);
+		}
+	}
+	else if (event.Equals("#unsubscribe"))
+	{
+		if (data.IsValid() && data->Type == EJson::String)
+		{
+			connection.subscriptions.Remove(data->AsString());
+		}
+		if (cid != 0)
+		{
+			sendResponse(connection, cid, nullptr, nullptr);
+		}
+	}
+	else if (event.Equals("#publish"))
+	{
+		FString channel;
+		if (!data.IsValid() || data->Type != EJson::Object || !data->AsObject()->TryGetStringField("channel", channel))
+		{
+			if (cid != 0)
+			{
+				sendResponse(connection, cid, makeError("InvalidActionError", "Socket tried to publish without a channel name"), nullptr);
+			}
+			return;
+		}
+		publish(channel, data->AsObject()->TryGetField("data"));
+		if (cid != 0)
+		{
+			sendResponse(connection, cid, nullptr, nullptr);
+		}
+	}
+	else if (!onevent || !onevent(connection.id, event, data, cid))
+	{
+		if (cid != 0)
+		{
+			sendResponse(connection, cid, nullptr, data);
+		}
+	}
+}
+
+bool FSCServer::shouldDrop(const FString& event) const
+{
+	if (script.dropResponses.Contains(event))
+	{
+		return true;
+	}
+	return script.dropRate > 0.0f && !event.Equals("#handshake") && FMath::FRand() < script.dropRate;
+}
+
+TSharedPtr<FJsonValue> FSCServer::authenticate(FSCServerConnection& connection, const FString& token)
+{
+	connection.authToken.Empty();
+	if (token.IsEmpty())
+	{
+		return nullptr;
+	}
+	if (!script.acceptAuthTokens)
+	{
+		return makeError("AuthTokenInvalidError", "The auth token was rejected by the server script");
+	}
+	connection.authToken = token;
+	return nullptr;
+}
+
+TSharedPtr<FJsonValue> FSCServer::makeError(const FString& name, const FString& message)
+{
+	TSharedPtr<FJsonObject> error = MakeShareable(new FJsonObject);
+	error->SetStringField("name", name);
+	error->SetStringField("message", message);
+	return USCJsonConvert::ToJsonValue(error);
+}
@@ -0,0 +1,24 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCServerModule.h"
+
+#define LOCTEXT_NAMESPACE "FSCServerModule"
+
+DEFINE_LOG_CATEGORY(LogSCServer);
+
+DEFINE_STAT(STAT_SCServerService);
+
+void FSCServerModule::StartupModule()
+{
+	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+}
+
+void FSCServerModule::ShutdownModule()
+{
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FSCServerModule, SCServer)
\ No newline at end of file
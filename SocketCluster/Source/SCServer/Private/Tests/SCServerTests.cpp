@@ -0,0 +1,287 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "SCServer.h"
+#include "SCSocket.h"
+#include "SCJsonConvert.h"
+#include "SCByteWriter.h"
+#include "SC_Formatter.h"
+#include "SC_CodecMinBin.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** The loopback port of the tests, apart from the one of the benchmark so both can run at once */
+static const int32 SCServerTestPort = 8183;
+
+/** The time in seconds a test waits for the server or the socket before it fails */
+static const double SCServerTestTimeout = 5.0;
+
+/**
+* A USCSocket connected to a FSCServer on loopback, both serviced by pump on the calling thread.
+* The socket speaks the protocol by hand, so the tests only depend on the server, the socket and the codec.
+*/
+struct FSCServerTestClient
+{
+	FSCServer server;
+
+	USCSocket* socket = nullptr;
+
+	USCCodecEngine* codec = nullptr;
+
+	bool opened = false;
+
+	bool closed = false;
+
+	TArray<TSharedPtr<FJsonObject>> received;
+
+	TArray<FString> connected;
+
+	TArray<FString> disconnected;
+
+	~FSCServerTestClient()
+	{
+		if (socket != nullptr)
+		{
+			socket->onopen = nullptr;
+			socket->onclose = nullptr;
+			socket->ondata = nullptr;
+			socket->RemoveFromRoot();
+			socket->MarkPendingKill();
+		}
+		if (codec != nullptr)
+		{
+			codec->RemoveFromRoot();
+		}
+		server.close();
+	}
+
+	bool connect(USCCodecEngine* codecEngine)
+	{
+		codec = codecEngine;
+		codec->AddToRoot();
+
+		server.onconnection = [this](const FString& clientId) { connected.Add(clientId); };
+		server.ondisconnection = [this](const FString& clientId, int32 code) { disconnected.Add(clientId); };
+		if (!server.listen(SCServerTestPort, 2, codec))
+		{
+			return false;
+		}
+
+		socket = NewObject<USCSocket>();
+		socket->AddToRoot();
+		socket->onopen = [this]() { opened = true; };
+		socket->onclose = [this](const TSharedPtr<FJsonObject> error) { closed = true; };
+		socket->ondata = [this](const TArray<uint8>& data, bool binary)
+		{
+			// Pings are empty frames in protocol v2
+			if (data.Num() == 0)
+			{
+				return;
+			}
+			TSharedPtr<FJsonValue> packet = codec->decode(TArrayView<const uint8>(data), binary ? ESCCodecFrame::BINARY : ESCCodecFrame::TEXT);
+			if (packet.IsValid() && packet->Type == EJson::Object)
+			{
+				received.Add(packet->AsObject());
+			}
+		};
+		socket->createWebSocket(FString::Printf(TEXT("ws://127.0.0.1:%d/socketcluster/"), SCServerTestPort), MakeShareable(new FJsonObject));
+		return pump([this]() { return opened && connected.Num() == 1; });
+	}
+
+	/** Service the server and the socket until done returns true, false when it timed out */
+	bool pump(TFunctionRef<bool()> done)
+	{
+		const double start = FPlatformTime::Seconds();
+		while (!done())
+		{
+			if (FPlatformTime::Seconds() - start > SCServerTestTimeout)
+			{
+				return false;
+			}
+			server.service(1);
+			if (socket != nullptr)
+			{
+				static_cast<FTickableGameObject*>(socket)->Tick(0.0f);
+			}
+		}
+		return true;
+	}
+
+	void emit(const FString& event, TSharedPtr<FJsonValue> data, int32 cid)
+	{
+		TSharedPtr<FJsonObject> packet = MakeShareable(new FJsonObject);
+		packet->SetStringField("event", event);
+		if (data.IsValid())
+		{
+			packet->SetField("data", data);
+		}
+		if (cid != 0)
+		{
+			packet->SetNumberField("cid", cid);
+		}
+
+		FSCSocketFrame& frame = socket->bufferFrame();
+		FSCByteWriter writer(frame.payload);
+		frame.binary = codec->encodeTo(USCJsonConvert::ToJsonValue(packet), writer) == ESCCodecFrame::BINARY;
+	}
+
+	/** Wait for the response to cid, nullptr when it timed out */
+	TSharedPtr<FJsonObject> waitResponse(int32 cid)
+	{
+		TSharedPtr<FJsonObject> response;
+		pump([this, cid, &response]()
+		{
+			for (const TSharedPtr<FJsonObject>& packet : received)
+			{
+				double rid;
+				if (packet->TryGetNumberField("rid", rid) && (int32)rid == cid)
+				{
+					response = packet;
+					return true;
+				}
+			}
+			return false;
+		});
+		return response;
+	}
+
+	/** Wait for an event sent by the server, nullptr when it timed out */
+	TSharedPtr<FJsonObject> waitEvent(const FString& event)
+	{
+		TSharedPtr<FJsonObject> result;
+		pump([this, &event, &result]()
+		{
+			for (const TSharedPtr<FJsonObject>& packet : received)
+			{
+				FString name;
+				if (packet->TryGetStringField("event", name) && name.Equals(event))
+				{
+					result = packet;
+					return true;
+				}
+			}
+			return false;
+		});
+		return result;
+	}
+};
+
+static USCCodecEngine* SCMakeTestCodec(const FString& name)
+{
+	if (name.Equals("MinBin"))
+	{
+		return NewObject<USC_CodecMinBin>();
+	}
+	return NewObject<USC_Formatter>();
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FSCServerRoundTripTest, "SocketCluster.Server.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+void FSCServerRoundTripTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Add("Formatter");
+	OutTestCommands.Add("Formatter");
+	OutBeautifiedNames.Add("MinBin");
+	OutTestCommands.Add("MinBin");
+}
+
+bool FSCServerRoundTripTest::RunTest(const FString& Parameters)
+{
+	FSCServerTestClient client;
+	if (!client.connect(SCMakeTestCodec(Parameters)))
+	{
+		AddError(TEXT("The socket did not connect to the server"));
+		return false;
+	}
+
+	// Handshake
+	TSharedPtr<FJsonObject> handshakeData = MakeShareable(new FJsonObject);
+	client.emit("#handshake", USCJsonConvert::ToJsonValue(handshakeData), 1);
+	TSharedPtr<FJsonObject> handshake = client.waitResponse(1);
+	if (!handshake.IsValid())
+	{
+		AddError(TEXT("The server did not answer the handshake"));
+		return false;
+	}
+	const TSharedPtr<FJsonObject>* status;
+	FString id;
+	if (!handshake->TryGetObjectField("data", status) || !(*status)->TryGetStringField("id", id))
+	{
+		AddError(TEXT("The handshake response has no socket id"));
+		return false;
+	}
+	TestEqual(TEXT("Handshake socket id"), id, client.connected[0]);
+
+	// Emit with an ack, the server echoes the data
+	TSharedPtr<FJsonObject> data = MakeShareable(new FJsonObject);
+	data->SetStringField("text", TEXT("round trip"));
+	data->SetNumberField("number", 42);
+	client.emit("echo", USCJsonConvert::ToJsonValue(data), 2);
+	TSharedPtr<FJsonObject> ack = client.waitResponse(2);
+	if (!ack.IsValid())
+	{
+		AddError(TEXT("The server did not ack the emit"));
+		return false;
+	}
+	const TSharedPtr<FJsonObject>* echo;
+	if (TestTrue(TEXT("Ack carries the echoed data"), ack->TryGetObjectField("data", echo)))
+	{
+		TestEqual(TEXT("Echoed text"), (*echo)->GetStringField("text"), FString("round trip"));
+		TestEqual(TEXT("Echoed number"), (*echo)->GetNumberField("number"), 42.0);
+	}
+	TestFalse(TEXT("Ack without an error"), ack->HasField("error"));
+
+	// Emit from the server
+	TestTrue(TEXT("Server emit to a connected client"), client.server.emit(id, "greeting", MakeShareable(new FJsonValueString("hello"))));
+	TSharedPtr<FJsonObject> greeting = client.waitEvent("greeting");
+	if (TestTrue(TEXT("The client received the server emit"), greeting.IsValid()))
+	{
+		TestEqual(TEXT("Server emit data"), greeting->GetStringField("data"), FString("hello"));
+	}
+
+	// Close
+	client.socket->close(1000);
+	TestTrue(TEXT("The socket closed"), client.pump([&client]() { return client.closed && client.disconnected.Num() == 1; }));
+	TestEqual(TEXT("Clients after close"), client.server.getClientCount(), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCServerScriptTest, "SocketCluster.Server.Script", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCServerScriptTest::RunTest(const FString& Parameters)
+{
+	FSCServerTestClient client;
+	client.server.script.rejectEvents.Add("reject", "Rejected by the script");
+	client.server.script.disconnectOn.Add("leave", 4000);
+	if (!client.connect(NewObject<USC_Formatter>()))
+	{
+		AddError(TEXT("The socket did not connect to the server"));
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> handshakeData = MakeShareable(new FJsonObject);
+	client.emit("#handshake", USCJsonConvert::ToJsonValue(handshakeData), 1);
+	if (!client.waitResponse(1).IsValid())
+	{
+		AddError(TEXT("The server did not answer the handshake"));
+		return false;
+	}
+
+	// A rejected emit is acked with the scripted error
+	client.emit("reject", nullptr, 2);
+	TSharedPtr<FJsonObject> ack = client.waitResponse(2);
+	const TSharedPtr<FJsonObject>* error;
+	if (TestTrue(TEXT("The rejected emit was acked"), ack.IsValid()) && TestTrue(TEXT("The ack carries an error"), ack->TryGetObjectField("error", error)))
+	{
+		TestEqual(TEXT("Scripted error message"), (*error)->GetStringField("message"), FString("Rejected by the script"));
+	}
+
+	// A scripted disconnect closes the connection from the server side
+	client.emit("leave", nullptr, 3);
+	TestTrue(TEXT("The server closed the connection"), client.pump([&client]() { return client.closed && client.disconnected.Num() == 1; }));
+	TestEqual(TEXT("Clients after the scripted disconnect"), client.server.getClientCount(), 0);
+	return true;
+}
+
+#endif
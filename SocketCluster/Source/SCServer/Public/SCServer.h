@@ -0,0 +1,205 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "UObject/GCObject.h"
+#include "Dom/JsonValue.h"
+#include "SCSocket.h"
+#include "SCCodecEngine.h"
+
+/**
+* The misbehaviour of a stand-in server, changed at any time while it runs.
+*/
+struct FSCServerScript
+{
+	/** The time in seconds every frame the server sends is held back */
+	double latency = 0.0;
+
+	/** A random time in seconds up to jitter is added to latency, frames keep their order */
+	double jitter = 0.0;
+
+	/** The chance (0 - 1) that the response to an emit is never sent, the handshake is never dropped this way */
+	float dropRate = 0.0f;
+
+	/** The events which are never answered, so the ack timeout of the client fires */
+	TSet<FString> dropResponses;
+
+	/** The events which are answered with an error, event -> error message */
+	TMap<FString, FString> rejectEvents;
+
+	/** The events which make the server close the connection, event -> close code */
+	TMap<FString, int32> disconnectOn;
+
+	/** Whether the auth tokens sent with #handshake and #authenticate are accepted */
+	bool acceptAuthTokens = true;
+};
+
+/** A client connected to the stand-in server */
+struct FSCServerConnection
+{
+	FString id;
+
+	struct lws* wsi = nullptr;
+
+	/** The fragments of the message being received */
+	TArray<uint8> receiveBuffer;
+
+	/** The frames waiting to be written, each with the time it is due */
+	TArray<TPair<double, FSCSocketFrame>> outbox;
+
+	TSet<FString> subscriptions;
+
+	FString authToken;
+
+	bool handshaken = false;
+
+	double lastPong = 0.0;
+
+	double nextPing = 0.0;
+
+	/** Set when the connection is closed once the frames due so far are written */
+	int32 closeCode = 0;
+
+	FString closeReason;
+
+	int32 cid = 0;
+};
+
+/**
+* The SocketCluster Server
+*
+* A small stand-in for a SocketCluster server, built on the server side of libwebsockets, so the client can be tested and benchmarked without a node server.
+* It speaks the handshake, ping / pong (protocol v1 and v2), #subscribe, #unsubscribe, #publish, #authenticate, #setAuthToken, #removeAuthToken and #kickOut.
+* Every other emit is answered with its own data (RPC echo) unless onevent handles it, and script adds latency, dropped responses and disconnects.
+*
+* Inside the engine the server is ticked like the client socket, a standalone program calls service in a loop instead.
+*/
+class SCSERVER_API FSCServer : public FTickableGameObject, public FGCObject
+{
+public:
+
+	FSCServer();
+
+	virtual ~FSCServer();
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual bool IsTickableWhenPaused() const override { return true; }
+
+	virtual bool IsTickableInEditor() const override { return true; }
+
+	virtual TStatId GetStatId() const override;
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	/**
+	* Start listening for clients.
+	*
+	* @param port				The port to listen on.
+	* @param protocolVersion	The SocketCluster protocol version, 1 pings with #1 / #2, 2 with empty frames.
+	* @param codecEngine		The codec the frames are encoded with, the JSON formatter if null.
+	* @return					Whether the server is listening.
+	*/
+	bool listen(int32 port, int32 protocolVersion = 2, USCCodecEngine* codecEngine = nullptr);
+
+	/** Drop every client and stop listening */
+	void close();
+
+	bool isListening() const { return context != nullptr; }
+
+	int32 getPort() const { return port; }
+
+	/** Run the libwebsockets event loop once, waiting up to timeoutMs for network activity. */
+	void service(int32 timeoutMs = 0);
+
+	/** The misbehaviour of the server, see FSCServerScript */
+	FSCServerScript script;
+
+	/** The time in seconds between pings */
+	double pingInterval = 8.0;
+
+	/** The time in seconds the server waits for a pong before it closes the connection with 4001 */
+	double pingTimeout = 20.0;
+
+	/** The number of times service runs the event loop while frames are due, libwebsockets writes one frame per connection and pass */
+	int32 servicePasses = 16;
+
+	TArray<FString> getClientIds() const;
+
+	int32 getClientCount() const { return connections.Num(); }
+
+	/** The channels a client is subscribed to */
+	TArray<FString> getSubscriptions(const FString& clientId) const;
+
+	/** Emit an event to a client, returns false if the client is not connected */
+	bool emit(const FString& clientId, const FString& event, TSharedPtr<FJsonValue> data = nullptr);
+
+	/** Publish data to every client subscribed to the channel */
+	void publish(const FString& channel, TSharedPtr<FJsonValue> data);
+
+	/** Answer an emit of a client, used by onevent handlers */
+	bool respond(const FString& clientId, int32 cid, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data = nullptr);
+
+	bool setAuthToken(const FString& clientId, const FString& token);
+
+	bool removeAuthToken(const FString& clientId);
+
+	/** Unsubscribe a client from a channel and tell it with #kickOut */
+	bool kickOut(const FString& clientId, const FString& channel, const FString& message = FString());
+
+	/** Close the connection of a client once the frames due so far are written */
+	bool disconnect(const FString& clientId, int32 code = 1000, const FString& reason = FString());
+
+	TFunction<void(const FString& clientId)> onconnection;
+
+	TFunction<void(const FString& clientId, int32 code)> ondisconnection;
+
+	/** Optional, receives the emits which are not part of the protocol, returns whether it handled them, the others are echoed */
+	TFunction<bool(const FString& clientId, const FString& event, TSharedPtr<FJsonValue> data, int32 cid)> onevent;
+
+	static int ws_service_callback(struct lws* wsi, enum lws_callback_reasons reason, void* user, void* in, size_t len);
+
+private:
+
+	struct lws_context* context;
+
+	int32 port;
+
+	int32 protocolVersion;
+
+	USCCodecEngine* codec;
+
+	TMap<struct lws*, TSharedPtr<FSCServerConnection>> connections;
+
+	TSharedPtr<FSCServerConnection> findConnection(const FString& clientId) const;
+
+	bool hasDueFrames() const;
+
+	/** Queue a frame with the scripted latency */
+	void queueFrame(FSCServerConnection& connection, FSCSocketFrame&& frame);
+
+	void sendObject(FSCServerConnection& connection, TSharedPtr<FJsonValue> object);
+
+	void sendRaw(FSCServerConnection& connection, const FString& message);
+
+	void sendEvent(FSCServerConnection& connection, const FString& event, TSharedPtr<FJsonValue> data, bool expectResponse = false);
+
+	void sendResponse(FSCServerConnection& connection, int32 cid, TSharedPtr<FJsonValue> error, TSharedPtr<FJsonValue> data);
+
+	/** Returns -1 when the connection has to be closed */
+	int writeDue(FSCServerConnection& connection);
+
+	void onData(FSCServerConnection& connection, const TArray<uint8>& message, bool binary);
+
+	void handlePacket(FSCServerConnection& connection, TSharedPtr<FJsonObject> packet);
+
+	bool shouldDrop(const FString& event) const;
+
+	TSharedPtr<FJsonValue> authenticate(FSCServerConnection& connection, const FString& token);
+
+	static TSharedPtr<FJsonValue> makeError(const FString& name, const FString& message);
+};
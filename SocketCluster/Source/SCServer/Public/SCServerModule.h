@@ -0,0 +1,20 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Core/Public/Modules/ModuleManager.h"
+#include "SCSocketModule.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSCServer, Log, All);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Server Service"), STAT_SCServerService, STATGROUP_SocketCluster, SCSERVER_API);
+
+class FSCServerModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
@@ -0,0 +1,33 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class SCServer : ModuleRules
+{
+	public SCServer(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"Json",
+				"SCJson",
+				"SCSocket",
+				"SCCodecEngine",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"libWebSockets",
+				"OpenSSL",
+				"zlib",
+			}
+			);
+	}
+}
@@ -0,0 +1,137 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCNetworkSimulator.h"
+
+FSCNetworkSimulator::FSCNetworkSimulator(const FSCNetworkConditions& InConditions)
+	: conditions(InConditions)
+	, random(InConditions.seed)
+	, outboundLast(0.0)
+	, outboundLinkFree(0.0)
+	, inboundLast(0.0)
+	, inboundLinkFree(0.0)
+	, stalledUntil(0.0)
+	, lastStallCheck(0.0)
+	, openedAt(0.0)
+	, lastDisconnectCheck(0.0)
+{
+}
+
+double FSCNetworkSimulator::schedule(int32 size, int32 bandwidth, double now, double& last, double& linkFree)
+{
+	double due = now;
+	if (bandwidth > 0)
+	{
+		// The frame goes on the link once the frames before it went through
+		due = FMath::Max(now, linkFree) + (double)size / bandwidth;
+		linkFree = due;
+	}
+	due += conditions.latency + (conditions.jitter > 0.0f ? random.FRand() * conditions.jitter : 0.0);
+	due = FMath::Max(due, last);
+	last = due;
+	return due;
+}
+
+void FSCNetworkSimulator::send(FSCSocketFrame&& frame, double now)
+{
+	const double due = schedule(frame.payload.Num(), conditions.uplinkBandwidth, now, outboundLast, outboundLinkFree);
+	FDelayedOutbound& delayed = outbound.AddDefaulted_GetRef();
+	delayed.frame = MoveTemp(frame);
+	delayed.due = due;
+}
+
+void FSCNetworkSimulator::receive(TArray<uint8>&& data, bool binary, double now)
+{
+	const double due = schedule(data.Num(), conditions.downlinkBandwidth, now, inboundLast, inboundLinkFree);
+	FDelayedInbound& delayed = inbound.AddDefaulted_GetRef();
+	delayed.payload = MoveTemp(data);
+	delayed.binary = binary;
+	delayed.due = due;
+}
+
+bool FSCNetworkSimulator::isStalled(double now)
+{
+	if (conditions.stallRate > 0.0f && conditions.stallDuration > 0.0f && now >= stalledUntil)
+	{
+		// A stall starts within the elapsed time with the probability of a poisson process
+		const double elapsed = lastStallCheck > 0.0 ? now - lastStallCheck : 0.0;
+		if (random.FRand() < 1.0 - FMath::Exp(-conditions.stallRate * elapsed))
+		{
+			stalledUntil = now + conditions.stallDuration;
+		}
+	}
+	lastStallCheck = now;
+	return now < stalledUntil;
+}
+
+void FSCNetworkSimulator::releaseOutbound(double now, TArray<FSCSocketFrame>& out)
+{
+	if (outbound.Num() == 0 || isStalled(now))
+	{
+		return;
+	}
+
+	int32 count = 0;
+	for (; count < outbound.Num() && outbound[count].due <= now; count++)
+	{
+		out.Add(MoveTemp(outbound[count].frame));
+	}
+	outbound.RemoveAt(0, count, false);
+}
+
+void FSCNetworkSimulator::releaseInbound(double now, TFunctionRef<void(const TArray<uint8>&, bool)> deliver)
+{
+	if (inbound.Num() == 0 || isStalled(now))
+	{
+		return;
+	}
+
+	// Moved out first, deliver may hold more frames or reset the simulator
+	TArray<FDelayedInbound> due;
+	int32 count = 0;
+	for (; count < inbound.Num() && inbound[count].due <= now; count++)
+	{
+		due.Add(MoveTemp(inbound[count]));
+	}
+	inbound.RemoveAt(0, count, false);
+
+	for (const FDelayedInbound& frame : due)
+	{
+		deliver(frame.payload, frame.binary);
+	}
+}
+
+bool FSCNetworkSimulator::shouldDisconnect(double now, int32& code)
+{
+	if (openedAt <= 0.0)
+	{
+		return false;
+	}
+
+	bool disconnect = conditions.disconnectAfter > 0.0f && now - openedAt >= conditions.disconnectAfter;
+	if (!disconnect && conditions.disconnectRate > 0.0f)
+	{
+		const double elapsed = now - lastDisconnectCheck;
+		disconnect = random.FRand() < 1.0 - FMath::Exp(-conditions.disconnectRate * elapsed);
+	}
+	lastDisconnectCheck = now;
+
+	if (disconnect)
+	{
+		code = conditions.disconnectCodes.Num() > 0 ? conditions.disconnectCodes[random.RandHelper(conditions.disconnectCodes.Num())] : 1006;
+		openedAt = 0.0;
+	}
+	return disconnect;
+}
+
+void FSCNetworkSimulator::open(double now)
+{
+	openedAt = now;
+	lastDisconnectCheck = now;
+}
+
+void FSCNetworkSimulator::reset()
+{
+	outbound.Empty();
+	inbound.Empty();
+	openedAt = 0.0;
+}
@@ -3,7 +3,10 @@
 #include "SCSocket.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "SCErrors.h"
+#include "SCSocketContext.h"
+#include "SCNetworkSimulator.h"
 #include "SCSocketModule.h"
+#include "SCMessageAccounting.h"
 
 // Namespace UI Conflict.
 // Remove UI Namepspace
@@ -77,23 +80,63 @@ static void lws_debug(int level, const char *line)
 	UE_LOG(LogSCSocket, Log, TEXT("%s"), ANSI_TO_TCHAR(line));
 }
 
+void USCSocket::BeginDestroy()
+{
+	onopen = nullptr;
+	onclose = nullptr;
+	onmessage = nullptr;
+	ondata = nullptr;
+	onerror = nullptr;
+
+	if (socket != nullptr)
+	{
+		// The connection may outlive this object on the shared context, it is closed on its next callback
+		lws_set_wsi_user(socket, nullptr);
+		lws_callback_on_writable(socket);
+		socket = nullptr;
+	}
+
+	if (shared)
+	{
+		FSCSocketContext::release(this);
+	}
+	else if (context != nullptr)
+	{
+		lws_context_destroy(context);
+	}
+	context = nullptr;
+
+	Super::BeginDestroy();
+}
+
 void USCSocket::Tick(float DeltaTime)
 {
-	if (context != nullptr)
+	if (context != nullptr && !shared)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_SCSocketService);
+		serviceSimulator();
 		lws_callback_on_writable_all_protocol(context, &protocols[0]);
 		lws_service(context, 0);
 	}
+	else if (offline)
+	{
+		for (int32 index = _bufferHead; index < _buffer.Num(); index++)
+		{
+			_writeFrame(_buffer[index]);
+		}
+		_buffer.Reset();
+		_bufferHead = 0;
+	}
 }
 
 bool USCSocket::IsTickable() const
 {
-	return true;
+	return !shared;
 }
 
 TStatId USCSocket::GetStatId() const
 {
-	return TStatId();
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USCSocket, STATGROUP_SocketCluster);
 }
 
 int USCSocket::ws_service_callback(lws* wsi, lws_callback_reasons reason, void* user, void* in, size_t len)
@@ -102,11 +145,33 @@ int USCSocket::ws_service_callback(lws* wsi, lws_callback_reasons reason, void*
 	void* wsi_user = lws_wsi_user(wsi);
 	USCSocket* SCSocket = (USCSocket*)wsi_user;
 
+	if (SCSocket == nullptr)
+	{
+		// The socket was destroyed, drop its connection
+		switch (reason)
+		{
+		case LWS_CALLBACK_CLIENT_ESTABLISHED:
+		case LWS_CALLBACK_CLIENT_RECEIVE:
+		case LWS_CALLBACK_CLIENT_WRITEABLE:
+			return -1;
+		default:
+			return 0;
+		}
+	}
+
 	switch (reason)
 	{
 	case LWS_CALLBACK_CLIENT_ESTABLISHED:
 	{
+		if (SCSocket->_closeCode != 0)
+		{
+			return -1;
+		}
 		SCSocket->readyState = ESocketState::OPEN;
+		if (SCSocket->simulator.IsValid())
+		{
+			SCSocket->simulator->open(FPlatformTime::Seconds());
+		}
 		if (SCSocket->onopen)
 		{
 			SCSocket->onopen();
@@ -124,8 +189,9 @@ int USCSocket::ws_service_callback(lws* wsi, lws_callback_reasons reason, void*
 	break;
 	case LWS_CALLBACK_CLIENT_CLOSED:
 		SCSocket->readyState = ESocketState::CLOSED;
-		if (SCSocket->onclose)
+		if (SCSocket->onclose && !SCSocket->_closeNotified)
 		{
+			SCSocket->_closeNotified = true;
 			TSharedPtr<FJsonObject> Error = MakeShareable(new FJsonObject);
 			Error->SetNumberField("code", 1006);
 			Error->SetStringField("reason", "");
@@ -134,8 +200,9 @@ int USCSocket::ws_service_callback(lws* wsi, lws_callback_reasons reason, void*
 	break;
 	case LWS_CALLBACK_CLOSED:
 	{
-		if (SCSocket->onclose)
+		if (SCSocket->onclose && !SCSocket->_closeNotified)
 		{
+			SCSocket->_closeNotified = true;
 			TSharedPtr<FJsonObject> Error = MakeShareable(new FJsonObject);
 			Error->SetNumberField("code", 1001);
 			Error->SetStringField("reason", UTF8_TO_TCHAR(in));
@@ -145,20 +212,63 @@ int USCSocket::ws_service_callback(lws* wsi, lws_callback_reasons reason, void*
 	break;
 	case LWS_CALLBACK_CLIENT_RECEIVE:
 	{
-		FString message = UTF8_TO_TCHAR(in);
-		if (SCSocket->onmessage)
+		// Large messages arrive in several fragments, only hand out complete messages
+		SCSocket->_receiveBuffer.Append((const uint8*)in, len);
+		if (!lws_is_final_fragment(wsi) || lws_remaining_packet_payload(wsi) > 0)
+		{
+			break;
+		}
+
+		TArray<uint8> data = MoveTemp(SCSocket->_receiveBuffer);
+		SCSocket->_receiveBuffer.Reset();
+		if (SCSocket->simulator.IsValid())
+		{
+			SCSocket->simulator->receive(MoveTemp(data), lws_frame_is_binary(wsi) != 0, FPlatformTime::Seconds());
+		}
+		else
 		{
-			SCSocket->onmessage(message);
+			SCSocket->_receiveFrame(data, lws_frame_is_binary(wsi) != 0);
 		}
 	}
 	break;
+	case LWS_CALLBACK_WSI_DESTROY:
+		SCSocket->socket = nullptr;
+	break;
 	case LWS_CALLBACK_CLIENT_WRITEABLE:
 	{
-		if (SCSocket->_buffer.Num() > 0)
+		const bool simulating = SCSocket->simulator.IsValid();
+		TArray<FSCSocketFrame>& queue = simulating ? SCSocket->_released : SCSocket->_buffer;
+		int32& head = simulating ? SCSocket->_releasedHead : SCSocket->_bufferHead;
+		if (head < queue.Num())
 		{
-			std::string strData = TCHAR_TO_UTF8(*SCSocket->_buffer[0]);
-			ws_write_back(wsi, strData.c_str(), strData.size());
-			SCSocket->_buffer.RemoveAt(0);
+			SCOPE_CYCLE_COUNTER(STAT_SCSocketWrite);
+			if (SCSocket->_writeFrame(queue[head]) < 0)
+			{
+				// The connection is broken, the frame stays queued and closing reports the abnormal closure through onclose
+				UE_LOG(LogSCSocket, Warning, TEXT("Writing a frame of %d bytes failed, closing the connection"), queue[head].payload.Num() - LWS_PRE);
+				if (SCSocket->onerror)
+				{
+					SCSocket->onerror(USCErrors::SocketProtocolError(TEXT("Failed to write a frame"), 1006));
+				}
+				return -1;
+			}
+			head++;
+
+			// Written frames stay in the queue until it drained or they are half of it, so a frame costs no shift of the frames behind it
+			if (head == queue.Num() || (head >= 64 && head * 2 >= queue.Num()))
+			{
+				_dropWritten(queue, head);
+			}
+		}
+		else if (SCSocket->_closeCode != 0 && SCSocket->getQueuedFrameCount() == 0)
+		{
+			// 1005, 1006 and 1015 are reserved for close events and must not be sent
+			const int32 code = SCSocket->_closeCode;
+			if (code >= 1000 && code < 5000 && code != 1005 && code != 1006 && code != 1015)
+			{
+				lws_close_reason(wsi, (enum lws_close_status)code, nullptr, 0);
+			}
+			return -1;
 		}
 	}
 	break;
@@ -166,40 +276,98 @@ int USCSocket::ws_service_callback(lws* wsi, lws_callback_reasons reason, void*
 	return 0;
 }
 
-int USCSocket::ws_write_back(lws* wsi, const char* str, int str_size_in)
+int USCSocket::ws_write_frame(lws* wsi, const FSCSocketFrame& frame)
 {
-	if (str == NULL || wsi == NULL)
+	if (wsi == NULL || frame.payload.Num() < LWS_PRE)
 		return -1;
 
-	int n;
-	int len;
-	unsigned char *out = NULL;
-
-	if (str_size_in < 1)
-		len = strlen(str);
-	else
-		len = str_size_in;
+	unsigned char* out = (unsigned char*)frame.payload.GetData() + LWS_PRE;
+	return lws_write(wsi, out, frame.payload.Num() - LWS_PRE, frame.binary ? LWS_WRITE_BINARY : LWS_WRITE_TEXT);
+}
 
-	out = (unsigned char*)malloc(sizeof(unsigned char)*(LWS_SEND_BUFFER_PRE_PADDING + len + LWS_SEND_BUFFER_POST_PADDING));
+void USCSocket::_dropWritten(TArray<FSCSocketFrame>& queue, int32& head)
+{
+	if (head >= queue.Num())
+	{
+		queue.Reset();
+	}
+	else if (head > 0)
+	{
+		queue.RemoveAt(0, head, false);
+	}
+	head = 0;
+}
 
-	memcpy(out + LWS_SEND_BUFFER_PRE_PADDING, str, len);
+int USCSocket::_writeFrame(const FSCSocketFrame& frame)
+{
+	int n = offline ? frame.payload.Num() - LWS_PRE : ws_write_frame(socket, frame);
+	if (n >= 0)
+	{
+		if (stats.IsValid())
+		{
+			stats->bytesSent += frame.payload.Num() - LWS_PRE;
+			stats->framesSent++;
+		}
+		if (capture.IsValid())
+		{
+			capture->record(ESCCaptureDirection::OUTBOUND, frame.payload.GetData() + LWS_PRE, frame.payload.Num() - LWS_PRE, frame.binary);
+		}
+	}
+	return n;
+}
 
-	n = lws_write(wsi, out + LWS_SEND_BUFFER_PRE_PADDING, len, LWS_WRITE_TEXT);
+void USCSocket::_receiveFrame(const TArray<uint8>& data, bool binary)
+{
+	// Everything from here until the frame is dispatched is accounted to one inbound message, the transport names it
+	SC_ACCOUNT_MESSAGE(ESCMessageDirection::INBOUND);
+	if (stats.IsValid())
+	{
+		stats->bytesReceived += data.Num();
+		stats->framesReceived++;
+	}
+	if (capture.IsValid())
+	{
+		capture->record(ESCCaptureDirection::INBOUND, data.GetData(), data.Num(), binary);
+	}
+	if (ondata)
+	{
+		ondata(data, binary);
+	}
+	else if (!binary)
+	{
+		FUTF8ToTCHAR converted((const ANSICHAR*)data.GetData(), data.Num());
+		SC_ACCOUNT_TRANSCODE(data.Num());
+		FString message(converted.Length(), converted.Get());
+		if (onmessage)
+		{
+			onmessage(message);
+		}
+	}
+}
 
-	free(out);
+void USCSocket::fillFrame(FSCSocketFrame& frame, const uint8* data, int32 size, bool binary)
+{
+	frame.payload.SetNumUninitialized(LWS_PRE + size);
+	if (size > 0)
+	{
+		FMemory::Memcpy(frame.payload.GetData() + LWS_PRE, data, size);
+	}
+	frame.binary = binary;
+}
 
-	return n;
+void USCSocket::beginFrame(FSCSocketFrame& frame)
+{
+	frame.payload.SetNumUninitialized(LWS_PRE, false);
+	frame.binary = false;
 }
 
-void USCSocket::createWebSocket(FString uri, TSharedPtr<FJsonObject> options)
+lws_context* USCSocket::createContext()
 {
 
 #if !UE_BUILD_SHIPPING
 	lws_set_log_level(LLL_ERR | LLL_WARN | LLL_NOTICE | LLL_DEBUG | LLL_INFO, lws_debug);
 #endif
 
-	readyState = ESocketState::CLOSED;
-
 	struct lws_context_creation_info context_info;
 	memset(&context_info, 0, sizeof(context_info));
 
@@ -218,7 +386,140 @@ void USCSocket::createWebSocket(FString uri, TSharedPtr<FJsonObject> options)
 	context_info.options |= LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
 #endif
 
-	context = lws_create_context(&context_info);
+	return lws_create_context(&context_info);
+}
+
+bool USCSocket::requestWritable()
+{
+	const int32 queued = simulator.IsValid() ? _released.Num() - _releasedHead : _buffer.Num() - _bufferHead;
+	if (socket != nullptr && (queued > 0 || _closeCode != 0))
+	{
+		lws_callback_on_writable(socket);
+		return true;
+	}
+	return false;
+}
+
+int32 USCSocket::getQueuedFrameCount() const
+{
+	return _buffer.Num() - _bufferHead + _released.Num() - _releasedHead + (simulator.IsValid() ? simulator->getOutboundCount() : 0);
+}
+
+void USCSocket::simulate(const FSCNetworkConditions& conditions)
+{
+	if (simulator.IsValid())
+	{
+		simulator->conditions = conditions;
+		return;
+	}
+	simulator = MakeShared<FSCNetworkSimulator>(conditions);
+	if (readyState == ESocketState::OPEN)
+	{
+		simulator->open(FPlatformTime::Seconds());
+	}
+}
+
+void USCSocket::stopSimulating()
+{
+	if (!simulator.IsValid())
+	{
+		return;
+	}
+
+	// Everything held is due now, in the order it was sent
+	TSharedPtr<FSCNetworkSimulator> held = simulator;
+	simulator.Reset();
+	const double forever = TNumericLimits<double>::Max();
+	held->conditions.stallRate = 0.0f;
+	_dropWritten(_released, _releasedHead);
+	_dropWritten(_buffer, _bufferHead);
+	TArray<FSCSocketFrame> frames = MoveTemp(_released);
+	held->releaseOutbound(forever, frames);
+	frames.Append(MoveTemp(_buffer));
+	_buffer = MoveTemp(frames);
+	_released.Reset();
+	held->releaseInbound(forever, [this](const TArray<uint8>& data, bool binary)
+	{
+		_receiveFrame(data, binary);
+	});
+}
+
+void USCSocket::simulateDisconnect(int32 code)
+{
+	if (readyState == ESocketState::CLOSED && socket == nullptr)
+	{
+		return;
+	}
+
+	if (simulator.IsValid())
+	{
+		simulator->reset();
+	}
+	_buffer.Reset();
+	_released.Reset();
+	_bufferHead = 0;
+	_releasedHead = 0;
+	readyState = ESocketState::CLOSED;
+
+	// The connection is dropped without writing the frames which were held
+	if (socket != nullptr && _closeCode == 0)
+	{
+		_closeCode = code;
+		lws_callback_on_writable(socket);
+	}
+
+	// lws reports the connection closed once the close frame is out, onclose was called for it already
+	TFunction<void(const TSharedPtr<FJsonObject>)> handler = onclose;
+	if (handler && !_closeNotified)
+	{
+		_closeNotified = true;
+		TSharedPtr<FJsonObject> Error = MakeShareable(new FJsonObject);
+		Error->SetNumberField("code", code);
+		Error->SetStringField("reason", "Simulated disconnect");
+		handler(Error);
+	}
+}
+
+void USCSocket::serviceSimulator()
+{
+	if (!simulator.IsValid() || offline)
+	{
+		return;
+	}
+
+	// Held locally, a handler may stop the simulation while frames are handed out
+	TSharedPtr<FSCNetworkSimulator> held = simulator;
+	const double now = FPlatformTime::Seconds();
+
+	int32 code;
+	if (readyState == ESocketState::OPEN && held->shouldDisconnect(now, code))
+	{
+		simulateDisconnect(code);
+		return;
+	}
+
+	for (int32 index = _bufferHead; index < _buffer.Num(); index++)
+	{
+		held->send(MoveTemp(_buffer[index]), now);
+	}
+	_buffer.Reset();
+	_bufferHead = 0;
+	held->releaseOutbound(now, _released);
+
+	held->releaseInbound(now, [this](const TArray<uint8>& data, bool binary)
+	{
+		_receiveFrame(data, binary);
+	});
+}
+
+void USCSocket::createWebSocket(FString uri, TSharedPtr<FJsonObject> options)
+{
+	readyState = ESocketState::CLOSED;
+	_closeCode = 0;
+	_closeNotified = false;
+
+	shared = options->HasField("sharedContext") && options->GetBoolField("sharedContext");
+	context = shared ? FSCSocketContext::acquire(this) : createContext();
 
 	if (!context)
 	{
@@ -313,18 +614,66 @@ void USCSocket::createWebSocket(FString uri, TSharedPtr<FJsonObject> options)
 	}
 }
 
+void USCSocket::openOffline()
+{
+	context = nullptr;
+	socket = nullptr;
+	offline = true;
+	readyState = ESocketState::OPEN;
+}
+
+void USCSocket::receiveOffline(const TArray<uint8>& data, bool binary)
+{
+	if (offline)
+	{
+		_receiveFrame(data, binary);
+	}
+}
+
 void USCSocket::send(FString data)
 {
-	std::string strData = TCHAR_TO_UTF8(*data);
-	ws_write_back(socket, strData.c_str(), strData.size());
+	FTCHARToUTF8 converted(*data);
+	SC_ACCOUNT_TRANSCODE(converted.Length());
+	FSCSocketFrame frame;
+	fillFrame(frame, (const uint8*)converted.Get(), converted.Length(), false);
+	sendFrame(frame);
 }
 
 void USCSocket::sendBuffer(FString data)
 {
-	_buffer.Add(data);	
+	FTCHARToUTF8 converted(*data);
+	SC_ACCOUNT_TRANSCODE(converted.Length());
+	FSCSocketFrame& frame = _buffer.AddDefaulted_GetRef();
+	fillFrame(frame, (const uint8*)converted.Get(), converted.Length(), false);
 }
 
-void USCSocket::close(int32 code)
+FSCSocketFrame& USCSocket::bufferFrame()
 {
+	FSCSocketFrame& frame = _buffer.AddDefaulted_GetRef();
+	beginFrame(frame);
+	return frame;
+}
 
+void USCSocket::sendFrame(const FSCSocketFrame& frame)
+{
+	if (simulator.IsValid() && !offline)
+	{
+		simulator->send(FSCSocketFrame(frame), FPlatformTime::Seconds());
+		return;
+	}
+	_writeFrame(frame);
+}
+
+void USCSocket::close(int32 code)
+{
+	if (offline)
+	{
+		readyState = ESocketState::CLOSED;
+		return;
+	}
+	if (socket != nullptr && _closeCode == 0)
+	{
+		_closeCode = code != 0 ? code : 1000;
+		lws_callback_on_writable(socket);
+	}
 }
@@ -0,0 +1,167 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCSocketCapture.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "SCSocketModule.h"
+
+static const uint8 SCCaptureMagic[4] = { 'S', 'C', 'W', 'C' };
+
+static const int32 SCCaptureBlockSize = 64 * 1024;
+
+static void SCWriteVarint(TArray<uint8>& out, uint64 value)
+{
+	while (value >= 0x80)
+	{
+		out.Add((uint8)(value | 0x80));
+		value >>= 7;
+	}
+	out.Add((uint8)value);
+}
+
+FSCSocketCapture::FSCSocketCapture(const FString& InPath)
+	: path(InPath)
+	, frameCount(0)
+{
+	writer = IFileManager::Get().CreateFileWriter(*path);
+	if (writer == nullptr)
+	{
+		UE_LOG(LogSCSocket, Error, TEXT("Could not open capture file %s"), *path);
+	}
+	else
+	{
+		buffer.Append(SCCaptureMagic, 4);
+		buffer.Add(Version);
+	}
+	start = FPlatformTime::Cycles64();
+	previous = start;
+}
+
+FSCSocketCapture::~FSCSocketCapture()
+{
+	close();
+}
+
+void FSCSocketCapture::record(ESCCaptureDirection direction, const uint8* data, int32 size, bool binary)
+{
+	if (writer == nullptr)
+	{
+		return;
+	}
+
+	const uint64 now = FPlatformTime::Cycles64();
+	const uint64 delta = (uint64)(FPlatformTime::ToSeconds64(now - previous) * 1000000.0);
+	// Only whole microseconds move the clock on, so rounding errors do not add up over a long capture
+	previous += (uint64)(delta / (FPlatformTime::GetSecondsPerCycle64() * 1000000.0));
+
+	buffer.Add((direction == ESCCaptureDirection::OUTBOUND ? 1 : 0) | (binary ? 2 : 0));
+	SCWriteVarint(buffer, delta);
+	SCWriteVarint(buffer, (uint64)size);
+	buffer.Append(data, size);
+	frameCount++;
+
+	if (buffer.Num() >= SCCaptureBlockSize)
+	{
+		flush();
+	}
+}
+
+void FSCSocketCapture::flush()
+{
+	if (writer != nullptr && buffer.Num() > 0)
+	{
+		writer->Serialize(buffer.GetData(), buffer.Num());
+		writer->Flush();
+		buffer.Reset();
+	}
+}
+
+void FSCSocketCapture::close()
+{
+	if (writer != nullptr)
+	{
+		flush();
+		writer->Close();
+		delete writer;
+		writer = nullptr;
+	}
+}
+
+bool FSCSocketCaptureReader::open(const FString& path)
+{
+	data.Reset();
+	offset = 0;
+	time = 0.0;
+
+	if (!FFileHelper::LoadFileToArray(data, *path))
+	{
+		UE_LOG(LogSCSocket, Error, TEXT("Could not read capture file %s"), *path);
+		return false;
+	}
+	if (data.Num() < 5 || FMemory::Memcmp(data.GetData(), SCCaptureMagic, 4) != 0 || data[4] != FSCSocketCapture::Version)
+	{
+		UE_LOG(LogSCSocket, Error, TEXT("%s is not a capture of this version"), *path);
+		data.Reset();
+		return false;
+	}
+	offset = 5;
+	return true;
+}
+
+bool FSCSocketCaptureReader::readVarint(uint64& value)
+{
+	value = 0;
+	for (int32 shift = 0; shift < 64 && offset < data.Num(); shift += 7)
+	{
+		const uint8 byte = data[offset++];
+		value |= (uint64)(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FSCSocketCaptureReader::next(FSCCaptureRecord& record)
+{
+	if (offset >= data.Num())
+	{
+		return false;
+	}
+
+	const uint8 flags = data[offset++];
+	uint64 delta;
+	uint64 size;
+	if (!readVarint(delta) || !readVarint(size) || size > (uint64)(data.Num() - offset))
+	{
+		UE_LOG(LogSCSocket, Warning, TEXT("The capture is truncated"));
+		offset = data.Num();
+		return false;
+	}
+
+	time += delta / 1000000.0;
+	record.time = time;
+	record.direction = (flags & 1) != 0 ? ESCCaptureDirection::OUTBOUND : ESCCaptureDirection::INBOUND;
+	record.binary = (flags & 2) != 0;
+	record.payload.Reset();
+	record.payload.Append(data.GetData() + offset, (int32)size);
+	offset += (int32)size;
+	return true;
+}
+
+bool FSCSocketCaptureReader::load(const FString& path, TArray<FSCCaptureRecord>& records)
+{
+	FSCSocketCaptureReader reader;
+	if (!reader.open(path))
+	{
+		return false;
+	}
+
+	FSCCaptureRecord record;
+	while (reader.next(record))
+	{
+		records.Add(record);
+	}
+	return true;
+}
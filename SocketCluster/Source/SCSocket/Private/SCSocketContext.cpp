@@ -0,0 +1,124 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCSocketContext.h"
+#include "SCSocket.h"
+#include "SCSocketModule.h"
+
+// Namespace UI Conflict.
+// Remove UI Namepspace
+#if PLATFORM_LINUX
+#pragma push_macro("UI")
+#undef UI
+#elif PLATFORM_WINDOWS || PLATFORM_MAC
+#define UI UI_ST
+#endif 
+
+THIRD_PARTY_INCLUDES_START
+#include "libwebsockets.h"
+THIRD_PARTY_INCLUDES_END
+
+// Namespace UI Conflict.
+// Restore UI Namepspace
+#if PLATFORM_LINUX
+#pragma pop_macro("UI")
+#elif PLATFORM_WINDOWS || PLATFORM_MAC
+#undef UI
+#endif
+
+FSCSocketContext* FSCSocketContext::instance = nullptr;
+
+int32 FSCSocketContext::servicePasses = 16;
+
+FSCSocketContext::FSCSocketContext()
+{
+	context = USCSocket::createContext();
+}
+
+FSCSocketContext::~FSCSocketContext()
+{
+	if (context != nullptr)
+	{
+		lws_context_destroy(context);
+		context = nullptr;
+	}
+}
+
+lws_context* FSCSocketContext::acquire(USCSocket* socket)
+{
+	if (instance == nullptr)
+	{
+		instance = new FSCSocketContext();
+	}
+	if (instance->context == nullptr)
+	{
+		UE_LOG(LogSCSocket, Error, TEXT("shared context failed"));
+		delete instance;
+		instance = nullptr;
+		return nullptr;
+	}
+	instance->sockets.Add(socket);
+	return instance->context;
+}
+
+void FSCSocketContext::release(USCSocket* socket)
+{
+	if (instance == nullptr)
+	{
+		return;
+	}
+	instance->sockets.Remove(socket);
+	if (instance->sockets.Num() == 0)
+	{
+		delete instance;
+		instance = nullptr;
+	}
+}
+
+int32 FSCSocketContext::getSocketCount()
+{
+	return instance != nullptr ? instance->sockets.Num() : 0;
+}
+
+void FSCSocketContext::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SCSocketService);
+
+	// Handing out the frames a network simulator held runs client handlers, which may create sockets
+	TArray<USCSocket*> simulating;
+	for (USCSocket* socket : sockets)
+	{
+		if (socket->simulator.IsValid())
+		{
+			simulating.Add(socket);
+		}
+	}
+	for (USCSocket* socket : simulating)
+	{
+		socket->serviceSimulator();
+	}
+
+	for (int32 pass = 0; pass < FMath::Max(1, servicePasses); pass++)
+	{
+		// Only the sockets with queued frames are asked for a writable callback
+		bool pending = false;
+		for (USCSocket* socket : sockets)
+		{
+			if (socket->requestWritable())
+			{
+				pending = true;
+			}
+		}
+
+		lws_service(context, 0);
+
+		if (!pending)
+		{
+			break;
+		}
+	}
+}
+
+TStatId FSCSocketContext::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FSCSocketContext, STATGROUP_SocketCluster);
+}
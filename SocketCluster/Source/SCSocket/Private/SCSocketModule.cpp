@@ -6,6 +6,9 @@
 
 DEFINE_LOG_CATEGORY(LogSCSocket);
 
+DEFINE_STAT(STAT_SCSocketService);
+DEFINE_STAT(STAT_SCSocketWrite);
+
 void FSCSocketModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
@@ -0,0 +1,140 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "SCSocket.h"
+#include "SCNetworkSimulator.generated.h"
+
+/** The network conditions a socket simulates, every rate and delay is in seconds and every bandwidth in bytes per second */
+USTRUCT(BlueprintType)
+struct SCSOCKET_API FSCNetworkConditions
+{
+	GENERATED_BODY()
+
+	/** The one way delay added to every frame in both directions */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	float latency = 0.0f;
+
+	/** The random extra delay of a frame, up to this value. Frames keep their order like on a TCP connection */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	float jitter = 0.0f;
+
+	/** The bandwidth from the client to the server, 0 is unlimited */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	int32 uplinkBandwidth = 0;
+
+	/** The bandwidth from the server to the client, 0 is unlimited */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	int32 downlinkBandwidth = 0;
+
+	/** The average number of stalls per second, no frame moves in either direction during a stall */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	float stallRate = 0.0f;
+
+	/** The length of a stall */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	float stallDuration = 0.0f;
+
+	/** The time after the connection opened it is dropped, 0 never drops it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	float disconnectAfter = 0.0f;
+
+	/** The average number of forced disconnects per second */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	float disconnectRate = 0.0f;
+
+	/** The close codes a forced disconnect picks from, 1006 when empty */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	TArray<int32> disconnectCodes;
+
+	/** The seed of the random delays, stalls and disconnects, every connection starts from it so runs repeat */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SocketCluster|Network")
+	int32 seed = 0;
+};
+
+/**
+* Delays, throttles and stalls the frames of a socket and drops its connection, as set by FSCNetworkConditions.
+* Outbound frames are held before they are written and inbound frames before they are handed out, so everything above the socket sees the simulated network.
+*/
+class SCSOCKET_API FSCNetworkSimulator
+{
+public:
+
+	explicit FSCNetworkSimulator(const FSCNetworkConditions& conditions);
+
+	FSCNetworkConditions conditions;
+
+	/** Hold an outbound frame */
+	void send(FSCSocketFrame&& frame, double now);
+
+	/** Hold an inbound frame */
+	void receive(TArray<uint8>&& data, bool binary, double now);
+
+	/** Move the outbound frames which are due to out */
+	void releaseOutbound(double now, TArray<FSCSocketFrame>& out);
+
+	/** Hand the inbound frames which are due to deliver, in order */
+	void releaseInbound(double now, TFunctionRef<void(const TArray<uint8>&, bool)> deliver);
+
+	/** Returns whether the connection is dropped now, with the close code to report */
+	bool shouldDisconnect(double now, int32& code);
+
+	/** Returns the number of outbound frames held */
+	int32 getOutboundCount() const { return outbound.Num(); }
+
+	/** Returns the number of inbound frames held */
+	int32 getInboundCount() const { return inbound.Num(); }
+
+	/** Call once the connection opened, disconnectAfter counts from it */
+	void open(double now);
+
+	/** Drop every held frame */
+	void reset();
+
+private:
+
+	struct FDelayedOutbound
+	{
+		FSCSocketFrame frame;
+
+		double due;
+	};
+
+	struct FDelayedInbound
+	{
+		TArray<uint8> payload;
+
+		bool binary;
+
+		double due;
+	};
+
+	/** The time a frame of size bytes arrives, never before the frame ahead of it */
+	double schedule(int32 size, int32 bandwidth, double now, double& last, double& linkFree);
+
+	bool isStalled(double now);
+
+	FRandomStream random;
+
+	TArray<FDelayedOutbound> outbound;
+
+	TArray<FDelayedInbound> inbound;
+
+	double outboundLast;
+
+	double outboundLinkFree;
+
+	double inboundLast;
+
+	double inboundLinkFree;
+
+	double stalledUntil;
+
+	double lastStallCheck;
+
+	double openedAt;
+
+	double lastDisconnectCheck;
+};
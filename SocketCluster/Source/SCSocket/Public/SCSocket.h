@@ -6,8 +6,12 @@
 #include "UObject/NoExportTypes.h"
 #include "Tickable.h"
 #include "SCJsonObject.h"
+#include "SCSocketCapture.h"
 #include "SCSocket.generated.h"
 
+class FSCNetworkSimulator;
+struct FSCNetworkConditions;
+
 enum class ESocketState : uint8
 {
 	CLOSED,
@@ -15,6 +19,32 @@ enum class ESocketState : uint8
 	OPEN
 };
 
+/**
+* A queued outgoing frame.
+* The payload is stored behind the padding libwebsockets needs in front of the data, so it is written in place without another copy.
+*/
+struct FSCSocketFrame
+{
+	TArray<uint8> payload;
+
+	bool binary;
+};
+
+/**
+* Traffic counters of a socket, counting payload bytes without the websocket framing.
+* Shared, so the owner can keep counting across the sockets of several connections.
+*/
+struct FSCSocketStats
+{
+	uint64 bytesSent = 0;
+
+	uint64 bytesReceived = 0;
+
+	uint64 framesSent = 0;
+
+	uint64 framesReceived = 0;
+};
+
 /**
 * The SocketCluster Socket
 */
@@ -23,6 +53,8 @@ class SCSOCKET_API USCSocket : public UObject, public FTickableGameObject
 {
 	GENERATED_BODY()
 
+	virtual void BeginDestroy() override;
+
 	virtual void Tick(float DeltaTime) override;
 
 	virtual bool IsTickable() const override;
@@ -33,30 +65,123 @@ class SCSOCKET_API USCSocket : public UObject, public FTickableGameObject
 
 	struct lws* socket;
 
+	/** Write a frame and count it */
+	int _writeFrame(const FSCSocketFrame& frame);
+
+	/** Count a complete received message and hand it out */
+	void _receiveFrame(const TArray<uint8>& data, bool binary);
+
+	/** Whether the socket was opened with openOffline */
+	bool offline;
+
+	/** Whether the socket connects through the FSCSocketContext shared context instead of a context of its own */
+	bool shared;
+
+	/** The close code sent once the socket is writable, 0 while the socket is not closing */
+	int32 _closeCode;
+
+	/** Set once onclose was called for the connection, so a simulated disconnect is not reported again when lws closes the connection */
+	bool _closeNotified;
+
+	/** The first frame of _buffer and of _released which was not written yet, the written frames are dropped in batches */
+	int32 _bufferHead;
+
+	int32 _releasedHead;
+
+	/** Drop the frames of queue before head */
+	static void _dropWritten(TArray<FSCSocketFrame>& queue, int32& head);
+
 public:
 
-	TArray<FString> _buffer;
+	TArray<FSCSocketFrame> _buffer;
+
+	/** The fragments of the message being received */
+	TArray<uint8> _receiveBuffer;
 
 	ESocketState readyState;
 
+	/** Optional, the counters written and received frames are added to */
+	TSharedPtr<FSCSocketStats> stats;
+
+	/** Optional, every written and received frame is appended to it */
+	TSharedPtr<FSCSocketCapture> capture;
+
+	/** Set while network conditions are simulated, see simulate */
+	TSharedPtr<FSCNetworkSimulator> simulator;
+
+	/** The frames the network simulator released, written in place of _buffer while simulating */
+	TArray<FSCSocketFrame> _released;
+
 	TFunction<void()> onopen;
 
 	TFunction<void(const TSharedPtr<FJsonObject>)> onclose;
 
 	TFunction<void(const FString&)> onmessage;
 
+	/** Receives every frame as raw bytes, onmessage is not called while this is bound */
+	TFunction<void(const TArray<uint8>&, bool)> ondata;
+
 	TFunction<void(const TSharedPtr<FJsonValue>)> onerror;
 
 	static int ws_service_callback(struct lws* wsi, enum lws_callback_reasons reason, void* user, void* in, size_t len);
 
-	static int ws_write_back(lws* wsi, const char* str, int str_size_in);
+	static int ws_write_frame(lws* wsi, const FSCSocketFrame& frame);
+
+	static void fillFrame(FSCSocketFrame& frame, const uint8* data, int32 size, bool binary);
+
+	/** Reset frame to an empty payload, the data is appended to frame.payload afterwards */
+	static void beginFrame(FSCSocketFrame& frame);
 
+	/** Create a client context, returns nullptr on failure */
+	static struct lws_context* createContext();
+
+	/** Ask for a writable callback if frames are queued or the socket is closing, returns whether it asked */
+	bool requestWritable();
+
+	/** Returns the number of frames which were sent but not written yet */
+	int32 getQueuedFrameCount() const;
+
+	/**
+	* Simulate network conditions: delay, throttle and stall the frames in both directions and drop the connection.
+	* Updates the conditions when the socket simulates already.
+	*/
+	void simulate(const FSCNetworkConditions& conditions);
+
+	/** Stop simulating, the held frames are written and handed out right away */
+	void stopSimulating();
+
+	/** Drop the connection as if the network failed, onclose receives code */
+	void simulateDisconnect(int32 code);
+
+	/** Pass the queued frames to the network simulator, then queue the outbound and hand out the inbound frames it released */
+	void serviceSimulator();
+
+	/**
+	* Connect to uri.
+	* With the sharedContext option the socket uses the FSCSocketContext shared context, which is serviced for every socket at once.
+	*/
 	void createWebSocket(FString uri, TSharedPtr<FJsonObject> options);
 
+	/**
+	* Open the socket without a connection, used to replay a capture.
+	* Written frames are counted and captured, then dropped, received frames are passed to receiveOffline.
+	*/
+	void openOffline();
+
+	/** Hand out a frame as if it was received on the connection */
+	void receiveOffline(const TArray<uint8>& data, bool binary);
+
 	void send(FString data);
 
 	void sendBuffer(FString data);
 
+	/** Queue an empty frame, the caller appends the data to its payload and sets the frame type */
+	FSCSocketFrame& bufferFrame();
+
+	/** Write a frame built with beginFrame immediately */
+	void sendFrame(const FSCSocketFrame& frame);
+
+	/** Close the connection with code once the queued frames were written */
 	void close(int32 code);
 
 };
\ No newline at end of file
@@ -0,0 +1,93 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class ESCCaptureDirection : uint8
+{
+	INBOUND,
+	OUTBOUND
+};
+
+/** A frame read back from a capture */
+struct FSCCaptureRecord
+{
+	/** The time in seconds since the capture started */
+	double time = 0.0;
+
+	ESCCaptureDirection direction = ESCCaptureDirection::INBOUND;
+
+	bool binary = false;
+
+	TArray<uint8> payload;
+};
+
+/**
+* Appends every frame of a socket to a compact binary log.
+* The file starts with the magic "SCWC" and a version byte, then every frame is written as
+* [flags: uint8, bit 0 outbound, bit 1 binary] [time since the previous frame in microseconds: varint] [size: varint] [payload]
+* The time comes from the monotonic cycle counter, frames are buffered and written in blocks.
+*/
+class SCSOCKET_API FSCSocketCapture
+{
+public:
+
+	explicit FSCSocketCapture(const FString& path);
+
+	~FSCSocketCapture();
+
+	bool isOpen() const { return writer != nullptr; }
+
+	const FString& getPath() const { return path; }
+
+	uint64 getFrameCount() const { return frameCount; }
+
+	void record(ESCCaptureDirection direction, const uint8* data, int32 size, bool binary);
+
+	/** Write the buffered frames to the file */
+	void flush();
+
+	void close();
+
+	static const uint8 Version = 1;
+
+private:
+
+	FString path;
+
+	FArchive* writer;
+
+	TArray<uint8> buffer;
+
+	uint64 start;
+
+	uint64 previous;
+
+	uint64 frameCount;
+};
+
+/** Reads a log written by FSCSocketCapture */
+class SCSOCKET_API FSCSocketCaptureReader
+{
+public:
+
+	/** Load a capture, returns false if the file is missing or not a capture */
+	bool open(const FString& path);
+
+	/** Read the next frame, returns false at the end of the capture or when the rest is truncated */
+	bool next(FSCCaptureRecord& record);
+
+	/** Read every frame of a capture */
+	static bool load(const FString& path, TArray<FSCCaptureRecord>& records);
+
+private:
+
+	bool readVarint(uint64& value);
+
+	TArray<uint8> data;
+
+	int32 offset = 0;
+
+	double time = 0.0;
+};
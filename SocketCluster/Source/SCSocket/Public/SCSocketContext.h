@@ -0,0 +1,53 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+
+class USCSocket;
+
+/**
+* A libwebsockets context shared by every socket created with the sharedContext option.
+* A context per socket costs a poll set and a service call every tick, the shared context is serviced once per tick for all of its sockets,
+* which lets a single process run thousands of client sockets.
+* It is created with the first socket and destroyed with the last one, on the game thread like every socket callback.
+*/
+class SCSOCKET_API FSCSocketContext : public FTickableGameObject
+{
+public:
+
+	/** Register socket and return the shared context, created on the first call */
+	static struct lws_context* acquire(USCSocket* socket);
+
+	/** Unregister socket, the context is destroyed once no socket uses it */
+	static void release(USCSocket* socket);
+
+	/** Returns the number of sockets using the shared context */
+	static int32 getSocketCount();
+
+	/** The number of service passes per tick while sockets have queued frames, every pass writes one frame per socket. Defaults to 16 */
+	static int32 servicePasses;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override { return context != nullptr; }
+
+	virtual bool IsTickableWhenPaused() const override { return true; }
+
+	virtual bool IsTickableInEditor() const override { return true; }
+
+	virtual TStatId GetStatId() const override;
+
+private:
+
+	FSCSocketContext();
+
+	~FSCSocketContext();
+
+	struct lws_context* context;
+
+	TSet<USCSocket*> sockets;
+
+	static FSCSocketContext* instance;
+};
@@ -4,9 +4,16 @@
 
 #include "CoreMinimal.h"
 #include "Runtime/Core/Public/Modules/ModuleManager.h"
+#include "Stats/Stats.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSCSocket, Log, All);
 
+/** The stat group of the whole plugin, shown with 'stat SocketCluster' */
+DECLARE_STATS_GROUP(TEXT("SocketCluster"), STATGROUP_SocketCluster, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Service (lws_service)"), STAT_SCSocketService, STATGROUP_SocketCluster, SCSOCKET_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Write Frame"), STAT_SCSocketWrite, STATGROUP_SocketCluster, SCSOCKET_API);
+
 class FSCSocketModule : public IModuleInterface
 {
 public:
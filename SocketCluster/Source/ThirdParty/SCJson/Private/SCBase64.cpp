@@ -0,0 +1,408 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCBase64.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define SC_BASE64_NEON 1
+#else
+#define SC_BASE64_NEON 0
+#endif
+
+#if !SC_BASE64_NEON && PLATFORM_ENABLE_VECTORINTRINSICS && (defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__))
+#include <emmintrin.h>
+#define SC_BASE64_SSE2 1
+#else
+#define SC_BASE64_SSE2 0
+#endif
+
+//The byte shuffle is only used when the whole module is built for SSSE3 or AVX, there is no runtime dispatch
+#if SC_BASE64_SSE2 && (defined(__SSSE3__) || defined(__AVX__))
+#include <tmmintrin.h>
+#define SC_BASE64_SSSE3 1
+#else
+#define SC_BASE64_SSSE3 0
+#endif
+
+static const ANSICHAR SCBase64Alphabets[2][65] =
+{
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+};
+
+/** Character to 6 bit value, 0xff for anything outside the alphabet */
+struct FSCBase64DecodeTables
+{
+	uint8 Values[2][256];
+
+	FSCBase64DecodeTables()
+	{
+		FMemory::Memset(Values, 0xff, sizeof(Values));
+		for (int32 Alphabet = 0; Alphabet < 2; Alphabet++)
+		{
+			for (int32 i = 0; i < 64; i++)
+			{
+				Values[Alphabet][(uint8)SCBase64Alphabets[Alphabet][i]] = (uint8)i;
+			}
+		}
+	}
+};
+
+static const uint8* SCGetBase64DecodeTable(ESCBase64 Alphabet)
+{
+	static const FSCBase64DecodeTables Tables;
+	return Tables.Values[(int32)Alphabet];
+}
+
+#if SC_BASE64_SSE2
+
+#if SC_BASE64_SSSE3
+
+/** Bytes a block reads, the shuffle loads 16 bytes for the 12 it encodes */
+static const int32 SCBase64EncodeRead = 16;
+
+/** Characters a block reads, the store writes 16 bytes for the 12 it decodes */
+static const int32 SCBase64DecodeRead = 24;
+
+/** The 6 bit indices of 12 bytes, byte k of every 32 bit lane holds the k-th index of its group */
+static FORCEINLINE __m128i SCSplitBase64Groups(const uint8* Source)
+{
+	// Every lane gets bytes 1 0 2 1 of its group, two multiplies move the four indices in place
+	const __m128i In = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)Source), _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	const __m128i High = _mm_mulhi_epu16(_mm_and_si128(In, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+	const __m128i Low = _mm_mullo_epi16(_mm_and_si128(In, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+	return _mm_or_si128(High, Low);
+}
+
+/** Write the 12 bytes of 16 decoded 6 bit values, the store covers 16 bytes */
+static FORCEINLINE void SCPackBase64Groups(__m128i Values, uint8* Dest)
+{
+	const __m128i Pairs = _mm_maddubs_epi16(Values, _mm_set1_epi32(0x01400140));
+	const __m128i Groups = _mm_madd_epi16(Pairs, _mm_set1_epi32(0x00011000));
+	_mm_storeu_si128((__m128i*)Dest, _mm_shuffle_epi8(Groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+}
+
+#else
+
+static const int32 SCBase64EncodeRead = 12;
+
+static const int32 SCBase64DecodeRead = 16;
+
+/** The three bytes of a group in the upper 24 bits */
+static FORCEINLINE int32 SCLoadBase64Group(const uint8* Source)
+{
+	return (int32)((uint32)Source[0] << 24 | (uint32)Source[1] << 16 | (uint32)Source[2] << 8);
+}
+
+/** SSE2 has no byte shuffle, the groups are gathered with scalar loads and split on all four at once */
+static FORCEINLINE __m128i SCSplitBase64Groups(const uint8* Source)
+{
+	const __m128i Words = _mm_setr_epi32(SCLoadBase64Group(Source), SCLoadBase64Group(Source + 3), SCLoadBase64Group(Source + 6), SCLoadBase64Group(Source + 9));
+	return _mm_or_si128(
+		_mm_or_si128(_mm_srli_epi32(Words, 26), _mm_and_si128(_mm_srli_epi32(Words, 12), _mm_set1_epi32(0x3f00))),
+		_mm_or_si128(_mm_and_si128(_mm_slli_epi32(Words, 2), _mm_set1_epi32(0x3f0000)), _mm_and_si128(_mm_slli_epi32(Words, 16), _mm_set1_epi32(0x3f000000))));
+}
+
+static FORCEINLINE void SCPackBase64Groups(__m128i Values, uint8* Dest)
+{
+	// Merge the four 6 bit values of every lane into the 24 bit value of its group
+	const __m128i Pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(Values, _mm_set1_epi16(0x3f)), 6), _mm_srli_epi16(Values, 8));
+	const __m128i Groups = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(Pairs, _mm_set1_epi32(0xffff)), 12), _mm_srli_epi32(Pairs, 16));
+
+	uint32 Words[4];
+	_mm_storeu_si128((__m128i*)Words, Groups);
+	for (int32 i = 0; i < 4; i++)
+	{
+		Dest[0] = (uint8)(Words[i] >> 16);
+		Dest[1] = (uint8)(Words[i] >> 8);
+		Dest[2] = (uint8)Words[i];
+		Dest += 3;
+	}
+}
+
+#endif
+
+/** 12 bytes to 16 characters, the translation of the indices to characters is done on all 16 at once */
+static FORCEINLINE void SCEncodeBlockSSE2(const uint8* Source, ANSICHAR* Dest, __m128i Offset62, __m128i Offset63)
+{
+	const __m128i Indices = SCSplitBase64Groups(Source);
+
+	// 'A' for 0-25, 'a' - 26 for 26-51, '0' - 52 for 52-61, the alphabet decides 62 and 63
+	__m128i Offset = _mm_set1_epi8('A');
+	Offset = _mm_add_epi8(Offset, _mm_and_si128(_mm_cmpgt_epi8(Indices, _mm_set1_epi8(25)), _mm_set1_epi8('a' - 26 - 'A')));
+	Offset = _mm_add_epi8(Offset, _mm_and_si128(_mm_cmpgt_epi8(Indices, _mm_set1_epi8(51)), _mm_set1_epi8('0' - 52 - ('a' - 26))));
+	Offset = _mm_add_epi8(Offset, _mm_and_si128(_mm_cmpeq_epi8(Indices, _mm_set1_epi8(62)), Offset62));
+	Offset = _mm_add_epi8(Offset, _mm_and_si128(_mm_cmpeq_epi8(Indices, _mm_set1_epi8(63)), Offset63));
+	_mm_storeu_si128((__m128i*)Dest, _mm_add_epi8(Indices, Offset));
+}
+
+static FORCEINLINE __m128i SCInRange(__m128i Chars, ANSICHAR Low, ANSICHAR High)
+{
+	return _mm_and_si128(_mm_cmpgt_epi8(Chars, _mm_set1_epi8(Low - 1)), _mm_cmplt_epi8(Chars, _mm_set1_epi8(High + 1)));
+}
+
+/** 16 characters to 12 bytes, false if one of them is outside the alphabet */
+static FORCEINLINE bool SCDecodeBlockSSE2(const ANSICHAR* Source, uint8* Dest, __m128i Char62, __m128i Char63, __m128i Shift62, __m128i Shift63)
+{
+	// Bytes from 128 up are negative and fall outside every range
+	const __m128i Chars = _mm_loadu_si128((const __m128i*)Source);
+	const __m128i Upper = SCInRange(Chars, 'A', 'Z');
+	const __m128i Lower = SCInRange(Chars, 'a', 'z');
+	const __m128i Digit = SCInRange(Chars, '0', '9');
+	const __m128i Is62 = _mm_cmpeq_epi8(Chars, Char62);
+	const __m128i Is63 = _mm_cmpeq_epi8(Chars, Char63);
+	if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(Upper, Lower), Digit), _mm_or_si128(Is62, Is63))) != 0xffff)
+	{
+		return false;
+	}
+
+	__m128i Shift = _mm_and_si128(Upper, _mm_set1_epi8(-'A'));
+	Shift = _mm_or_si128(Shift, _mm_and_si128(Lower, _mm_set1_epi8(26 - 'a')));
+	Shift = _mm_or_si128(Shift, _mm_and_si128(Digit, _mm_set1_epi8(52 - '0')));
+	Shift = _mm_or_si128(Shift, _mm_and_si128(Is62, Shift62));
+	Shift = _mm_or_si128(Shift, _mm_and_si128(Is63, Shift63));
+	SCPackBase64Groups(_mm_add_epi8(Chars, Shift), Dest);
+	return true;
+}
+
+#elif SC_BASE64_NEON
+
+static FORCEINLINE uint8x16x4_t SCLoadBase64Table(const uint8* Table)
+{
+	uint8x16x4_t Result;
+	Result.val[0] = vld1q_u8(Table);
+	Result.val[1] = vld1q_u8(Table + 16);
+	Result.val[2] = vld1q_u8(Table + 32);
+	Result.val[3] = vld1q_u8(Table + 48);
+	return Result;
+}
+
+/** 48 bytes to 64 characters, the load and store do the (de)interleaving */
+static FORCEINLINE void SCEncodeBlockNEON(const uint8* Source, ANSICHAR* Dest, const uint8x16x4_t& Alphabet)
+{
+	const uint8x16x3_t In = vld3q_u8(Source);
+	const uint8x16_t Mask = vdupq_n_u8(0x3f);
+	uint8x16x4_t Out;
+	Out.val[0] = vshrq_n_u8(In.val[0], 2);
+	Out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(In.val[0], 4), vshrq_n_u8(In.val[1], 4)), Mask);
+	Out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(In.val[1], 2), vshrq_n_u8(In.val[2], 6)), Mask);
+	Out.val[3] = vandq_u8(In.val[2], Mask);
+	for (int32 i = 0; i < 4; i++)
+	{
+		Out.val[i] = vqtbl4q_u8(Alphabet, Out.val[i]);
+	}
+	vst4q_u8((uint8*)Dest, Out);
+}
+
+/** 64 characters to 48 bytes, false if one of them is outside the alphabet */
+static FORCEINLINE bool SCDecodeBlockNEON(const ANSICHAR* Source, uint8* Dest, const uint8x16x4_t& Low, const uint8x16x4_t& High)
+{
+	const uint8x16x4_t In = vld4q_u8((const uint8*)Source);
+	uint8x16_t Values[4];
+	uint8x16_t Error = vdupq_n_u8(0);
+	for (int32 i = 0; i < 4; i++)
+	{
+		// Lookups past the table give 0 (vqtbl) or keep the value (vqtbx), characters from 128 up are marked invalid by hand
+		uint8x16_t Value = vqtbl4q_u8(Low, In.val[i]);
+		Value = vqtbx4q_u8(Value, High, vsubq_u8(In.val[i], vdupq_n_u8(64)));
+		Value = vorrq_u8(Value, vcgeq_u8(In.val[i], vdupq_n_u8(128)));
+		Error = vorrq_u8(Error, Value);
+		Values[i] = Value;
+	}
+	if (vmaxvq_u8(Error) > 63)
+	{
+		return false;
+	}
+
+	uint8x16x3_t Out;
+	Out.val[0] = vorrq_u8(vshlq_n_u8(Values[0], 2), vshrq_n_u8(Values[1], 4));
+	Out.val[1] = vorrq_u8(vshlq_n_u8(Values[1], 4), vshrq_n_u8(Values[2], 2));
+	Out.val[2] = vorrq_u8(vshlq_n_u8(Values[2], 6), Values[3]);
+	vst3q_u8(Dest, Out);
+	return true;
+}
+
+#endif
+
+int32 FSCBase64::GetEncodedLength(int32 Size, ESCBase64 Alphabet)
+{
+	if (Alphabet == ESCBase64::Standard)
+	{
+		return (Size + 2) / 3 * 4;
+	}
+	return Size / 3 * 4 + (Size % 3 != 0 ? Size % 3 + 1 : 0);
+}
+
+void FSCBase64::Encode(const uint8* Source, int32 Size, ANSICHAR* Dest, ESCBase64 Alphabet)
+{
+	const ANSICHAR* Table = SCBase64Alphabets[(int32)Alphabet];
+	const uint8* End = Source + Size;
+
+#if SC_BASE64_SSE2
+	const __m128i Offset62 = _mm_set1_epi8(Table[62] - 62 - ('0' - 52));
+	const __m128i Offset63 = _mm_set1_epi8(Table[63] - 63 - ('0' - 52));
+	while (End - Source >= SCBase64EncodeRead)
+	{
+		SCEncodeBlockSSE2(Source, Dest, Offset62, Offset63);
+		Source += 12;
+		Dest += 16;
+	}
+#elif SC_BASE64_NEON
+	const uint8x16x4_t Characters = SCLoadBase64Table((const uint8*)Table);
+	while (End - Source >= 48)
+	{
+		SCEncodeBlockNEON(Source, Dest, Characters);
+		Source += 48;
+		Dest += 64;
+	}
+#endif
+
+	while (End - Source >= 3)
+	{
+		const uint32 Group = (uint32)Source[0] << 16 | (uint32)Source[1] << 8 | Source[2];
+		Dest[0] = Table[Group >> 18];
+		Dest[1] = Table[(Group >> 12) & 0x3f];
+		Dest[2] = Table[(Group >> 6) & 0x3f];
+		Dest[3] = Table[Group & 0x3f];
+		Source += 3;
+		Dest += 4;
+	}
+
+	const int32 Remainder = End - Source;
+	if (Remainder > 0)
+	{
+		const uint32 Group = (uint32)Source[0] << 16 | (Remainder > 1 ? (uint32)Source[1] << 8 : 0);
+		*Dest++ = Table[Group >> 18];
+		*Dest++ = Table[(Group >> 12) & 0x3f];
+		if (Remainder > 1)
+		{
+			*Dest++ = Table[(Group >> 6) & 0x3f];
+		}
+		if (Alphabet == ESCBase64::Standard)
+		{
+			*Dest++ = '=';
+			if (Remainder == 1)
+			{
+				*Dest++ = '=';
+			}
+		}
+	}
+}
+
+FString FSCBase64::Encode(TArrayView<const uint8> Source, ESCBase64 Alphabet)
+{
+	TArray<ANSICHAR> Chars;
+	Chars.SetNumUninitialized(GetEncodedLength(Source.Num(), Alphabet));
+	Encode(Source.GetData(), Source.Num(), Chars.GetData(), Alphabet);
+	return FString(Chars.Num(), Chars.GetData());
+}
+
+bool FSCBase64::Decode(const ANSICHAR* Source, int32 Length, TArray<uint8>& OutBytes, ESCBase64 Alphabet)
+{
+	OutBytes.Reset();
+
+	// Padding is optional, what is left has to be whole groups and 2 or 3 characters for the last one
+	for (int32 i = 0; i < 2 && Length > 0 && Source[Length - 1] == '='; i++)
+	{
+		--Length;
+	}
+	const int32 Remainder = Length % 4;
+	if (Remainder == 1)
+	{
+		return false;
+	}
+
+	OutBytes.SetNumUninitialized(Length / 4 * 3 + (Remainder > 0 ? Remainder - 1 : 0));
+	uint8* Dest = OutBytes.GetData();
+	const ANSICHAR* End = Source + Length;
+	const uint8* Table = SCGetBase64DecodeTable(Alphabet);
+	bool bValid = true;
+
+#if SC_BASE64_SSE2
+	const ANSICHAR* Characters = SCBase64Alphabets[(int32)Alphabet];
+	const __m128i Char62 = _mm_set1_epi8(Characters[62]);
+	const __m128i Char63 = _mm_set1_epi8(Characters[63]);
+	const __m128i Shift62 = _mm_set1_epi8(62 - Characters[62]);
+	const __m128i Shift63 = _mm_set1_epi8(63 - Characters[63]);
+	while (End - Source >= SCBase64DecodeRead)
+	{
+		if (!SCDecodeBlockSSE2(Source, Dest, Char62, Char63, Shift62, Shift63))
+		{
+			bValid = false;
+			break;
+		}
+		Source += 16;
+		Dest += 12;
+	}
+#elif SC_BASE64_NEON
+	const uint8x16x4_t Low = SCLoadBase64Table(Table);
+	const uint8x16x4_t High = SCLoadBase64Table(Table + 64);
+	while (End - Source >= 64)
+	{
+		if (!SCDecodeBlockNEON(Source, Dest, Low, High))
+		{
+			bValid = false;
+			break;
+		}
+		Source += 64;
+		Dest += 48;
+	}
+#endif
+
+	while (bValid && End - Source >= 4)
+	{
+		const uint32 A = Table[(uint8)Source[0]];
+		const uint32 B = Table[(uint8)Source[1]];
+		const uint32 C = Table[(uint8)Source[2]];
+		const uint32 D = Table[(uint8)Source[3]];
+		if ((A | B | C | D) & 0x80)
+		{
+			bValid = false;
+			break;
+		}
+		const uint32 Group = A << 18 | B << 12 | C << 6 | D;
+		Dest[0] = (uint8)(Group >> 16);
+		Dest[1] = (uint8)(Group >> 8);
+		Dest[2] = (uint8)Group;
+		Source += 4;
+		Dest += 3;
+	}
+
+	if (bValid && Remainder > 0)
+	{
+		const uint32 A = Table[(uint8)Source[0]];
+		const uint32 B = Table[(uint8)Source[1]];
+		const uint32 C = Remainder > 2 ? Table[(uint8)Source[2]] : 0;
+		bValid = ((A | B | C) & 0x80) == 0;
+		const uint32 Group = A << 18 | B << 12 | C << 6;
+		Dest[0] = (uint8)(Group >> 16);
+		if (Remainder > 2)
+		{
+			Dest[1] = (uint8)(Group >> 8);
+		}
+	}
+
+	if (!bValid)
+	{
+		OutBytes.Reset();
+	}
+	return bValid;
+}
+
+bool FSCBase64::Decode(const FString& Source, TArray<uint8>& OutBytes, ESCBase64 Alphabet)
+{
+	const int32 Length = Source.Len();
+	const TCHAR* Chars = *Source;
+	TArray<ANSICHAR> Narrow;
+	Narrow.SetNumUninitialized(Length);
+	for (int32 i = 0; i < Length; i++)
+	{
+		if (Chars[i] > 0x7f)
+		{
+			OutBytes.Reset();
+			return false;
+		}
+		Narrow[i] = (ANSICHAR)Chars[i];
+	}
+	return Decode(Narrow.GetData(), Length, OutBytes, Alphabet);
+}
@@ -0,0 +1,488 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCJsonArena.h"
+#include "SCJsonStructural.h"
+#include "SCMessageAccounting.h"
+
+/** Arenas which grew beyond this are released on reset instead of kept, a single huge message should not pin its memory */
+static const SIZE_T SCJsonArenaMaxKeptSize = 1024 * 1024;
+
+FSCJsonArena::FSCJsonArena(int32 InBlockSize)
+	: BlockSize(FMath::Max(InBlockSize, 64))
+	, Cursor(nullptr)
+	, BlockEnd(nullptr)
+	, UsedBefore(0)
+{
+}
+
+FSCJsonArena::~FSCJsonArena()
+{
+	for (const FBlock& Block : Blocks)
+	{
+		FMemory::Free(Block.Data);
+	}
+}
+
+void* FSCJsonArena::AllocSlow(SIZE_T Size, SIZE_T Alignment)
+{
+	if (Cursor != nullptr)
+	{
+		UsedBefore += Cursor - Blocks.Last().Data;
+	}
+
+	//Blocks double in size so large messages need few of them
+	FBlock Block;
+	Block.Size = FMath::Max<SIZE_T>(Blocks.Num() > 0 ? Blocks.Last().Size * 2 : BlockSize, Size + Alignment);
+	Block.Data = (uint8*)FMemory::Malloc(Block.Size);
+	Blocks.Add(Block);
+
+	uint8* Aligned = Align(Block.Data, Alignment);
+	Cursor = Aligned + Size;
+	BlockEnd = Block.Data + Block.Size;
+	return Aligned;
+}
+
+void FSCJsonArena::Reset()
+{
+	if (Blocks.Num() == 0)
+	{
+		return;
+	}
+
+	SIZE_T Total = 0;
+	for (const FBlock& Block : Blocks)
+	{
+		Total += Block.Size;
+	}
+
+	if (Blocks.Num() > 1 || Total > SCJsonArenaMaxKeptSize)
+	{
+		for (const FBlock& Block : Blocks)
+		{
+			FMemory::Free(Block.Data);
+		}
+		Blocks.Reset();
+
+		if (Total <= SCJsonArenaMaxKeptSize)
+		{
+			FBlock Block;
+			Block.Size = Total;
+			Block.Data = (uint8*)FMemory::Malloc(Total);
+			Blocks.Add(Block);
+		}
+	}
+
+	Cursor = Blocks.Num() > 0 ? Blocks[0].Data : nullptr;
+	BlockEnd = Blocks.Num() > 0 ? Blocks[0].Data + Blocks[0].Size : nullptr;
+	UsedBefore = 0;
+}
+
+SIZE_T FSCJsonArena::GetUsed() const
+{
+	return UsedBefore + (Cursor != nullptr ? Cursor - Blocks.Last().Data : 0);
+}
+
+FString FSCJsonNode::AsString() const
+{
+	switch (Type)
+	{
+	case EJson::String:
+		return FString(Length, String);
+	case EJson::Number:
+		return FString::SanitizeFloat(Number, 0);
+	case EJson::Boolean:
+		return Bool ? TEXT("true") : TEXT("false");
+	default:
+		return FString();
+	}
+}
+
+const FSCJsonNode& FSCJsonNode::operator[](int32 Index) const
+{
+	if (Type != EJson::Array || Index < 0 || Index >= Length)
+	{
+		return NullNode();
+	}
+	return Items[Index];
+}
+
+const FSCJsonMember& FSCJsonNode::GetMember(int32 Index) const
+{
+	check(Type == EJson::Object && Index >= 0 && Index < Length);
+	return Members[Index];
+}
+
+const FSCJsonNode* FSCJsonNode::FindField(const TCHAR* Key) const
+{
+	if (Type != EJson::Object || Key == nullptr)
+	{
+		return nullptr;
+	}
+
+	//Searched from the back so duplicate keys resolve like FJsonObject, the last one wins
+	const int32 KeyLength = FCString::Strlen(Key);
+	for (int32 i = Length - 1; i >= 0; i--)
+	{
+		const FSCJsonMember& Member = Members[i];
+		if (Member.KeyLength == KeyLength && FCString::Strnicmp(Member.Key, Key, KeyLength) == 0)
+		{
+			return &Member.Value;
+		}
+	}
+	return nullptr;
+}
+
+const FSCJsonNode& FSCJsonNode::GetField(const TCHAR* Key) const
+{
+	const FSCJsonNode* Field = FindField(Key);
+	return Field != nullptr ? *Field : NullNode();
+}
+
+TSharedPtr<FJsonValue> FSCJsonNode::ToJsonValue() const
+{
+	switch (Type)
+	{
+	case EJson::Number:
+		return MakeShareable(new FJsonValueNumber(Number));
+	case EJson::Boolean:
+		return MakeShareable(new FJsonValueBoolean(Bool));
+	case EJson::String:
+		return MakeShareable(new FJsonValueString(FString(Length, String)));
+	case EJson::Array:
+	{
+		TArray<TSharedPtr<FJsonValue>> Array;
+		Array.Reserve(Length);
+		for (int32 i = 0; i < Length; i++)
+		{
+			Array.Add(Items[i].ToJsonValue());
+		}
+		return MakeShareable(new FJsonValueArray(Array));
+	}
+	case EJson::Object:
+	{
+		TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject);
+		for (int32 i = 0; i < Length; i++)
+		{
+			Object->SetField(FString(Members[i].KeyLength, Members[i].Key), Members[i].Value.ToJsonValue());
+		}
+		return MakeShareable(new FJsonValueObject(Object));
+	}
+	case EJson::None:
+	case EJson::Null:
+	default:
+		return MakeShareable(new FJsonValueNull);
+	}
+}
+
+const FSCJsonNode& FSCJsonNode::NullNode()
+{
+	static const FSCJsonNode Null;
+	return Null;
+}
+
+FSCJsonDocument::FSCJsonDocument()
+{
+}
+
+void FSCJsonDocument::Reset()
+{
+	Arena.Reset();
+	Root = FSCJsonNode();
+	ItemStack.Reset();
+	MemberStack.Reset();
+}
+
+bool FSCJsonDocument::Parse(TArrayView<const uint8> Bytes)
+{
+	Reset();
+	if (Bytes.Num() == 0 || !SCBuildJsonStructuralIndex(Bytes.GetData(), Bytes.Num(), StructuralIndices))
+	{
+		return false;
+	}
+
+	//Trailing garbage makes the whole message invalid
+	FSCJsonTokenCursor Cursor(Bytes.GetData(), Bytes.Num(), StructuralIndices);
+	if (!ParseValue(Cursor, Root) || !Cursor.AtEnd())
+	{
+		Reset();
+		return false;
+	}
+	return true;
+}
+
+void FSCJsonDocument::Assign(const TSharedPtr<FJsonValue>& JsonValue)
+{
+	Reset();
+	CopyValue(JsonValue, Root);
+}
+
+bool FSCJsonDocument::ParseValue(FSCJsonTokenCursor& Cursor, FSCJsonNode& Out)
+{
+	switch (Cursor.Peek())
+	{
+	case '{':
+	{
+		++Cursor.Next;
+		if (++Cursor.Reader.Depth > SCJsonMaxDepth)
+		{
+			return false;
+		}
+
+		//Members are collected on the stack, nested containers push theirs above and pop them before this one continues
+		const int32 Start = MemberStack.Num();
+		if (!Cursor.Consume('}'))
+		{
+			do
+			{
+				FSCJsonMember Member;
+				if (Cursor.Peek() != '"' || !Cursor.ReadRawString() || !Cursor.Consume(':'))
+				{
+					return false;
+				}
+				Member.Key = CopyString(Cursor.Reader.Scratch.GetData(), Cursor.Reader.Scratch.Num(), Member.KeyLength);
+				if (!ParseValue(Cursor, Member.Value))
+				{
+					return false;
+				}
+				MemberStack.Add(Member);
+			} while (Cursor.Consume(','));
+			if (!Cursor.Consume('}'))
+			{
+				return false;
+			}
+		}
+		--Cursor.Reader.Depth;
+
+		const int32 Count = MemberStack.Num() - Start;
+		FSCJsonMember* Members = nullptr;
+		if (Count > 0)
+		{
+			Members = Arena.AllocArray<FSCJsonMember>(Count);
+			FMemory::Memcpy(Members, MemberStack.GetData() + Start, Count * sizeof(FSCJsonMember));
+			MemberStack.SetNum(Start, false);
+		}
+		Out.Type = EJson::Object;
+		Out.Length = Count;
+		Out.Members = Members;
+		return true;
+	}
+	case '[':
+	{
+		++Cursor.Next;
+		if (++Cursor.Reader.Depth > SCJsonMaxDepth)
+		{
+			return false;
+		}
+
+		const int32 Start = ItemStack.Num();
+		if (!Cursor.Consume(']'))
+		{
+			do
+			{
+				FSCJsonNode Item;
+				if (!ParseValue(Cursor, Item))
+				{
+					return false;
+				}
+				ItemStack.Add(Item);
+			} while (Cursor.Consume(','));
+			if (!Cursor.Consume(']'))
+			{
+				return false;
+			}
+		}
+		--Cursor.Reader.Depth;
+
+		const int32 Count = ItemStack.Num() - Start;
+		FSCJsonNode* Items = nullptr;
+		if (Count > 0)
+		{
+			Items = Arena.AllocArray<FSCJsonNode>(Count);
+			FMemory::Memcpy(Items, ItemStack.GetData() + Start, Count * sizeof(FSCJsonNode));
+			ItemStack.SetNum(Start, false);
+		}
+		Out.Type = EJson::Array;
+		Out.Length = Count;
+		Out.Items = Items;
+		return true;
+	}
+	case '"':
+		if (!Cursor.ReadRawString())
+		{
+			return false;
+		}
+		Out.Type = EJson::String;
+		Out.String = CopyString(Cursor.Reader.Scratch.GetData(), Cursor.Reader.Scratch.Num(), Out.Length);
+		return true;
+	case 't':
+	case 'f':
+	{
+		const bool bValue = Cursor.Peek() == 't';
+		if (!(bValue ? Cursor.ReadLiteral("true", 4) : Cursor.ReadLiteral("false", 5)))
+		{
+			return false;
+		}
+		Out.Type = EJson::Boolean;
+		Out.Length = 0;
+		Out.Bool = bValue;
+		return true;
+	}
+	case 'n':
+		if (!Cursor.ReadLiteral("null", 4))
+		{
+			return false;
+		}
+		Out = FSCJsonNode();
+		return true;
+	case 0:
+	case '}':
+	case ']':
+	case ':':
+	case ',':
+		return false;
+	default:
+	{
+		double Value;
+		if (!Cursor.ReadNumber(Value))
+		{
+			return false;
+		}
+		Out.Type = EJson::Number;
+		Out.Length = 0;
+		Out.Number = Value;
+		return true;
+	}
+	}
+}
+
+void FSCJsonDocument::CopyValue(const TSharedPtr<FJsonValue>& JsonValue, FSCJsonNode& Out)
+{
+	Out = FSCJsonNode();
+	if (!JsonValue.IsValid())
+	{
+		return;
+	}
+
+	switch (JsonValue->Type)
+	{
+	case EJson::Number:
+		Out.Type = EJson::Number;
+		Out.Number = JsonValue->AsNumber();
+		break;
+	case EJson::Boolean:
+		Out.Type = EJson::Boolean;
+		Out.Bool = JsonValue->AsBool();
+		break;
+	case EJson::String:
+	{
+		FString Value;
+		JsonValue->TryGetString(Value);
+		Out.Type = EJson::String;
+		Out.String = CopyString(Value, Out.Length);
+	}
+	break;
+	case EJson::Array:
+	if (const TArray<double>* Numbers = FJsonValueNumberArray::AsNumberArray(JsonValue))
+	{
+		//Packed numbers never make their FJsonValue items
+		FSCJsonNode* Items = Numbers->Num() > 0 ? Arena.AllocArray<FSCJsonNode>(Numbers->Num()) : nullptr;
+		for (int32 i = 0; i < Numbers->Num(); i++)
+		{
+			new (&Items[i]) FSCJsonNode();
+			Items[i].Type = EJson::Number;
+			Items[i].Number = (*Numbers)[i];
+		}
+		Out.Type = EJson::Array;
+		Out.Length = Numbers->Num();
+		Out.Items = Items;
+	}
+	else
+	{
+		//Sizes are known up front, so children are copied straight into the arena
+		const TArray<TSharedPtr<FJsonValue>>& Array = JsonValue->AsArray();
+		FSCJsonNode* Items = Array.Num() > 0 ? Arena.AllocArray<FSCJsonNode>(Array.Num()) : nullptr;
+		for (int32 i = 0; i < Array.Num(); i++)
+		{
+			new (&Items[i]) FSCJsonNode();
+			CopyValue(Array[i], Items[i]);
+		}
+		Out.Type = EJson::Array;
+		Out.Length = Array.Num();
+		Out.Items = Items;
+	}
+	break;
+	case EJson::Object:
+	{
+		const TSharedPtr<FJsonObject>& Object = JsonValue->AsObject();
+		const int32 Count = Object.IsValid() ? Object->Values.Num() : 0;
+		FSCJsonMember* Members = Count > 0 ? Arena.AllocArray<FSCJsonMember>(Count) : nullptr;
+		int32 Index = 0;
+		if (Count > 0)
+		{
+			for (const auto& Field : Object->Values)
+			{
+				FSCJsonMember& Member = Members[Index++];
+				Member.Key = CopyString(Field.Key, Member.KeyLength);
+				new (&Member.Value) FSCJsonNode();
+				CopyValue(Field.Value, Member.Value);
+			}
+		}
+		Out.Type = EJson::Object;
+		Out.Length = Count;
+		Out.Members = Members;
+	}
+	break;
+	default:
+		break;
+	}
+}
+
+const TCHAR* FSCJsonDocument::CopyString(const ANSICHAR* Utf8, int32 Utf8Length, int32& OutLength)
+{
+	if (Utf8Length == 0)
+	{
+		OutLength = 0;
+		return TEXT("");
+	}
+	SC_ACCOUNT_TRANSCODE(Utf8Length);
+
+	//Keys and most values are ASCII, those are widened without the converter
+	int32 AsciiLength = 0;
+	while (AsciiLength < Utf8Length && (uint8)Utf8[AsciiLength] < 0x80)
+	{
+		AsciiLength++;
+	}
+
+	TCHAR* Dest;
+	if (AsciiLength == Utf8Length)
+	{
+		Dest = Arena.AllocArray<TCHAR>(Utf8Length + 1);
+		for (int32 i = 0; i < Utf8Length; i++)
+		{
+			Dest[i] = (TCHAR)Utf8[i];
+		}
+		OutLength = Utf8Length;
+	}
+	else
+	{
+		FUTF8ToTCHAR Converted(Utf8, Utf8Length);
+		OutLength = Converted.Length();
+		Dest = Arena.AllocArray<TCHAR>(OutLength + 1);
+		FMemory::Memcpy(Dest, Converted.Get(), OutLength * sizeof(TCHAR));
+	}
+	Dest[OutLength] = 0;
+	return Dest;
+}
+
+const TCHAR* FSCJsonDocument::CopyString(const FString& Value, int32& OutLength)
+{
+	OutLength = Value.Len();
+	if (OutLength == 0)
+	{
+		return TEXT("");
+	}
+
+	TCHAR* Dest = Arena.AllocArray<TCHAR>(OutLength + 1);
+	FMemory::Memcpy(Dest, *Value, (OutLength + 1) * sizeof(TCHAR));
+	return Dest;
+}
@@ -0,0 +1,649 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+#include "SCJsonValue.h"
+#include "SCMessageAccounting.h"
+
+/** Nesting limit of the reader, deeper input is rejected instead of overflowing the stack */
+static const int32 SCJsonMaxDepth = 256;
+
+/** Arrays of at least this many numbers and nothing else are read into one FJsonValueNumberArray instead of a node per number */
+static const int32 SCJsonPackedArrayMin = 8;
+
+/** Powers of ten a double holds exactly */
+static const double SCJsonExactPowersOf10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static FORCEINLINE bool SCIsDigit(uint8 Char)
+{
+	return Char >= '0' && Char <= '9';
+}
+
+static FORCEINLINE bool SCIsNumberStart(uint8 Char)
+{
+	return Char == '-' || SCIsDigit(Char);
+}
+
+static FORCEINLINE void SCAppendNumbers(const TArray<double>& Numbers, TArray<TSharedPtr<FJsonValue>>& OutItems)
+{
+	OutItems.Reserve(OutItems.Num() + Numbers.Num());
+	for (double Number : Numbers)
+	{
+		OutItems.Add(MakeShareable(new FJsonValueNumber(Number)));
+	}
+}
+
+/** The value of an array which held nothing but Numbers, packed unless it is too short to be worth it */
+static FORCEINLINE TSharedPtr<FJsonValue> SCMakeNumberArray(TArray<double>&& Numbers)
+{
+	if (Numbers.Num() >= SCJsonPackedArrayMin)
+	{
+		return MakeShareable(new FJsonValueNumberArray(MoveTemp(Numbers)));
+	}
+	TArray<TSharedPtr<FJsonValue>> Items;
+	SCAppendNumbers(Numbers, Items);
+	return MakeShareable(new FJsonValueArray(Items));
+}
+
+#if PLATFORM_LITTLE_ENDIAN
+/** True if all eight bytes are ASCII digits */
+static FORCEINLINE bool SCIsEightDigits(uint64 Value)
+{
+	return ((Value & 0xF0F0F0F0F0F0F0F0ull) | (((Value + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+/** The value of eight ASCII digits, the first one in the lowest byte, with three multiplies instead of eight */
+static FORCEINLINE uint32 SCParseEightDigits(uint64 Value)
+{
+	const uint64 Mask = 0x000000FF000000FFull;
+	const uint64 Mul1 = 0x000F424000000064ull;	// 100 + (1000000 << 32)
+	const uint64 Mul2 = 0x0000271000000001ull;	// 1 + (10000 << 32)
+	Value -= 0x3030303030303030ull;
+	Value = (Value * 10) + (Value >> 8);
+	Value = (((Value & Mask) * Mul1) + (((Value >> 16) & Mask) * Mul2)) >> 32;
+	return (uint32)Value;
+}
+#endif
+
+/** A minimal pull reader over UTF-8 JSON */
+class FSCJsonByteReader
+{
+public:
+
+	FSCJsonByteReader(const uint8* InData, int32 InSize)
+		: Cursor(InData)
+		, End(InData + InSize)
+		, Depth(0)
+	{
+		// Skip the UTF-8 byte order mark
+		if (InSize >= 3 && InData[0] == 0xef && InData[1] == 0xbb && InData[2] == 0xbf)
+		{
+			Cursor += 3;
+		}
+	}
+
+	const uint8* Cursor;
+
+	const uint8* End;
+
+	int32 Depth;
+
+	/** Unescaped UTF-8 of the last string read with ReadRawString */
+	TArray<ANSICHAR> Scratch;
+
+	FORCEINLINE void SkipWhitespace()
+	{
+		while (Cursor < End && (*Cursor == ' ' || *Cursor == '\n' || *Cursor == '\r' || *Cursor == '\t'))
+		{
+			++Cursor;
+		}
+	}
+
+	FORCEINLINE uint8 Peek()
+	{
+		SkipWhitespace();
+		return Cursor < End ? *Cursor : 0;
+	}
+
+	FORCEINLINE bool Consume(uint8 Char)
+	{
+		if (Peek() == Char)
+		{
+			++Cursor;
+			return true;
+		}
+		return false;
+	}
+
+	bool ConsumeLiteral(const ANSICHAR* Literal, int32 Length)
+	{
+		SkipWhitespace();
+		if (End - Cursor < Length || FMemory::Memcmp(Cursor, Literal, Length) != 0)
+		{
+			return false;
+		}
+		Cursor += Length;
+		return true;
+	}
+
+	bool ReadHex4(uint32& OutValue)
+	{
+		if (End - Cursor < 4)
+		{
+			return false;
+		}
+		OutValue = 0;
+		for (int32 i = 0; i < 4; i++)
+		{
+			uint8 Char = *Cursor++;
+			OutValue <<= 4;
+			if (Char >= '0' && Char <= '9')
+			{
+				OutValue |= Char - '0';
+			}
+			else if (Char >= 'a' && Char <= 'f')
+			{
+				OutValue |= Char - 'a' + 10;
+			}
+			else if (Char >= 'A' && Char <= 'F')
+			{
+				OutValue |= Char - 'A' + 10;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static void AppendUtf8(TArray<ANSICHAR>& Out, uint32 CodePoint)
+	{
+		if (CodePoint < 0x80)
+		{
+			Out.Add((ANSICHAR)CodePoint);
+		}
+		else if (CodePoint < 0x800)
+		{
+			Out.Add((ANSICHAR)(0xc0 | (CodePoint >> 6)));
+			Out.Add((ANSICHAR)(0x80 | (CodePoint & 0x3f)));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Out.Add((ANSICHAR)(0xe0 | (CodePoint >> 12)));
+			Out.Add((ANSICHAR)(0x80 | ((CodePoint >> 6) & 0x3f)));
+			Out.Add((ANSICHAR)(0x80 | (CodePoint & 0x3f)));
+		}
+		else
+		{
+			Out.Add((ANSICHAR)(0xf0 | (CodePoint >> 18)));
+			Out.Add((ANSICHAR)(0x80 | ((CodePoint >> 12) & 0x3f)));
+			Out.Add((ANSICHAR)(0x80 | ((CodePoint >> 6) & 0x3f)));
+			Out.Add((ANSICHAR)(0x80 | (CodePoint & 0x3f)));
+		}
+	}
+
+	/** Read a string into Scratch as unescaped UTF-8 */
+	bool ReadRawString()
+	{
+		if (!Consume('"'))
+		{
+			return false;
+		}
+
+		Scratch.Reset();
+		const uint8* RunStart = Cursor;
+		while (Cursor < End)
+		{
+			uint8 Char = *Cursor;
+			if (Char == '"')
+			{
+				Scratch.Append((const ANSICHAR*)RunStart, Cursor - RunStart);
+				++Cursor;
+				return true;
+			}
+			else if (Char == '\\')
+			{
+				Scratch.Append((const ANSICHAR*)RunStart, Cursor - RunStart);
+				if (++Cursor >= End)
+				{
+					return false;
+				}
+
+				switch (*Cursor++)
+				{
+				case '"': Scratch.Add('"'); break;
+				case '\\': Scratch.Add('\\'); break;
+				case '/': Scratch.Add('/'); break;
+				case 'b': Scratch.Add('\b'); break;
+				case 'f': Scratch.Add('\f'); break;
+				case 'n': Scratch.Add('\n'); break;
+				case 'r': Scratch.Add('\r'); break;
+				case 't': Scratch.Add('\t'); break;
+				case 'u':
+				{
+					uint32 CodePoint;
+					if (!ReadHex4(CodePoint))
+					{
+						return false;
+					}
+					if (CodePoint >= 0xd800 && CodePoint <= 0xdfff)
+					{
+						//A surrogate is only valid as a high half followed by a low half, an unpaired one becomes U+FFFD instead of CESU-8 bytes
+						const uint8* Restore = Cursor;
+						bool bPaired = false;
+						if (CodePoint <= 0xdbff && End - Cursor >= 6 && Cursor[0] == '\\' && Cursor[1] == 'u')
+						{
+							Cursor += 2;
+							uint32 Low;
+							bPaired = ReadHex4(Low) && Low >= 0xdc00 && Low <= 0xdfff;
+							if (bPaired)
+							{
+								CodePoint = 0x10000 + ((CodePoint - 0xd800) << 10) + (Low - 0xdc00);
+							}
+						}
+						if (!bPaired)
+						{
+							Cursor = Restore;
+							CodePoint = 0xfffd;
+						}
+					}
+					AppendUtf8(Scratch, CodePoint);
+				}
+				break;
+				default:
+					return false;
+				}
+				RunStart = Cursor;
+			}
+			else if (Char < 0x20)
+			{
+				return false;
+			}
+			else
+			{
+				++Cursor;
+			}
+		}
+		return false;
+	}
+
+	bool ReadString(FString& OutValue)
+	{
+		if (!ReadRawString())
+		{
+			return false;
+		}
+
+		if (Scratch.Num() == 0)
+		{
+			OutValue.Reset();
+			return true;
+		}
+		FUTF8ToTCHAR Converted(Scratch.GetData(), Scratch.Num());
+		SC_ACCOUNT_TRANSCODE(Scratch.Num());
+		OutValue = FString(Converted.Length(), Converted.Get());
+		return true;
+	}
+
+	/**
+	 * Move past a number of the RFC 8259 grammar, -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+	 * Input like 1.2.3, 01, 1e, - or +1 is rejected, the cursor is left somewhere inside it then.
+	 */
+	bool ScanNumber(bool& bIsInteger)
+	{
+		bIsInteger = true;
+		if (Cursor < End && *Cursor == '-')
+		{
+			++Cursor;
+		}
+		if (Cursor >= End || !SCIsDigit(*Cursor))
+		{
+			return false;
+		}
+		if (*Cursor++ != '0')
+		{
+			while (Cursor < End && SCIsDigit(*Cursor))
+			{
+				++Cursor;
+			}
+		}
+
+		if (Cursor < End && *Cursor == '.')
+		{
+			bIsInteger = false;
+			if (++Cursor >= End || !SCIsDigit(*Cursor))
+			{
+				return false;
+			}
+			while (Cursor < End && SCIsDigit(*Cursor))
+			{
+				++Cursor;
+			}
+		}
+
+		if (Cursor < End && (*Cursor == 'e' || *Cursor == 'E'))
+		{
+			bIsInteger = false;
+			if (++Cursor < End && (*Cursor == '+' || *Cursor == '-'))
+			{
+				++Cursor;
+			}
+			if (Cursor >= End || !SCIsDigit(*Cursor))
+			{
+				return false;
+			}
+			while (Cursor < End && SCIsDigit(*Cursor))
+			{
+				++Cursor;
+			}
+		}
+
+		//The number has to end here, 1.2.3 and 01 stop early on a character which would continue it
+		return Cursor == End || !(SCIsDigit(*Cursor) || *Cursor == '.' || *Cursor == 'e' || *Cursor == 'E' || *Cursor == '+' || *Cursor == '-');
+	}
+
+	/** Copy the next number into Buffer as a null terminated string, false if it does not follow the JSON number grammar */
+	bool ReadNumberText(ANSICHAR* Buffer, int32 BufferSize, bool& bIsInteger)
+	{
+		SkipWhitespace();
+		const uint8* Start = Cursor;
+		if (!ScanNumber(bIsInteger))
+		{
+			return false;
+		}
+
+		int32 Length = Cursor - Start;
+		if (Length >= BufferSize)
+		{
+			return false;
+		}
+		FMemory::Memcpy(Buffer, Start, Length);
+		Buffer[Length] = 0;
+		return true;
+	}
+
+	/**
+	 * Read the digits at Cursor into Mantissa, eight at a time where the input allows.
+	 * Digits counts every digit read, only the first 19 are added to Mantissa so it can not overflow.
+	 */
+	FORCEINLINE void ReadDigits(uint64& Mantissa, int32& Digits)
+	{
+#if PLATFORM_LITTLE_ENDIAN
+		while (Digits <= 11 && End - Cursor >= 8)
+		{
+			uint64 Chunk;
+			FMemory::Memcpy(&Chunk, Cursor, 8);
+			if (!SCIsEightDigits(Chunk))
+			{
+				break;
+			}
+			Mantissa = Mantissa * 100000000 + SCParseEightDigits(Chunk);
+			Digits += 8;
+			Cursor += 8;
+		}
+#endif
+		while (Cursor < End && SCIsDigit(*Cursor))
+		{
+			if (Digits < 19)
+			{
+				Mantissa = Mantissa * 10 + (*Cursor - '0');
+			}
+			++Digits;
+			++Cursor;
+		}
+	}
+
+	/**
+	 * Read a number without Atod when the result is exact anyway: at most 19 digits, a mantissa below 2^53 and a power of ten
+	 * a double holds exactly, one multiply or divide is correctly rounded then (Clinger's fast path).
+	 * Returns false with the cursor unmoved for anything else, ReadDouble falls back to Atod.
+	 */
+	bool ReadDoubleFast(double& OutValue)
+	{
+		const uint8* Start = Cursor;
+		const bool bNegative = Cursor < End && *Cursor == '-';
+		Cursor += bNegative ? 1 : 0;
+
+		uint64 Mantissa = 0;
+		int32 Digits = 0;
+		int32 Exponent = 0;
+		const uint8* IntegerStart = Cursor;
+		ReadDigits(Mantissa, Digits);
+		bool bValid = Cursor > IntegerStart && (*IntegerStart != '0' || Cursor - IntegerStart == 1);
+
+		if (bValid && Cursor < End && *Cursor == '.')
+		{
+			const uint8* FractionStart = ++Cursor;
+			ReadDigits(Mantissa, Digits);
+			bValid = Cursor > FractionStart;
+			Exponent = -(int32)(Cursor - FractionStart);
+		}
+
+		if (bValid && Cursor < End && (*Cursor == 'e' || *Cursor == 'E'))
+		{
+			++Cursor;
+			const bool bNegativeExponent = Cursor < End && *Cursor == '-';
+			if (Cursor < End && (*Cursor == '+' || *Cursor == '-'))
+			{
+				++Cursor;
+			}
+			const uint8* ExponentStart = Cursor;
+			int32 Value = 0;
+			while (Cursor < End && SCIsDigit(*Cursor) && Value < 10000)
+			{
+				Value = Value * 10 + (*Cursor++ - '0');
+			}
+			bValid = Cursor > ExponentStart;
+			Exponent += bNegativeExponent ? -Value : Value;
+		}
+
+		// A number continued by any of these is malformed, the slow path rejects it
+		bValid &= Cursor == End || !(SCIsDigit(*Cursor) || *Cursor == '.' || *Cursor == 'e' || *Cursor == 'E' || *Cursor == '+' || *Cursor == '-');
+		if (!bValid || Digits > 19 || Mantissa > (1ull << 53) || Exponent < -22 || Exponent > 22)
+		{
+			Cursor = Start;
+			return false;
+		}
+
+		double Value = (double)Mantissa;
+		Value = Exponent < 0 ? Value / SCJsonExactPowersOf10[-Exponent] : Value * SCJsonExactPowersOf10[Exponent];
+		OutValue = bNegative ? -Value : Value;
+		return true;
+	}
+
+	bool ReadDouble(double& OutValue)
+	{
+		SkipWhitespace();
+		if (ReadDoubleFast(OutValue))
+		{
+			return true;
+		}
+
+		ANSICHAR Buffer[64];
+		bool bIsInteger;
+		if (!ReadNumberText(Buffer, 64, bIsInteger))
+		{
+			return false;
+		}
+		OutValue = FCStringAnsi::Atod(Buffer);
+		return true;
+	}
+
+	bool SkipValue()
+	{
+		switch (Peek())
+		{
+		case '{':
+		case '[':
+		{
+			uint8 Close = *Cursor == '{' ? '}' : ']';
+			bool bObject = Close == '}';
+			++Cursor;
+			if (++Depth > SCJsonMaxDepth)
+			{
+				return false;
+			}
+			if (!Consume(Close))
+			{
+				do
+				{
+					if (bObject && (!ReadRawString() || !Consume(':')))
+					{
+						return false;
+					}
+					if (!SkipValue())
+					{
+						return false;
+					}
+				} while (Consume(','));
+				if (!Consume(Close))
+				{
+					return false;
+				}
+			}
+			--Depth;
+			return true;
+		}
+		case '"':
+			return ReadRawString();
+		case 't':
+			return ConsumeLiteral("true", 4);
+		case 'f':
+			return ConsumeLiteral("false", 5);
+		case 'n':
+			return ConsumeLiteral("null", 4);
+		default:
+		{
+			double Value;
+			return ReadDouble(Value);
+		}
+		}
+	}
+
+	/** Read any value into the shared pointer DOM */
+	TSharedPtr<FJsonValue> ReadJsonValue()
+	{
+		switch (Peek())
+		{
+		case '{':
+		{
+			++Cursor;
+			if (++Depth > SCJsonMaxDepth)
+			{
+				return nullptr;
+			}
+			TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject);
+			if (!Consume('}'))
+			{
+				do
+				{
+					FString Key;
+					if (!ReadString(Key) || !Consume(':'))
+					{
+						return nullptr;
+					}
+					TSharedPtr<FJsonValue> Value = ReadJsonValue();
+					if (!Value.IsValid())
+					{
+						return nullptr;
+					}
+					Object->SetField(Key, Value);
+				} while (Consume(','));
+				if (!Consume('}'))
+				{
+					return nullptr;
+				}
+			}
+			--Depth;
+			return MakeShareable(new FJsonValueObject(Object));
+		}
+		case '[':
+		{
+			++Cursor;
+			if (++Depth > SCJsonMaxDepth)
+			{
+				return nullptr;
+			}
+			TArray<TSharedPtr<FJsonValue>> Array;
+			if (!Consume(']'))
+			{
+				// Leading numbers are read packed, they only become FJsonValueNumber items if something else follows
+				TArray<double> Numbers;
+				bool bOnlyNumbers = false;
+				while (SCIsNumberStart(Peek()))
+				{
+					double Number;
+					if (!ReadDouble(Number))
+					{
+						return nullptr;
+					}
+					Numbers.Add(Number);
+					if (!Consume(','))
+					{
+						bOnlyNumbers = true;
+						break;
+					}
+				}
+				if (bOnlyNumbers)
+				{
+					if (!Consume(']'))
+					{
+						return nullptr;
+					}
+					--Depth;
+					return SCMakeNumberArray(MoveTemp(Numbers));
+				}
+				SCAppendNumbers(Numbers, Array);
+
+				do
+				{
+					TSharedPtr<FJsonValue> Value = ReadJsonValue();
+					if (!Value.IsValid())
+					{
+						return nullptr;
+					}
+					Array.Add(Value);
+				} while (Consume(','));
+				if (!Consume(']'))
+				{
+					return nullptr;
+				}
+			}
+			--Depth;
+			return MakeShareable(new FJsonValueArray(Array));
+		}
+		case '"':
+		{
+			FString Value;
+			if (!ReadString(Value))
+			{
+				return nullptr;
+			}
+			return MakeShareable(new FJsonValueString(Value));
+		}
+		case 't':
+			return ConsumeLiteral("true", 4) ? MakeShareable(new FJsonValueBoolean(true)) : nullptr;
+		case 'f':
+			return ConsumeLiteral("false", 5) ? MakeShareable(new FJsonValueBoolean(false)) : nullptr;
+		case 'n':
+			return ConsumeLiteral("null", 4) ? MakeShareable(new FJsonValueNull) : nullptr;
+		default:
+		{
+			double Value;
+			if (!ReadDouble(Value))
+			{
+				return nullptr;
+			}
+			return MakeShareable(new FJsonValueNumber(Value));
+		}
+		}
+	}
+};
@@ -3,14 +3,15 @@
 
 #include "SCJsonConvert.h"
 #include "JsonGlobals.h"
-#include "Policies/CondensedJsonPrintPolicy.h"
 #include "Runtime/JsonUtilities/Public/JsonObjectConverter.h"
 #include "Runtime/Core/Public/Misc/FileHelper.h"
 #include "SCJsonValue.h"
 #include "SCJsonObject.h"
-
-typedef TJsonWriterFactory< TCHAR, TCondensedJsonPrintPolicy<TCHAR> > FCondensedJsonStringWriterFactory;
-typedef TJsonWriter< TCHAR, TCondensedJsonPrintPolicy<TCHAR> > FCondensedJsonStringWriter;
+#include "SCStructPlan.h"
+#include "SCJsonStructural.h"
+#include "SCJsonByteReader.h"
+#include "SCJsonNumber.h"
+#include "SCMessageAccounting.h"
 
 //The one key that will break
 #define TMAP_STRING TEXT("!__!INTERNAL_TMAP")
@@ -28,20 +29,28 @@ FString FTrimmedKeyMap::ToString()
 	return FString::Printf(TEXT("{%s:%s}"), *LongKey, *SubMapString);
 }
 
+/** Containers are written as UTF-8 by the struct plan writer, which formats numbers with FSCJsonNumber */
+static FString SCBytesToString(const TArray<uint8>& Bytes)
+{
+	FUTF8ToTCHAR Converted((const ANSICHAR*)Bytes.GetData(), Bytes.Num());
+	SC_ACCOUNT_TRANSCODE(Bytes.Num());
+	return FString(Converted.Length(), Converted.Get());
+}
+
 FString USCJsonConvert::ToJsonString(const TSharedPtr<FJsonObject>& JsonObject)
 {
-	FString OutputString;
-	TSharedRef< FCondensedJsonStringWriter > Writer = FCondensedJsonStringWriterFactory::Create(&OutputString);
-	FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
-	return OutputString;
+	TArray<uint8> Bytes;
+	FSCByteWriter Writer(Bytes);
+	FSCStructPlan::WriteJsonObject(JsonObject, Writer);
+	return SCBytesToString(Bytes);
 }
 
 FString USCJsonConvert::ToJsonString(const TArray<TSharedPtr<FJsonValue>>& JsonValueArray)
 {
-	FString OutputString;
-	TSharedRef< FCondensedJsonStringWriter > Writer = FCondensedJsonStringWriterFactory::Create(&OutputString);
-	FJsonSerializer::Serialize(JsonValueArray, Writer);
-	return OutputString;
+	TArray<uint8> Bytes;
+	FSCByteWriter Writer(Bytes);
+	FSCStructPlan::WriteJsonArray(JsonValueArray, Writer);
+	return SCBytesToString(Bytes);
 }
 
 FString USCJsonConvert::ToJsonString(const TSharedPtr<FJsonValue>& JsonValue)
@@ -60,7 +69,7 @@ FString USCJsonConvert::ToJsonString(const TSharedPtr<FJsonValue>& JsonValue)
 	}
 	else if (JsonValue->Type == EJson::Number)
 	{
-		return FString::Printf(TEXT("%f"),JsonValue->AsNumber());
+		return FSCJsonNumber::ToString(JsonValue->AsNumber());
 	}
 	else if (JsonValue->Type == EJson::Boolean)
 	{
@@ -68,7 +77,10 @@ FString USCJsonConvert::ToJsonString(const TSharedPtr<FJsonValue>& JsonValue)
 	}
 	else if (JsonValue->Type == EJson::Array)
 	{
-		return ToJsonString(JsonValue->AsArray());
+		TArray<uint8> Bytes;
+		FSCByteWriter Writer(Bytes);
+		FSCStructPlan::WriteJsonValue(JsonValue, Writer);
+		return SCBytesToString(Bytes);
 	}
 	else if (JsonValue->Type == EJson::Object)
 	{
@@ -106,6 +118,48 @@ USCJsonObject* USCJsonConvert::ToSCJsonObject(const TSharedPtr<FJsonObject>& Jso
 #pragma endregion ToJsonValue
 #endif
 
+/** Parse an object or array with the structural index parser, nullptr if the input is not valid JSON */
+static TSharedPtr<FJsonValue> SCParseJsonContainer(const uint8* Data, int32 Size)
+{
+	TArray<uint32> Indices;
+	if (!SCBuildJsonStructuralIndex(Data, Size, Indices))
+	{
+		return nullptr;
+	}
+
+	FSCJsonTokenCursor Cursor(Data, Size, Indices);
+	TSharedPtr<FJsonValue> Value = Cursor.ReadJsonValue();
+	return Value.IsValid() && Cursor.AtEnd() ? Value : nullptr;
+}
+
+/** FCString::IsNumeric over UTF-8 */
+static bool SCIsNumeric(const uint8* Data, int32 Size)
+{
+	int32 i = 0;
+	if (Size > 0 && (Data[0] == '-' || Data[0] == '+'))
+	{
+		i++;
+	}
+
+	bool bHasDot = false;
+	for (; i < Size; i++)
+	{
+		if (Data[i] == '.')
+		{
+			if (bHasDot)
+			{
+				return false;
+			}
+			bHasDot = true;
+		}
+		else if (Data[i] < '0' || Data[i] > '9')
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 TSharedPtr<FJsonValue> USCJsonConvert::JsonStringToJsonValue(const FString& JsonString)
 {
 	//Null
@@ -114,48 +168,84 @@ TSharedPtr<FJsonValue> USCJsonConvert::JsonStringToJsonValue(const FString& Json
 		return MakeShareable(new FJsonValueNull);
 	}
 
+	//Object or Array, checked first so only other strings pay for the numeric scan
+	const TCHAR First = JsonString[0];
+	if (First == '{' || First == '[')
+	{
+		FTCHARToUTF8 Utf8(*JsonString, JsonString.Len());
+		SC_ACCOUNT_TRANSCODE(Utf8.Length());
+		TSharedPtr<FJsonValue> Value = SCParseJsonContainer((const uint8*)Utf8.Get(), Utf8.Length());
+		if (Value.IsValid())
+		{
+			return Value;
+		}
+	}
 	//Number
-	if (JsonString.IsNumeric())
+	else if (JsonString.IsNumeric())
 	{
 		//convert to double
 		return MakeShareable(new FJsonValueNumber(FCString::Atod(*JsonString)));
 	}
 
-	//Object
-	if (JsonString.StartsWith(FString(TEXT("{"))))
+	//Bool
+	if (JsonString == FString("true") || JsonString == FString("false"))
 	{
-		TSharedPtr< FJsonObject > JsonObject = MakeShareable(new FJsonObject);
-		TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(*JsonString);
-		bool success = FJsonSerializer::Deserialize(Reader, JsonObject);
+		bool BooleanValue = (JsonString == FString("true"));
+		return MakeShareable(new FJsonValueBoolean(BooleanValue));
+	}
+	
+	//String
+	return MakeShareable(new FJsonValueString(JsonString));
+}
+
+TSharedPtr<FJsonValue> USCJsonConvert::JsonBytesToJsonValue(TArrayView<const uint8> Bytes)
+{
+	const uint8* Data = Bytes.GetData();
+	const int32 Size = Bytes.Num();
+
+	//Null
+	if (Size == 0)
+	{
+		return MakeShareable(new FJsonValueNull);
+	}
 
-		if (success)
+	//Object or Array
+	if (Data[0] == '{' || Data[0] == '[')
+	{
+		TSharedPtr<FJsonValue> Value = SCParseJsonContainer(Data, Size);
+		if (Value.IsValid())
 		{
-			return MakeShareable(new FJsonValueObject(JsonObject));
+			return Value;
 		}
 	}
-
-	//Array
-	if (JsonString.StartsWith(FString(TEXT("["))))
+	//Number
+	else if (SCIsNumeric(Data, Size))
 	{
-		TArray < TSharedPtr<FJsonValue>> RawJsonValueArray;
-		TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(*JsonString);
-		bool success = FJsonSerializer::Deserialize(Reader, RawJsonValueArray);
-
-		if (success) 
+		ANSICHAR Buffer[64];
+		if (Size < 64)
 		{
-			return MakeShareable(new FJsonValueArray(RawJsonValueArray));
+			FMemory::Memcpy(Buffer, Data, Size);
+			Buffer[Size] = 0;
+			return MakeShareable(new FJsonValueNumber(FCStringAnsi::Atod(Buffer)));
 		}
+		FString Number(Size, (const ANSICHAR*)Data);
+		return MakeShareable(new FJsonValueNumber(FCString::Atod(*Number)));
 	}
 
 	//Bool
-	if (JsonString == FString("true") || JsonString == FString("false"))
+	if (Size == 4 && FMemory::Memcmp(Data, "true", 4) == 0)
 	{
-		bool BooleanValue = (JsonString == FString("true"));
-		return MakeShareable(new FJsonValueBoolean(BooleanValue));
+		return MakeShareable(new FJsonValueBoolean(true));
 	}
-	
+	if (Size == 5 && FMemory::Memcmp(Data, "false", 5) == 0)
+	{
+		return MakeShareable(new FJsonValueBoolean(false));
+	}
+
 	//String
-	return MakeShareable(new FJsonValueString(JsonString));
+	FUTF8ToTCHAR Converted((const ANSICHAR*)Data, Size);
+	SC_ACCOUNT_TRANSCODE(Size);
+	return MakeShareable(new FJsonValueString(FString(Converted.Length(), Converted.Get())));
 }
 
 TSharedPtr<FJsonValue> USCJsonConvert::ToJsonValue(const TSharedPtr<FJsonObject>& JsonObject)
@@ -188,6 +278,11 @@ TSharedPtr<FJsonValue> USCJsonConvert::ToJsonValue(const TArray<TSharedPtr<FJson
 	return MakeShareable(new FJsonValueArray(ArrayValue));
 }
 
+TSharedPtr<FJsonValue> USCJsonConvert::ToJsonValue(const FSCJsonNode& Node)
+{
+	return Node.ToJsonValue();
+}
+
 #if PLATFORM_WINDOWS
 #pragma endregion ToJsonValue
 #endif
@@ -213,15 +308,8 @@ TSharedPtr<FJsonObject> USCJsonConvert::ToJsonObject(UStruct* Struct, void* Stru
 {	
 	if (IsBlueprintStruct)
 	{
-		//Get the object keys
-		TSharedPtr<FJsonObject> Object = ToJsonObject(Struct, StructPtr, false);
-
-		//Wrap it into a value and pass it into the trimmer
-		TSharedPtr<FJsonValue> JsonValue = MakeShareable(new FJsonValueObject(Object));
-		TrimValueKeyNames(JsonValue);
-
-		//Return object with trimmed names
-		return JsonValue->AsObject();
+		//The plan has the trimmed names of every property, so nothing is renamed afterwards
+		return FSCStructPlan::Get(Struct, true)->ToJsonObject(StructPtr);
 	}
 	else
 	{
@@ -241,25 +329,56 @@ bool USCJsonConvert::JsonObjectToUStruct(TSharedPtr<FJsonObject> JsonObject, USt
 	if (IsBlueprintStruct)
 	{
 		//Json object we pass will have their trimmed BP names, e.g. boolKey vs boolKey_8_EDBB36654CF43866C376DE921373AF23
-		//so we have to match them to the verbose versions, get a map of the names
+		//the cached plan matches both the trimmed and the verbose names
+		return FSCStructPlan::Get(Struct, true)->FromJsonObject(JsonObject, StructPtr);
+	}
+	else
+	{
+		return FJsonObjectConverter::JsonObjectToUStruct(JsonObject.ToSharedRef(), Struct, StructPtr, 0, 0);
+	}
+}
 
-		TSharedPtr<FTrimmedKeyMap> KeyMap = MakeShareable(new FTrimmedKeyMap);
-		SetTrimmedKeyMapForStruct(KeyMap, Struct);
+void USCJsonConvert::UStructToJsonBytes(UStruct* Struct, const void* StructPtr, TArray<uint8>& OutBytes, bool IsBlueprintStruct)
+{
+	FSCByteWriter Writer(OutBytes);
+	FSCStructPlan::Get(Struct, IsBlueprintStruct)->Write(StructPtr, Writer);
+}
 
-		//Print our keymap for debug
-		//UE_LOG(LogTemp, Log, TEXT("Keymap: %s"), *KeyMap->ToString());
+bool USCJsonConvert::JsonBytesToUStruct(TArrayView<const uint8> Bytes, UStruct* Struct, void* StructPtr, bool IsBlueprintStruct)
+{
+	return FSCStructPlan::Get(Struct, IsBlueprintStruct)->Read(Bytes, StructPtr);
+}
 
-		//Adjust our passed in JsonObject to use the long key names
-		TSharedPtr<FJsonValue> JsonValue = MakeShareable(new FJsonValueObject(JsonObject));
-		ReplaceJsonValueNamesWithMap(JsonValue, KeyMap);
+bool USCJsonConvert::JsonBytesToDocument(TArrayView<const uint8> Bytes, FSCJsonDocument& OutDocument)
+{
+	return OutDocument.Parse(Bytes);
+}
 
-		//Now it's a regular struct and will fill correctly
-		return JsonObjectToUStruct(JsonObject, Struct, StructPtr, false);
-	}
-	else
+bool USCJsonConvert::JsonBytesFindStringField(TArrayView<const uint8> Bytes, const ANSICHAR* Key, FString& OutValue)
+{
+	FSCJsonByteReader Reader(Bytes.GetData(), Bytes.Num());
+	if (!Reader.Consume('{') || Reader.Consume('}'))
 	{
-		return FJsonObjectConverter::JsonObjectToUStruct(JsonObject.ToSharedRef(), Struct, StructPtr, 0, 0);
+		return false;
 	}
+
+	const int32 KeyLength = FCStringAnsi::Strlen(Key);
+	do
+	{
+		if (!Reader.ReadRawString() || !Reader.Consume(':'))
+		{
+			return false;
+		}
+		if (Reader.Scratch.Num() == KeyLength && FCStringAnsi::Strnicmp(Reader.Scratch.GetData(), Key, KeyLength) == 0)
+		{
+			return Reader.Peek() == '"' && Reader.ReadString(OutValue);
+		}
+		if (!Reader.SkipValue())
+		{
+			return false;
+		}
+	} while (Reader.Consume(','));
+	return false;
 }
 
 bool USCJsonConvert::JsonFileToUStruct(const FString& FilePath, UStruct* Struct, void* StructPtr, bool IsBlueprintStruct /*= false*/)
@@ -271,28 +390,24 @@ bool USCJsonConvert::JsonFileToUStruct(const FString& FilePath, UStruct* Struct,
 		return false;
 	}
 
-	//Convert to json string
-	FString JsonString;
-	FFileHelper::BufferToString(JsonString, OutBytes.GetData(), OutBytes.Num());
+	//UTF-16 files still go through a json string
+	if (OutBytes.Num() >= 2 && ((OutBytes[0] == 0xff && OutBytes[1] == 0xfe) || (OutBytes[0] == 0xfe && OutBytes[1] == 0xff)))
+	{
+		FString JsonString;
+		FFileHelper::BufferToString(JsonString, OutBytes.GetData(), OutBytes.Num());
+		return JsonObjectToUStruct(ToJsonObject(JsonString), Struct, StructPtr, IsBlueprintStruct);
+	}
 
 	//Read into struct
-	return JsonObjectToUStruct(ToJsonObject(JsonString), Struct, StructPtr, IsBlueprintStruct);
+	return JsonBytesToUStruct(OutBytes, Struct, StructPtr, IsBlueprintStruct);
 }
 	
 
 bool USCJsonConvert::ToJsonFile(const FString& FilePath, UStruct* Struct, void* StructPtr, bool IsBlueprintStruct /*= false*/)
 {
-	//Get json object with trimmed values
-	TSharedPtr<FJsonObject> JsonObject = ToJsonObject(Struct, StructPtr, IsBlueprintStruct);
-	TSharedPtr<FJsonValue> TrimmedValue = MakeShareable(new FJsonValueObject(JsonObject));
-	TrimValueKeyNames(TrimmedValue);
-
-	//Convert to string
-	FString JsonString = ToJsonString(TrimmedValue);
-	FTCHARToUTF8 Utf8String(*JsonString);
-
+	//Get json with trimmed names
 	TArray<uint8> Bytes;
-	Bytes.Append((uint8*)Utf8String.Get(), Utf8String.Length());
+	UStructToJsonBytes(Struct, StructPtr, Bytes, true);
 
 	//flush to disk
 	return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
@@ -0,0 +1,377 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCJsonNumber.h"
+
+/** Normalized significands of 10^-348, 10^-340, ... 10^340, rounded to nearest */
+static const uint64 SCCachedPowersF[] =
+{
+	0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+	0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+	0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+	0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+	0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+	0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+	0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+	0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+	0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+	0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+	0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+	0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+	0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+	0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+	0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+	0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+	0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+	0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+	0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+	0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+	0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+	0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+/** Binary exponents of the cached powers */
+static const int16 SCCachedPowersE[] =
+{
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066
+};
+
+static const uint64 SCPow10[] =
+{
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+	10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL,
+	10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static FORCEINLINE int32 SCLeadingZeros64(uint64 Value)
+{
+	const uint32 High = (uint32)(Value >> 32);
+	return High != 0 ? FMath::CountLeadingZeros(High) : 32 + FMath::CountLeadingZeros((uint32)Value);
+}
+
+/** A floating point number with a 64 bit significand, F * 2^E */
+struct FSCDiyFp
+{
+	static const int32 SignificandSize = 52;
+
+	static const int32 ExponentBias = 0x3ff + SignificandSize;
+
+	static const int32 MinExponent = -ExponentBias;
+
+	static const uint64 HiddenBit = 1ULL << SignificandSize;
+
+	static const uint64 SignificandMask = HiddenBit - 1;
+
+	static const uint64 ExponentMask = 0x7ff0000000000000ULL;
+
+	uint64 F;
+
+	int32 E;
+
+	FSCDiyFp(uint64 InF, int32 InE)
+		: F(InF)
+		, E(InE)
+	{
+	}
+
+	explicit FSCDiyFp(double Value)
+	{
+		uint64 Bits;
+		FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+		const int32 BiasedExponent = (int32)((Bits & ExponentMask) >> SignificandSize);
+		const uint64 Significand = Bits & SignificandMask;
+		if (BiasedExponent != 0)
+		{
+			F = Significand + HiddenBit;
+			E = BiasedExponent - ExponentBias;
+		}
+		else
+		{
+			//Denormal
+			F = Significand;
+			E = MinExponent + 1;
+		}
+	}
+
+	FSCDiyFp operator-(const FSCDiyFp& Other) const
+	{
+		return FSCDiyFp(F - Other.F, E);
+	}
+
+	/** The upper 64 bits of the 128 bit product, rounded */
+	FSCDiyFp operator*(const FSCDiyFp& Other) const
+	{
+		const uint64 M32 = 0xffffffffULL;
+		const uint64 A = F >> 32;
+		const uint64 B = F & M32;
+		const uint64 C = Other.F >> 32;
+		const uint64 D = Other.F & M32;
+		const uint64 AC = A * C;
+		const uint64 BC = B * C;
+		const uint64 AD = A * D;
+		const uint64 BD = B * D;
+		uint64 Tmp = (BD >> 32) + (AD & M32) + (BC & M32);
+		Tmp += 1ULL << 31;
+		return FSCDiyFp(AC + (AD >> 32) + (BC >> 32) + (Tmp >> 32), E + Other.E + 64);
+	}
+
+	FSCDiyFp Normalize() const
+	{
+		const int32 Shift = SCLeadingZeros64(F);
+		return FSCDiyFp(F << Shift, E - Shift);
+	}
+
+	/** The boundaries halfway to the neighbouring doubles, normalized to the same exponent */
+	void NormalizedBoundaries(FSCDiyFp& OutMinus, FSCDiyFp& OutPlus) const
+	{
+		FSCDiyFp Plus((F << 1) + 1, E - 1);
+		const int32 Shift = SCLeadingZeros64(Plus.F);
+		Plus.F <<= Shift;
+		Plus.E -= Shift;
+
+		//The lower neighbour is closer when F is a power of two
+		FSCDiyFp Minus = F == HiddenBit ? FSCDiyFp((F << 2) - 1, E - 2) : FSCDiyFp((F << 1) - 1, E - 1);
+		Minus.F <<= Minus.E - Plus.E;
+		Minus.E = Plus.E;
+
+		OutMinus = Minus;
+		OutPlus = Plus;
+	}
+};
+
+/** The cached power c = 10^-K which brings the product with a number of binary exponent E into [-60, -32] */
+static FORCEINLINE FSCDiyFp SCGetCachedPower(int32 E, int32& OutK)
+{
+	const double Dk = (-61 - E) * 0.30102999566398114 + 347;
+	int32 K = (int32)Dk;
+	if (Dk - K > 0.0)
+	{
+		K++;
+	}
+
+	const uint32 Index = (uint32)((K >> 3) + 1);
+	OutK = -(-348 + (int32)(Index << 3));
+	return FSCDiyFp(SCCachedPowersF[Index], SCCachedPowersE[Index]);
+}
+
+/** Step the last digit down while that moves closer to the exact value and stays inside the rounding interval */
+static FORCEINLINE void SCGrisuRound(ANSICHAR* Buffer, int32 Length, uint64 Delta, uint64 Rest, uint64 TenKappa, uint64 Distance)
+{
+	while (Rest < Distance && Delta - Rest >= TenKappa && (Rest + TenKappa < Distance || Distance - Rest > Rest + TenKappa - Distance))
+	{
+		Buffer[Length - 1]--;
+		Rest += TenKappa;
+	}
+}
+
+static FORCEINLINE int32 SCCountDecimalDigits32(uint32 Value)
+{
+	int32 Digits = 1;
+	while (Digits < 9 && Value >= SCPow10[Digits])
+	{
+		Digits++;
+	}
+	return Digits;
+}
+
+static void SCDigitGen(const FSCDiyFp& W, const FSCDiyFp& Mp, uint64 Delta, ANSICHAR* Buffer, int32& OutLength, int32& InOutK)
+{
+	const FSCDiyFp One(1ULL << -Mp.E, Mp.E);
+	const FSCDiyFp Distance = Mp - W;
+	uint32 P1 = (uint32)(Mp.F >> -One.E);
+	uint64 P2 = Mp.F & (One.F - 1);
+	int32 Kappa = SCCountDecimalDigits32(P1);
+	OutLength = 0;
+
+	//Integral part
+	while (Kappa > 0)
+	{
+		const uint32 Divisor = (uint32)SCPow10[Kappa - 1];
+		const uint32 Digit = P1 / Divisor;
+		P1 %= Divisor;
+		if (Digit != 0 || OutLength != 0)
+		{
+			Buffer[OutLength++] = (ANSICHAR)('0' + Digit);
+		}
+		Kappa--;
+
+		const uint64 Rest = ((uint64)P1 << -One.E) + P2;
+		if (Rest <= Delta)
+		{
+			InOutK += Kappa;
+			SCGrisuRound(Buffer, OutLength, Delta, Rest, SCPow10[Kappa] << -One.E, Distance.F);
+			return;
+		}
+	}
+
+	//Fractional part
+	for (;;)
+	{
+		P2 *= 10;
+		Delta *= 10;
+		const ANSICHAR Digit = (ANSICHAR)(P2 >> -One.E);
+		if (Digit != 0 || OutLength != 0)
+		{
+			Buffer[OutLength++] = (ANSICHAR)('0' + Digit);
+		}
+		P2 &= One.F - 1;
+		Kappa--;
+		if (P2 < Delta)
+		{
+			InOutK += Kappa;
+			const int32 Index = -Kappa;
+			SCGrisuRound(Buffer, OutLength, Delta, P2, One.F, Distance.F * (Index < 20 ? SCPow10[Index] : 0));
+			return;
+		}
+	}
+}
+
+/** Shortest digits of a positive finite Value, Value = Digits * 10^OutK */
+static void SCGrisu2(double Value, ANSICHAR* Buffer, int32& OutLength, int32& OutK)
+{
+	const FSCDiyFp V(Value);
+	FSCDiyFp Minus(0, 0);
+	FSCDiyFp Plus(0, 0);
+	V.NormalizedBoundaries(Minus, Plus);
+
+	const FSCDiyFp CachedPower = SCGetCachedPower(Plus.E, OutK);
+	const FSCDiyFp W = V.Normalize() * CachedPower;
+	FSCDiyFp Wp = Plus * CachedPower;
+	FSCDiyFp Wm = Minus * CachedPower;
+	Wm.F++;
+	Wp.F--;
+	SCDigitGen(W, Wp, Wp.F - Wm.F, Buffer, OutLength, OutK);
+}
+
+static int32 SCWriteExponent(int32 Exponent, ANSICHAR* Buffer)
+{
+	int32 Length = 0;
+	Buffer[Length++] = Exponent < 0 ? '-' : '+';
+	if (Exponent < 0)
+	{
+		Exponent = -Exponent;
+	}
+	if (Exponent >= 100)
+	{
+		Buffer[Length++] = (ANSICHAR)('0' + Exponent / 100);
+		Exponent %= 100;
+		Buffer[Length++] = (ANSICHAR)('0' + Exponent / 10);
+	}
+	else if (Exponent >= 10)
+	{
+		Buffer[Length++] = (ANSICHAR)('0' + Exponent / 10);
+	}
+	Buffer[Length++] = (ANSICHAR)('0' + Exponent % 10);
+	return Length;
+}
+
+/** Lay out Length digits times 10^K with the same rules as JavaScript */
+static int32 SCPrettify(ANSICHAR* Buffer, int32 Length, int32 K)
+{
+	//The position of the decimal point counted from the first digit
+	const int32 Point = Length + K;
+
+	if (Length <= Point && Point <= 21)
+	{
+		//1234e7 -> 12340000000
+		for (int32 i = Length; i < Point; i++)
+		{
+			Buffer[i] = '0';
+		}
+		return Point;
+	}
+	else if (0 < Point && Point <= 21)
+	{
+		//1234e-2 -> 12.34
+		FMemory::Memmove(&Buffer[Point + 1], &Buffer[Point], Length - Point);
+		Buffer[Point] = '.';
+		return Length + 1;
+	}
+	else if (-6 < Point && Point <= 0)
+	{
+		//1234e-6 -> 0.001234
+		const int32 Offset = 2 - Point;
+		FMemory::Memmove(&Buffer[Offset], &Buffer[0], Length);
+		Buffer[0] = '0';
+		Buffer[1] = '.';
+		for (int32 i = 2; i < Offset; i++)
+		{
+			Buffer[i] = '0';
+		}
+		return Length + Offset;
+	}
+
+	//1e30 -> 1e+30, 1234e30 -> 1.234e+33
+	int32 End = 1;
+	if (Length > 1)
+	{
+		FMemory::Memmove(&Buffer[2], &Buffer[1], Length - 1);
+		Buffer[1] = '.';
+		End = Length + 1;
+	}
+	Buffer[End++] = 'e';
+	return End + SCWriteExponent(Point - 1, &Buffer[End]);
+}
+
+static int32 SCWriteInteger(int64 Value, ANSICHAR* Buffer)
+{
+	ANSICHAR Digits[20];
+	int32 Count = 0;
+	uint64 Magnitude = Value < 0 ? (uint64)(-Value) : (uint64)Value;
+	do
+	{
+		Digits[Count++] = (ANSICHAR)('0' + Magnitude % 10);
+		Magnitude /= 10;
+	} while (Magnitude != 0);
+
+	int32 Length = 0;
+	if (Value < 0)
+	{
+		Buffer[Length++] = '-';
+	}
+	while (Count > 0)
+	{
+		Buffer[Length++] = Digits[--Count];
+	}
+	return Length;
+}
+
+int32 FSCJsonNumber::Format(double Value, ANSICHAR* Buffer)
+{
+	if (!FMath::IsFinite(Value))
+	{
+		FMemory::Memcpy(Buffer, "null", 4);
+		return 4;
+	}
+
+	//Integers below 2^53 are exact and printed in full, this also writes -0 as 0 like JavaScript
+	if (Value == FMath::FloorToDouble(Value) && FMath::Abs(Value) < 9007199254740992.0)
+	{
+		return SCWriteInteger((int64)Value, Buffer);
+	}
+
+	int32 Sign = 0;
+	if (Value < 0)
+	{
+		Buffer[Sign++] = '-';
+		Value = -Value;
+	}
+
+	int32 Length;
+	int32 K;
+	SCGrisu2(Value, Buffer + Sign, Length, K);
+	return Sign + SCPrettify(Buffer + Sign, Length, K);
+}
+
+FString FSCJsonNumber::ToString(double Value)
+{
+	ANSICHAR Buffer[MaxLength];
+	const int32 Length = Format(Value, Buffer);
+	return FString(Length, Buffer);
+}
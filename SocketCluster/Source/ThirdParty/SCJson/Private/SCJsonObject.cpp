@@ -8,6 +8,7 @@
 #include "Runtime/Json/Public/Serialization/JsonSerializer.h"
 #include "SCJsonValue.h"
 #include "SCJsonModule.h"
+#include "SCJsonWrapperCache.h"
 
 typedef TJsonWriterFactory< TCHAR, TCondensedJsonPrintPolicy<TCHAR> > FCondensedJsonStringWriterFactory;
 typedef TJsonWriter< TCHAR, TCondensedJsonPrintPolicy<TCHAR> > FCondensedJsonStringWriter;
@@ -31,6 +32,7 @@ void USCJsonObject::Reset()
 	}
 
 	JsonObj = MakeShareable(new FJsonObject());
+	WrapperCache = nullptr;
 }
 
 TSharedPtr<FJsonObject>& USCJsonObject::GetRootObject()
@@ -41,6 +43,23 @@ TSharedPtr<FJsonObject>& USCJsonObject::GetRootObject()
 void USCJsonObject::SetRootObject(const TSharedPtr<FJsonObject>& JsonObject)
 {
 	JsonObj = JsonObject;
+
+	// Wrappers of the previous object belong to whoever holds them now
+	WrapperCache = nullptr;
+}
+
+void USCJsonObject::SetWrapperCache(USCJsonWrapperCache* Cache)
+{
+	WrapperCache = Cache;
+}
+
+USCJsonWrapperCache* USCJsonObject::GetWrapperCache() const
+{
+	if (WrapperCache == nullptr)
+	{
+		const_cast<USCJsonObject*>(this)->WrapperCache = NewObject<USCJsonWrapperCache>();
+	}
+	return WrapperCache;
 }
 
 
@@ -77,6 +96,7 @@ FString USCJsonObject::EncodeJsonToSingleString() const
 bool USCJsonObject::DecodeJson(const FString& JsonString)
 {
 	TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(*JsonString);
+	WrapperCache = nullptr;
 	if (FJsonSerializer::Deserialize(Reader, JsonObj) && JsonObj.IsValid())
 	{
 		return true;
@@ -135,16 +155,7 @@ USCJsonValue* USCJsonObject::GetField(const FString& FieldName) const
 		return nullptr;
 	}
 
-	TSharedPtr<FJsonValue> NewVal = JsonObj->TryGetField(FieldName);
-	if (NewVal.IsValid())
-	{
-		USCJsonValue* NewValue = NewObject<USCJsonValue>();
-		NewValue->SetRootValue(NewVal);
-
-		return NewValue;
-	}
-	
-	return nullptr;
+	return GetWrapperCache()->FindOrAddValue(JsonObj->TryGetField(FieldName));
 }
 
 void USCJsonObject::SetField(const FString& FieldName, USCJsonValue* JsonValue)
@@ -245,24 +256,20 @@ void USCJsonObject::SetBoolField(const FString& FieldName, bool InValue)
 
 TArray<USCJsonValue*> USCJsonObject::GetArrayField(const FString& FieldName)
 {
-	if (!JsonObj->HasTypedField<EJson::Array>(FieldName))
-	{
-		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
-	}
-
 	TArray<USCJsonValue*> OutArray;
-	if (!JsonObj.IsValid() || FieldName.IsEmpty())
+	TSharedPtr<FJsonValue> ArrayValue = FindArrayField(FieldName);
+	if (!ArrayValue.IsValid())
 	{
+		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
 		return OutArray;
 	}
 
-	TArray< TSharedPtr<FJsonValue> > ValArray = JsonObj->GetArrayField(FieldName);
-	for (auto Value : ValArray)
+	const TArray< TSharedPtr<FJsonValue> >& ValArray = ArrayValue->AsArray();
+	USCJsonWrapperCache* Cache = GetWrapperCache();
+	OutArray.Reserve(ValArray.Num());
+	for (const auto& Value : ValArray)
 	{
-		USCJsonValue* NewValue = NewObject<USCJsonValue>();
-		NewValue->SetRootValue(Value);
-
-		OutArray.Add(NewValue);
+		OutArray.Add(Cache->FindOrAddValue(Value));
 	}
 
 	return OutArray;
@@ -342,12 +349,7 @@ USCJsonObject* USCJsonObject::GetObjectField(const FString& FieldName) const
 		return nullptr;
 	}
 
-	TSharedPtr<FJsonObject> JsonObjField = JsonObj->GetObjectField(FieldName);
-
-	USCJsonObject* OutRestJsonObj = NewObject<USCJsonObject>();
-	OutRestJsonObj->SetRootObject(JsonObjField);
-
-	return OutRestJsonObj;
+	return GetWrapperCache()->FindOrAddObject(JsonObj->GetObjectField(FieldName));
 }
 
 void USCJsonObject::SetObjectField(const FString& FieldName, USCJsonObject* JsonObject)
@@ -369,15 +371,13 @@ TArray<uint8> USCJsonObject::GetBinaryField(const FString& FieldName) const
 	}
 	TSharedPtr<FJsonValue> JsonValue = JsonObj->TryGetField(FieldName);
 
-	if (FJsonValueBinary::IsBinary(JsonValue))
+	//Binary values are written as base64, so strings are read as base64 too
+	TArray<uint8> ByteArray;
+	if (!FJsonValueBinary::TryGetBinary(JsonValue, ByteArray, true))
 	{
-		return FJsonValueBinary::AsBinary(JsonValue);
-	}
-	else
-	{
-		TArray<uint8> EmptyArray;
-		return EmptyArray;
+		ByteArray.Empty();
 	}
+	return ByteArray;
 }
 
 void USCJsonObject::SetBinaryField(const FString& FieldName, const TArray<uint8>& Bytes)
@@ -395,27 +395,14 @@ void USCJsonObject::SetBinaryField(const FString& FieldName, const TArray<uint8>
 
 TArray<float> USCJsonObject::GetNumberArrayField(const FString& FieldName)
 {
-	if (!JsonObj->HasTypedField<EJson::Array>(FieldName))
-	{
-		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
-	}
-
 	TArray<float> NumberArray;
-	if (!JsonObj.IsValid() || FieldName.IsEmpty())
+	if (!FindArrayField(FieldName).IsValid())
 	{
-		return NumberArray;
+		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
 	}
-
-	TArray<TSharedPtr<FJsonValue> > JsonArrayValues = JsonObj->GetArrayField(FieldName);
-	for (TArray<TSharedPtr<FJsonValue> >::TConstIterator It(JsonArrayValues); It; ++It)
+	else if (!CopyNumberArrayField(FieldName, NumberArray))
 	{
-		auto Value = (*It).Get();
-		if (Value->Type != EJson::Number)
-		{
-			UE_LOG(LogSCJson, Error, TEXT("Not Number element in array with field name %s"), *FieldName);
-		}
-		
-		NumberArray.Add((*It)->AsNumber());
+		UE_LOG(LogSCJson, Error, TEXT("Not Number element in array with field name %s"), *FieldName);
 	}
 
 	return NumberArray;
@@ -428,39 +415,29 @@ void USCJsonObject::SetNumberArrayField(const FString& FieldName, const TArray<f
 		return;
 	}
 
-	TArray< TSharedPtr<FJsonValue> > EntriesArray;
+	JsonObj->SetField(FieldName, MakeShareable(new FJsonValueNumberArray(NumberArray)));
+}
 
-	for (auto Number : NumberArray)
+void USCJsonObject::SetDoubleArrayField(const FString& FieldName, const TArray<double>& NumberArray)
+{
+	if (!JsonObj.IsValid() || FieldName.IsEmpty())
 	{
-		EntriesArray.Add(MakeShareable(new FJsonValueNumber(Number)));
+		return;
 	}
 
-	JsonObj->SetArrayField(FieldName, EntriesArray);
+	JsonObj->SetField(FieldName, MakeShareable(new FJsonValueNumberArray(NumberArray)));
 }
 
 TArray<FString> USCJsonObject::GetStringArrayField(const FString& FieldName)
 {
-	if (!JsonObj->HasTypedField<EJson::Array>(FieldName))
+	TArray<FString> StringArray;
+	if (!FindArrayField(FieldName).IsValid())
 	{
 		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
 	}
-
-	TArray<FString> StringArray;
-	if (!JsonObj.IsValid() || FieldName.IsEmpty())
+	else if (!CopyStringArrayField(FieldName, StringArray))
 	{
-		return StringArray;
-	}
-
-	TArray<TSharedPtr<FJsonValue> > JsonArrayValues = JsonObj->GetArrayField(FieldName);
-	for (TArray<TSharedPtr<FJsonValue> >::TConstIterator It(JsonArrayValues); It; ++It)
-	{
-		auto Value = (*It).Get();
-		if (Value->Type != EJson::String)
-		{
-			UE_LOG(LogSCJson, Error, TEXT("Not String element in array with field name %s"), *FieldName);
-		}
-
-		StringArray.Add((*It)->AsString());
+		UE_LOG(LogSCJson, Error, TEXT("Not String element in array with field name %s"), *FieldName);
 	}
 
 	return StringArray;
@@ -484,27 +461,14 @@ void USCJsonObject::SetStringArrayField(const FString& FieldName, const TArray<F
 
 TArray<bool> USCJsonObject::GetBoolArrayField(const FString& FieldName)
 {
-	if (!JsonObj->HasTypedField<EJson::Array>(FieldName))
-	{
-		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
-	}
-
 	TArray<bool> BoolArray;
-	if (!JsonObj.IsValid() || FieldName.IsEmpty())
+	if (!FindArrayField(FieldName).IsValid())
 	{
-		return BoolArray;
+		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
 	}
-
-	TArray<TSharedPtr<FJsonValue> > JsonArrayValues = JsonObj->GetArrayField(FieldName);
-	for (TArray<TSharedPtr<FJsonValue> >::TConstIterator It(JsonArrayValues); It; ++It)
+	else if (!CopyBoolArrayField(FieldName, BoolArray))
 	{
-		auto Value = (*It).Get();
-		if (Value->Type != EJson::Boolean)
-		{
-			UE_LOG(LogSCJson, Error, TEXT("Not Boolean element in array with field name %s"), *FieldName);
-		}
-
-		BoolArray.Add((*It)->AsBool());
+		UE_LOG(LogSCJson, Error, TEXT("Not Boolean element in array with field name %s"), *FieldName);
 	}
 
 	return BoolArray;
@@ -528,31 +492,27 @@ void USCJsonObject::SetBoolArrayField(const FString& FieldName, const TArray<boo
 
 TArray<USCJsonObject*> USCJsonObject::GetObjectArrayField(const FString& FieldName)
 {
-	if (!JsonObj->HasTypedField<EJson::Array>(FieldName))
-	{
-		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
-	}
-
 	TArray<USCJsonObject*> OutArray;
-	if (!JsonObj.IsValid() || FieldName.IsEmpty())
+	TSharedPtr<FJsonValue> ArrayValue = FindArrayField(FieldName);
+	if (!ArrayValue.IsValid())
 	{
+		UE_LOG(LogSCJson, Warning, TEXT("No field with name %s of type Array"), *FieldName);
 		return OutArray;
 	}
 
-	TArray< TSharedPtr<FJsonValue> > ValArray = JsonObj->GetArrayField(FieldName);
-	for (auto Value : ValArray)
+	const TArray< TSharedPtr<FJsonValue> >& ValArray = ArrayValue->AsArray();
+	USCJsonWrapperCache* Cache = GetWrapperCache();
+	OutArray.Reserve(ValArray.Num());
+	for (const auto& Value : ValArray)
 	{
 		if (Value->Type != EJson::Object)
 		{
 			UE_LOG(LogSCJson, Error, TEXT("Not Object element in array with field name %s"), *FieldName);
+			OutArray.Add(nullptr);
+			continue;
 		}
 
-		TSharedPtr<FJsonObject> NewObj = Value->AsObject();
-
-		USCJsonObject* NewJson = NewObject<USCJsonObject>();
-		NewJson->SetRootObject(NewObj);
-
-		OutArray.Add(NewJson);
+		OutArray.Add(Cache->FindOrAddObject(Value->AsObject()));
 	}
 
 	return OutArray;
@@ -573,3 +533,48 @@ void USCJsonObject::SetObjectArrayField(const FString& FieldName, const TArray<U
 
 	JsonObj->SetArrayField(FieldName, EntriesArray);
 }
+
+
+//////////////////////////////////////////////////////////////////////////
+// Array fields without wrapping every item
+
+TSharedPtr<FJsonValue> USCJsonObject::FindArrayField(const FString& FieldName) const
+{
+	if (!JsonObj.IsValid() || FieldName.IsEmpty())
+	{
+		return nullptr;
+	}
+	TSharedPtr<FJsonValue> Field = JsonObj->TryGetField(FieldName);
+	return Field.IsValid() && Field->Type == EJson::Array ? Field : TSharedPtr<FJsonValue>();
+}
+
+int32 USCJsonObject::GetArrayFieldLength(const FString& FieldName) const
+{
+	TSharedPtr<FJsonValue> Field = FindArrayField(FieldName);
+	if (!Field.IsValid())
+	{
+		return 0;
+	}
+	const TArray<double>* Numbers = FJsonValueNumberArray::AsNumberArray(Field);
+	return Numbers != nullptr ? Numbers->Num() : Field->AsArray().Num();
+}
+
+bool USCJsonObject::CopyNumberArrayField(const FString& FieldName, TArray<float>& OutNumbers) const
+{
+	return USCJsonValue::CopyNumbers(FindArrayField(FieldName), OutNumbers);
+}
+
+bool USCJsonObject::CopyDoubleArrayField(const FString& FieldName, TArray<double>& OutNumbers) const
+{
+	return USCJsonValue::CopyNumbers(FindArrayField(FieldName), OutNumbers);
+}
+
+bool USCJsonObject::CopyStringArrayField(const FString& FieldName, TArray<FString>& OutStrings) const
+{
+	return USCJsonValue::CopyStrings(FindArrayField(FieldName), OutStrings);
+}
+
+bool USCJsonObject::CopyBoolArrayField(const FString& FieldName, TArray<bool>& OutBools) const
+{
+	return USCJsonValue::CopyBools(FindArrayField(FieldName), OutBools);
+}
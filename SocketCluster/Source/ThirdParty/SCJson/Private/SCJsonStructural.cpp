@@ -0,0 +1,446 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCJsonStructural.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define SC_JSON_NEON 1
+#else
+#define SC_JSON_NEON 0
+#endif
+
+#if !SC_JSON_NEON && PLATFORM_ENABLE_VECTORINTRINSICS && (defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__))
+#include <emmintrin.h>
+#define SC_JSON_SSE2 1
+#else
+#define SC_JSON_SSE2 0
+#endif
+
+//AVX2 is only used when the whole module is built for it, there is no runtime dispatch
+#if SC_JSON_SSE2 && defined(__AVX2__)
+#include <immintrin.h>
+#define SC_JSON_AVX2 1
+#else
+#define SC_JSON_AVX2 0
+#endif
+
+/** Bit i of every mask describes byte i of a 64 byte block */
+struct FSCJsonBlockMasks
+{
+	uint64 Backslash;
+
+	uint64 Quote;
+
+	uint64 Whitespace;
+
+	/** {}[]:, */
+	uint64 Op;
+
+	uint64 NonAscii;
+};
+
+#if SC_JSON_AVX2
+
+static FORCEINLINE uint64 SCMoveMask(__m256i Value)
+{
+	return (uint32)_mm256_movemask_epi8(Value);
+}
+
+static FORCEINLINE void SCClassifyBlock(const uint8* Block, FSCJsonBlockMasks& Out)
+{
+	Out = FSCJsonBlockMasks();
+	for (int32 Offset = 0; Offset < 64; Offset += 32)
+	{
+		const __m256i Value = _mm256_loadu_si256((const __m256i*)(Block + Offset));
+		//'[' and ']' differ from '{' and '}' only in bit 0x20
+		const __m256i Folded = _mm256_or_si256(Value, _mm256_set1_epi8(0x20));
+
+		const __m256i Whitespace = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(Value, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(Value, _mm256_set1_epi8('\t'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(Value, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(Value, _mm256_set1_epi8('\r'))));
+		const __m256i Op = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(Folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(Folded, _mm256_set1_epi8('}'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(Value, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(Value, _mm256_set1_epi8(','))));
+
+		Out.Backslash |= SCMoveMask(_mm256_cmpeq_epi8(Value, _mm256_set1_epi8('\\'))) << Offset;
+		Out.Quote |= SCMoveMask(_mm256_cmpeq_epi8(Value, _mm256_set1_epi8('"'))) << Offset;
+		Out.Whitespace |= SCMoveMask(Whitespace) << Offset;
+		Out.Op |= SCMoveMask(Op) << Offset;
+		Out.NonAscii |= SCMoveMask(Value) << Offset;
+	}
+}
+
+#elif SC_JSON_SSE2
+
+static FORCEINLINE uint64 SCMoveMask(__m128i Value)
+{
+	return (uint32)_mm_movemask_epi8(Value);
+}
+
+static FORCEINLINE void SCClassifyBlock(const uint8* Block, FSCJsonBlockMasks& Out)
+{
+	Out = FSCJsonBlockMasks();
+	for (int32 Offset = 0; Offset < 64; Offset += 16)
+	{
+		const __m128i Value = _mm_loadu_si128((const __m128i*)(Block + Offset));
+		//'[' and ']' differ from '{' and '}' only in bit 0x20
+		const __m128i Folded = _mm_or_si128(Value, _mm_set1_epi8(0x20));
+
+		const __m128i Whitespace = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(Value, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(Value, _mm_set1_epi8('\t'))),
+			_mm_or_si128(_mm_cmpeq_epi8(Value, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(Value, _mm_set1_epi8('\r'))));
+		const __m128i Op = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(Folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(Folded, _mm_set1_epi8('}'))),
+			_mm_or_si128(_mm_cmpeq_epi8(Value, _mm_set1_epi8(':')), _mm_cmpeq_epi8(Value, _mm_set1_epi8(','))));
+
+		Out.Backslash |= SCMoveMask(_mm_cmpeq_epi8(Value, _mm_set1_epi8('\\'))) << Offset;
+		Out.Quote |= SCMoveMask(_mm_cmpeq_epi8(Value, _mm_set1_epi8('"'))) << Offset;
+		Out.Whitespace |= SCMoveMask(Whitespace) << Offset;
+		Out.Op |= SCMoveMask(Op) << Offset;
+		Out.NonAscii |= SCMoveMask(Value) << Offset;
+	}
+}
+
+#elif SC_JSON_NEON
+
+/** NEON has no movemask, the lanes are weighted by their bit and summed */
+static FORCEINLINE uint64 SCMoveMask(uint8x16_t Value)
+{
+	static const uint8 Weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint8x16_t Masked = vandq_u8(Value, vld1q_u8(Weights));
+	return (uint64)vaddv_u8(vget_low_u8(Masked)) | ((uint64)vaddv_u8(vget_high_u8(Masked)) << 8);
+}
+
+static FORCEINLINE void SCClassifyBlock(const uint8* Block, FSCJsonBlockMasks& Out)
+{
+	Out = FSCJsonBlockMasks();
+	for (int32 Offset = 0; Offset < 64; Offset += 16)
+	{
+		const uint8x16_t Value = vld1q_u8(Block + Offset);
+		//'[' and ']' differ from '{' and '}' only in bit 0x20
+		const uint8x16_t Folded = vorrq_u8(Value, vdupq_n_u8(0x20));
+
+		const uint8x16_t Whitespace = vorrq_u8(
+			vorrq_u8(vceqq_u8(Value, vdupq_n_u8(' ')), vceqq_u8(Value, vdupq_n_u8('\t'))),
+			vorrq_u8(vceqq_u8(Value, vdupq_n_u8('\n')), vceqq_u8(Value, vdupq_n_u8('\r'))));
+		const uint8x16_t Op = vorrq_u8(
+			vorrq_u8(vceqq_u8(Folded, vdupq_n_u8('{')), vceqq_u8(Folded, vdupq_n_u8('}'))),
+			vorrq_u8(vceqq_u8(Value, vdupq_n_u8(':')), vceqq_u8(Value, vdupq_n_u8(','))));
+
+		Out.Backslash |= SCMoveMask(vceqq_u8(Value, vdupq_n_u8('\\'))) << Offset;
+		Out.Quote |= SCMoveMask(vceqq_u8(Value, vdupq_n_u8('"'))) << Offset;
+		Out.Whitespace |= SCMoveMask(Whitespace) << Offset;
+		Out.Op |= SCMoveMask(Op) << Offset;
+		Out.NonAscii |= SCMoveMask(vcgeq_u8(Value, vdupq_n_u8(0x80))) << Offset;
+	}
+}
+
+#else
+
+static FORCEINLINE void SCClassifyBlock(const uint8* Block, FSCJsonBlockMasks& Out)
+{
+	Out = FSCJsonBlockMasks();
+	for (int32 i = 0; i < 64; i++)
+	{
+		const uint64 Bit = 1ULL << i;
+		switch (Block[i])
+		{
+		case '\\': Out.Backslash |= Bit; break;
+		case '"': Out.Quote |= Bit; break;
+		case ' ': case '\t': case '\n': case '\r': Out.Whitespace |= Bit; break;
+		case '{': case '}': case '[': case ']': case ':': case ',': Out.Op |= Bit; break;
+		default:
+			if (Block[i] >= 0x80)
+			{
+				Out.NonAscii |= Bit;
+			}
+			break;
+		}
+	}
+}
+
+#endif
+
+/** Bits of characters escaped by an odd run of backslashes, PrevEscaped carries a backslash ending the previous block */
+static FORCEINLINE uint64 SCFindEscaped(uint64 Backslash, uint64& PrevEscaped)
+{
+	Backslash &= ~PrevEscaped;
+	const uint64 FollowsEscape = (Backslash << 1) | PrevEscaped;
+
+	//Runs starting on an odd bit are cleared by the carry of the add, runs starting on an even bit are left
+	const uint64 EvenBits = 0x5555555555555555ULL;
+	const uint64 OddSequenceStarts = Backslash & ~EvenBits & ~FollowsEscape;
+	const uint64 SequencesStartingOnEvenBits = OddSequenceStarts + Backslash;
+	PrevEscaped = SequencesStartingOnEvenBits < OddSequenceStarts ? 1 : 0;
+
+	const uint64 InvertMask = SequencesStartingOnEvenBits << 1;
+	return (EvenBits ^ InvertMask) & FollowsEscape;
+}
+
+/** Bit i is the xor of bits 0 to i, turns quote bits into a mask of the bytes inside strings */
+static FORCEINLINE uint64 SCPrefixXor(uint64 Bits)
+{
+	Bits ^= Bits << 1;
+	Bits ^= Bits << 2;
+	Bits ^= Bits << 4;
+	Bits ^= Bits << 8;
+	Bits ^= Bits << 16;
+	Bits ^= Bits << 32;
+	return Bits;
+}
+
+static FORCEINLINE uint32 SCTrailingZeros(uint64 Bits)
+{
+	const uint32 Low = (uint32)Bits;
+	return Low != 0 ? FMath::CountTrailingZeros(Low) : 32 + FMath::CountTrailingZeros((uint32)(Bits >> 32));
+}
+
+/**
+ * UTF-8 validation for the blocks which are not pure ASCII, the state carries sequences across blocks.
+ * Overlong forms, surrogates and code points above U+10FFFF are rejected.
+ */
+struct FSCUtf8Validator
+{
+	int32 Pending = 0;
+
+	uint8 Min = 0x80;
+
+	uint8 Max = 0xbf;
+
+	bool Validate(const uint8* Bytes, int32 Num)
+	{
+		for (int32 i = 0; i < Num; i++)
+		{
+			const uint8 Byte = Bytes[i];
+			if (Pending > 0)
+			{
+				if (Byte < Min || Byte > Max)
+				{
+					return false;
+				}
+				Pending--;
+				Min = 0x80;
+				Max = 0xbf;
+			}
+			else if (Byte >= 0x80)
+			{
+				if (Byte >= 0xc2 && Byte <= 0xdf)
+				{
+					Pending = 1;
+				}
+				else if (Byte >= 0xe0 && Byte <= 0xef)
+				{
+					Pending = 2;
+					Min = Byte == 0xe0 ? 0xa0 : 0x80;
+					Max = Byte == 0xed ? 0x9f : 0xbf;
+				}
+				else if (Byte >= 0xf0 && Byte <= 0xf4)
+				{
+					Pending = 3;
+					Min = Byte == 0xf0 ? 0x90 : 0x80;
+					Max = Byte == 0xf4 ? 0x8f : 0xbf;
+				}
+				else
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+};
+
+bool SCBuildJsonStructuralIndex(const uint8* Data, int32 Size, TArray<uint32>& OutIndices)
+{
+	OutIndices.Reset();
+	OutIndices.Reserve(Size / 8 + 16);
+
+	int32 Start = 0;
+	if (Size >= 3 && Data[0] == 0xef && Data[1] == 0xbb && Data[2] == 0xbf)
+	{
+		Start = 3;
+	}
+
+	FSCUtf8Validator Utf8;
+	uint64 PrevEscaped = 0;
+	uint64 PrevInString = 0;
+	uint64 PrevScalar = 0;
+
+	//The last partial block is padded with whitespace
+	uint8 Tail[64];
+
+	for (int32 Offset = Start; Offset < Size; Offset += 64)
+	{
+		const uint8* Block = Data + Offset;
+		if (Size - Offset < 64)
+		{
+			FMemory::Memset(Tail, ' ', 64);
+			FMemory::Memcpy(Tail, Block, Size - Offset);
+			Block = Tail;
+		}
+
+		FSCJsonBlockMasks Masks;
+		SCClassifyBlock(Block, Masks);
+
+		if ((Masks.NonAscii != 0 || Utf8.Pending != 0) && !Utf8.Validate(Block, 64))
+		{
+			return false;
+		}
+
+		const uint64 Escaped = SCFindEscaped(Masks.Backslash, PrevEscaped);
+		const uint64 Quote = Masks.Quote & ~Escaped;
+
+		//Opening quotes and string content, closing quotes excluded
+		const uint64 InString = SCPrefixXor(Quote) ^ PrevInString;
+		PrevInString = (uint64)((int64)InString >> 63);
+
+		//A scalar starts at any other non whitespace character which does not follow one
+		const uint64 Scalar = ~(Masks.Op | Masks.Whitespace);
+		const uint64 NonQuoteScalar = Scalar & ~Quote;
+		const uint64 FollowsNonQuoteScalar = (NonQuoteScalar << 1) | PrevScalar;
+		PrevScalar = NonQuoteScalar >> 63;
+		const uint64 PotentialScalarStart = Scalar & ~FollowsNonQuoteScalar;
+
+		//String content and closing quotes, opening quotes stay in the index
+		const uint64 StringTail = InString ^ Quote;
+		uint64 Structurals = (Masks.Op | PotentialScalarStart) & ~StringTail;
+		if (Structurals == 0)
+		{
+			continue;
+		}
+
+		const int32 First = OutIndices.AddUninitialized(FMath::CountBits(Structurals));
+		uint32* Dest = OutIndices.GetData() + First;
+		while (Structurals != 0)
+		{
+			*Dest++ = (uint32)Offset + SCTrailingZeros(Structurals);
+			Structurals &= Structurals - 1;
+		}
+	}
+
+	return PrevInString == 0 && Utf8.Pending == 0;
+}
+
+TSharedPtr<FJsonValue> FSCJsonTokenCursor::ReadJsonValue()
+{
+	switch (Peek())
+	{
+	case '{':
+	{
+		++Next;
+		if (++Reader.Depth > SCJsonMaxDepth)
+		{
+			return nullptr;
+		}
+		TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject);
+		if (!Consume('}'))
+		{
+			do
+			{
+				FString Key;
+				if (Peek() != '"' || !Scalar().ReadString(Key) || !Consume(':'))
+				{
+					return nullptr;
+				}
+				TSharedPtr<FJsonValue> Value = ReadJsonValue();
+				if (!Value.IsValid())
+				{
+					return nullptr;
+				}
+				Object->SetField(Key, Value);
+			} while (Consume(','));
+			if (!Consume('}'))
+			{
+				return nullptr;
+			}
+		}
+		--Reader.Depth;
+		return MakeShareable(new FJsonValueObject(Object));
+	}
+	case '[':
+	{
+		++Next;
+		if (++Reader.Depth > SCJsonMaxDepth)
+		{
+			return nullptr;
+		}
+		TArray<TSharedPtr<FJsonValue>> Array;
+		if (!Consume(']'))
+		{
+			// Leading numbers are read packed, they only become FJsonValueNumber items if something else follows
+			TArray<double> Numbers;
+			bool bOnlyNumbers = false;
+			while (SCIsNumberStart(Peek()))
+			{
+				double Number;
+				if (!ReadNumber(Number))
+				{
+					return nullptr;
+				}
+				Numbers.Add(Number);
+				if (!Consume(','))
+				{
+					bOnlyNumbers = true;
+					break;
+				}
+			}
+			if (bOnlyNumbers)
+			{
+				if (!Consume(']'))
+				{
+					return nullptr;
+				}
+				--Reader.Depth;
+				return SCMakeNumberArray(MoveTemp(Numbers));
+			}
+			SCAppendNumbers(Numbers, Array);
+
+			do
+			{
+				TSharedPtr<FJsonValue> Value = ReadJsonValue();
+				if (!Value.IsValid())
+				{
+					return nullptr;
+				}
+				Array.Add(Value);
+			} while (Consume(','));
+			if (!Consume(']'))
+			{
+				return nullptr;
+			}
+		}
+		--Reader.Depth;
+		return MakeShareable(new FJsonValueArray(Array));
+	}
+	case '"':
+	{
+		FString Value;
+		if (!Scalar().ReadString(Value))
+		{
+			return nullptr;
+		}
+		return MakeShareable(new FJsonValueString(Value));
+	}
+	case 't':
+		return ReadLiteral("true", 4) ? MakeShareable(new FJsonValueBoolean(true)) : nullptr;
+	case 'f':
+		return ReadLiteral("false", 5) ? MakeShareable(new FJsonValueBoolean(false)) : nullptr;
+	case 'n':
+		return ReadLiteral("null", 4) ? MakeShareable(new FJsonValueNull) : nullptr;
+	case 0:
+	case '}':
+	case ']':
+	case ':':
+	case ',':
+		return nullptr;
+	default:
+	{
+		double Value;
+		if (!ReadNumber(Value))
+		{
+			return nullptr;
+		}
+		return MakeShareable(new FJsonValueNumber(Value));
+	}
+	}
+}
@@ -0,0 +1,105 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+#include "SCJsonByteReader.h"
+
+/**
+ * Stage one of the two stage parser: index the offset of every structural character ({}[]:,), every opening quote and the
+ * first byte of every other scalar outside of strings, validating the input as UTF-8 on the way.
+ * The input is processed in 64 byte blocks, SIMD classifies the bytes into bitmasks and escapes and strings are resolved on the masks.
+ *
+ * @return		false if the input is not UTF-8 or ends inside a string.
+ */
+bool SCBuildJsonStructuralIndex(const uint8* Data, int32 Size, TArray<uint32>& OutIndices);
+
+/**
+ * Stage two: walks the structural index. Strings, numbers and literals are read with FSCJsonByteReader placed at their index,
+ * whitespace and container syntax never go through it.
+ */
+class FSCJsonTokenCursor
+{
+public:
+
+	FSCJsonTokenCursor(const uint8* InData, int32 InSize, const TArray<uint32>& InIndices)
+		: Data(InData)
+		, Indices(InIndices.GetData())
+		, NumIndices(InIndices.Num())
+		, Next(0)
+		, Reader(InData, InSize)
+	{
+	}
+
+	/** The character at the next index, 0 at the end */
+	FORCEINLINE uint8 Peek() const
+	{
+		return Next < NumIndices ? Data[Indices[Next]] : 0;
+	}
+
+	FORCEINLINE bool Consume(uint8 Char)
+	{
+		if (Peek() == Char)
+		{
+			++Next;
+			return true;
+		}
+		return false;
+	}
+
+	/** Move the reader to the next index and step past it */
+	FORCEINLINE FSCJsonByteReader& Scalar()
+	{
+		Reader.Cursor = Data + Indices[Next++];
+		return Reader;
+	}
+
+	/** After a scalar was read the reader has to stand at the next index or at trailing whitespace, "truex" or "1a" are rejected */
+	FORCEINLINE bool EndScalar()
+	{
+		return Reader.Cursor == (Next < NumIndices ? Data + Indices[Next] : Reader.End) || (Reader.Cursor < Reader.End && IsWhitespace(*Reader.Cursor));
+	}
+
+	bool AtEnd() const
+	{
+		return Next == NumIndices;
+	}
+
+	/** Read the string at the next index into Reader.Scratch */
+	FORCEINLINE bool ReadRawString()
+	{
+		return Scalar().ReadRawString();
+	}
+
+	FORCEINLINE bool ReadNumber(double& OutValue)
+	{
+		return Scalar().ReadDouble(OutValue) && EndScalar();
+	}
+
+	FORCEINLINE bool ReadLiteral(const ANSICHAR* Literal, int32 Length)
+	{
+		return Scalar().ConsumeLiteral(Literal, Length) && EndScalar();
+	}
+
+	/** Read the value at the next index into the shared pointer DOM */
+	TSharedPtr<FJsonValue> ReadJsonValue();
+
+	const uint8* Data;
+
+	const uint32* Indices;
+
+	int32 NumIndices;
+
+	int32 Next;
+
+	FSCJsonByteReader Reader;
+
+private:
+
+	static FORCEINLINE bool IsWhitespace(uint8 Char)
+	{
+		return Char == ' ' || Char == '\n' || Char == '\r' || Char == '\t';
+	}
+};
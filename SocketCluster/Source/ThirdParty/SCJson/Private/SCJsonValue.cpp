@@ -6,12 +6,35 @@
 #include "SCJsonObject.h"
 #include "SCJsonConvert.h"
 #include "SCJsonModule.h"
+#include "SCJsonWrapperCache.h"
+#include "SCBase64.h"
+
+/** GetType is protected, a subclass may still name it through its own scope and call it on any value */
+struct FSCJsonValueTypeAccess : public FJsonValue
+{
+	static FString Get(const FJsonValue& Value)
+	{
+		return (Value.*(&FSCJsonValueTypeAccess::GetType))();
+	}
+};
+
+FString SCGetJsonValueType(const FJsonValue& Value)
+{
+	return FSCJsonValueTypeAccess::Get(Value);
+}
 
 #if PLATFORM_WINDOWS
 #pragma region FJsonValueBinary
 #endif
 
 
+bool FJsonValueBinary::TryGetString(FString& OutString) const
+{
+	OutString = FSCBase64::Encode(Value);
+	return true;
+}
+
+
 TArray<uint8> FJsonValueBinary::AsBinary(const TSharedPtr<FJsonValue>& InJsonValue)
 {
 	if (FJsonValueBinary::IsBinary(InJsonValue))
@@ -34,8 +57,84 @@ bool FJsonValueBinary::IsBinary(const TSharedPtr<FJsonValue>& InJsonValue)
 	return !InJsonValue->TryGetBool(IgnoreBool);
 }
 
+
+bool FJsonValueBinary::TryGetBinary(const TSharedPtr<FJsonValue>& InJsonValue, TArray<uint8>& OutBytes, bool bBase64Strings)
+{
+	if (!InJsonValue.IsValid())
+	{
+		return false;
+	}
+
+	if (InJsonValue->Type == EJson::String)
+	{
+		if (FJsonValueBinary::IsBinary(InJsonValue))
+		{
+			OutBytes = StaticCastSharedPtr<FJsonValueBinary>(InJsonValue)->GetBinary();
+			return true;
+		}
+
+		const FString& String = InJsonValue->AsString();
+		if (bBase64Strings)
+		{
+			//base64url strings are told apart by their alphabet, the standard one is tried first
+			return FSCBase64::Decode(String, OutBytes, ESCBase64::Standard) || FSCBase64::Decode(String, OutBytes, ESCBase64::Url);
+		}
+
+		//It's a string, decode as if hex encoded binary
+		OutBytes.SetNumUninitialized(String.Len() / 2);
+		if (!FString::ToHexBlob(String, OutBytes.GetData(), OutBytes.Num()))
+		{
+			OutBytes.Reset();
+			return false;
+		}
+		return true;
+	}
+
+	if (InJsonValue->Type == EJson::Object)
+	{
+		const TSharedPtr<FJsonObject> Object = InJsonValue->AsObject();
+		bool IsBase64 = false;
+		FString Data;
+		if (Object.IsValid() && Object->TryGetBoolField(TEXT("base64"), IsBase64) && IsBase64 && Object->TryGetStringField(TEXT("data"), Data))
+		{
+			return FSCBase64::Decode(Data, OutBytes, ESCBase64::Standard);
+		}
+	}
+	return false;
+}
+
 #if PLATFORM_WINDOWS
 #pragma endregion FJsonValueBinary
+#pragma region FJsonValueNumberArray
+#endif
+
+FThreadSafeCounter FJsonValueNumberArray::NumAlive;
+
+bool FJsonValueNumberArray::TryGetArray(const TArray<TSharedPtr<FJsonValue>>*& OutArray) const
+{
+	if (Items.Num() != Numbers.Num())
+	{
+		Items.Reset(Numbers.Num());
+		for (double Number : Numbers)
+		{
+			Items.Add(MakeShareable(new FJsonValueNumber(Number)));
+		}
+	}
+	OutArray = &Items;
+	return true;
+}
+
+const TArray<double>* FJsonValueNumberArray::AsNumberArray(const FJsonValue* InJsonValue)
+{
+	if (InJsonValue == nullptr || InJsonValue->Type != EJson::Array || NumAlive.GetValue() == 0)
+	{
+		return nullptr;
+	}
+	return SCGetJsonValueType(*InJsonValue).Equals(TEXT("NumberArray"), ESearchCase::CaseSensitive) ? &static_cast<const FJsonValueNumberArray*>(InJsonValue)->Numbers : nullptr;
+}
+
+#if PLATFORM_WINDOWS
+#pragma endregion FJsonValueNumberArray
 #pragma region USCJsonValue
 #endif
 
@@ -92,6 +191,16 @@ USCJsonValue* USCJsonValue::ConstructJsonValueArray(UObject* WorldContextObject,
 	return NewValue;
 }
 
+USCJsonValue* USCJsonValue::ConstructJsonValueNumberArray(UObject* WorldContextObject, const TArray<float>& NumberArray)
+{
+	TSharedPtr<FJsonValue> NewVal = MakeShareable(new FJsonValueNumberArray(NumberArray));
+
+	USCJsonValue* NewValue = NewObject<USCJsonValue>();
+	NewValue->SetRootValue(NewVal);
+
+	return NewValue;
+}
+
 USCJsonValue* USCJsonValue::ConstructJsonValueObject(USCJsonObject *JsonObject, UObject* WorldContextObject)
 {
 	TSharedPtr<FJsonValue> NewVal = MakeShareable(new FJsonValueObject(JsonObject->GetRootObject()));
@@ -142,6 +251,23 @@ TSharedPtr<FJsonValue>& USCJsonValue::GetRootValue()
 void USCJsonValue::SetRootValue(TSharedPtr<FJsonValue>& JsonValue)
 {
 	JsonVal = JsonValue;
+
+	// Wrappers of the previous value belong to whoever holds them now
+	WrapperCache = nullptr;
+}
+
+void USCJsonValue::SetWrapperCache(USCJsonWrapperCache* Cache)
+{
+	WrapperCache = Cache;
+}
+
+USCJsonWrapperCache* USCJsonValue::GetWrapperCache() const
+{
+	if (WrapperCache == nullptr)
+	{
+		const_cast<USCJsonValue*>(this)->WrapperCache = NewObject<USCJsonWrapperCache>();
+	}
+	return WrapperCache;
 }
 
 
@@ -285,13 +411,11 @@ TArray<USCJsonValue*> USCJsonValue::AsArray() const
 		return OutArray;
 	}
 
-	TArray< TSharedPtr<FJsonValue> > ValArray = JsonVal->AsArray();
-	for (auto Value : ValArray)
+	const TArray< TSharedPtr<FJsonValue> >& ValArray = JsonVal->AsArray();
+	OutArray.Reserve(ValArray.Num());
+	for (const auto& Value : ValArray)
 	{
-		USCJsonValue* NewValue = NewObject<USCJsonValue>();
-		NewValue->SetRootValue(Value);
-
-		OutArray.Add(NewValue);
+		OutArray.Add(GetWrapperCache()->FindOrAddValue(Value));
 	}
 
 	return OutArray;
@@ -305,12 +429,7 @@ USCJsonObject* USCJsonValue::AsObject()
 		return nullptr;
 	}
 
-	TSharedPtr<FJsonObject> NewObj = JsonVal->AsObject();
-
-	USCJsonObject* JsonObj = NewObject<USCJsonObject>();
-	JsonObj->SetRootObject(NewObj);
-
-	return JsonObj;
+	return GetWrapperCache()->FindOrAddObject(JsonVal->AsObject());
 }
 
 
@@ -322,47 +441,198 @@ TArray<uint8> USCJsonValue::AsBinary()
 		TArray<uint8> ByteArray;
 		return ByteArray;
 	}
-	
-	//binary object pretending & starts with non-json format? it's our disguise binary
-	if (JsonVal->Type == EJson::String)
+
+	//a binary value, an sc-formatter binary object or a base64 string like binary values are written, anything else is an empty array
+	TArray<uint8> ByteArray;
+	if (!FJsonValueBinary::TryGetBinary(JsonVal, ByteArray, true))
 	{
-		//it's a legit binary
-		if (FJsonValueBinary::IsBinary(JsonVal))
+		ByteArray.Empty();
+	}
+	return ByteArray;
+}
+
+FString USCJsonValue::EncodeJson() const
+{ 
+	return USCJsonConvert::ToJsonString(JsonVal);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Array access without wrapping every item
+
+/** The items of Value, nullptr if it is not an array */
+static const TArray<TSharedPtr<FJsonValue>>* SCGetItems(const TSharedPtr<FJsonValue>& Value)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Items = nullptr;
+	if (!Value.IsValid() || Value->Type != EJson::Array || !Value->TryGetArray(Items))
+	{
+		return nullptr;
+	}
+	return Items;
+}
+
+/** The item at Index, nullptr if out of range or Value is not an array */
+static const FJsonValue* SCGetItem(const TSharedPtr<FJsonValue>& Value, int32 Index)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Items = SCGetItems(Value);
+	return Items != nullptr && Items->IsValidIndex(Index) ? (*Items)[Index].Get() : nullptr;
+}
+
+int32 USCJsonValue::GetArrayLength() const
+{
+	if (const TArray<double>* Numbers = FJsonValueNumberArray::AsNumberArray(JsonVal))
+	{
+		return Numbers->Num();
+	}
+	const TArray<TSharedPtr<FJsonValue>>* Items = SCGetItems(JsonVal);
+	return Items != nullptr ? Items->Num() : 0;
+}
+
+USCJsonValue* USCJsonValue::GetValueAt(int32 Index) const
+{
+	const TArray<TSharedPtr<FJsonValue>>* Items = SCGetItems(JsonVal);
+	if (Items == nullptr || !Items->IsValidIndex(Index))
+	{
+		return nullptr;
+	}
+	return GetWrapperCache()->FindOrAddValue((*Items)[Index]);
+}
+
+float USCJsonValue::GetNumberAt(int32 Index) const
+{
+	if (const TArray<double>* Numbers = FJsonValueNumberArray::AsNumberArray(JsonVal))
+	{
+		return Numbers->IsValidIndex(Index) ? (*Numbers)[Index] : 0.f;
+	}
+	const FJsonValue* Item = SCGetItem(JsonVal, Index);
+	return Item != nullptr && Item->Type == EJson::Number ? Item->AsNumber() : 0.f;
+}
+
+FString USCJsonValue::GetStringAt(int32 Index) const
+{
+	const FJsonValue* Item = SCGetItem(JsonVal, Index);
+	return Item != nullptr && Item->Type == EJson::String ? Item->AsString() : FString();
+}
+
+bool USCJsonValue::GetBoolAt(int32 Index) const
+{
+	const FJsonValue* Item = SCGetItem(JsonVal, Index);
+	return Item != nullptr && Item->Type == EJson::Boolean && Item->AsBool();
+}
+
+USCJsonObject* USCJsonValue::GetObjectAt(int32 Index) const
+{
+	const TArray<TSharedPtr<FJsonValue>>* Items = SCGetItems(JsonVal);
+	if (Items == nullptr || !Items->IsValidIndex(Index) || (*Items)[Index]->Type != EJson::Object)
+	{
+		return nullptr;
+	}
+	return GetWrapperCache()->FindOrAddObject((*Items)[Index]->AsObject());
+}
+
+bool USCJsonValue::CopyNumberArray(TArray<float>& OutNumbers) const
+{
+	return CopyNumbers(JsonVal, OutNumbers);
+}
+
+bool USCJsonValue::CopyStringArray(TArray<FString>& OutStrings) const
+{
+	return CopyStrings(JsonVal, OutStrings);
+}
+
+bool USCJsonValue::CopyBoolArray(TArray<bool>& OutBools) const
+{
+	return CopyBools(JsonVal, OutBools);
+}
+
+bool USCJsonValue::CopyDoubleArray(TArray<double>& OutNumbers) const
+{
+	return CopyNumbers(JsonVal, OutNumbers);
+}
+
+template<typename NumberType>
+static bool SCCopyNumbers(const TSharedPtr<FJsonValue>& Array, TArray<NumberType>& OutNumbers)
+{
+	OutNumbers.Reset();
+	if (const TArray<double>* Numbers = FJsonValueNumberArray::AsNumberArray(Array))
+	{
+		const int32 Num = Numbers->Num();
+		OutNumbers.SetNumUninitialized(Num, false);
+		const double* Source = Numbers->GetData();
+		NumberType* Dest = OutNumbers.GetData();
+		for (int32 i = 0; i < Num; i++)
 		{
-			//Valid binary available
-			return FJsonValueBinary::AsBinary(JsonVal);
+			Dest[i] = (NumberType)Source[i];
 		}
+		return true;
+	}
 
-		//It's a string, decode as if hex encoded binary
+	const TArray<TSharedPtr<FJsonValue>>* Items = SCGetItems(Array);
+	if (Items == nullptr)
+	{
+		return false;
+	}
+	bool bUniform = true;
+	OutNumbers.Reserve(Items->Num());
+	for (const auto& Item : *Items)
+	{
+		if (Item->Type == EJson::Number)
+		{
+			OutNumbers.Add((NumberType)Item->AsNumber());
+		}
 		else
 		{
-			const FString& HexString = JsonVal->AsString();
-
-			TArray<uint8> ByteArray;
-			ByteArray.AddUninitialized(HexString.Len() / 2);
-
-			bool DidConvert = FString::ToHexBlob(HexString, ByteArray.GetData(), ByteArray.Num());
-			
-			//Empty our array if conversion failed
-			if (!DidConvert)
-			{
-				ByteArray.Empty();
-			}
-			return ByteArray;
+			OutNumbers.Add(0);
+			bUniform = false;
 		}
 	}
-	//Not a binary nor binary string, return empty array
-	else
+	return bUniform;
+}
+
+bool USCJsonValue::CopyNumbers(const TSharedPtr<FJsonValue>& Array, TArray<float>& OutNumbers)
+{
+	return SCCopyNumbers(Array, OutNumbers);
+}
+
+bool USCJsonValue::CopyNumbers(const TSharedPtr<FJsonValue>& Array, TArray<double>& OutNumbers)
+{
+	return SCCopyNumbers(Array, OutNumbers);
+}
+
+bool USCJsonValue::CopyStrings(const TSharedPtr<FJsonValue>& Array, TArray<FString>& OutStrings)
+{
+	OutStrings.Reset();
+	const TArray<TSharedPtr<FJsonValue>>* Items = SCGetItems(Array);
+	if (Items == nullptr)
 	{
-		//Empty array
-		TArray<uint8> ByteArray;
-		return ByteArray;
+		return false;
 	}
+	bool bUniform = true;
+	OutStrings.Reserve(Items->Num());
+	for (const auto& Item : *Items)
+	{
+		bUniform &= Item->Type == EJson::String;
+		OutStrings.Add(Item->AsString());
+	}
+	return bUniform;
 }
 
-FString USCJsonValue::EncodeJson() const
-{ 
-	return USCJsonConvert::ToJsonString(JsonVal);
+bool USCJsonValue::CopyBools(const TSharedPtr<FJsonValue>& Array, TArray<bool>& OutBools)
+{
+	OutBools.Reset();
+	const TArray<TSharedPtr<FJsonValue>>* Items = SCGetItems(Array);
+	if (Items == nullptr)
+	{
+		return false;
+	}
+	bool bUniform = true;
+	OutBools.Reserve(Items->Num());
+	for (const auto& Item : *Items)
+	{
+		bUniform &= Item->Type == EJson::Boolean;
+		OutBools.Add(Item->AsBool());
+	}
+	return bUniform;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,62 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCJsonWrapperCache.h"
+#include "SCJsonValue.h"
+#include "SCJsonObject.h"
+
+USCJsonValue* USCJsonWrapperCache::FindOrAddValue(const TSharedPtr<FJsonValue>& Value)
+{
+	if (!Value.IsValid())
+	{
+		return nullptr;
+	}
+
+	USCJsonValue*& Wrapper = Values.FindOrAdd(Value.Get());
+
+	// A cached wrapper which was given another root since is left to its owner
+	if (Wrapper == nullptr || Wrapper->GetRootValue().Get() != Value.Get())
+	{
+		TSharedPtr<FJsonValue> NewVal = Value;
+		Wrapper = NewObject<USCJsonValue>();
+		Wrapper->SetRootValue(NewVal);
+		Wrapper->SetWrapperCache(this);
+	}
+	return Wrapper;
+}
+
+USCJsonObject* USCJsonWrapperCache::FindOrAddObject(const TSharedPtr<FJsonObject>& Object)
+{
+	if (!Object.IsValid())
+	{
+		return nullptr;
+	}
+
+	USCJsonObject*& Wrapper = Objects.FindOrAdd(Object.Get());
+	if (Wrapper == nullptr || Wrapper->GetRootObject().Get() != Object.Get())
+	{
+		Wrapper = NewObject<USCJsonObject>();
+		Wrapper->SetRootObject(Object);
+		Wrapper->SetWrapperCache(this);
+	}
+	return Wrapper;
+}
+
+void USCJsonWrapperCache::Reset()
+{
+	Values.Reset();
+	Objects.Reset();
+}
+
+void USCJsonWrapperCache::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	USCJsonWrapperCache* This = CastChecked<USCJsonWrapperCache>(InThis);
+	for (auto& Pair : This->Values)
+	{
+		Collector.AddReferencedObject(Pair.Value, This);
+	}
+	for (auto& Pair : This->Objects)
+	{
+		Collector.AddReferencedObject(Pair.Value, This);
+	}
+	Super::AddReferencedObjects(InThis, Collector);
+}
@@ -0,0 +1,303 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCMessageAccounting.h"
+#include "CoreGlobals.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "SCAllocationCounter.h"
+#include "SCJsonConvert.h"
+#include "SCJsonModule.h"
+
+bool FSCMessageAccounting::running = false;
+
+/** A message being accounted, what was counted since the mark belongs to it */
+struct FSCOpenMessage
+{
+	ESCMessageDirection direction = ESCMessageDirection::INBOUND;
+
+	FString type;
+
+	/** The number of nested scopes of the message */
+	int32 depth = 0;
+
+	int64 allocations = 0;
+
+	int64 allocatedBytes = 0;
+
+	int64 markAllocations = 0;
+
+	int64 markBytes = 0;
+
+	uint64 transcodes = 0;
+
+	uint64 transcodedBytes = 0;
+};
+
+/** Installed by the first start and never freed, another proxy may have been installed over it when accounting stops */
+static FSCAllocationCounter* SCAccountingCounter = nullptr;
+
+static FMalloc* SCAccountingPrevious = nullptr;
+
+static TMap<FString, FSCMessageCost> SCMessageCosts[2];
+
+/** The open messages of the game thread, innermost last. The entries are kept when a message closes so opening one does not allocate */
+static TArray<FSCOpenMessage> SCOpenMessages;
+
+static int32 SCOpenMessageCount = 0;
+
+/** Move what was counted since the mark of message to it */
+static void SCAccountOpenMessage(FSCOpenMessage& message, int64 allocations, int64 allocatedBytes)
+{
+	message.allocations += allocations - message.markAllocations;
+	message.allocatedBytes += allocatedBytes - message.markBytes;
+	message.markAllocations = allocations;
+	message.markBytes = allocatedBytes;
+}
+
+bool FSCMessageAccounting::start()
+{
+#if SC_MESSAGE_ACCOUNTING
+	check(IsInGameThread());
+	if (running)
+	{
+		return true;
+	}
+
+	if (SCAccountingCounter == nullptr)
+	{
+		SCAccountingCounter = new FSCAllocationCounter(GMalloc, GGameThreadId);
+	}
+	if (GMalloc != SCAccountingCounter)
+	{
+		SCAccountingPrevious = GMalloc;
+		GMalloc = SCAccountingCounter;
+	}
+
+	// Messages of both directions nest, a few levels cover a handler which emits while an event is dispatched
+	if (SCOpenMessages.Num() < 4)
+	{
+		SCOpenMessages.SetNum(4);
+	}
+	running = true;
+	UE_LOG(LogSCJson, Log, TEXT("Message accounting started"));
+	return true;
+#else
+	UE_LOG(LogSCJson, Warning, TEXT("Message accounting is compiled out of this build, see SC_MESSAGE_ACCOUNTING"));
+	return false;
+#endif
+}
+
+void FSCMessageAccounting::stop()
+{
+	check(IsInGameThread());
+	if (!running)
+	{
+		return;
+	}
+	running = false;
+
+	if (GMalloc == SCAccountingCounter)
+	{
+		GMalloc = SCAccountingPrevious;
+	}
+	else
+	{
+		UE_LOG(LogSCJson, Warning, TEXT("Another allocator was installed over the message accounting counter, it stays installed"));
+	}
+	UE_LOG(LogSCJson, Log, TEXT("Message accounting stopped"));
+}
+
+void FSCMessageAccounting::reset()
+{
+	SCMessageCosts[(int32)ESCMessageDirection::INBOUND].Empty();
+	SCMessageCosts[(int32)ESCMessageDirection::OUTBOUND].Empty();
+}
+
+void FSCMessageAccounting::_countTranscode(int32 bytes)
+{
+	if (SCOpenMessageCount > 0 && IsInGameThread())
+	{
+		FSCOpenMessage& message = SCOpenMessages[SCOpenMessageCount - 1];
+		message.transcodes++;
+		message.transcodedBytes += bytes;
+	}
+}
+
+const TMap<FString, FSCMessageCost>& FSCMessageAccounting::getCosts(ESCMessageDirection direction)
+{
+	return SCMessageCosts[(int32)direction];
+}
+
+TSharedPtr<FJsonObject> FSCMessageAccounting::toJson()
+{
+	TSharedPtr<FJsonObject> result = MakeShareable(new FJsonObject);
+	static const TCHAR* directions[] = { TEXT("inbound"), TEXT("outbound") };
+	for (int32 direction = 0; direction < 2; direction++)
+	{
+		TSharedPtr<FJsonObject> types = MakeShareable(new FJsonObject);
+		for (const TPair<FString, FSCMessageCost>& entry : SCMessageCosts[direction])
+		{
+			const FSCMessageCost& cost = entry.Value;
+			const double messages = (double)FMath::Max<uint64>(cost.messages, 1);
+			TSharedPtr<FJsonObject> type = MakeShareable(new FJsonObject);
+			type->SetNumberField("messages", (double)cost.messages);
+			type->SetNumberField("allocationsPerMessage", cost.allocations / messages);
+			type->SetNumberField("allocatedBytesPerMessage", cost.allocatedBytes / messages);
+			type->SetNumberField("transcodesPerMessage", cost.transcodes / messages);
+			type->SetNumberField("transcodedBytesPerMessage", cost.transcodedBytes / messages);
+			types->SetObjectField(entry.Key, type);
+		}
+		result->SetObjectField(directions[direction], types);
+	}
+	return result;
+}
+
+FSCMessageScope::FSCMessageScope(ESCMessageDirection direction)
+	: active(FSCMessageAccounting::running && IsInGameThread())
+{
+	if (!active)
+	{
+		return;
+	}
+
+	if (SCOpenMessageCount > 0 && SCOpenMessages[SCOpenMessageCount - 1].direction == direction)
+	{
+		SCOpenMessages[SCOpenMessageCount - 1].depth++;
+		return;
+	}
+
+	if (SCOpenMessageCount == SCOpenMessages.Num())
+	{
+		SCOpenMessages.AddDefaulted();
+	}
+
+	const int64 allocations = SCAccountingCounter->getAllocations();
+	const int64 allocatedBytes = SCAccountingCounter->getBytes();
+	if (SCOpenMessageCount > 0)
+	{
+		SCAccountOpenMessage(SCOpenMessages[SCOpenMessageCount - 1], allocations, allocatedBytes);
+	}
+
+	FSCOpenMessage& message = SCOpenMessages[SCOpenMessageCount++];
+	message.direction = direction;
+	message.type.Reset();
+	message.depth = 1;
+	message.allocations = 0;
+	message.allocatedBytes = 0;
+	message.markAllocations = allocations;
+	message.markBytes = allocatedBytes;
+	message.transcodes = 0;
+	message.transcodedBytes = 0;
+}
+
+FSCMessageScope::FSCMessageScope(ESCMessageDirection direction, const TCHAR* type)
+	: FSCMessageScope(direction)
+{
+	if (active)
+	{
+		setType(type);
+	}
+}
+
+FSCMessageScope::~FSCMessageScope()
+{
+	if (!active || SCOpenMessageCount == 0)
+	{
+		return;
+	}
+
+	FSCOpenMessage& message = SCOpenMessages[SCOpenMessageCount - 1];
+	if (--message.depth > 0)
+	{
+		return;
+	}
+
+	SCAccountOpenMessage(message, SCAccountingCounter->getAllocations(), SCAccountingCounter->getBytes());
+	SCOpenMessageCount--;
+
+	FSCMessageCost& cost = SCMessageCosts[(int32)message.direction].FindOrAdd(message.type.IsEmpty() ? TEXT("unknown") : message.type);
+	cost.messages++;
+	cost.allocations += message.allocations;
+	cost.allocatedBytes += message.allocatedBytes;
+	cost.transcodes += message.transcodes;
+	cost.transcodedBytes += message.transcodedBytes;
+
+	// The message of the other direction picks up again, without what recording this one allocated
+	if (SCOpenMessageCount > 0)
+	{
+		FSCOpenMessage& outer = SCOpenMessages[SCOpenMessageCount - 1];
+		outer.markAllocations = SCAccountingCounter->getAllocations();
+		outer.markBytes = SCAccountingCounter->getBytes();
+	}
+}
+
+void FSCMessageScope::setType(TFunctionRef<FString()> type)
+{
+	if (!FSCMessageAccounting::running || SCOpenMessageCount == 0 || !IsInGameThread())
+	{
+		return;
+	}
+
+	FSCOpenMessage& message = SCOpenMessages[SCOpenMessageCount - 1];
+	if (!message.type.IsEmpty())
+	{
+		return;
+	}
+
+	// Naming the message is bookkeeping, move the mark past what it allocated
+	const int64 allocations = SCAccountingCounter->getAllocations();
+	const int64 allocatedBytes = SCAccountingCounter->getBytes();
+	message.type = type();
+	message.markAllocations += SCAccountingCounter->getAllocations() - allocations;
+	message.markBytes += SCAccountingCounter->getBytes() - allocatedBytes;
+}
+
+void FSCMessageScope::setType(const TCHAR* type)
+{
+	setType([type]() { return FString(type); });
+}
+
+static void RunMessageAccountingCommand(const TArray<FString>& Args)
+{
+	const FString command = Args.Num() > 0 ? Args[0] : FString("dump");
+	if (command.Equals("start"))
+	{
+		FSCMessageAccounting::start();
+	}
+	else if (command.Equals("stop"))
+	{
+		FSCMessageAccounting::stop();
+	}
+	else if (command.Equals("reset"))
+	{
+		FSCMessageAccounting::reset();
+	}
+	else if (command.Equals("dump"))
+	{
+		static const TCHAR* directions[] = { TEXT("inbound"), TEXT("outbound") };
+		for (int32 direction = 0; direction < 2; direction++)
+		{
+			for (const TPair<FString, FSCMessageCost>& entry : FSCMessageAccounting::getCosts((ESCMessageDirection)direction))
+			{
+				const FSCMessageCost& cost = entry.Value;
+				const double messages = (double)FMath::Max<uint64>(cost.messages, 1);
+				UE_LOG(LogSCJson, Display, TEXT("%-8s %-32s %10llu msgs %8.1f allocs/msg %10.0f B/msg %6.1f transcodes/msg"), directions[direction], *entry.Key,
+					cost.messages, cost.allocations / messages, cost.allocatedBytes / messages, cost.transcodes / messages);
+			}
+		}
+		if (Args.Num() > 1 && !FFileHelper::SaveStringToFile(USCJsonConvert::ToJsonString(FSCMessageAccounting::toJson()), *Args[1], FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+		{
+			UE_LOG(LogSCJson, Error, TEXT("Could not write the message accounting to %s"), *Args[1]);
+		}
+	}
+	else
+	{
+		UE_LOG(LogSCJson, Warning, TEXT("Unknown message accounting command %s"), *command);
+	}
+}
+
+static FAutoConsoleCommand SCMessageAccountingCommand(
+	TEXT("SocketCluster.MessageAccounting"),
+	TEXT("Counts the allocations and string transcodes of every SocketCluster message by type. Arguments: start|stop|reset|dump [file]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunMessageAccountingCommand)
+);
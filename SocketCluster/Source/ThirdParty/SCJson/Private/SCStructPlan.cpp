@@ -0,0 +1,1237 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "SCStructPlan.h"
+#include "Runtime/JsonUtilities/Public/JsonObjectConverter.h"
+#include "Runtime/JsonUtilities/Public/JsonObjectWrapper.h"
+#include "Misc/ScopeLock.h"
+#include "SCJsonConvert.h"
+#include "SCJsonByteReader.h"
+#include "SCJsonArena.h"
+#include "SCJsonValue.h"
+#include "SCJsonNumber.h"
+#include "SCBase64.h"
+#include "SCMessageAccounting.h"
+
+struct FSCStructPlanCache
+{
+	FCriticalSection Lock;
+
+	/** Plans with untrimmed and with trimmed keys */
+	TMap<const UStruct*, FSCStructPlan*> Plans[2];
+
+	/** Plans are never freed, other plans and callers keep raw pointers to them */
+	TArray<TUniquePtr<FSCStructPlan>> Owned;
+};
+
+static FSCStructPlanCache& GetStructPlanCache()
+{
+	static FSCStructPlanCache Cache;
+	return Cache;
+}
+
+FSCStructPlan::FSCStructPlan(UStruct* InStruct, bool bInTrimKeys)
+	: Struct(InStruct)
+	, bTrimKeys(bInTrimKeys)
+	, StructureSize(InStruct->GetStructureSize())
+	, PropertyLink(InStruct->PropertyLink)
+{
+}
+
+const FSCStructPlan* FSCStructPlan::Get(UStruct* Struct, bool bTrimKeys)
+{
+	if (Struct == nullptr)
+	{
+		return nullptr;
+	}
+
+	FSCStructPlanCache& Cache = GetStructPlanCache();
+	FScopeLock Lock(&Cache.Lock);
+
+	if (FSCStructPlan** Existing = Cache.Plans[bTrimKeys ? 1 : 0].Find(Struct))
+	{
+		const FSCStructPlan* Plan = *Existing;
+		bool bStale = Plan->Struct.Get() != Struct;
+#if WITH_EDITOR
+		//Blueprint structs are recompiled in place
+		bStale |= Plan->StructureSize != Struct->GetStructureSize() || Plan->PropertyLink != Struct->PropertyLink;
+#endif
+		if (!bStale)
+		{
+			return Plan;
+		}
+
+		//Plans of other structs may point at the stale plan, so every plan is compiled again
+		Cache.Plans[0].Empty();
+		Cache.Plans[1].Empty();
+	}
+
+	//Registered before compiling so structs which contain themselves (through arrays or maps) find their own plan
+	FSCStructPlan* Plan = new FSCStructPlan(Struct, bTrimKeys);
+	Cache.Owned.Add(TUniquePtr<FSCStructPlan>(Plan));
+	Cache.Plans[bTrimKeys ? 1 : 0].Add(Struct, Plan);
+	Plan->Compile();
+	return Plan;
+}
+
+void FSCStructPlan::Compile()
+{
+	UStruct* StructPtr = Struct.Get();
+	for (TFieldIterator<UProperty> It(StructPtr); It; ++It)
+	{
+		int32 Index = Entries.AddDefaulted();
+		FEntry& Entry = Entries[Index];
+		Entry.Property = *It;
+
+		Entry.LongKey = FJsonObjectConverter::StandardizeCase(It->GetName());
+		if (!bTrimKeys || !USCJsonConvert::TrimKey(Entry.LongKey, Entry.Key))
+		{
+			Entry.Key = Entry.LongKey;
+		}
+
+		FTCHARToUTF8 KeyUtf8(*Entry.Key);
+		Entry.KeyUtf8.Append(KeyUtf8.Get(), KeyUtf8.Length());
+		FTCHARToUTF8 LongKeyUtf8(*Entry.LongKey);
+		Entry.LongKeyUtf8.Append(LongKeyUtf8.Get(), LongKeyUtf8.Length());
+
+		FSCByteWriter PrefixWriter(Entry.KeyPrefix);
+		WriteJsonString(Entry.Key, PrefixWriter);
+		PrefixWriter.write(':');
+
+		ClassifyEntry(Entry);
+
+		KeyIndex.Add(Entry.Key, Index);
+		if (!Entry.LongKey.Equals(Entry.Key, ESearchCase::CaseSensitive))
+		{
+			KeyIndex.Add(Entry.LongKey, Index);
+		}
+	}
+}
+
+TSharedPtr<FSCStructPlan::FEntry> FSCStructPlan::MakeEntry(UProperty* Property) const
+{
+	TSharedPtr<FEntry> Entry = MakeShareable(new FEntry);
+	Entry->Property = Property;
+	ClassifyEntry(*Entry);
+	return Entry;
+}
+
+void FSCStructPlan::ClassifyEntry(FEntry& Entry) const
+{
+	UProperty* Property = Entry.Property;
+	Entry.Kind = ESCStructPlanKind::Other;
+
+	//Static arrays are left to FJsonObjectConverter
+	if (Property->ArrayDim != 1)
+	{
+		return;
+	}
+
+	if (Property->IsA<UBoolProperty>())
+	{
+		Entry.Kind = ESCStructPlanKind::Bool;
+	}
+	else if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+	{
+		if (EnumProperty->GetEnum() != nullptr)
+		{
+			Entry.Kind = ESCStructPlanKind::Enum;
+			Entry.Enum = EnumProperty->GetEnum();
+			Entry.Numeric = EnumProperty->GetUnderlyingProperty();
+		}
+	}
+	else if (UNumericProperty* NumericProperty = Cast<UNumericProperty>(Property))
+	{
+		UByteProperty* ByteProperty = Cast<UByteProperty>(Property);
+		Entry.Numeric = NumericProperty;
+		if (ByteProperty != nullptr && ByteProperty->Enum != nullptr)
+		{
+			Entry.Kind = ESCStructPlanKind::Enum;
+			Entry.Enum = ByteProperty->Enum;
+		}
+		else if (NumericProperty->IsFloatingPoint())
+		{
+			Entry.Kind = ESCStructPlanKind::Float;
+		}
+		else if (ByteProperty != nullptr || Property->IsA<UUInt16Property>() || Property->IsA<UUInt32Property>() || Property->IsA<UUInt64Property>())
+		{
+			Entry.Kind = ESCStructPlanKind::Unsigned;
+		}
+		else
+		{
+			Entry.Kind = ESCStructPlanKind::Integer;
+		}
+	}
+	else if (Property->IsA<UStrProperty>())
+	{
+		Entry.Kind = ESCStructPlanKind::String;
+	}
+	else if (Property->IsA<UNameProperty>())
+	{
+		Entry.Kind = ESCStructPlanKind::Name;
+	}
+	else if (Property->IsA<UTextProperty>())
+	{
+		Entry.Kind = ESCStructPlanKind::Text;
+	}
+	else if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	{
+		//FJsonObjectConverter exports structs with ExportTextItem as strings
+		UScriptStruct::ICppStructOps* CppStructOps = StructProperty->Struct->GetCppStructOps();
+		if (StructProperty->Struct != FJsonObjectWrapper::StaticStruct() && !(CppStructOps != nullptr && CppStructOps->HasExportTextItem()))
+		{
+			Entry.Kind = ESCStructPlanKind::Struct;
+			Entry.SubPlan = Get(StructProperty->Struct, bTrimKeys);
+		}
+	}
+	else if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		Entry.Kind = ESCStructPlanKind::Array;
+		Entry.Inner = MakeEntry(ArrayProperty->Inner);
+	}
+	else if (USetProperty* SetProperty = Cast<USetProperty>(Property))
+	{
+		Entry.Kind = ESCStructPlanKind::Set;
+		Entry.Inner = MakeEntry(SetProperty->ElementProp);
+	}
+	else if (UMapProperty* MapProperty = Cast<UMapProperty>(Property))
+	{
+		//Only keys with an obvious string form, the rest go through ExportText in FJsonObjectConverter
+		TSharedPtr<FEntry> MapKey = MakeEntry(MapProperty->KeyProp);
+		switch (MapKey->Kind)
+		{
+		case ESCStructPlanKind::String:
+		case ESCStructPlanKind::Name:
+		case ESCStructPlanKind::Enum:
+		case ESCStructPlanKind::Integer:
+		case ESCStructPlanKind::Unsigned:
+			Entry.Kind = ESCStructPlanKind::Map;
+			Entry.MapKey = MapKey;
+			Entry.Inner = MakeEntry(MapProperty->ValueProp);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+const FSCStructPlan::FEntry* FSCStructPlan::FindEntry(const ANSICHAR* Key, int32 KeyLength, int32& Hint) const
+{
+	const int32 Num = Entries.Num();
+	for (int32 Offset = 0; Offset < Num; Offset++)
+	{
+		//Fields usually arrive in declaration order, so start at the entry after the last match
+		const int32 Index = (Hint + Offset) % Num;
+		const FEntry& Entry = Entries[Index];
+		if ((Entry.KeyUtf8.Num() == KeyLength && FMemory::Memcmp(Entry.KeyUtf8.GetData(), Key, KeyLength) == 0)
+			|| (Entry.LongKeyUtf8.Num() == KeyLength && FMemory::Memcmp(Entry.LongKeyUtf8.GetData(), Key, KeyLength) == 0))
+		{
+			Hint = Index + 1;
+			return &Entry;
+		}
+	}
+
+	//FJsonObjectConverter matches keys ignoring case, only look for that once the exact match missed
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		const FEntry& Entry = Entries[Index];
+		if ((Entry.KeyUtf8.Num() == KeyLength && FCStringAnsi::Strnicmp(Entry.KeyUtf8.GetData(), Key, KeyLength) == 0)
+			|| (Entry.LongKeyUtf8.Num() == KeyLength && FCStringAnsi::Strnicmp(Entry.LongKeyUtf8.GetData(), Key, KeyLength) == 0))
+		{
+			Hint = Index + 1;
+			return &Entry;
+		}
+	}
+	return nullptr;
+}
+
+const FSCStructPlan::FEntry* FSCStructPlan::FindEntry(const TCHAR* Key, int32 KeyLength, int32& Hint) const
+{
+	const int32 Num = Entries.Num();
+	for (int32 Offset = 0; Offset < Num; Offset++)
+	{
+		const int32 Index = (Hint + Offset) % Num;
+		const FEntry& Entry = Entries[Index];
+		if ((Entry.Key.Len() == KeyLength && FCString::Strncmp(*Entry.Key, Key, KeyLength) == 0)
+			|| (Entry.LongKey.Len() == KeyLength && FCString::Strncmp(*Entry.LongKey, Key, KeyLength) == 0))
+		{
+			Hint = Index + 1;
+			return &Entry;
+		}
+	}
+
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		const FEntry& Entry = Entries[Index];
+		if ((Entry.Key.Len() == KeyLength && FCString::Strnicmp(*Entry.Key, Key, KeyLength) == 0)
+			|| (Entry.LongKey.Len() == KeyLength && FCString::Strnicmp(*Entry.LongKey, Key, KeyLength) == 0))
+		{
+			Hint = Index + 1;
+			return &Entry;
+		}
+	}
+	return nullptr;
+}
+
+const FSCStructPlan::FEntry* FSCStructPlan::FindEntry(const FString& Key) const
+{
+	const int32* Index = KeyIndex.Find(Key);
+	return Index != nullptr ? &Entries[*Index] : nullptr;
+}
+
+void FSCStructPlan::Write(const void* StructPtr, FSCByteWriter& Writer) const
+{
+	Writer.write('{');
+	for (int32 i = 0; i < Entries.Num(); i++)
+	{
+		const FEntry& Entry = Entries[i];
+		if (i > 0)
+		{
+			Writer.write(',');
+		}
+		Writer.write(Entry.KeyPrefix.GetData(), Entry.KeyPrefix.Num());
+		WriteValue(Entry, Entry.Property->ContainerPtrToValuePtr<void>(StructPtr), Writer);
+	}
+	Writer.write('}');
+}
+
+void FSCStructPlan::WriteValue(const FEntry& Entry, const void* ValuePtr, FSCByteWriter& Writer)
+{
+	switch (Entry.Kind)
+	{
+	case ESCStructPlanKind::Bool:
+		if (CastChecked<UBoolProperty>(Entry.Property)->GetPropertyValue(ValuePtr))
+		{
+			Writer.write("true", 4);
+		}
+		else
+		{
+			Writer.write("false", 5);
+		}
+		break;
+	case ESCStructPlanKind::Integer:
+	{
+		ANSICHAR Buffer[32];
+		int32 Length = FCStringAnsi::Sprintf(Buffer, "%lld", (long long)Entry.Numeric->GetSignedIntPropertyValue(ValuePtr));
+		Writer.write(Buffer, Length);
+	}
+	break;
+	case ESCStructPlanKind::Unsigned:
+	{
+		ANSICHAR Buffer[32];
+		int32 Length = FCStringAnsi::Sprintf(Buffer, "%llu", (unsigned long long)Entry.Numeric->GetUnsignedIntPropertyValue(ValuePtr));
+		Writer.write(Buffer, Length);
+	}
+	break;
+	case ESCStructPlanKind::Float:
+		WriteJsonNumber(Entry.Numeric->GetFloatingPointPropertyValue(ValuePtr), Writer);
+		break;
+	case ESCStructPlanKind::Enum:
+		WriteJsonString(Entry.Enum->GetNameStringByValue(Entry.Numeric->GetSignedIntPropertyValue(ValuePtr)), Writer);
+		break;
+	case ESCStructPlanKind::String:
+		WriteJsonString(*(const FString*)ValuePtr, Writer);
+		break;
+	case ESCStructPlanKind::Name:
+		WriteJsonString(((const FName*)ValuePtr)->ToString(), Writer);
+		break;
+	case ESCStructPlanKind::Text:
+		WriteJsonString(((const FText*)ValuePtr)->ToString(), Writer);
+		break;
+	case ESCStructPlanKind::Struct:
+		Entry.SubPlan->Write(ValuePtr, Writer);
+		break;
+	case ESCStructPlanKind::Array:
+	{
+		FScriptArrayHelper Helper(CastChecked<UArrayProperty>(Entry.Property), ValuePtr);
+		Writer.write('[');
+		for (int32 i = 0; i < Helper.Num(); i++)
+		{
+			if (i > 0)
+			{
+				Writer.write(',');
+			}
+			WriteValue(*Entry.Inner, Helper.GetRawPtr(i), Writer);
+		}
+		Writer.write(']');
+	}
+	break;
+	case ESCStructPlanKind::Set:
+	{
+		FScriptSetHelper Helper(CastChecked<USetProperty>(Entry.Property), ValuePtr);
+		Writer.write('[');
+		bool bFirst = true;
+		for (int32 i = 0, Remaining = Helper.Num(); Remaining > 0; i++)
+		{
+			if (Helper.IsValidIndex(i))
+			{
+				if (!bFirst)
+				{
+					Writer.write(',');
+				}
+				bFirst = false;
+				WriteValue(*Entry.Inner, Helper.GetElementPtr(i), Writer);
+				--Remaining;
+			}
+		}
+		Writer.write(']');
+	}
+	break;
+	case ESCStructPlanKind::Map:
+	{
+		FScriptMapHelper Helper(CastChecked<UMapProperty>(Entry.Property), ValuePtr);
+		Writer.write('{');
+		bool bFirst = true;
+		for (int32 i = 0, Remaining = Helper.Num(); Remaining > 0; i++)
+		{
+			if (Helper.IsValidIndex(i))
+			{
+				if (!bFirst)
+				{
+					Writer.write(',');
+				}
+				bFirst = false;
+				WriteJsonString(GetKeyString(*Entry.MapKey, Helper.GetKeyPtr(i)), Writer);
+				Writer.write(':');
+				WriteValue(*Entry.Inner, Helper.GetValuePtr(i), Writer);
+				--Remaining;
+			}
+		}
+		Writer.write('}');
+	}
+	break;
+	case ESCStructPlanKind::Other:
+	default:
+		WriteJsonValue(FJsonObjectConverter::UPropertyToJsonValue(Entry.Property, ValuePtr, 0, 0), Writer);
+		break;
+	}
+}
+
+void FSCStructPlan::WriteJsonValue(const TSharedPtr<FJsonValue>& JsonValue, FSCByteWriter& Writer)
+{
+	if (!JsonValue.IsValid())
+	{
+		Writer.write("null", 4);
+		return;
+	}
+
+	switch (JsonValue->Type)
+	{
+	case EJson::Boolean:
+		if (JsonValue->AsBool())
+		{
+			Writer.write("true", 4);
+		}
+		else
+		{
+			Writer.write("false", 5);
+		}
+		break;
+	case EJson::Number:
+		WriteJsonNumber(JsonValue->AsNumber(), Writer);
+		break;
+	case EJson::String:
+		if (FJsonValueBinary::IsBinary(JsonValue))
+		{
+			WriteJsonBinary(StaticCastSharedPtr<FJsonValueBinary>(JsonValue)->GetBinary(), Writer);
+		}
+		else
+		{
+			WriteJsonString(JsonValue->AsString(), Writer);
+		}
+		break;
+	case EJson::Array:
+		if (const TArray<double>* Numbers = FJsonValueNumberArray::AsNumberArray(JsonValue))
+		{
+			WriteJsonNumberArray(*Numbers, Writer);
+		}
+		else
+		{
+			WriteJsonArray(JsonValue->AsArray(), Writer);
+		}
+		break;
+	case EJson::Object:
+		if (const FJsonValueStruct* StructValue = FJsonValueStruct::AsStruct(JsonValue.Get()))
+		{
+			StructValue->GetPlan()->Write(StructValue->GetStructMemory(), Writer);
+		}
+		else
+		{
+			WriteJsonObject(JsonValue->AsObject(), Writer);
+		}
+		break;
+	case EJson::None:
+	case EJson::Null:
+	default:
+		Writer.write("null", 4);
+		break;
+	}
+}
+
+void FSCStructPlan::WriteJsonArray(const TArray<TSharedPtr<FJsonValue>>& Array, FSCByteWriter& Writer)
+{
+	Writer.write('[');
+	for (int32 i = 0; i < Array.Num(); i++)
+	{
+		if (i > 0)
+		{
+			Writer.write(',');
+		}
+		WriteJsonValue(Array[i], Writer);
+	}
+	Writer.write(']');
+}
+
+void FSCStructPlan::WriteJsonNumberArray(const TArray<double>& Numbers, FSCByteWriter& Writer)
+{
+	Writer.reserve(Numbers.Num() * 8 + 2);
+	Writer.write('[');
+	ANSICHAR Buffer[FSCJsonNumber::MaxLength + 1];
+	for (int32 i = 0; i < Numbers.Num(); i++)
+	{
+		int32 Length = 0;
+		if (i > 0)
+		{
+			Buffer[Length++] = ',';
+		}
+		Length += FSCJsonNumber::Format(Numbers[i], Buffer + Length);
+		Writer.write(Buffer, Length);
+	}
+	Writer.write(']');
+}
+
+void FSCStructPlan::WriteJsonObject(const TSharedPtr<FJsonObject>& Object, FSCByteWriter& Writer)
+{
+	Writer.write('{');
+	if (Object.IsValid())
+	{
+		bool bFirst = true;
+		for (const auto& Pair : Object->Values)
+		{
+			if (!bFirst)
+			{
+				Writer.write(',');
+			}
+			bFirst = false;
+			WriteJsonString(Pair.Key, Writer);
+			Writer.write(':');
+			WriteJsonValue(Pair.Value, Writer);
+		}
+	}
+	Writer.write('}');
+}
+
+void FSCStructPlan::WriteJsonString(const FString& Value, FSCByteWriter& Writer)
+{
+	static const ANSICHAR Hex[] = "0123456789abcdef";
+
+	FTCHARToUTF8 Converted(*Value, Value.Len());
+	SC_ACCOUNT_TRANSCODE(Converted.Length());
+	const uint8* Data = (const uint8*)Converted.Get();
+	const int32 Length = Converted.Length();
+
+	Writer.reserve(Length + 2);
+	Writer.write('"');
+	int32 RunStart = 0;
+	for (int32 i = 0; i < Length; i++)
+	{
+		const uint8 Char = Data[i];
+		if (Char >= 0x20 && Char != '"' && Char != '\\')
+		{
+			continue;
+		}
+
+		Writer.write(Data + RunStart, i - RunStart);
+		RunStart = i + 1;
+		Writer.write('\\');
+		switch (Char)
+		{
+		case '"': Writer.write('"'); break;
+		case '\\': Writer.write('\\'); break;
+		case '\b': Writer.write('b'); break;
+		case '\f': Writer.write('f'); break;
+		case '\n': Writer.write('n'); break;
+		case '\r': Writer.write('r'); break;
+		case '\t': Writer.write('t'); break;
+		default:
+			Writer.write("u00", 3);
+			Writer.write(Hex[Char >> 4]);
+			Writer.write(Hex[Char & 0xf]);
+			break;
+		}
+	}
+	Writer.write(Data + RunStart, Length - RunStart);
+	Writer.write('"');
+}
+
+void FSCStructPlan::WriteJsonBinary(TArrayView<const uint8> Bytes, FSCByteWriter& Writer)
+{
+	//the base64 alphabet needs no escaping
+	const int32 Length = FSCBase64::GetEncodedLength(Bytes.Num());
+	uint8* Out = Writer.writeUninitialized(Length + 2);
+	Out[0] = '"';
+	FSCBase64::Encode(Bytes.GetData(), Bytes.Num(), (ANSICHAR*)Out + 1);
+	Out[Length + 1] = '"';
+}
+
+void FSCStructPlan::WriteJsonNumber(double Value, FSCByteWriter& Writer)
+{
+	ANSICHAR Buffer[FSCJsonNumber::MaxLength];
+	Writer.write(Buffer, FSCJsonNumber::Format(Value, Buffer));
+}
+
+bool FSCStructPlan::Read(TArrayView<const uint8> Bytes, void* StructPtr) const
+{
+	FSCJsonByteReader Reader(Bytes.GetData(), Bytes.Num());
+	return ReadObject(Reader, StructPtr);
+}
+
+bool FSCStructPlan::ReadObject(FSCJsonByteReader& Reader, void* StructPtr) const
+{
+	if (!Reader.Consume('{') || ++Reader.Depth > SCJsonMaxDepth)
+	{
+		return false;
+	}
+
+	if (!Reader.Consume('}'))
+	{
+		int32 Hint = 0;
+		do
+		{
+			if (!Reader.ReadRawString())
+			{
+				return false;
+			}
+			const FEntry* Entry = FindEntry(Reader.Scratch.GetData(), Reader.Scratch.Num(), Hint);
+			if (!Reader.Consume(':'))
+			{
+				return false;
+			}
+
+			if (Entry != nullptr)
+			{
+				if (!ReadValue(*Entry, Reader, Entry->Property->ContainerPtrToValuePtr<void>(StructPtr)))
+				{
+					return false;
+				}
+			}
+			else if (!Reader.SkipValue())
+			{
+				return false;
+			}
+		} while (Reader.Consume(','));
+
+		if (!Reader.Consume('}'))
+		{
+			return false;
+		}
+	}
+
+	--Reader.Depth;
+	return true;
+}
+
+bool FSCStructPlan::ReadValue(const FEntry& Entry, FSCJsonByteReader& Reader, void* ValuePtr)
+{
+	const uint8 Next = Reader.Peek();
+
+	//Null keeps the current value
+	if (Next == 'n')
+	{
+		return Reader.ConsumeLiteral("null", 4);
+	}
+
+	const bool bNumber = Next == '-' || (Next >= '0' && Next <= '9');
+
+	switch (Entry.Kind)
+	{
+	case ESCStructPlanKind::Bool:
+		if (Next == 't' || Next == 'f')
+		{
+			const bool bValue = Next == 't';
+			if (!(bValue ? Reader.ConsumeLiteral("true", 4) : Reader.ConsumeLiteral("false", 5)))
+			{
+				return false;
+			}
+			CastChecked<UBoolProperty>(Entry.Property)->SetPropertyValue(ValuePtr, bValue);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Integer:
+	case ESCStructPlanKind::Unsigned:
+	case ESCStructPlanKind::Float:
+		if (bNumber)
+		{
+			ANSICHAR Buffer[64];
+			bool bIsInteger;
+			if (!Reader.ReadNumberText(Buffer, 64, bIsInteger))
+			{
+				return false;
+			}
+
+			//Integers are parsed as integers so 64 bit values keep their precision
+			if (Entry.Kind == ESCStructPlanKind::Float)
+			{
+				Entry.Numeric->SetFloatingPointPropertyValue(ValuePtr, FCStringAnsi::Atod(Buffer));
+			}
+			else if (!bIsInteger)
+			{
+				Entry.Numeric->SetIntPropertyValue(ValuePtr, (int64)FCStringAnsi::Atod(Buffer));
+			}
+			else if (Entry.Kind == ESCStructPlanKind::Unsigned && Buffer[0] != '-')
+			{
+				Entry.Numeric->SetIntPropertyValue(ValuePtr, (uint64)FCStringAnsi::Strtoui64(Buffer, nullptr, 10));
+			}
+			else
+			{
+				Entry.Numeric->SetIntPropertyValue(ValuePtr, (int64)FCStringAnsi::Atoi64(Buffer));
+			}
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Enum:
+		if (Next == '"')
+		{
+			FString Name;
+			if (!Reader.ReadString(Name))
+			{
+				return false;
+			}
+			const int64 Value = Entry.Enum->GetValueByNameString(Name);
+			if (Value == INDEX_NONE)
+			{
+				return false;
+			}
+			Entry.Numeric->SetIntPropertyValue(ValuePtr, Value);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::String:
+		if (Next == '"')
+		{
+			return Reader.ReadString(*(FString*)ValuePtr);
+		}
+		break;
+	case ESCStructPlanKind::Name:
+		if (Next == '"')
+		{
+			FString Value;
+			if (!Reader.ReadString(Value))
+			{
+				return false;
+			}
+			*(FName*)ValuePtr = FName(*Value);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Text:
+		if (Next == '"')
+		{
+			FString Value;
+			if (!Reader.ReadString(Value))
+			{
+				return false;
+			}
+			*(FText*)ValuePtr = FText::FromString(Value);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Struct:
+		if (Next == '{')
+		{
+			return Entry.SubPlan->ReadObject(Reader, ValuePtr);
+		}
+		break;
+	case ESCStructPlanKind::Array:
+		if (Next == '[')
+		{
+			FScriptArrayHelper Helper(CastChecked<UArrayProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyValues();
+			Reader.Consume('[');
+			if (++Reader.Depth > SCJsonMaxDepth)
+			{
+				return false;
+			}
+			if (!Reader.Consume(']'))
+			{
+				do
+				{
+					const int32 Index = Helper.AddValue();
+					if (!ReadValue(*Entry.Inner, Reader, Helper.GetRawPtr(Index)))
+					{
+						return false;
+					}
+				} while (Reader.Consume(','));
+				if (!Reader.Consume(']'))
+				{
+					return false;
+				}
+			}
+			--Reader.Depth;
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Set:
+		if (Next == '[')
+		{
+			FScriptSetHelper Helper(CastChecked<USetProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyElements();
+			Reader.Consume('[');
+			if (++Reader.Depth > SCJsonMaxDepth)
+			{
+				return false;
+			}
+			bool bSuccess = true;
+			if (!Reader.Consume(']'))
+			{
+				do
+				{
+					const int32 Index = Helper.AddDefaultValue_Invalid_NeedsRehash();
+					bSuccess = ReadValue(*Entry.Inner, Reader, Helper.GetElementPtr(Index));
+				} while (bSuccess && Reader.Consume(','));
+				bSuccess = bSuccess && Reader.Consume(']');
+			}
+			Helper.Rehash();
+			--Reader.Depth;
+			return bSuccess;
+		}
+		break;
+	case ESCStructPlanKind::Map:
+		if (Next == '{')
+		{
+			FScriptMapHelper Helper(CastChecked<UMapProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyValues();
+			Reader.Consume('{');
+			if (++Reader.Depth > SCJsonMaxDepth)
+			{
+				return false;
+			}
+			bool bSuccess = true;
+			if (!Reader.Consume('}'))
+			{
+				do
+				{
+					FString Key;
+					if (!Reader.ReadString(Key) || !Reader.Consume(':'))
+					{
+						bSuccess = false;
+						break;
+					}
+					const int32 Index = Helper.AddDefaultValue_Invalid_NeedsRehash();
+					bSuccess = SetKeyFromString(*Entry.MapKey, Key, Helper.GetKeyPtr(Index)) && ReadValue(*Entry.Inner, Reader, Helper.GetValuePtr(Index));
+				} while (bSuccess && Reader.Consume(','));
+				bSuccess = bSuccess && Reader.Consume('}');
+			}
+			Helper.Rehash();
+			--Reader.Depth;
+			return bSuccess;
+		}
+		break;
+	case ESCStructPlanKind::Other:
+	default:
+		break;
+	}
+
+	//Unexpected JSON types and Other entries get FJsonObjectConverter's conversion rules
+	TSharedPtr<FJsonValue> JsonValue = Reader.ReadJsonValue();
+	return JsonValue.IsValid() && FromJsonValue(Entry, JsonValue, ValuePtr);
+}
+
+bool FSCStructPlan::Read(const FSCJsonNode& Node, void* StructPtr) const
+{
+	if (!Node.IsObject())
+	{
+		return false;
+	}
+
+	bool bSuccess = true;
+	int32 Hint = 0;
+	for (int32 i = 0; i < Node.Num(); i++)
+	{
+		const FSCJsonMember& Member = Node.GetMember(i);
+		const FEntry* Entry = FindEntry(Member.Key, Member.KeyLength, Hint);
+		if (Entry != nullptr && !ReadNodeValue(*Entry, Member.Value, Entry->Property->ContainerPtrToValuePtr<void>(StructPtr)))
+		{
+			bSuccess = false;
+		}
+	}
+	return bSuccess;
+}
+
+bool FSCStructPlan::ReadNodeValue(const FEntry& Entry, const FSCJsonNode& Node, void* ValuePtr)
+{
+	//Null keeps the current value
+	if (Node.IsNull())
+	{
+		return true;
+	}
+
+	switch (Entry.Kind)
+	{
+	case ESCStructPlanKind::Bool:
+		if (Node.IsBool())
+		{
+			CastChecked<UBoolProperty>(Entry.Property)->SetPropertyValue(ValuePtr, Node.AsBool());
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Integer:
+		if (Node.IsNumber())
+		{
+			Entry.Numeric->SetIntPropertyValue(ValuePtr, (int64)Node.Number);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Unsigned:
+		if (Node.IsNumber())
+		{
+			if (Node.Number < 0.0)
+			{
+				Entry.Numeric->SetIntPropertyValue(ValuePtr, (int64)Node.Number);
+			}
+			else
+			{
+				Entry.Numeric->SetIntPropertyValue(ValuePtr, (uint64)Node.Number);
+			}
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Float:
+		if (Node.IsNumber())
+		{
+			Entry.Numeric->SetFloatingPointPropertyValue(ValuePtr, Node.Number);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Enum:
+		if (Node.IsString())
+		{
+			const int64 Value = Entry.Enum->GetValueByNameString(FString(Node.Length, Node.String));
+			if (Value == INDEX_NONE)
+			{
+				return false;
+			}
+			Entry.Numeric->SetIntPropertyValue(ValuePtr, Value);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::String:
+		if (Node.IsString())
+		{
+			*(FString*)ValuePtr = FString(Node.Length, Node.String);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Name:
+		if (Node.IsString())
+		{
+			*(FName*)ValuePtr = FName(Node.String);
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Text:
+		if (Node.IsString())
+		{
+			*(FText*)ValuePtr = FText::FromString(FString(Node.Length, Node.String));
+			return true;
+		}
+		break;
+	case ESCStructPlanKind::Struct:
+		if (Node.IsObject())
+		{
+			return Entry.SubPlan->Read(Node, ValuePtr);
+		}
+		break;
+	case ESCStructPlanKind::Array:
+		if (Node.IsArray())
+		{
+			FScriptArrayHelper Helper(CastChecked<UArrayProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyValues();
+			Helper.AddValues(Node.Num());
+			bool bSuccess = true;
+			for (int32 i = 0; i < Node.Num(); i++)
+			{
+				bSuccess &= ReadNodeValue(*Entry.Inner, Node[i], Helper.GetRawPtr(i));
+			}
+			return bSuccess;
+		}
+		break;
+	case ESCStructPlanKind::Set:
+		if (Node.IsArray())
+		{
+			FScriptSetHelper Helper(CastChecked<USetProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyElements();
+			bool bSuccess = true;
+			for (int32 i = 0; i < Node.Num(); i++)
+			{
+				const int32 Index = Helper.AddDefaultValue_Invalid_NeedsRehash();
+				bSuccess &= ReadNodeValue(*Entry.Inner, Node[i], Helper.GetElementPtr(Index));
+			}
+			Helper.Rehash();
+			return bSuccess;
+		}
+		break;
+	case ESCStructPlanKind::Map:
+		if (Node.IsObject())
+		{
+			FScriptMapHelper Helper(CastChecked<UMapProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyValues();
+			bool bSuccess = true;
+			for (int32 i = 0; i < Node.Num(); i++)
+			{
+				const FSCJsonMember& Member = Node.GetMember(i);
+				const int32 Index = Helper.AddDefaultValue_Invalid_NeedsRehash();
+				bSuccess &= SetKeyFromString(*Entry.MapKey, FString(Member.KeyLength, Member.Key), Helper.GetKeyPtr(Index));
+				bSuccess &= ReadNodeValue(*Entry.Inner, Member.Value, Helper.GetValuePtr(Index));
+			}
+			Helper.Rehash();
+			return bSuccess;
+		}
+		break;
+	default:
+		break;
+	}
+
+	//Unexpected JSON types and Other entries get FJsonObjectConverter's conversion rules
+	return FromJsonValue(Entry, Node.ToJsonValue(), ValuePtr);
+}
+
+TSharedPtr<FJsonObject> FSCStructPlan::ToJsonObject(const void* StructPtr) const
+{
+	TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
+	for (const FEntry& Entry : Entries)
+	{
+		TSharedPtr<FJsonValue> JsonValue = ToJsonValue(Entry, Entry.Property->ContainerPtrToValuePtr<void>(StructPtr));
+		if (JsonValue.IsValid())
+		{
+			JsonObject->SetField(Entry.Key, JsonValue);
+		}
+	}
+	return JsonObject;
+}
+
+TSharedPtr<FJsonValue> FSCStructPlan::ToJsonValue(const FEntry& Entry, const void* ValuePtr)
+{
+	switch (Entry.Kind)
+	{
+	case ESCStructPlanKind::Struct:
+		return MakeShareable(new FJsonValueObject(Entry.SubPlan->ToJsonObject(ValuePtr)));
+	case ESCStructPlanKind::Array:
+	{
+		FScriptArrayHelper Helper(CastChecked<UArrayProperty>(Entry.Property), ValuePtr);
+		TArray<TSharedPtr<FJsonValue>> Array;
+		Array.Reserve(Helper.Num());
+		for (int32 i = 0; i < Helper.Num(); i++)
+		{
+			Array.Add(ToJsonValue(*Entry.Inner, Helper.GetRawPtr(i)));
+		}
+		return MakeShareable(new FJsonValueArray(Array));
+	}
+	case ESCStructPlanKind::Set:
+	{
+		FScriptSetHelper Helper(CastChecked<USetProperty>(Entry.Property), ValuePtr);
+		TArray<TSharedPtr<FJsonValue>> Array;
+		Array.Reserve(Helper.Num());
+		for (int32 i = 0, Remaining = Helper.Num(); Remaining > 0; i++)
+		{
+			if (Helper.IsValidIndex(i))
+			{
+				Array.Add(ToJsonValue(*Entry.Inner, Helper.GetElementPtr(i)));
+				--Remaining;
+			}
+		}
+		return MakeShareable(new FJsonValueArray(Array));
+	}
+	case ESCStructPlanKind::Map:
+	{
+		FScriptMapHelper Helper(CastChecked<UMapProperty>(Entry.Property), ValuePtr);
+		TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject);
+		for (int32 i = 0, Remaining = Helper.Num(); Remaining > 0; i++)
+		{
+			if (Helper.IsValidIndex(i))
+			{
+				Object->SetField(GetKeyString(*Entry.MapKey, Helper.GetKeyPtr(i)), ToJsonValue(*Entry.Inner, Helper.GetValuePtr(i)));
+				--Remaining;
+			}
+		}
+		return MakeShareable(new FJsonValueObject(Object));
+	}
+	default:
+		return FJsonObjectConverter::UPropertyToJsonValue(Entry.Property, ValuePtr, 0, 0);
+	}
+}
+
+bool FSCStructPlan::FromJsonObject(const TSharedPtr<FJsonObject>& JsonObject, void* StructPtr) const
+{
+	if (!JsonObject.IsValid())
+	{
+		return false;
+	}
+
+	bool bSuccess = true;
+	for (const auto& Pair : JsonObject->Values)
+	{
+		const FEntry* Entry = FindEntry(Pair.Key);
+		if (Entry != nullptr && !FromJsonValue(*Entry, Pair.Value, Entry->Property->ContainerPtrToValuePtr<void>(StructPtr)))
+		{
+			bSuccess = false;
+		}
+	}
+	return bSuccess;
+}
+
+bool FSCStructPlan::FromJsonValue(const FEntry& Entry, const TSharedPtr<FJsonValue>& JsonValue, void* ValuePtr)
+{
+	if (!JsonValue.IsValid() || JsonValue->IsNull())
+	{
+		return true;
+	}
+
+	switch (Entry.Kind)
+	{
+	case ESCStructPlanKind::Struct:
+		if (JsonValue->Type == EJson::Object)
+		{
+			return Entry.SubPlan->FromJsonObject(JsonValue->AsObject(), ValuePtr);
+		}
+		break;
+	case ESCStructPlanKind::Array:
+		if (JsonValue->Type == EJson::Array)
+		{
+			const TArray<TSharedPtr<FJsonValue>>& Array = JsonValue->AsArray();
+			FScriptArrayHelper Helper(CastChecked<UArrayProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyValues();
+			Helper.AddValues(Array.Num());
+			bool bSuccess = true;
+			for (int32 i = 0; i < Array.Num(); i++)
+			{
+				bSuccess &= FromJsonValue(*Entry.Inner, Array[i], Helper.GetRawPtr(i));
+			}
+			return bSuccess;
+		}
+		break;
+	case ESCStructPlanKind::Set:
+		if (JsonValue->Type == EJson::Array)
+		{
+			FScriptSetHelper Helper(CastChecked<USetProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyElements();
+			bool bSuccess = true;
+			for (const TSharedPtr<FJsonValue>& Item : JsonValue->AsArray())
+			{
+				const int32 Index = Helper.AddDefaultValue_Invalid_NeedsRehash();
+				bSuccess &= FromJsonValue(*Entry.Inner, Item, Helper.GetElementPtr(Index));
+			}
+			Helper.Rehash();
+			return bSuccess;
+		}
+		break;
+	case ESCStructPlanKind::Map:
+		if (JsonValue->Type == EJson::Object && JsonValue->AsObject().IsValid())
+		{
+			FScriptMapHelper Helper(CastChecked<UMapProperty>(Entry.Property), ValuePtr);
+			Helper.EmptyValues();
+			bool bSuccess = true;
+			for (const auto& Pair : JsonValue->AsObject()->Values)
+			{
+				const int32 Index = Helper.AddDefaultValue_Invalid_NeedsRehash();
+				bSuccess &= SetKeyFromString(*Entry.MapKey, Pair.Key, Helper.GetKeyPtr(Index));
+				bSuccess &= FromJsonValue(*Entry.Inner, Pair.Value, Helper.GetValuePtr(Index));
+			}
+			Helper.Rehash();
+			return bSuccess;
+		}
+		break;
+	default:
+		break;
+	}
+
+	return FJsonObjectConverter::JsonValueToUProperty(JsonValue, Entry.Property, ValuePtr, 0, 0);
+}
+
+bool FSCStructPlan::SetKeyFromString(const FEntry& Entry, const FString& Key, void* KeyPtr)
+{
+	switch (Entry.Kind)
+	{
+	case ESCStructPlanKind::String:
+		*(FString*)KeyPtr = Key;
+		return true;
+	case ESCStructPlanKind::Name:
+		*(FName*)KeyPtr = FName(*Key);
+		return true;
+	case ESCStructPlanKind::Enum:
+	{
+		int64 Value = Entry.Enum->GetValueByNameString(Key);
+		if (Value == INDEX_NONE)
+		{
+			if (!Key.IsNumeric())
+			{
+				return false;
+			}
+			Value = FCString::Atoi64(*Key);
+		}
+		Entry.Numeric->SetIntPropertyValue(KeyPtr, Value);
+		return true;
+	}
+	case ESCStructPlanKind::Integer:
+		Entry.Numeric->SetIntPropertyValue(KeyPtr, (int64)FCString::Atoi64(*Key));
+		return true;
+	case ESCStructPlanKind::Unsigned:
+		Entry.Numeric->SetIntPropertyValue(KeyPtr, (uint64)FCString::Strtoui64(*Key, nullptr, 10));
+		return true;
+	default:
+		return false;
+	}
+}
+
+FString FSCStructPlan::GetKeyString(const FEntry& Entry, const void* KeyPtr)
+{
+	switch (Entry.Kind)
+	{
+	case ESCStructPlanKind::String:
+		return *(const FString*)KeyPtr;
+	case ESCStructPlanKind::Name:
+		return ((const FName*)KeyPtr)->ToString();
+	case ESCStructPlanKind::Enum:
+		return Entry.Enum->GetNameStringByValue(Entry.Numeric->GetSignedIntPropertyValue(KeyPtr));
+	case ESCStructPlanKind::Integer:
+		return FString::Printf(TEXT("%lld"), (long long)Entry.Numeric->GetSignedIntPropertyValue(KeyPtr));
+	case ESCStructPlanKind::Unsigned:
+		return FString::Printf(TEXT("%llu"), (unsigned long long)Entry.Numeric->GetUnsignedIntPropertyValue(KeyPtr));
+	default:
+		return FString();
+	}
+}
+
+FThreadSafeCounter FJsonValueStruct::NumAlive;
+
+FJsonValueStruct::FJsonValueStruct(const FSCStructPlan* InPlan, const void* InStructPtr)
+	: Plan(InPlan)
+	, StructPtr(InStructPtr)
+{
+	Type = EJson::Object;
+	NumAlive.Increment();
+}
+
+FJsonValueStruct::~FJsonValueStruct()
+{
+	NumAlive.Decrement();
+}
+
+bool FJsonValueStruct::TryGetObject(const TSharedPtr<FJsonObject>*& OutObject) const
+{
+	if (!Object.IsValid())
+	{
+		Object = Plan->ToJsonObject(StructPtr);
+	}
+	OutObject = &Object;
+	return true;
+}
+
+const FJsonValueStruct* FJsonValueStruct::AsStruct(const FJsonValue* InJsonValue)
+{
+	//Asking for the type name allocates, so plain objects are only checked while struct values exist
+	if (InJsonValue == nullptr || InJsonValue->Type != EJson::Object || NumAlive.GetValue() == 0)
+	{
+		return nullptr;
+	}
+	return SCGetJsonValueType(*InJsonValue).Equals(TEXT("Struct"), ESearchCase::CaseSensitive) ? static_cast<const FJsonValueStruct*>(InJsonValue) : nullptr;
+}
@@ -0,0 +1,174 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Base64.h"
+#include "Math/RandomStream.h"
+#include "SCBase64.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Longer than two of the largest SIMD blocks (64 characters for 48 bytes on NEON) plus the read ahead of the SSE loads */
+static const int32 SCBase64TestMaxSize = 2 * 48 + 24;
+
+/**
+ * The scalar path as reference: groups of 3 bytes or 4 characters are shorter than any SIMD block,
+ * so encoding and decoding them one at a time never leaves the scalar loop.
+ */
+static FString SCEncodeScalar(const TArray<uint8>& Bytes, ESCBase64 Alphabet)
+{
+	FString Result;
+	for (int32 i = 0; i < Bytes.Num(); i += 3)
+	{
+		Result += FSCBase64::Encode(TArrayView<const uint8>(Bytes.GetData() + i, FMath::Min(3, Bytes.Num() - i)), Alphabet);
+	}
+	return Result;
+}
+
+static bool SCDecodeScalar(const TArray<ANSICHAR>& Chars, TArray<uint8>& OutBytes, ESCBase64 Alphabet)
+{
+	OutBytes.Reset();
+	TArray<uint8> Group;
+	for (int32 i = 0; i < Chars.Num(); i += 4)
+	{
+		if (!FSCBase64::Decode(Chars.GetData() + i, FMath::Min(4, Chars.Num() - i), Group, Alphabet))
+		{
+			OutBytes.Reset();
+			return false;
+		}
+		OutBytes.Append(Group);
+	}
+	return true;
+}
+
+static TArray<ANSICHAR> SCToChars(const FString& String)
+{
+	TArray<ANSICHAR> Chars;
+	for (TCHAR Char : String.GetCharArray())
+	{
+		if (Char != 0)
+		{
+			Chars.Add((ANSICHAR)Char);
+		}
+	}
+	return Chars;
+}
+
+static TArray<uint8> SCRandomBytes(FRandomStream& Random, int32 Size)
+{
+	TArray<uint8> Bytes;
+	for (int32 i = 0; i < Size; i++)
+	{
+		Bytes.Add((uint8)Random.RandRange(0, 255));
+	}
+	return Bytes;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCBase64EncodeTest, "SocketCluster.Json.Base64.Encode", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCBase64EncodeTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0x5C64);
+	for (int32 Size = 0; Size <= SCBase64TestMaxSize; Size++)
+	{
+		const TArray<uint8> Bytes = SCRandomBytes(Random, Size);
+		const FString Standard = FSCBase64::Encode(Bytes, ESCBase64::Standard);
+		const FString Url = FSCBase64::Encode(Bytes, ESCBase64::Url);
+
+		TestEqual(FString::Printf(TEXT("Standard encoding of %d bytes matches the scalar path"), Size), Standard, SCEncodeScalar(Bytes, ESCBase64::Standard));
+		TestEqual(FString::Printf(TEXT("Url encoding of %d bytes matches the scalar path"), Size), Url, SCEncodeScalar(Bytes, ESCBase64::Url));
+		TestEqual(FString::Printf(TEXT("Standard encoding of %d bytes matches FBase64"), Size), Standard, FBase64::Encode(Bytes));
+		TestEqual(FString::Printf(TEXT("Standard length of %d bytes"), Size), Standard.Len(), FSCBase64::GetEncodedLength(Size, ESCBase64::Standard));
+		TestEqual(FString::Printf(TEXT("Url length of %d bytes"), Size), Url.Len(), FSCBase64::GetEncodedLength(Size, ESCBase64::Url));
+
+		// The url alphabet is the standard one with -_ for +/ and without padding
+		FString Expected = Standard.Replace(TEXT("+"), TEXT("-")).Replace(TEXT("/"), TEXT("_"));
+		Expected.RemoveFromEnd(TEXT("="));
+		Expected.RemoveFromEnd(TEXT("="));
+		TestEqual(FString::Printf(TEXT("Url alphabet of %d bytes"), Size), Url, Expected);
+	}
+
+	// Every character of both alphabets
+	TArray<uint8> All;
+	for (int32 i = 0; i < 64; i++)
+	{
+		const uint32 Group = i << 18 | i << 12 | i << 6 | i;
+		All.Add((uint8)(Group >> 16));
+		All.Add((uint8)(Group >> 8));
+		All.Add((uint8)Group);
+	}
+	TestEqual(TEXT("Every standard character"), FSCBase64::Encode(All, ESCBase64::Standard), SCEncodeScalar(All, ESCBase64::Standard));
+	TestEqual(TEXT("Every url character"), FSCBase64::Encode(All, ESCBase64::Url), SCEncodeScalar(All, ESCBase64::Url));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCBase64DecodeTest, "SocketCluster.Json.Base64.Decode", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCBase64DecodeTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0x5C65);
+	for (int32 Size = 0; Size <= SCBase64TestMaxSize; Size++)
+	{
+		const TArray<uint8> Bytes = SCRandomBytes(Random, Size);
+		for (ESCBase64 Alphabet : { ESCBase64::Standard, ESCBase64::Url })
+		{
+			const TCHAR* Name = Alphabet == ESCBase64::Standard ? TEXT("standard") : TEXT("url");
+			const TArray<ANSICHAR> Chars = SCToChars(FSCBase64::Encode(Bytes, Alphabet));
+
+			TArray<uint8> Decoded;
+			TArray<uint8> Scalar;
+			TestTrue(FString::Printf(TEXT("Decode %d %s bytes"), Size, Name), FSCBase64::Decode(Chars.GetData(), Chars.Num(), Decoded, Alphabet));
+			TestTrue(FString::Printf(TEXT("Scalar decode %d %s bytes"), Size, Name), SCDecodeScalar(Chars, Scalar, Alphabet));
+			TestTrue(FString::Printf(TEXT("%d %s bytes decode like the scalar path"), Size, Name), Decoded == Scalar);
+			TestTrue(FString::Printf(TEXT("%d %s bytes round trip"), Size, Name), Decoded == Bytes);
+
+			// Padding is optional for both alphabets
+			TArray<ANSICHAR> Padded = Chars;
+			while (Padded.Num() % 4 != 0)
+			{
+				Padded.Add('=');
+			}
+			TArray<ANSICHAR> Unpadded = Chars;
+			while (Unpadded.Num() > 0 && Unpadded.Last() == '=')
+			{
+				Unpadded.Pop();
+			}
+			TestTrue(FString::Printf(TEXT("Padded %d %s bytes"), Size, Name), FSCBase64::Decode(Padded.GetData(), Padded.Num(), Decoded, Alphabet) && Decoded == Bytes);
+			TestTrue(FString::Printf(TEXT("Unpadded %d %s bytes"), Size, Name), FSCBase64::Decode(Unpadded.GetData(), Unpadded.Num(), Decoded, Alphabet) && Decoded == Bytes);
+
+			// A character outside the alphabet at any position fails the decode, inside a SIMD block as well as in the tail
+			const ANSICHAR Foreign = Alphabet == ESCBase64::Standard ? '-' : '+';
+			const ANSICHAR InvalidChars[] = { '!', ' ', '\n', '.', (ANSICHAR)0xC3, '\0', Foreign };
+			for (int32 Position = 0; Position < Unpadded.Num(); Position++)
+			{
+				for (ANSICHAR Invalid : InvalidChars)
+				{
+					TArray<ANSICHAR> Corrupt = Unpadded;
+					Corrupt[Position] = Invalid;
+					const bool bDecoded = FSCBase64::Decode(Corrupt.GetData(), Corrupt.Num(), Decoded, Alphabet);
+					const bool bScalarDecoded = SCDecodeScalar(Corrupt, Scalar, Alphabet);
+					if (bDecoded || bScalarDecoded || Decoded.Num() != 0)
+					{
+						AddError(FString::Printf(TEXT("Character %d at %d of %d %s bytes was accepted"), (uint8)Invalid, Position, Size, Name));
+					}
+				}
+			}
+		}
+	}
+
+	// Malformed lengths and padding
+	TArray<uint8> Decoded;
+	const TArray<FString> Malformed = { TEXT("A"), TEXT("AAAAA"), TEXT("AQ==="), TEXT("AQ=A"), TEXT("A=Q="), TEXT("AQ==AQ==") };
+	for (const FString& Text : Malformed)
+	{
+		TestFalse(FString::Printf(TEXT("Malformed \"%s\""), *Text), FSCBase64::Decode(Text, Decoded, ESCBase64::Standard));
+	}
+	TestTrue(TEXT("Empty input"), FSCBase64::Decode(FString(), Decoded, ESCBase64::Standard) && Decoded.Num() == 0);
+
+	// Characters outside of ASCII in an FString
+	const TCHAR Wide[] = { 'A', 'Q', 0x100 + 'I', 'D', 0 };
+	TestFalse(TEXT("Wide character"), FSCBase64::Decode(FString(Wide), Decoded, ESCBase64::Standard));
+	return true;
+}
+
+#endif
@@ -0,0 +1,64 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "SCJsonObject.h"
+#include "SCJsonValue.h"
+#include "SCJsonConvert.h"
+#include "SCStructPlan.h"
+#include "SCByteWriter.h"
+#include "SCBase64.h"
+#include "Tests/SCJsonTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonBinaryRoundTripTest, "SocketCluster.Json.Binary.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonBinaryRoundTripTest::RunTest(const FString& Parameters)
+{
+	for (int32 Size : { 0, 1, 2, 3, 4, 17, 256 })
+	{
+		TArray<uint8> Bytes;
+		for (int32 i = 0; i < Size; i++)
+		{
+			Bytes.Add((uint8)(i * 37 + 11));
+		}
+		const FString What = FString::Printf(TEXT("%d bytes"), Size);
+
+		USCJsonObject* Object = USCJsonObject::ConstructJsonObject(nullptr);
+		Object->SetBinaryField(TEXT("data"), Bytes);
+		TestTrue(What + TEXT(" read back from the same object"), Object->GetBinaryField(TEXT("data")) == Bytes);
+
+		// Written by the engine serializer and read back
+		USCJsonObject* Decoded = USCJsonObject::ConstructJsonObject(nullptr);
+		if (TestTrue(What + TEXT(" decoded"), Decoded->DecodeJson(Object->EncodeJson())))
+		{
+			TestTrue(What + TEXT(" through EncodeJson"), Decoded->GetBinaryField(TEXT("data")) == Bytes);
+		}
+
+		// Written by the plugin writer as it goes on the wire and read back
+		TArray<uint8> Frame;
+		FSCByteWriter Writer(Frame);
+		FSCStructPlan::WriteJsonValue(USCJsonConvert::ToJsonValue(Object->GetRootObject()), Writer);
+		TSharedPtr<FJsonValue> Received = USCJsonConvert::JsonBytesToJsonValue(Frame);
+		if (TestTrue(What + TEXT(" frame decoded"), Received.IsValid() && Received->Type == EJson::Object))
+		{
+			Decoded->SetRootObject(Received->AsObject());
+			TestTrue(What + TEXT(" through a frame"), Decoded->GetBinaryField(TEXT("data")) == Bytes);
+		}
+
+		// A string value holding base64, as a value of its own
+		USCJsonValue* Value = USCJsonValue::ConstructJsonValueString(nullptr, FSCBase64::Encode(Bytes));
+		TestTrue(What + TEXT(" from a base64 string value"), Value->AsBinary() == Bytes);
+		TestTrue(What + TEXT(" from a binary value"), USCJsonValue::ConstructJsonValueBinary(nullptr, Bytes)->AsBinary() == Bytes);
+	}
+
+	// The sc-formatter object form and strings which are no base64
+	TArray<uint8> Bytes;
+	TestTrue(TEXT("sc-formatter binary object"), FJsonValueBinary::TryGetBinary(USCJsonConvert::JsonStringToJsonValue(TEXT("{\"base64\":true,\"data\":\"AQID\"}")), Bytes, true));
+	TestTrue(TEXT("sc-formatter binary object bytes"), Bytes == TArray<uint8>({ 1, 2, 3 }));
+	TestFalse(TEXT("A string which is no base64"), FJsonValueBinary::TryGetBinary(MakeShareable(new FJsonValueString(TEXT("not base64!"))), Bytes, true));
+	return true;
+}
+
+#endif
@@ -0,0 +1,194 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "SCJsonNumber.h"
+#include "SCJsonConvert.h"
+#include "Tests/SCJsonTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static double SCDoubleFromBits(uint64 Bits)
+{
+	double Value;
+	FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+static uint64 SCDoubleToBits(double Value)
+{
+	uint64 Bits;
+	FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+	return Bits;
+}
+
+/** Format Value and read it back with the C runtime, the bits have to match. -0 is written as 0 like JavaScript does */
+static bool SCNumberRoundTrips(double Value, FString& OutText)
+{
+	ANSICHAR Buffer[FSCJsonNumber::MaxLength + 1];
+	const int32 Length = FSCJsonNumber::Format(Value, Buffer);
+	Buffer[Length] = 0;
+	OutText = Buffer;
+	return SCDoubleToBits(FCStringAnsi::Atod(Buffer)) == SCDoubleToBits(Value == 0.0 ? 0.0 : Value);
+}
+
+/** The number the byte reader reads from Text, read as the only item of an array */
+static double SCReadNumber(const FString& Text)
+{
+	TSharedPtr<FJsonValue> Value = USCJsonConvert::JsonBytesToJsonValue(SCJsonTestBytes(FString(TEXT("[")) + Text + TEXT("]")));
+	if (!Value.IsValid() || Value->Type != EJson::Array || Value->AsArray().Num() != 1)
+	{
+		return SCDoubleFromBits(0x7FF8000000000000ULL);
+	}
+	return Value->AsArray()[0]->AsNumber();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonNumberFormatTest, "SocketCluster.Json.Number.Format", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonNumberFormatTest::RunTest(const FString& Parameters)
+{
+	const double MaxDouble = TNumericLimits<double>::Max();
+	const double MinDenormal = SCDoubleFromBits(1);
+
+	// What JavaScript's Number.prototype.toString prints for the same doubles
+	struct FSCNumberLayout
+	{
+		double Value;
+		const TCHAR* Text;
+	};
+	const FSCNumberLayout Expected[] =
+	{
+		{ 0.0, TEXT("0") },
+		{ -0.0, TEXT("0") },
+		{ 1.0, TEXT("1") },
+		{ -1.5, TEXT("-1.5") },
+		{ 0.1, TEXT("0.1") },
+		{ 123.456, TEXT("123.456") },
+		{ 1.0 / 3.0, TEXT("0.3333333333333333") },
+		{ 1e-6, TEXT("0.000001") },
+		{ 1.7e-5, TEXT("0.000017") },
+		{ 1e-7, TEXT("1e-7") },
+		{ 1.5e-7, TEXT("1.5e-7") },
+		{ 1e20, TEXT("100000000000000000000") },
+		{ 1.23e20, TEXT("123000000000000000000") },
+		{ 1e21, TEXT("1e+21") },
+		{ 1.5e21, TEXT("1.5e+21") },
+		{ 1e300, TEXT("1e+300") },
+		{ 5e-324, TEXT("5e-324") },
+		{ MinDenormal, TEXT("5e-324") },
+		{ MaxDouble, TEXT("1.7976931348623157e+308") },
+		{ -MaxDouble, TEXT("-1.7976931348623157e+308") },
+		{ 9007199254740991.0, TEXT("9007199254740991") },
+		{ -9007199254740991.0, TEXT("-9007199254740991") },
+		{ 9007199254740992.0, TEXT("9007199254740992") },
+		{ 9007199254740994.0, TEXT("9007199254740994") },
+		{ -9007199254740994.0, TEXT("-9007199254740994") },
+		{ 9223372036854775808.0, TEXT("9223372036854776000") },
+	};
+	for (const FSCNumberLayout& Layout : Expected)
+	{
+		TestEqual(FString::Printf(TEXT("Layout of %s"), Layout.Text), FSCJsonNumber::ToString(Layout.Value), FString(Layout.Text));
+	}
+
+	TestEqual(TEXT("NaN"), FSCJsonNumber::ToString(SCDoubleFromBits(0x7FF8000000000000ULL)), FString(TEXT("null")));
+	TestEqual(TEXT("Infinity"), FSCJsonNumber::ToString(SCDoubleFromBits(0x7FF0000000000000ULL)), FString(TEXT("null")));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonNumberRoundTripTest, "SocketCluster.Json.Number.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonNumberRoundTripTest::RunTest(const FString& Parameters)
+{
+	FString Text;
+	int32 Failures = 0;
+	auto Check = [this, &Text, &Failures](double Value)
+	{
+		if (!SCNumberRoundTrips(Value, Text) && Failures++ < 10)
+		{
+			AddError(FString::Printf(TEXT("%.17g was written as %s"), Value, *Text));
+		}
+	};
+
+	// The neighbourhoods of the smallest denormal, the largest double and 2^53
+	const uint64 MaxBits = SCDoubleToBits(TNumericLimits<double>::Max());
+	for (uint64 i = 0; i < 1000; i++)
+	{
+		Check(SCDoubleFromBits(1 + i));
+		Check(SCDoubleFromBits(MaxBits - i));
+		Check(-SCDoubleFromBits(MaxBits - i));
+		Check(9007199254740992.0 - 500.0 + i);
+		Check(-9007199254740992.0 + 500.0 - i);
+	}
+
+	// Random bit patterns, which cover every exponent
+	FRandomStream Random(0x5C15);
+	for (int32 i = 0; i < 200000; i++)
+	{
+		const uint64 Bits = ((uint64)(uint32)Random.GetUnsignedInt() << 32) | (uint32)Random.GetUnsignedInt();
+		const double Value = SCDoubleFromBits(Bits);
+		if (FMath::IsFinite(Value))
+		{
+			Check(Value);
+		}
+	}
+	return Failures == 0;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonNumberReadTest, "SocketCluster.Json.Number.Read", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonNumberReadTest::RunTest(const FString& Parameters)
+{
+	int32 Failures = 0;
+	auto Check = [this, &Failures](const FString& Text)
+	{
+		const double Read = SCReadNumber(Text);
+		const double Expected = FCStringAnsi::Atod(TCHAR_TO_ANSI(*Text));
+		if (SCDoubleToBits(Read) != SCDoubleToBits(Expected) && Failures++ < 10)
+		{
+			AddError(FString::Printf(TEXT("%s was read as %.17g instead of %.17g"), *Text, Read, Expected));
+		}
+	};
+
+	// The edges of the exact fast path: 19 digits, a 2^53 mantissa and powers of ten up to 22
+	const TArray<FString> Edges =
+	{
+		TEXT("0"), TEXT("-0"), TEXT("1e22"), TEXT("1e23"), TEXT("9007199254740992e22"), TEXT("9007199254740993"),
+		TEXT("9007199254740993e-22"), TEXT("1234567890123456789"), TEXT("12345678901234567890"), TEXT("1e-22"), TEXT("1e-23"),
+		TEXT("0.1"), TEXT("2.2250738585072014e-308"), TEXT("5e-324"), TEXT("2.4703282292062328e-324"), TEXT("1.7976931348623157e308"),
+		TEXT("1.7976931348623158e308"), TEXT("123.456e-2"), TEXT("0.00000000000000000000012345"), TEXT("-12345678.87654321E+7"),
+	};
+	for (const FString& Edge : Edges)
+	{
+		Check(Edge);
+	}
+
+	// Generated numbers, mostly inside the fast path and some just outside of it
+	FRandomStream Random(0x5C16);
+	for (int32 i = 0; i < 200000; i++)
+	{
+		FString Digits;
+		const int32 NumDigits = Random.RandRange(1, 21);
+		for (int32 Digit = 0; Digit < NumDigits; Digit++)
+		{
+			Digits.AppendChar((TCHAR)('0' + Random.RandRange(Digit == 0 && NumDigits > 1 ? 1 : 0, 9)));
+		}
+		const int32 Point = Random.RandRange(0, NumDigits);
+		if (Point < NumDigits)
+		{
+			Digits = (Point == 0 ? FString(TEXT("0")) : Digits.Left(Point)) + TEXT(".") + Digits.Mid(Point);
+		}
+		if (Random.RandRange(0, 3) == 0)
+		{
+			Digits = FString(TEXT("-")) + Digits;
+		}
+		if (Random.RandRange(0, 1) == 0)
+		{
+			Digits += FString::Printf(TEXT("e%d"), Random.RandRange(-30, 30));
+		}
+		Check(Digits);
+	}
+	return Failures == 0;
+}
+
+#endif
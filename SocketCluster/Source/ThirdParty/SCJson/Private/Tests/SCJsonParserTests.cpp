@@ -0,0 +1,230 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "SCJsonConvert.h"
+#include "SCJsonArena.h"
+#include "SCJsonValue.h"
+#include "SCJsonStructural.h"
+#include "Tests/SCJsonTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Parse Text with the byte reader and into a document and compare both against FJsonSerializer */
+static void SCTestParseLikeReference(FAutomationTestBase& Test, const FString& What, const FString& Text)
+{
+	TSharedPtr<FJsonValue> Expected = SCJsonTestReference(Text);
+	if (!Test.TestTrue(What + TEXT(" is valid for FJsonSerializer"), Expected.IsValid()))
+	{
+		return;
+	}
+
+	TArray<uint8> Bytes = SCJsonTestBytes(Text);
+	Test.TestTrue(What + TEXT(" byte reader"), SCJsonTestEquals(USCJsonConvert::JsonBytesToJsonValue(Bytes), Expected));
+	Test.TestTrue(What + TEXT(" string reader"), SCJsonTestEquals(USCJsonConvert::JsonStringToJsonValue(Text), Expected));
+
+	FSCJsonDocument Document;
+	if (Test.TestTrue(What + TEXT(" document parsed"), Document.Parse(Bytes)))
+	{
+		Test.TestTrue(What + TEXT(" document"), SCJsonTestEquals(USCJsonConvert::ToJsonValue(Document.GetRoot()), Expected));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonStructuralTest, "SocketCluster.Json.Structural", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonStructuralTest::RunTest(const FString& Parameters)
+{
+	// Quotes and commas inside a string are not structural
+	TArray<uint32> Indices;
+	TArray<uint8> Bytes = SCJsonTestBytes(TEXT("{\"a\":\"x,\\\"y\"}"));
+	if (TestTrue(TEXT("Index built"), SCBuildJsonStructuralIndex(Bytes.GetData(), Bytes.Num(), Indices)))
+	{
+		const TArray<uint32> Expected = { 0, 1, 4, 5, 12 };
+		TestTrue(TEXT("Only the structural characters are indexed"), Indices == Expected);
+	}
+
+	// A run of backslashes before a quote, moved over the 64 byte block edges: an odd run escapes the quote, an even run does not
+	for (int32 Pad = 0; Pad <= 140; Pad++)
+	{
+		for (int32 Backslashes = 1; Backslashes <= 6; Backslashes++)
+		{
+			const bool bEscaped = Backslashes % 2 == 1;
+			const FString Text = FString(TEXT("{\"k\":\"")) + FString::ChrN(Pad, 'a') + FString::ChrN(Backslashes, '\\') + (bEscaped ? TEXT("\",]}\"}") : TEXT("\"}"));
+			const FString Expected = FString::ChrN(Pad, 'a') + FString::ChrN(Backslashes / 2, '\\') + (bEscaped ? TEXT("\",]}") : TEXT(""));
+			const FString What = FString::Printf(TEXT("%d backslashes after %d bytes"), Backslashes, Pad);
+
+			TSharedPtr<FJsonValue> Value = USCJsonConvert::JsonBytesToJsonValue(SCJsonTestBytes(Text));
+			FString String;
+			if (TestTrue(What + TEXT(" parsed"), Value.IsValid() && Value->Type == EJson::Object && Value->AsObject()->TryGetStringField(TEXT("k"), String)))
+			{
+				TestEqual(What, String, Expected);
+			}
+			SCTestParseLikeReference(*this, What, Text);
+		}
+	}
+
+	// A string that ends right before or right after a block edge, followed by more members
+	for (int32 Pad = 50; Pad <= 70; Pad++)
+	{
+		SCTestParseLikeReference(*this, FString::Printf(TEXT("Members after %d bytes"), Pad), FString(TEXT("{\"k\":\"")) + FString::ChrN(Pad, 'b') + TEXT("\",\"n\":[1,\"\\\\\",{\"m\":null}]}"));
+	}
+
+	// Unterminated strings and trailing garbage
+	Indices.Reset();
+	Bytes = SCJsonTestBytes(TEXT("{\"k\":\"abc\\\"}"));
+	TestFalse(TEXT("Input ending inside a string"), SCBuildJsonStructuralIndex(Bytes.GetData(), Bytes.Num(), Indices));
+	FSCJsonDocument Document;
+	TestFalse(TEXT("Document of a string escaping its closing quote"), Document.Parse(Bytes));
+	TestFalse(TEXT("Document with trailing garbage"), Document.Parse(SCJsonTestBytes(TEXT("{\"k\":1}x"))));
+	TestFalse(TEXT("Document with a second value"), Document.Parse(SCJsonTestBytes(TEXT("[1] [2]"))));
+	TestFalse(TEXT("Document of an unclosed array"), Document.Parse(SCJsonTestBytes(TEXT("[1,2"))));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonUtf8Test, "SocketCluster.Json.Utf8", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonUtf8Test::RunTest(const FString& Parameters)
+{
+	// Valid multi byte characters split over the block edges
+	const TCHAR Wide[] = { 'x', 0xE9, 0x20AC, 0x4E2D, 'y', 0 };
+	for (int32 Pad = 55; Pad <= 70; Pad++)
+	{
+		SCTestParseLikeReference(*this, FString::Printf(TEXT("Multi byte characters after %d bytes"), Pad), FString(TEXT("[\"")) + FString::ChrN(Pad, 'c') + Wide + TEXT("\",\"") + Wide + TEXT("\"]"));
+	}
+
+	// Overlong, surrogate, out of range, truncated and stray continuation bytes
+	const TArray<TArray<uint8>> Invalid =
+	{
+		{ 0xC0, 0x80 },
+		{ 0xC1, 0xBF },
+		{ 0xE0, 0x80, 0x80 },
+		{ 0xED, 0xA0, 0x80 },
+		{ 0xF0, 0x80, 0x80, 0x80 },
+		{ 0xF4, 0x90, 0x80, 0x80 },
+		{ 0xF5, 0x80, 0x80, 0x80 },
+		{ 0xFF },
+		{ 0x80 },
+		{ 0xE2, 0x82 },
+		{ 0xC3, 'a' },
+	};
+	for (int32 Case = 0; Case < Invalid.Num(); Case++)
+	{
+		for (int32 Pad = 55; Pad <= 70; Pad++)
+		{
+			TArray<uint8> Bytes = SCJsonTestBytes(FString(TEXT("[\"")) + FString::ChrN(Pad, 'd'));
+			Bytes.Append(Invalid[Case]);
+			Bytes.Append(SCJsonTestBytes(TEXT("\",1]")));
+
+			const FString What = FString::Printf(TEXT("Invalid sequence %d after %d bytes"), Case, Pad);
+			TArray<uint32> Indices;
+			TestFalse(What + TEXT(" index"), SCBuildJsonStructuralIndex(Bytes.GetData(), Bytes.Num(), Indices));
+			FSCJsonDocument Document;
+			TestFalse(What + TEXT(" document"), Document.Parse(Bytes));
+		}
+	}
+
+	// Invalid bytes at the very end of the input
+	TArray<uint8> Bytes = SCJsonTestBytes(TEXT("[\"e\"]"));
+	Bytes.Add(0xC3);
+	TArray<uint32> Indices;
+	TestFalse(TEXT("Truncated sequence at the end"), SCBuildJsonStructuralIndex(Bytes.GetData(), Bytes.Num(), Indices));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonNumberArrayTest, "SocketCluster.Json.NumberArray", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonNumberArrayTest::RunTest(const FString& Parameters)
+{
+	FString Short = TEXT("[");
+	for (int32 i = 0; i < SCJsonPackedArrayMin - 1; i++)
+	{
+		Short += FString::Printf(TEXT("%s%d.5"), i > 0 ? TEXT(",") : TEXT(""), i - 3);
+	}
+	const FString Packed = Short + TEXT(",1e3]");
+	Short += TEXT("]");
+
+	TSharedPtr<FJsonValue> Value = USCJsonConvert::JsonStringToJsonValue(Short);
+	TestNull(TEXT("Arrays below the threshold are not packed"), FJsonValueNumberArray::AsNumberArray(Value));
+	SCTestParseLikeReference(*this, TEXT("Short number array"), Short);
+
+	Value = USCJsonConvert::JsonStringToJsonValue(Packed);
+	const TArray<double>* Numbers = FJsonValueNumberArray::AsNumberArray(Value);
+	if (TestNotNull(TEXT("Arrays at the threshold are packed"), Numbers))
+	{
+		TestEqual(TEXT("Packed count"), Numbers->Num(), SCJsonPackedArrayMin);
+		TestEqual(TEXT("First packed number"), (*Numbers)[0], -3.5);
+		TestEqual(TEXT("Last packed number"), Numbers->Last(), 1000.0);
+		TestEqual(TEXT("Items made from the packed numbers"), Value->AsArray().Num(), SCJsonPackedArrayMin);
+	}
+	SCTestParseLikeReference(*this, TEXT("Packed number array"), Packed);
+
+	// The packed array written back is the same JSON
+	SCTestParseLikeReference(*this, TEXT("Packed number array written back"), USCJsonConvert::ToJsonString(Value));
+
+	// Anything but a number keeps the array unpacked
+	const FString Mixed = Packed.LeftChop(1) + TEXT(",\"9\"]");
+	TestNull(TEXT("Arrays with a string are not packed"), FJsonValueNumberArray::AsNumberArray(USCJsonConvert::JsonStringToJsonValue(Mixed)));
+	SCTestParseLikeReference(*this, TEXT("Mixed array"), Mixed);
+
+	// Nested in objects and arrays
+	SCTestParseLikeReference(*this, TEXT("Nested number arrays"), FString::Printf(TEXT("{\"a\":%s,\"b\":[%s,%s],\"c\":[[]]}"), *Packed, *Packed, *Short));
+	TestNull(TEXT("Other values are no number array"), FJsonValueNumberArray::AsNumberArray(MakeShareable(new FJsonValueNumber(1))));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonPingTest, "SocketCluster.Json.Ping", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonPingTest::RunTest(const FString& Parameters)
+{
+	// Messages which are no JSON text, the byte and the string reader have to agree on them
+	const TArray<FString> Messages = { TEXT(""), TEXT("#1"), TEXT("#2"), TEXT("1"), TEXT("-2.5"), TEXT("+3"), TEXT("1.2.3"), TEXT("true"), TEXT("false"), TEXT("null"), TEXT("{broken"), TEXT("[1,") };
+	for (const FString& Message : Messages)
+	{
+		TSharedPtr<FJsonValue> FromBytes = USCJsonConvert::JsonBytesToJsonValue(SCJsonTestBytes(Message));
+		TSharedPtr<FJsonValue> FromString = USCJsonConvert::JsonStringToJsonValue(Message);
+		TestTrue(FString::Printf(TEXT("Readers agree on \"%s\""), *Message), SCJsonTestEquals(FromBytes, FromString));
+	}
+
+	TestTrue(TEXT("An empty message is null"), USCJsonConvert::JsonBytesToJsonValue(TArray<uint8>())->IsNull());
+
+	TSharedPtr<FJsonValue> Ping = USCJsonConvert::JsonBytesToJsonValue(SCJsonTestBytes(TEXT("#1")));
+	TestTrue(TEXT("#1 is a string"), Ping->Type == EJson::String);
+	TestEqual(TEXT("#1 value"), Ping->AsString(), FString(TEXT("#1")));
+
+	TSharedPtr<FJsonValue> Number = USCJsonConvert::JsonBytesToJsonValue(SCJsonTestBytes(TEXT("1")));
+	TestTrue(TEXT("1 is a number"), Number->Type == EJson::Number);
+	TestEqual(TEXT("1 value"), Number->AsNumber(), 1.0);
+
+	TestTrue(TEXT("Malformed JSON falls back to a string"), USCJsonConvert::JsonBytesToJsonValue(SCJsonTestBytes(TEXT("{broken")))->Type == EJson::String);
+
+	// The document only takes JSON texts
+	FSCJsonDocument Document;
+	TestFalse(TEXT("Document of an empty message"), Document.Parse(TArray<uint8>()));
+	TestFalse(TEXT("Document of #1"), Document.Parse(SCJsonTestBytes(TEXT("#1"))));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCJsonReferenceTest, "SocketCluster.Json.Reference", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCJsonReferenceTest::RunTest(const FString& Parameters)
+{
+	const TArray<FString> Texts =
+	{
+		TEXT("{}"),
+		TEXT("[]"),
+		TEXT(" { \"a\" : [ ] , \"b\" : { } } "),
+		TEXT("{\"event\":\"#publish\",\"data\":{\"channel\":\"news\",\"data\":{\"id\":7,\"text\":\"hi\"}},\"cid\":12}"),
+		TEXT("{\"rid\":3,\"error\":{\"name\":\"BadMessageError\",\"message\":\"\\\"quoted\\\" \\\\ \\/ \\b\\f\\n\\r\\t\"}}"),
+		TEXT("{\"escapes\":\"\\u0041\\u00e9\\u20acend\"}"),
+		TEXT("[0,-0,1,-1,0.5,-12.25,1e3,1E-3,2.5e+2,123456789012,9007199254740993,1.7976931348623157e308]"),
+		TEXT("[true,false,null,\"\",[[[]]],{\"\":0}]"),
+		TEXT("{\"Key\":1,\"other\":{\"Key\":[{\"deep\":[1,2,3,4,5,6,7,8,9]}]}}"),
+	};
+	for (int32 i = 0; i < Texts.Num(); i++)
+	{
+		SCTestParseLikeReference(*this, FString::Printf(TEXT("Text %d"), i), Texts[i]);
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,93 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+#include "Runtime/Json/Public/Serialization/JsonReader.h"
+#include "Runtime/Json/Public/Serialization/JsonSerializer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** The UTF-8 bytes of Text */
+static TArray<uint8> SCJsonTestBytes(const FString& Text)
+{
+	FTCHARToUTF8 Utf8(*Text, Text.Len());
+	return TArray<uint8>((const uint8*)Utf8.Get(), Utf8.Length());
+}
+
+/** Parse Text with the engine's FJsonSerializer, the reference the SCJson readers are compared against */
+static TSharedPtr<FJsonValue> SCJsonTestReference(const FString& Text)
+{
+	TSharedPtr<FJsonValue> Value;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+	if (!FJsonSerializer::Deserialize(Reader, Value))
+	{
+		return nullptr;
+	}
+	return Value;
+}
+
+/** Deep comparison of two values, numbers have to be equal and object keys are looked up like FJsonObject does */
+static bool SCJsonTestEquals(const TSharedPtr<FJsonValue>& A, const TSharedPtr<FJsonValue>& B)
+{
+	if (!A.IsValid() || !B.IsValid())
+	{
+		return A.IsValid() == B.IsValid();
+	}
+	if (A->Type != B->Type)
+	{
+		return false;
+	}
+	switch (A->Type)
+	{
+	case EJson::None:
+	case EJson::Null:
+		return true;
+	case EJson::Boolean:
+		return A->AsBool() == B->AsBool();
+	case EJson::Number:
+		return A->AsNumber() == B->AsNumber();
+	case EJson::String:
+		return A->AsString().Equals(B->AsString(), ESearchCase::CaseSensitive);
+	case EJson::Array:
+	{
+		const TArray<TSharedPtr<FJsonValue>>& ItemsA = A->AsArray();
+		const TArray<TSharedPtr<FJsonValue>>& ItemsB = B->AsArray();
+		if (ItemsA.Num() != ItemsB.Num())
+		{
+			return false;
+		}
+		for (int32 i = 0; i < ItemsA.Num(); i++)
+		{
+			if (!SCJsonTestEquals(ItemsA[i], ItemsB[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	case EJson::Object:
+	{
+		const TSharedPtr<FJsonObject> ObjectA = A->AsObject();
+		const TSharedPtr<FJsonObject> ObjectB = B->AsObject();
+		if (ObjectA->Values.Num() != ObjectB->Values.Num())
+		{
+			return false;
+		}
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : ObjectA->Values)
+		{
+			const TSharedPtr<FJsonValue>* Other = ObjectB->Values.Find(Pair.Key);
+			if (Other == nullptr || !SCJsonTestEquals(Pair.Value, *Other))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	}
+	return false;
+}
+
+#endif
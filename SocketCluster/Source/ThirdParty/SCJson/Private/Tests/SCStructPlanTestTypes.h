@@ -0,0 +1,75 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SCStructPlanTestTypes.generated.h"
+
+/** The types the struct plan tests compare against FJsonObjectConverter */
+UENUM()
+enum class ESCStructPlanTestMode : uint8
+{
+	First,
+	Second,
+	Third
+};
+
+USTRUCT()
+struct FSCStructPlanTestInner
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Label;
+
+	UPROPERTY()
+	float Weight = 0.0f;
+
+	UPROPERTY()
+	TArray<int32> Values;
+};
+
+USTRUCT()
+struct FSCStructPlanTestStruct
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Name;
+
+	UPROPERTY()
+	int32 Count = 0;
+
+	UPROPERTY()
+	bool bEnabled = false;
+
+	UPROPERTY()
+	int64 Big = 0;
+
+	UPROPERTY()
+	uint64 BigUnsigned = 0;
+
+	UPROPERTY()
+	double Ratio = 0.0;
+
+	UPROPERTY()
+	ESCStructPlanTestMode Mode = ESCStructPlanTestMode::First;
+
+	UPROPERTY()
+	FName Tag;
+
+	UPROPERTY()
+	FSCStructPlanTestInner Inner;
+
+	UPROPERTY()
+	TArray<FSCStructPlanTestInner> Items;
+
+	UPROPERTY()
+	TArray<ESCStructPlanTestMode> Modes;
+
+	UPROPERTY()
+	TMap<FString, int32> Counts;
+
+	UPROPERTY()
+	TMap<int32, FSCStructPlanTestInner> ById;
+};
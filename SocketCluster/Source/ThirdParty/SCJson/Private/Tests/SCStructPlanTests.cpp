@@ -0,0 +1,192 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "JsonObjectConverter.h"
+#include "SCStructPlan.h"
+#include "SCByteWriter.h"
+#include "SCJsonArena.h"
+#include "SCJsonConvert.h"
+#include "Tests/SCJsonTestUtils.h"
+#include "Tests/SCStructPlanTestTypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static FSCStructPlanTestInner SCMakeTestInner(const FString& Label, float Weight, int32 NumValues)
+{
+	FSCStructPlanTestInner Inner;
+	Inner.Label = Label;
+	Inner.Weight = Weight;
+	for (int32 i = 0; i < NumValues; i++)
+	{
+		Inner.Values.Add(i * 10 - 5);
+	}
+	return Inner;
+}
+
+/** A struct with every kind of property set, the 64 bit integers are exact as doubles like FJsonObjectConverter needs them */
+static FSCStructPlanTestStruct SCMakeTestStruct()
+{
+	FSCStructPlanTestStruct Value;
+	Value.Name = TEXT("plan \"quoted\" \\ \t");
+	Value.Count = -7;
+	Value.bEnabled = true;
+	Value.Big = -4611686018427387904LL;
+	Value.BigUnsigned = 4611687117939015680ULL;
+	Value.Ratio = 0.1;
+	Value.Mode = ESCStructPlanTestMode::Third;
+	Value.Tag = TEXT("Tagged");
+	Value.Inner = SCMakeTestInner(TEXT("inner"), 0.25f, 3);
+	Value.Items.Add(SCMakeTestInner(TEXT("first"), 1.5f, 0));
+	Value.Items.Add(SCMakeTestInner(TEXT("second"), -2.0f, 9));
+	Value.Modes = { ESCStructPlanTestMode::Second, ESCStructPlanTestMode::First };
+	Value.Counts.Add(TEXT("a"), 1);
+	Value.Counts.Add(TEXT("B"), 2);
+	Value.ById.Add(5, SCMakeTestInner(TEXT("five"), 5.0f, 1));
+	Value.ById.Add(-1, SCMakeTestInner(TEXT("minus one"), 0.0f, 2));
+	return Value;
+}
+
+/** True if every object key of A is spelled like the one of B, SCJsonTestEquals matches keys without case */
+static bool SCSameKeyCase(const TSharedPtr<FJsonValue>& A, const TSharedPtr<FJsonValue>& B)
+{
+	if (!A.IsValid() || !B.IsValid() || A->Type != B->Type)
+	{
+		return false;
+	}
+	if (A->Type == EJson::Array)
+	{
+		const TArray<TSharedPtr<FJsonValue>>& ItemsA = A->AsArray();
+		const TArray<TSharedPtr<FJsonValue>>& ItemsB = B->AsArray();
+		for (int32 i = 0; i < ItemsA.Num() && i < ItemsB.Num(); i++)
+		{
+			if (!SCSameKeyCase(ItemsA[i], ItemsB[i]))
+			{
+				return false;
+			}
+		}
+	}
+	else if (A->Type == EJson::Object)
+	{
+		const TMap<FString, TSharedPtr<FJsonValue>>& ValuesB = B->AsObject()->Values;
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : A->AsObject()->Values)
+		{
+			const TSharedPtr<FJsonValue>* Other = ValuesB.Find(Pair.Key);
+			if (Other == nullptr || !ValuesB.FindKey(*Other)->Equals(Pair.Key, ESearchCase::CaseSensitive) || !SCSameKeyCase(Pair.Value, *Other))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCStructPlanWriteTest, "SocketCluster.Json.StructPlan.Write", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCStructPlanWriteTest::RunTest(const FString& Parameters)
+{
+	const FSCStructPlanTestStruct Value = SCMakeTestStruct();
+
+	TSharedRef<FJsonObject> ConverterObject = MakeShared<FJsonObject>();
+	if (!TestTrue(TEXT("FJsonObjectConverter wrote the struct"), FJsonObjectConverter::UStructToJsonObject(FSCStructPlanTestStruct::StaticStruct(), &Value, ConverterObject, 0, 0)))
+	{
+		return false;
+	}
+	TSharedPtr<FJsonValue> Expected = MakeShareable(new FJsonValueObject(ConverterObject));
+
+	// Written as bytes through the plan
+	TArray<uint8> Bytes;
+	FSCByteWriter Writer(Bytes);
+	TSCStructPlan<FSCStructPlanTestStruct>::Write(Value, Writer);
+	FUTF8ToTCHAR Text((const ANSICHAR*)Bytes.GetData(), Bytes.Num());
+	TSharedPtr<FJsonValue> Written = SCJsonTestReference(FString(Text.Length(), Text.Get()));
+	if (TestTrue(TEXT("The plan wrote valid JSON"), Written.IsValid()))
+	{
+		TestTrue(TEXT("Written values match FJsonObjectConverter"), SCJsonTestEquals(Written, Expected));
+		TestTrue(TEXT("Written keys are cased like FJsonObjectConverter"), SCSameKeyCase(Written, Expected));
+	}
+
+	// Built as an FJsonObject through the plan
+	TSharedPtr<FJsonValue> Built = MakeShareable(new FJsonValueObject(TSCStructPlan<FSCStructPlanTestStruct>::Get()->ToJsonObject(&Value)));
+	TestTrue(TEXT("Built values match FJsonObjectConverter"), SCJsonTestEquals(Built, Expected));
+	TestTrue(TEXT("Built keys are cased like FJsonObjectConverter"), SCSameKeyCase(Built, Expected));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCStructPlanReadTest, "SocketCluster.Json.StructPlan.Read", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCStructPlanReadTest::RunTest(const FString& Parameters)
+{
+	// Keys in another case than the properties, an unknown key and a missing one
+	const FString Text = TEXT("{\"NAME\":\"read\",\"count\":12,\"BENABLED\":true,\"Big\":-9007199254740992,\"bigunsigned\":4611686018427387904,")
+		TEXT("\"RATIO\":2.5e-3,\"mode\":\"Second\",\"TAG\":\"tag\",\"INNER\":{\"LABEL\":\"in\",\"weight\":0.5,\"VALUES\":[3,2,1]},")
+		TEXT("\"items\":[{\"label\":\"x\"},{\"Label\":\"y\",\"Values\":[1,2,3,4,5,6,7,8,9]}],\"Modes\":[\"Third\",\"First\"],")
+		TEXT("\"counts\":{\"a\":1,\"B\":2},\"BYID\":{\"5\":{\"label\":\"five\"},\"-3\":{\"weight\":3}},\"unknown\":[1,{\"name\":\"ignored\"}]}");
+	UScriptStruct* Struct = FSCStructPlanTestStruct::StaticStruct();
+
+	FSCStructPlanTestStruct Expected;
+	if (!TestTrue(TEXT("FJsonObjectConverter read the text"), FJsonObjectConverter::JsonObjectStringToUStruct(Text, &Expected, 0, 0)))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Converter matched keys without case"), Expected.Name, FString(TEXT("read")));
+
+	const TArray<uint8> Bytes = SCJsonTestBytes(Text);
+	FSCStructPlanTestStruct FromBytes;
+	if (TestTrue(TEXT("Plan read the bytes"), TSCStructPlan<FSCStructPlanTestStruct>::Read(Bytes, FromBytes)))
+	{
+		TestTrue(TEXT("Read from bytes matches FJsonObjectConverter"), Struct->CompareScriptStruct(&FromBytes, &Expected, PPF_None));
+		TestTrue(TEXT("int64 from bytes"), FromBytes.Big == Expected.Big);
+		TestTrue(TEXT("uint64 from bytes"), FromBytes.BigUnsigned == Expected.BigUnsigned);
+		TestTrue(TEXT("Enum from bytes"), FromBytes.Mode == ESCStructPlanTestMode::Second);
+		TestEqual(TEXT("Map with an int key from bytes"), FromBytes.ById.Num(), 2);
+	}
+
+	FSCJsonDocument Document;
+	FSCStructPlanTestStruct FromNode;
+	if (TestTrue(TEXT("Document parsed"), Document.Parse(Bytes)) && TestTrue(TEXT("Plan read the node"), TSCStructPlan<FSCStructPlanTestStruct>::Read(Document.GetRoot(), FromNode)))
+	{
+		TestTrue(TEXT("Read from a node matches FJsonObjectConverter"), Struct->CompareScriptStruct(&FromNode, &Expected, PPF_None));
+	}
+
+	FSCStructPlanTestStruct FromValue;
+	if (TestTrue(TEXT("Plan decoded the value"), TSCStructPlan<FSCStructPlanTestStruct>::Decode(USCJsonConvert::JsonStringToJsonValue(Text), FromValue)))
+	{
+		TestTrue(TEXT("Decoded from a value matches FJsonObjectConverter"), Struct->CompareScriptStruct(&FromValue, &Expected, PPF_None));
+	}
+
+	// Malformed input and other values than objects
+	FSCStructPlanTestStruct Unused;
+	TestFalse(TEXT("Truncated bytes"), TSCStructPlan<FSCStructPlanTestStruct>::Read(SCJsonTestBytes(TEXT("{\"name\":\"x\"")), Unused));
+	TestFalse(TEXT("An array is no struct"), TSCStructPlan<FSCStructPlanTestStruct>::Read(SCJsonTestBytes(TEXT("[1]")), Unused));
+	TestFalse(TEXT("A string value is no struct"), TSCStructPlan<FSCStructPlanTestStruct>::Decode(MakeShareable(new FJsonValueString(TEXT("x"))), Unused));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSCStructPlanRoundTripTest, "SocketCluster.Json.StructPlan.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSCStructPlanRoundTripTest::RunTest(const FString& Parameters)
+{
+	const FSCStructPlanTestStruct Value = SCMakeTestStruct();
+
+	TArray<uint8> Bytes;
+	FSCByteWriter Writer(Bytes);
+	TSCStructPlan<FSCStructPlanTestStruct>::Write(Value, Writer);
+
+	FSCStructPlanTestStruct Read;
+	if (TestTrue(TEXT("Plan read its own output"), TSCStructPlan<FSCStructPlanTestStruct>::Read(Bytes, Read)))
+	{
+		TestTrue(TEXT("Round trip through the plan"), FSCStructPlanTestStruct::StaticStruct()->CompareScriptStruct(&Read, &Value, PPF_None));
+	}
+
+	// A struct value is written through the plan when it is encoded as JSON
+	FSCStructPlanTestStruct FromString;
+	const FString Encoded = USCJsonConvert::ToJsonString(TSCStructPlan<FSCStructPlanTestStruct>::MakeJsonValue(Value));
+	if (TestTrue(TEXT("FJsonObjectConverter read the encoded struct value"), FJsonObjectConverter::JsonObjectStringToUStruct(Encoded, &FromString, 0, 0)))
+	{
+		TestTrue(TEXT("Round trip through a struct value and FJsonObjectConverter"), FSCStructPlanTestStruct::StaticStruct()->CompareScriptStruct(&FromString, &Value, PPF_None));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,139 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "HAL/PlatformTLS.h"
+
+/**
+* Counts the allocations made through GMalloc while it is installed, every call is forwarded to the allocator it replaced.
+* Allocations of every thread are counted unless the counter is limited to one thread, so measure on an otherwise idle process.
+*/
+class FSCAllocationCounter : public FMalloc
+{
+public:
+
+	/** thread limits the counting to the allocations of that thread id, 0 counts every thread */
+	explicit FSCAllocationCounter(FMalloc* InInner, uint32 InThread = 0)
+		: inner(InInner)
+		, thread(InThread)
+	{
+	}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		count(Count);
+		return inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+	{
+		count(Count);
+		return inner->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		// A realloc which moves the block copies it, count it like a new allocation
+		if (Count > 0)
+		{
+			count(Count);
+		}
+		return inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0)
+		{
+			count(Count);
+		}
+		return inner->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override
+	{
+		inner->Free(Original);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return inner->QuantizeSize(Count, Alignment); }
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return inner->GetAllocationSize(Original, SizeOut); }
+
+	virtual void Trim(bool bTrimThreadCaches) override { inner->Trim(bTrimThreadCaches); }
+
+	virtual void SetupTLSCachesOnCurrentThread() override { inner->SetupTLSCachesOnCurrentThread(); }
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+
+	virtual void InitializeStatsMetadata() override { inner->InitializeStatsMetadata(); }
+
+	virtual void UpdateStats() override { inner->UpdateStats(); }
+
+	virtual void GetAllocatorStats(FGenericMemoryStats& out_Stats) override { inner->GetAllocatorStats(out_Stats); }
+
+	virtual void DumpAllocatorStats(class FOutputDevice& Ar) override { inner->DumpAllocatorStats(Ar); }
+
+	virtual bool IsInternallyThreadSafe() const override { return inner->IsInternallyThreadSafe(); }
+
+	virtual bool ValidateHeap() override { return inner->ValidateHeap(); }
+
+	virtual const TCHAR* GetDescriptiveName() override { return TEXT("SCAllocationCounter"); }
+
+	int64 getAllocations() const { return allocations.GetValue(); }
+
+	int64 getBytes() const { return bytes.GetValue(); }
+
+	void reset()
+	{
+		allocations.Reset();
+		bytes.Reset();
+	}
+
+private:
+
+	FORCEINLINE void count(SIZE_T Count)
+	{
+		if (thread == 0 || thread == FPlatformTLS::GetCurrentThreadId())
+		{
+			allocations.Increment();
+			bytes.Add((int64)Count);
+		}
+	}
+
+	FMalloc* inner;
+
+	uint32 thread;
+
+	FThreadSafeCounter64 allocations;
+
+	FThreadSafeCounter64 bytes;
+};
+
+/** Installs an FSCAllocationCounter as GMalloc for its lifetime */
+class FSCAllocationCounterScope
+{
+public:
+
+	FSCAllocationCounterScope()
+		: previous(GMalloc)
+		, counter(GMalloc)
+	{
+		GMalloc = &counter;
+	}
+
+	~FSCAllocationCounterScope()
+	{
+		GMalloc = previous;
+	}
+
+	FSCAllocationCounter& get() { return counter; }
+
+private:
+
+	FMalloc* previous;
+
+	FSCAllocationCounter counter;
+};
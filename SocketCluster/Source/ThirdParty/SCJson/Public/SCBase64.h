@@ -0,0 +1,37 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The two base64 alphabets of RFC 4648 */
+enum class ESCBase64 : uint8
+{
+	/** +/ and padded with = */
+	Standard,
+
+	/** -_ and not padded, as used in JWTs */
+	Url
+};
+
+/**
+ * Base64 over byte spans, without an FString in between. Whole blocks are translated with SIMD (SSE2, SSSE3 when the module is built for it, or NEON), the rest one group at a time.
+ */
+struct SCJSON_API FSCBase64
+{
+	/** Number of characters Encode writes for Size bytes */
+	static int32 GetEncodedLength(int32 Size, ESCBase64 Alphabet = ESCBase64::Standard);
+
+	/** Write the encoding of Size bytes to Dest, which has room for GetEncodedLength characters. Not null terminated */
+	static void Encode(const uint8* Source, int32 Size, ANSICHAR* Dest, ESCBase64 Alphabet = ESCBase64::Standard);
+
+	static FString Encode(TArrayView<const uint8> Source, ESCBase64 Alphabet = ESCBase64::Standard);
+
+	/**
+	 * Decode Length characters into OutBytes, replacing its content but reusing its allocation.
+	 * Padding is optional for both alphabets, any character outside the alphabet (whitespace included) fails the decode.
+	 */
+	static bool Decode(const ANSICHAR* Source, int32 Length, TArray<uint8>& OutBytes, ESCBase64 Alphabet = ESCBase64::Standard);
+
+	static bool Decode(const FString& Source, TArray<uint8>& OutBytes, ESCBase64 Alphabet = ESCBase64::Standard);
+};
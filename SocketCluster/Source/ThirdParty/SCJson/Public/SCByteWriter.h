@@ -0,0 +1,82 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SCMessageAccounting.h"
+
+/**
+* Appends encoded bytes to a buffer owned by someone else, usually a queued socket frame.
+* Anything already in the buffer (e.g. the padding the socket keeps in front of the payload) is left untouched.
+*/
+class FSCByteWriter
+{
+public:
+
+	explicit FSCByteWriter(TArray<uint8>& InBuffer)
+		: buffer(InBuffer)
+		, start(InBuffer.Num())
+	{
+	}
+
+	/** Make room for at least size more bytes */
+	FORCEINLINE void reserve(int32 size)
+	{
+		buffer.Reserve(buffer.Num() + size);
+	}
+
+	FORCEINLINE void write(uint8 byte)
+	{
+		buffer.Add(byte);
+	}
+
+	FORCEINLINE void write(const void* data, int32 size)
+	{
+		buffer.Append((const uint8*)data, size);
+	}
+
+	/** Append size bytes for the caller to fill in, the pointer is valid until the next write */
+	FORCEINLINE uint8* writeUninitialized(int32 size)
+	{
+		int32 offset = buffer.AddUninitialized(size);
+		return buffer.GetData() + offset;
+	}
+
+	/** Write the lowest bytes of value, most significant byte first */
+	FORCEINLINE void writeBigEndian(uint64 value, int32 bytes)
+	{
+		int32 offset = buffer.AddUninitialized(bytes);
+		uint8* out = buffer.GetData() + offset;
+		for (int32 i = bytes - 1; i >= 0; i--)
+		{
+			out[i] = (uint8)value;
+			value >>= 8;
+		}
+	}
+
+	/** Write the UTF-8 encoding of value, without a terminator */
+	FORCEINLINE void writeUTF8(const FString& value)
+	{
+		FTCHARToUTF8 converted(*value, value.Len());
+		SC_ACCOUNT_TRANSCODE(converted.Length());
+		write(converted.Get(), converted.Length());
+	}
+
+	/** The number of bytes written through this writer */
+	FORCEINLINE int32 num() const
+	{
+		return buffer.Num() - start;
+	}
+
+	/** The bytes written through this writer */
+	FORCEINLINE TArrayView<const uint8> view() const
+	{
+		return TArrayView<const uint8>(buffer.GetData() + start, num());
+	}
+
+private:
+
+	TArray<uint8>& buffer;
+
+	int32 start;
+};
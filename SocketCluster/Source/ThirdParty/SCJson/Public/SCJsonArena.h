@@ -0,0 +1,206 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+
+class FSCJsonTokenCursor;
+
+/**
+ * A bump allocator, memory handed out is never freed on its own, Reset releases all of it at once.
+ * Nothing allocated from the arena has its destructor run.
+ */
+class SCJSON_API FSCJsonArena
+{
+public:
+
+	explicit FSCJsonArena(int32 InBlockSize = 4096);
+
+	~FSCJsonArena();
+
+	FSCJsonArena(const FSCJsonArena&) = delete;
+
+	FSCJsonArena& operator=(const FSCJsonArena&) = delete;
+
+	FORCEINLINE void* Alloc(SIZE_T Size, SIZE_T Alignment = 8)
+	{
+		uint8* Aligned = Align(Cursor, Alignment);
+		if (Cursor == nullptr || Aligned + Size > BlockEnd)
+		{
+			return AllocSlow(Size, Alignment);
+		}
+		Cursor = Aligned + Size;
+		return Aligned;
+	}
+
+	template<typename T>
+	FORCEINLINE T* AllocArray(int32 Num)
+	{
+		return (T*)Alloc(sizeof(T) * Num, alignof(T));
+	}
+
+	/** Release everything, the memory is kept as a single block sized for what was used so the next message fits in one block */
+	void Reset();
+
+	/** Bytes handed out since the last reset */
+	SIZE_T GetUsed() const;
+
+private:
+
+	void* AllocSlow(SIZE_T Size, SIZE_T Alignment);
+
+	struct FBlock
+	{
+		uint8* Data;
+
+		SIZE_T Size;
+	};
+
+	TArray<FBlock> Blocks;
+
+	SIZE_T BlockSize;
+
+	uint8* Cursor;
+
+	uint8* BlockEnd;
+
+	/** Bytes used in the blocks before the current one */
+	SIZE_T UsedBefore;
+};
+
+struct FSCJsonMember;
+
+/**
+ * A JSON value allocated in an FSCJsonArena. Nodes are plain data and stay valid until the arena is reset,
+ * use ToJsonValue to keep any part of a message beyond that.
+ */
+struct SCJSON_API FSCJsonNode
+{
+	EJson Type;
+
+	/** String length, number of array items or object members */
+	int32 Length;
+
+	union
+	{
+		double Number;
+
+		bool Bool;
+
+		/** Null terminated */
+		const TCHAR* String;
+
+		const FSCJsonNode* Items;
+
+		const FSCJsonMember* Members;
+	};
+
+	FSCJsonNode()
+		: Type(EJson::Null)
+		, Length(0)
+		, Number(0.0)
+	{
+	}
+
+	bool IsNull() const { return Type == EJson::Null || Type == EJson::None; }
+
+	bool IsNumber() const { return Type == EJson::Number; }
+
+	bool IsBool() const { return Type == EJson::Boolean; }
+
+	bool IsString() const { return Type == EJson::String; }
+
+	bool IsArray() const { return Type == EJson::Array; }
+
+	bool IsObject() const { return Type == EJson::Object; }
+
+	/** The number, 0 for any other type */
+	double AsNumber() const { return Type == EJson::Number ? Number : 0.0; }
+
+	/** The boolean, false for any other type */
+	bool AsBool() const { return Type == EJson::Boolean && Bool; }
+
+	/** The string without a copy, empty for any other type */
+	const TCHAR* GetString() const { return Type == EJson::String ? String : TEXT(""); }
+
+	/** The value as a string, numbers and booleans are converted like FJsonValue::AsString */
+	FString AsString() const;
+
+	/** Number of array items or object members */
+	int32 Num() const { return Type == EJson::Array || Type == EJson::Object ? Length : 0; }
+
+	/** Array item, the null node if out of range or not an array */
+	const FSCJsonNode& operator[](int32 Index) const;
+
+	const FSCJsonMember& GetMember(int32 Index) const;
+
+	/** Find a member of an object by key, ignoring case like FJsonObject, nullptr if missing or not an object */
+	const FSCJsonNode* FindField(const TCHAR* Key) const;
+
+	/** The member or the null node */
+	const FSCJsonNode& GetField(const TCHAR* Key) const;
+
+	/** Deep copy into the shared pointer DOM, the result does not depend on the arena */
+	TSharedPtr<FJsonValue> ToJsonValue() const;
+
+	/** A null node, returned for missing values */
+	static const FSCJsonNode& NullNode();
+};
+
+struct FSCJsonMember
+{
+	/** Null terminated */
+	const TCHAR* Key;
+
+	int32 KeyLength;
+
+	FSCJsonNode Value;
+};
+
+/**
+ * One decoded message: every node and string is allocated from the document's arena, Reset frees the whole tree at once.
+ * A document is meant to be reused, after the first few messages parsing does not allocate.
+ */
+class SCJSON_API FSCJsonDocument
+{
+public:
+
+	FSCJsonDocument();
+
+	/** Parse UTF-8 JSON, the previous content is released first. Returns false on malformed input, the document is empty then */
+	bool Parse(TArrayView<const uint8> Bytes);
+
+	/** Copy a shared pointer DOM value into the arena, the previous content is released first */
+	void Assign(const TSharedPtr<FJsonValue>& JsonValue);
+
+	/** Release every node */
+	void Reset();
+
+	const FSCJsonNode& GetRoot() const { return Root; }
+
+	FSCJsonArena& GetArena() { return Arena; }
+
+private:
+
+	bool ParseValue(FSCJsonTokenCursor& Cursor, FSCJsonNode& Out);
+
+	void CopyValue(const TSharedPtr<FJsonValue>& JsonValue, FSCJsonNode& Out);
+
+	const TCHAR* CopyString(const ANSICHAR* Utf8, int32 Utf8Length, int32& OutLength);
+
+	const TCHAR* CopyString(const FString& Value, int32& OutLength);
+
+	FSCJsonArena Arena;
+
+	FSCJsonNode Root;
+
+	/** Children of the containers being parsed, copied to the arena in one piece once a container is closed */
+	TArray<FSCJsonNode> ItemStack;
+
+	TArray<FSCJsonMember> MemberStack;
+
+	/** Offsets of the structural characters of the message being parsed */
+	TArray<uint32> StructuralIndices;
+};
@@ -8,6 +8,7 @@
 #include "UObject/ObjectMacros.h"
 #include "Runtime/Json/Public/Dom/JsonObject.h"
 #include "Runtime/Json/Public/Dom/JsonValue.h"
+#include "SCJsonArena.h"
 #include "SCJsonConvert.generated.h"
 
 struct FTrimmedKeyMap
@@ -44,6 +45,16 @@ public:
 	//Expects a JsonObject, if blueprint struct it will lengthen the names to fill properly
 	static bool JsonObjectToUStruct(TSharedPtr<FJsonObject> JsonObject, UStruct* Struct, void* StructPtr, bool IsBlueprintStruct = false);
 	
+	//Straight between struct memory and UTF-8 JSON without an FJsonObject, uses the cached FSCStructPlan of the struct
+	static void UStructToJsonBytes(UStruct* Struct, const void* StructPtr, TArray<uint8>& OutBytes, bool IsBlueprintStruct = false);
+	static bool JsonBytesToUStruct(TArrayView<const uint8> Bytes, UStruct* Struct, void* StructPtr, bool IsBlueprintStruct = false);
+
+	//Parse UTF-8 JSON into an arena document, the nodes stay valid until the document is reset or parses again
+	static bool JsonBytesToDocument(TArrayView<const uint8> Bytes, FSCJsonDocument& OutDocument);
+
+	//Read one string member of a UTF-8 JSON object without parsing the rest, the key is matched ignoring case like FJsonObject. False if the bytes are not an object or the member is missing or no string
+	static bool JsonBytesFindStringField(TArrayView<const uint8> Bytes, const ANSICHAR* Key, FString& OutValue);
+
 	//Files - convenience read/write files
 	static bool JsonFileToUStruct(const FString& FilePath, UStruct* Struct, void* StructPtr, bool IsBlueprintStruct = false);
 	static bool ToJsonFile(const FString& FilePath, UStruct* Struct, void* StructPtr, bool IsBlueprintStruct = false);
@@ -61,8 +72,12 @@ public:
 	static TSharedPtr<FJsonValue> ToJsonValue(bool BoolValue);
 	static TSharedPtr<FJsonValue> ToJsonValue(const TArray<uint8>& BinaryValue);
 	static TSharedPtr<FJsonValue> ToJsonValue(const TArray<TSharedPtr<FJsonValue>>& ArrayValue);
+	static TSharedPtr<FJsonValue> ToJsonValue(const FSCJsonNode& Node);
 
 	static TSharedPtr<FJsonValue> JsonStringToJsonValue(const FString& JsonString);
+
+	//Same rules as JsonStringToJsonValue straight from UTF-8, objects and arrays go through the structural index parser
+	static TSharedPtr<FJsonValue> JsonBytesToJsonValue(TArrayView<const uint8> Bytes);
 	static TArray<TSharedPtr<FJsonValue>> JsonStringToJsonArray(const FString& JsonString);
 
 
@@ -0,0 +1,21 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Number to text the way JavaScript prints numbers (Number.prototype.toString, JSON.stringify): the shortest digits which read
+ * back to the same double, integers below 2^53 in full, exponent notation below 1e-6 and from 1e21.
+ * Digits come from Grisu2, which is always round trip exact and shortest for all but a tiny fraction of inputs.
+ */
+struct SCJSON_API FSCJsonNumber
+{
+	/** Enough for any double */
+	static const int32 MaxLength = 32;
+
+	/** Write Value to Buffer (MaxLength characters, not null terminated) and return the length. Non finite numbers are written as null */
+	static int32 Format(double Value, ANSICHAR* Buffer);
+
+	static FString ToString(double Value);
+};
@@ -8,6 +8,7 @@
 #include "SCJsonObject.generated.h"
 
 class USCJsonValue;
+class USCJsonWrapperCache;
 
 /**
  * Blueprintable FJsonObject wrapper
@@ -31,6 +32,12 @@ class SCJSON_API USCJsonObject : public UObject
 	/** Set the root Json object */
 	void SetRootObject(const TSharedPtr<FJsonObject>& JsonObject);
 
+	/** Share the wrapper cache of the root this object was read from */
+	void SetWrapperCache(USCJsonWrapperCache* Cache);
+
+	/** The cache of the wrappers handed out for fields of this object, made on first use */
+	USCJsonWrapperCache* GetWrapperCache() const;
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// Serialization
@@ -127,7 +134,7 @@ class SCJSON_API USCJsonObject : public UObject
 	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
 	void SetObjectField(const FString& FieldName, USCJsonObject* JsonObject);
 
-	/** Get the field named FieldName as a binary buffer array. */
+	/** Get the field named FieldName as a binary buffer array. Strings are read as base64, the encoding binary fields are written in. */
 	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
 	TArray<uint8> GetBinaryField(const FString& FieldName) const;
 
@@ -144,11 +151,14 @@ class SCJSON_API USCJsonObject : public UObject
 	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
 	TArray<float> GetNumberArrayField(const FString& FieldName);
 
-	/** Set an ObjectField named FieldName and value of Number Array
+	/** Set an ObjectField named FieldName and value of Number Array, stored packed without a Json value per number
 	 * Attn.!! float used instead of double to make the function blueprintable! */
 	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
 	void SetNumberArrayField(const FString& FieldName, const TArray<float>& NumberArray);
 
+	/** Set an ObjectField named FieldName and value of Number Array at full precision, stored packed */
+	void SetDoubleArrayField(const FString& FieldName, const TArray<double>& NumberArray);
+
 	/** Get the field named FieldName as a String Array. Use it only if you're sure that array is uniform! */
 	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
 	TArray<FString> GetStringArrayField(const FString& FieldName);
@@ -174,6 +184,29 @@ class SCJSON_API USCJsonObject : public UObject
 	void SetObjectArrayField(const FString& FieldName, const TArray<USCJsonObject*>& ObjectArray);
 
 
+	//////////////////////////////////////////////////////////////////////////
+	// Array fields without wrapping every item
+
+	/** Number of items of the array named FieldName, 0 if missing or not an array */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	int32 GetArrayFieldLength(const FString& FieldName) const;
+
+	/** Copy the Number Array named FieldName into OutNumbers, reusing its allocation. Returns false if missing or not uniform */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	bool CopyNumberArrayField(const FString& FieldName, TArray<float>& OutNumbers) const;
+
+	/** Copy the Number Array named FieldName into OutNumbers at full precision, packed arrays are copied in one go */
+	bool CopyDoubleArrayField(const FString& FieldName, TArray<double>& OutNumbers) const;
+
+	/** Copy the String Array named FieldName into OutStrings, reusing its allocation. Returns false if missing or not uniform */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	bool CopyStringArrayField(const FString& FieldName, TArray<FString>& OutStrings) const;
+
+	/** Copy the Bool Array named FieldName into OutBools, reusing its allocation. Returns false if missing or not uniform */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	bool CopyBoolArrayField(const FString& FieldName, TArray<bool>& OutBools) const;
+
+
 	//////////////////////////////////////////////////////////////////////////
 	// Data
 
@@ -181,4 +214,11 @@ private:
 	/** Internal JSON data */
 	TSharedPtr<FJsonObject> JsonObj;
 
+	/** Shared by every wrapper read from the same root */
+	UPROPERTY(Transient)
+	USCJsonWrapperCache* WrapperCache;
+
+	/** The array named FieldName, nullptr if missing or not an array */
+	TSharedPtr<FJsonValue> FindArrayField(const FString& FieldName) const;
+
 };
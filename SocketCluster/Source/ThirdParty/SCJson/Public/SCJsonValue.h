@@ -5,9 +5,11 @@
 #pragma once
 
 #include "Runtime/Json/Public/Dom/JsonValue.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "SCJsonValue.generated.h"
 
 class USCJsonObject;
+class USCJsonWrapperCache;
 
 /**
  * Represents all the types a Json Value can be.
@@ -28,16 +30,20 @@ namespace ESCJson
 	};
 }
 
+/**
+ * The type name FJsonValue::GetType gives a value. The modules are built without RTTI, so this is how the FJsonValue subclasses
+ * of the plugin are told apart from the engine values of the same EJson type.
+ */
+SCJSON_API FString SCGetJsonValueType(const FJsonValue& Value);
+
 class SCJSON_API FJsonValueBinary : public FJsonValue
 {
 public:
 	FJsonValueBinary(const TArray<uint8>& InBinary) : Value(InBinary) { Type = EJson::String; }	//pretends to be none
 
-	virtual bool TryGetString(FString& OutString) const override 
-	{
-		OutString = FString::FromHexBlob(Value.GetData(), Value.Num());	//encode the binary into the string directly
-		return true;
-	}
+	/** The bytes as standard base64, which is also how the Json writers put them on the wire */
+	virtual bool TryGetString(FString& OutString) const override;
+
 	virtual bool TryGetNumber(double& OutDouble) const override 
 	{
 		OutDouble = Value.Num();
@@ -50,18 +56,65 @@ public:
 	/** Return our binary data from this value */
 	TArray<uint8> AsBinary() { return Value; }
 
+	/** Our binary data without a copy */
+	const TArray<uint8>& GetBinary() const { return Value; }
+
 	/** Convenience method to determine if passed FJsonValue is a FJsonValueBinary or not. */
 	static bool IsBinary(const TSharedPtr<FJsonValue>& InJsonValue);
 
 	/** Convenience method to get binary array from unknown JsonValue, test with IsBinary first. */
 	static TArray<uint8> AsBinary(const TSharedPtr<FJsonValue>& InJsonValue);
 
+	/**
+	 * Get the bytes of a binary value, of a {"base64":true,"data":"..."} object as the sc-formatter sends them, or of a hex string.
+	 * A plain string is only read as base64 when bBase64Strings is set. False for anything else and for strings which do not decode.
+	 */
+	static bool TryGetBinary(const TSharedPtr<FJsonValue>& InJsonValue, TArray<uint8>& OutBytes, bool bBase64Strings = false);
+
 protected:
 	TArray<uint8> Value;
 
 	virtual FString GetType() const override { return TEXT("Binary"); }
 };
 
+/**
+ * A Json array of numbers kept as one contiguous TArray<double>. It is an EJson::Array to everyone, the FJsonValueNumber items are
+ * only made the first time something asks for AsArray. The readers, the writers and the number array helpers use the numbers directly.
+ */
+class SCJSON_API FJsonValueNumberArray : public FJsonValue
+{
+public:
+	FJsonValueNumberArray(TArray<double>&& InNumbers) : Numbers(MoveTemp(InNumbers)) { Type = EJson::Array; NumAlive.Increment(); }
+
+	FJsonValueNumberArray(const TArray<double>& InNumbers) : Numbers(InNumbers) { Type = EJson::Array; NumAlive.Increment(); }
+
+	FJsonValueNumberArray(const TArray<float>& InNumbers) : Numbers(InNumbers) { Type = EJson::Array; NumAlive.Increment(); }
+
+	virtual ~FJsonValueNumberArray() { NumAlive.Decrement(); }
+
+	using FJsonValue::TryGetArray;
+
+	virtual bool TryGetArray(const TArray<TSharedPtr<FJsonValue>>*& OutArray) const override;
+
+	const TArray<double>& GetNumbers() const { return Numbers; }
+
+	/** The numbers of InJsonValue if it is a packed number array, nullptr otherwise */
+	static const TArray<double>* AsNumberArray(const FJsonValue* InJsonValue);
+
+	static const TArray<double>* AsNumberArray(const TSharedPtr<FJsonValue>& InJsonValue) { return AsNumberArray(InJsonValue.Get()); }
+
+protected:
+	TArray<double> Numbers;
+
+	/** The FJsonValueNumber items, made on first use */
+	mutable TArray<TSharedPtr<FJsonValue>> Items;
+
+	virtual FString GetType() const override { return TEXT("NumberArray"); }
+
+	/** The number of packed number arrays alive, the type check is skipped while there are none */
+	static FThreadSafeCounter NumAlive;
+};
+
 /**
  * Blueprintable FJsonValue wrapper
  */
@@ -87,6 +140,11 @@ class SCJSON_API USCJsonValue : public UObject
 	UFUNCTION(BlueprintPure, meta = (DisplayName = "Construct Json Array Value", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject"), Category = "SocketCluster|Json")
 	static USCJsonValue* ConstructJsonValueArray(UObject* WorldContextObject, const TArray<USCJsonValue*>& InArray);
 
+	/** Create new Json Array value of numbers, stored packed without a Json value per number
+	 * Attn.!! float used instead of double to make the function blueprintable! */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Construct Json Number Array Value", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject"), Category = "SocketCluster|Json")
+	static USCJsonValue* ConstructJsonValueNumberArray(UObject* WorldContextObject, const TArray<float>& NumberArray);
+
 	/** Create new Json Object value */
 	UFUNCTION(BlueprintPure, meta = (DisplayName = "Construct Json Object Value", HidePin = "WorldContextObject", DefaultToSelf = "WorldContextObject"), Category = "SocketCluster|Json")
 	static USCJsonValue* ConstructJsonValueObject(USCJsonObject *JsonObject, UObject* WorldContextObject);
@@ -108,6 +166,12 @@ class SCJSON_API USCJsonValue : public UObject
 	/** Set the root Json value */
 	void SetRootValue(TSharedPtr<FJsonValue>& JsonValue);
 
+	/** Share the wrapper cache of the root this value was read from */
+	void SetWrapperCache(USCJsonWrapperCache* Cache);
+
+	/** The cache of the wrappers handed out for items of this value, made on first use */
+	USCJsonWrapperCache* GetWrapperCache() const;
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// FJsonValue API
@@ -145,6 +209,59 @@ class SCJSON_API USCJsonValue : public UObject
 	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
 	USCJsonObject* AsObject();
 
+
+	//////////////////////////////////////////////////////////////////////////
+	// Array access without wrapping every item
+
+	/** Number of items, 0 if this is not an array */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	int32 GetArrayLength() const;
+
+	/** The item at Index, nullptr if out of range or not an array */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	USCJsonValue* GetValueAt(int32 Index) const;
+
+	/** The item at Index as a number, 0 if out of range or not a number
+	 * Attn.!! float used instead of double to make the function blueprintable! */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	float GetNumberAt(int32 Index) const;
+
+	/** The item at Index as a string, empty if out of range or not a string */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	FString GetStringAt(int32 Index) const;
+
+	/** The item at Index as a boolean, false if out of range or not a boolean */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	bool GetBoolAt(int32 Index) const;
+
+	/** The item at Index as an object, nullptr if out of range or not an object */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	USCJsonObject* GetObjectAt(int32 Index) const;
+
+	/** Copy every item into OutNumbers, reusing its allocation. Returns false if this is not an array or an item is not a number (read as 0) */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	bool CopyNumberArray(TArray<float>& OutNumbers) const;
+
+	/** Copy every item into OutStrings, reusing its allocation. Returns false if this is not an array or an item is not a string */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	bool CopyStringArray(TArray<FString>& OutStrings) const;
+
+	/** Copy every item into OutBools, reusing its allocation. Returns false if this is not an array or an item is not a boolean */
+	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
+	bool CopyBoolArray(TArray<bool>& OutBools) const;
+
+	/** Copy every item into OutNumbers at full precision, packed number arrays are copied in one go */
+	bool CopyDoubleArray(TArray<double>& OutNumbers) const;
+
+	/** The typed copies behind the Copy functions of values and objects, false if Array is not an array or not uniform */
+	static bool CopyNumbers(const TSharedPtr<FJsonValue>& Array, TArray<float>& OutNumbers);
+
+	static bool CopyNumbers(const TSharedPtr<FJsonValue>& Array, TArray<double>& OutNumbers);
+
+	static bool CopyStrings(const TSharedPtr<FJsonValue>& Array, TArray<FString>& OutStrings);
+
+	static bool CopyBools(const TSharedPtr<FJsonValue>& Array, TArray<bool>& OutBools);
+
 	//todo: add basic binary e.g. tarray<byte>
 	UFUNCTION(BlueprintCallable, Category = "SocketCluster|Json")
 	TArray<uint8> AsBinary();
@@ -159,6 +276,10 @@ private:
 	/** Internal JSON data */
 	TSharedPtr<FJsonValue> JsonVal;
 
+	/** Shared by every wrapper read from the same root */
+	UPROPERTY(Transient)
+	USCJsonWrapperCache* WrapperCache;
+
 
 	//////////////////////////////////////////////////////////////////////////
 	// Helpers
@@ -0,0 +1,42 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+#include "SCJsonWrapperCache.generated.h"
+
+class USCJsonValue;
+class USCJsonObject;
+
+/**
+ * The Blueprint wrappers handed out for the values below one root wrapper. Every wrapper of the tree shares the cache of its root,
+ * so reading the same array or field again returns the wrapper made the first time instead of a new UObject.
+ * A wrapper keeps its value alive, the address of a cached value is never reused while its wrapper is in the cache.
+ */
+UCLASS()
+class SCJSON_API USCJsonWrapperCache : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The wrapper of Value, made on first use */
+	USCJsonValue* FindOrAddValue(const TSharedPtr<FJsonValue>& Value);
+
+	/** The wrapper of Object, made on first use */
+	USCJsonObject* FindOrAddObject(const TSharedPtr<FJsonObject>& Object);
+
+	/** Forget every wrapper, they stay valid for whoever still holds them */
+	void Reset();
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+private:
+
+	TMap<const FJsonValue*, USCJsonValue*> Values;
+
+	TMap<const FJsonObject*, USCJsonObject*> Objects;
+};
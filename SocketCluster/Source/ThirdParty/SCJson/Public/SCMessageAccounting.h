@@ -0,0 +1,116 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+
+/** Message accounting is compiled out of shipping builds, its hooks are empty there */
+#ifndef SC_MESSAGE_ACCOUNTING
+#define SC_MESSAGE_ACCOUNTING !UE_BUILD_SHIPPING
+#endif
+
+#if SC_MESSAGE_ACCOUNTING
+#define SC_ACCOUNT_MESSAGE(Direction) FSCMessageScope ANONYMOUS_VARIABLE(SCMessageScope)(Direction)
+#define SC_ACCOUNT_MESSAGE_TYPE(Direction, Type) FSCMessageScope ANONYMOUS_VARIABLE(SCMessageScope)(Direction, Type)
+#define SC_NAME_MESSAGE(Type) FSCMessageScope::setType(Type)
+#define SC_ACCOUNT_TRANSCODE(Bytes) FSCMessageAccounting::countTranscode(Bytes)
+#else
+#define SC_ACCOUNT_MESSAGE(Direction)
+#define SC_ACCOUNT_MESSAGE_TYPE(Direction, Type)
+#define SC_NAME_MESSAGE(Type)
+#define SC_ACCOUNT_TRANSCODE(Bytes)
+#endif
+
+enum class ESCMessageDirection : uint8
+{
+	INBOUND,
+	OUTBOUND
+};
+
+/** The totals accounted to a message type */
+struct FSCMessageCost
+{
+	uint64 messages = 0;
+
+	uint64 allocations = 0;
+
+	uint64 allocatedBytes = 0;
+
+	/** The UTF-8 to TCHAR conversions and back, with the UTF-8 bytes they covered */
+	uint64 transcodes = 0;
+
+	uint64 transcodedBytes = 0;
+};
+
+/**
+* Counts the heap allocations and string transcodes of every inbound and outbound message, by message type.
+* An inbound message is a frame from the socket receiving it until the client socket dispatched it, an outbound message an emit, publish or send until its frame is queued on the socket.
+* While running GMalloc is replaced by a counting proxy which counts the game thread, so it is a debug tool and slows every allocation down.
+* A message of the other direction started while one is open, like an emit from an event handler, is accounted to its own type and not to the open message.
+*/
+class SCJSON_API FSCMessageAccounting
+{
+public:
+
+	/** Install the counting allocator, returns false when accounting is compiled out */
+	static bool start();
+
+	/** Restore the allocator, the totals are kept until reset */
+	static void stop();
+
+	static bool isRunning() { return running; }
+
+	/** Clear the totals of every message type */
+	static void reset();
+
+	/** Count a string transcode of the open message, bytes is the size of the UTF-8 side */
+	static FORCEINLINE void countTranscode(int32 bytes)
+	{
+		if (running)
+		{
+			_countTranscode(bytes);
+		}
+	}
+
+	static const TMap<FString, FSCMessageCost>& getCosts(ESCMessageDirection direction);
+
+	/** The averages per message of every type, {"inbound": {"<type>": {"messages", "allocationsPerMessage", "allocatedBytesPerMessage", "transcodesPerMessage", "transcodedBytesPerMessage"}}, "outbound": {...}} */
+	static TSharedPtr<FJsonObject> toJson();
+
+private:
+
+	friend class FSCMessageScope;
+
+	static bool running;
+
+	static void _countTranscode(int32 bytes);
+};
+
+/**
+* Accounts what the game thread allocates and transcodes while it is in scope to a message.
+* Scopes of the same direction nest into the outermost one, the first type given names the message.
+*/
+class SCJSON_API FSCMessageScope
+{
+public:
+
+	explicit FSCMessageScope(ESCMessageDirection direction);
+
+	FSCMessageScope(ESCMessageDirection direction, const TCHAR* type);
+
+	~FSCMessageScope();
+
+	FSCMessageScope(const FSCMessageScope&) = delete;
+
+	FSCMessageScope& operator=(const FSCMessageScope&) = delete;
+
+	/** Name the open message once its type is known, type is only called when the message has none yet and what it allocates is not accounted */
+	static void setType(TFunctionRef<FString()> type);
+
+	static void setType(const TCHAR* type);
+
+private:
+
+	bool active;
+};
@@ -0,0 +1,284 @@
+// Copyright 2019 ZiiCreater, LLC. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UnrealType.h"
+#include "UObject/WeakObjectPtr.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Runtime/Json/Public/Dom/JsonObject.h"
+#include "Runtime/Json/Public/Dom/JsonValue.h"
+#include "SCByteWriter.h"
+
+class FSCJsonByteReader;
+struct FSCJsonNode;
+
+/** How a property is serialized by a struct plan */
+enum class ESCStructPlanKind : uint8
+{
+	Bool,
+	Integer,
+	Unsigned,
+	Float,
+	Enum,
+	String,
+	Name,
+	Text,
+	Struct,
+	Array,
+	Set,
+	Map,
+	/** Anything else goes through FJsonObjectConverter for the property */
+	Other
+};
+
+/**
+ * A serialization plan for a UStruct, compiled once from reflection and cached per struct.
+ * The plan maps every property to its JSON key (with the Blueprint GUID suffix trimmed if requested) and reads and writes
+ * JSON bytes directly from and to the struct memory, without building an FJsonObject in between.
+ * Output matches FJsonObjectConverter: standardized key case, enums as names, structs with ExportTextItem as strings.
+ */
+class SCJSON_API FSCStructPlan
+{
+public:
+
+	struct FEntry
+	{
+		UProperty* Property = nullptr;
+
+		ESCStructPlanKind Kind = ESCStructPlanKind::Other;
+
+		/** The key written to JSON */
+		FString Key;
+
+		/** The standardized, untrimmed key, also accepted when reading */
+		FString LongKey;
+
+		/** Key as UTF-8, used to match keys while reading */
+		TArray<ANSICHAR> KeyUtf8;
+
+		TArray<ANSICHAR> LongKeyUtf8;
+
+		/** The escaped and quoted key followed by ':', written as is */
+		TArray<uint8> KeyPrefix;
+
+		/** The numeric property for Integer, Unsigned, Float and Enum (the underlying property) entries */
+		UNumericProperty* Numeric = nullptr;
+
+		UEnum* Enum = nullptr;
+
+		const FSCStructPlan* SubPlan = nullptr;
+
+		/** The element of Array and Set entries, the value of Map entries */
+		TSharedPtr<FEntry> Inner;
+
+		/** The key of Map entries */
+		TSharedPtr<FEntry> MapKey;
+	};
+
+	/**
+	 * Returns the plan for a struct, compiling it on first use.
+	 *
+	 * @param Struct		The struct to get the plan of.
+	 * @param bTrimKeys		Whether to trim Blueprint struct keys, e.g. boolKey_8_EDBB36654CF43866C376DE921373AF23 -> boolKey.
+	 */
+	static const FSCStructPlan* Get(UStruct* Struct, bool bTrimKeys);
+
+	/** Write the struct as a JSON object */
+	void Write(const void* StructPtr, FSCByteWriter& Writer) const;
+
+	/** Read a JSON object into the struct, fields missing from the input keep their value. Returns false on malformed input */
+	bool Read(TArrayView<const uint8> Bytes, void* StructPtr) const;
+
+	/** Read an object node of an arena document into the struct, fields missing from the node keep their value. Returns false if the node is not an object */
+	bool Read(const FSCJsonNode& Node, void* StructPtr) const;
+
+	/** Build an FJsonObject from the struct, for callers which need the DOM */
+	TSharedPtr<FJsonObject> ToJsonObject(const void* StructPtr) const;
+
+	/** Fill the struct from an FJsonObject, keys are matched through the plan */
+	bool FromJsonObject(const TSharedPtr<FJsonObject>& JsonObject, void* StructPtr) const;
+
+	/** Write any FJsonValue as JSON */
+	static void WriteJsonValue(const TSharedPtr<FJsonValue>& JsonValue, FSCByteWriter& Writer);
+
+	static void WriteJsonArray(const TArray<TSharedPtr<FJsonValue>>& Array, FSCByteWriter& Writer);
+
+	/** Write the numbers of a packed number array, without a FJsonValue per number */
+	static void WriteJsonNumberArray(const TArray<double>& Numbers, FSCByteWriter& Writer);
+
+	/** An invalid object is written as {} */
+	static void WriteJsonObject(const TSharedPtr<FJsonObject>& Object, FSCByteWriter& Writer);
+
+	/** Write an escaped and quoted JSON string */
+	static void WriteJsonString(const FString& Value, FSCByteWriter& Writer);
+
+	/** Write bytes as a quoted standard base64 string, encoded straight into the writer */
+	static void WriteJsonBinary(TArrayView<const uint8> Bytes, FSCByteWriter& Writer);
+
+	/** Write a JSON number with FSCJsonNumber, the shortest text which reads back to the same double, non finite numbers as null */
+	static void WriteJsonNumber(double Value, FSCByteWriter& Writer);
+
+	UStruct* GetStruct() const { return Struct.Get(); }
+
+	const TArray<FEntry>& GetEntries() const { return Entries; }
+
+private:
+
+	FSCStructPlan(UStruct* InStruct, bool bInTrimKeys);
+
+	void Compile();
+
+	TSharedPtr<FEntry> MakeEntry(UProperty* Property) const;
+
+	void ClassifyEntry(FEntry& Entry) const;
+
+	const FEntry* FindEntry(const ANSICHAR* Key, int32 KeyLength, int32& Hint) const;
+
+	const FEntry* FindEntry(const TCHAR* Key, int32 KeyLength, int32& Hint) const;
+
+	const FEntry* FindEntry(const FString& Key) const;
+
+	bool ReadObject(FSCJsonByteReader& Reader, void* StructPtr) const;
+
+	static void WriteValue(const FEntry& Entry, const void* ValuePtr, FSCByteWriter& Writer);
+
+	static bool ReadValue(const FEntry& Entry, FSCJsonByteReader& Reader, void* ValuePtr);
+
+	static bool ReadNodeValue(const FEntry& Entry, const FSCJsonNode& Node, void* ValuePtr);
+
+	static TSharedPtr<FJsonValue> ToJsonValue(const FEntry& Entry, const void* ValuePtr);
+
+	static bool FromJsonValue(const FEntry& Entry, const TSharedPtr<FJsonValue>& JsonValue, void* ValuePtr);
+
+	static bool SetKeyFromString(const FEntry& Entry, const FString& Key, void* KeyPtr);
+
+	static FString GetKeyString(const FEntry& Entry, const void* KeyPtr);
+
+	TWeakObjectPtr<UStruct> Struct;
+
+	bool bTrimKeys;
+
+	/** Used to detect recompiled Blueprint structs in the editor */
+	int32 StructureSize;
+
+	UProperty* PropertyLink;
+
+	TArray<FEntry> Entries;
+
+	TMap<FString, int32> KeyIndex;
+};
+
+template<typename T>
+struct TSCStructPlan;
+
+/**
+ * A struct held as a Json object value. FSCStructPlan::WriteJsonValue writes it through its plan straight into the writer,
+ * so an emit or publish of a struct builds no FJsonObject on its way into the frame.
+ * The FJsonObject is only made the first time something asks for AsObject, like a codec which does not write JSON text.
+ */
+class SCJSON_API FJsonValueStruct : public FJsonValue
+{
+public:
+	virtual ~FJsonValueStruct();
+
+	using FJsonValue::TryGetObject;
+
+	virtual bool TryGetObject(const TSharedPtr<FJsonObject>*& OutObject) const override;
+
+	const FSCStructPlan* GetPlan() const { return Plan; }
+
+	const void* GetStructMemory() const { return StructPtr; }
+
+	/** InJsonValue if it is a struct value, nullptr otherwise */
+	static const FJsonValueStruct* AsStruct(const FJsonValue* InJsonValue);
+
+protected:
+	FJsonValueStruct(const FSCStructPlan* InPlan, const void* InStructPtr);
+
+	const FSCStructPlan* Plan;
+
+	const void* StructPtr;
+
+	/** The FJsonObject of the struct, made on first use */
+	mutable TSharedPtr<FJsonObject> Object;
+
+	virtual FString GetType() const override { return TEXT("Struct"); }
+
+	/** The number of struct values alive, the type check is skipped while there are none */
+	static FThreadSafeCounter NumAlive;
+};
+
+/** A struct value holding its own copy of a USTRUCT */
+template<typename T>
+class TJsonValueStruct : public FJsonValueStruct
+{
+public:
+	explicit TJsonValueStruct(const T& InValue)
+		: FJsonValueStruct(TSCStructPlan<T>::Get(), &Value)
+		, Value(InValue)
+	{
+	}
+
+private:
+	T Value;
+};
+
+/** Whether T is a USTRUCT with a generated StaticStruct */
+template<typename T>
+struct TSCIsUStruct
+{
+	template<typename U> static char Test(decltype(&U::StaticStruct));
+	template<typename U> static int32 Test(...);
+
+	enum { Value = sizeof(Test<T>(nullptr)) == sizeof(char) };
+};
+
+/**
+ * The plan of a USTRUCT type, resolved once per type instead of through the plan cache on every call.
+ * Keys are not trimmed, C++ structs have no GUID suffixes.
+ */
+template<typename T>
+struct TSCStructPlan
+{
+	static const FSCStructPlan* Get()
+	{
+#if WITH_EDITOR
+		//Hot reload replaces the struct, so the editor asks the cache every time
+		return FSCStructPlan::Get(T::StaticStruct(), false);
+#else
+		static const FSCStructPlan* Plan = FSCStructPlan::Get(T::StaticStruct(), false);
+		return Plan;
+#endif
+	}
+
+	/** Decode an object value into Out, fields missing from the value keep their current value. Returns false if the value is not an object */
+	static bool Decode(const TSharedPtr<FJsonValue>& JsonValue, T& Out)
+	{
+		return JsonValue.IsValid() && JsonValue->Type == EJson::Object && Get()->FromJsonObject(JsonValue->AsObject(), &Out);
+	}
+
+	/** Wrap a copy of Value as a Json object value, it is written through the plan when it is encoded as JSON */
+	static TSharedPtr<FJsonValue> MakeJsonValue(const T& Value)
+	{
+		return MakeShareable(new TJsonValueStruct<T>(Value));
+	}
+
+	/** Write Value as UTF-8 JSON */
+	static void Write(const T& Value, FSCByteWriter& Writer)
+	{
+		Get()->Write(&Value, Writer);
+	}
+
+	/** Read UTF-8 JSON into Out */
+	static bool Read(TArrayView<const uint8> Bytes, T& Out)
+	{
+		return Get()->Read(Bytes, &Out);
+	}
+
+	/** Read an object node of an arena document into Out */
+	static bool Read(const FSCJsonNode& Node, T& Out)
+	{
+		return Get()->Read(Node, &Out);
+	}
+};